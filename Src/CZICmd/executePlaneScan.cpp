@@ -11,12 +11,6 @@ using namespace libCZI;
 
 class CExecutePlaneScan : public CExecuteBase
 {
-protected:
-    struct CacheContext
-    {
-        shared_ptr<ISubBlockCache> cache;
-        ISubBlockCache::PruneOptions prune_options;
-    };
 public:
     static bool execute(const CCmdLineOptions& options)
     {
@@ -26,17 +20,27 @@ public:
         const auto roi = CExecuteBase::GetRoiFromOptions(options, reader->GetStatistics());
         const auto& coordinate = options.GetPlaneCoordinate();
 
-        CacheContext cache_context;
+        // the cache is created with a capacity, so it is pruned automatically whenever a sub-block is added
+        shared_ptr<ISubBlockCache> cache;
         const uint64_t max_cache_size = options.GetSubBlockCacheSize();
         if (max_cache_size > 0)
         {
-            cache_context.cache = CreateSubBlockCache();
-            cache_context.prune_options.maxMemoryUsage = max_cache_size;
+            SubBlockCacheOptions cache_options;
+            cache_options.capacity.maxMemoryUsage = max_cache_size;
+            cache = CreateSubBlockCache(cache_options);
         }
         const auto tile_size_for_plane_scan = options.GetTileSizeForPlaneScan();
         const IntSize tileSize = { get<0>(tile_size_for_plane_scan), get<1>(tile_size_for_plane_scan) };
         const auto saver = CSaveBitmapFactory::CreateSaveBitmapObj(nullptr);
 
+        if (options.GetZoom() == 1)
+        {
+            // at full resolution, the plane-tile iterator reads and decodes every sub-block only once (instead of once for every
+            //  tile it intersects)
+            CExecutePlaneScan::WriteTilesWithPlaneTileIterator(reader, coordinate, roi, tileSize, cache, saver, options);
+            return true;
+        }
+
         for (int y = 0; y < (roi.h + static_cast<int>(tileSize.h) - 1) / static_cast<int>(tileSize.h); ++y)
         {
             for (int x = 0; x < (roi.w + static_cast<int>(tileSize.w) - 1) / static_cast<int>(tileSize.w); ++x)
@@ -49,18 +53,42 @@ public:
                     min(static_cast<int>(tileSize.h), roi.h - y * static_cast<int>(tileSize.h))
                 };
 
-                CExecutePlaneScan::WriteRoi(accessor, coordinate, tileRect, cache_context, saver, options);
+                CExecutePlaneScan::WriteRoi(accessor, coordinate, tileRect, cache, saver, options);
             }
         }
 
         return true;
     }
 protected:
+    static void WriteTilesWithPlaneTileIterator(
+        const shared_ptr<ICZIReader>& reader,
+        const CDimCoordinate& plane_coordinate,
+        const IntRect& roi,
+        const IntSize& tile_size,
+        const shared_ptr<ISubBlockCache>& cache,
+        const shared_ptr<ISaveBitmap>& saver,
+        const CCmdLineOptions& options)
+    {
+        PlaneTileIteratorOptions iterator_options;
+        iterator_options.backGroundColor = GetBackgroundColorFromOptions(options);
+        iterator_options.sceneFilter = options.GetSceneIndexSet();
+        iterator_options.subBlockCache = cache;
+
+        const auto iterator = CreatePlaneTileIterator(reader, PixelType::Invalid, roi, &plane_coordinate, tile_size, iterator_options);
+        IntRect tile_rect;
+        shared_ptr<IBitmapData> tile;
+        while (iterator->GetNext(&tile_rect, &tile))
+        {
+            const auto filename = GetFileName(options, tile_rect);
+            saver->Save(filename.c_str(), SaveDataFormat::PNG, tile.get());
+        }
+    }
+
     static void WriteRoi(
         const shared_ptr<ISingleChannelScalingTileAccessor>& accessor,
         const CDimCoordinate& plane_coordinate,
         const IntRect& roi,
-        const CacheContext& cache_context,
+        const shared_ptr<ISubBlockCache>& cache,
         const shared_ptr<ISaveBitmap>& saver,
         const CCmdLineOptions& options)
     {
@@ -68,16 +96,11 @@ protected:
         scstaOptions.Clear();
         scstaOptions.backGroundColor = GetBackgroundColorFromOptions(options);
         scstaOptions.sceneFilter = options.GetSceneIndexSet();
-        scstaOptions.subBlockCache = cache_context.cache;
+        scstaOptions.subBlockCache = cache;
         scstaOptions.useVisibilityCheckOptimization = options.GetUseVisibilityCheckOptimization();
 
         const auto bitmap = accessor->Get(roi, &plane_coordinate, options.GetZoom(), &scstaOptions);
 
-        if (cache_context.cache)
-        {
-            cache_context.cache->Prune(cache_context.prune_options);
-        }
-
         const auto filename = GetFileName(options, roi);
         saver->Save(filename.c_str(), SaveDataFormat::PNG, bitmap.get());
     }
@@ -6,6 +6,10 @@
 #include <memory>
 #include <stdexcept> 
 #include <sstream>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
 #include "jxrlib/jxrgluelib/JXRGlue.h"
 
 #include "jxrlib/image/sys/windowsmediaphoto.h"
@@ -96,10 +100,22 @@ static void WriteGuidToStream(ostringstream& string_stream, const GUID& guid)
     string_stream << std::nouppercase;
 }
 
-void JxrDecode::Decode(
+namespace
+{
+    /// This structure bundles a jxrlib-decoder-object and the stream-object it operates on. The decoder is
+    /// destroyed before the stream.
+    struct JxrlibDecoderInstance
+    {
+        unique_ptr<WMPStream, void(*)(WMPStream*)> stream{ nullptr, [](WMPStream* p)->void {p->Close(&p); } };
+        unique_ptr<PKImageDecode, void(*)(PKImageDecode*)> decoder{ nullptr, [](PKImageDecode* p)->void {p->Release(&p); } };
+    };
+}
+
+/*static*/void JxrDecode::Decode(
             const void* ptrData,
             size_t size,
-            const std::function<std::tuple<void*, std::uint32_t>(PixelFormat pixel_format, std::uint32_t  width, std::uint32_t  height)>& get_destination_func)
+            const std::function<std::tuple<void*, std::uint32_t>(PixelFormat pixel_format, std::uint32_t  width, std::uint32_t  height)>& get_destination_func,
+            std::uint32_t max_number_of_threads/*=1*/)
 {
     if (ptrData == nullptr)
     {
@@ -116,36 +132,44 @@ void JxrDecode::Decode(
         throw invalid_argument("get_destination_func");
     }
 
-    WMPStream* pStream = nullptr;
-    ERR err = JXRLIB_API(CreateWS_Memory)(&pStream, const_cast<void*>(ptrData), size);
-    if (Failed(err))
-    {
-        // note: the call "CreateWS_Memory" cannot fail (or the only way it can fail is that the memory allocation fails),
-        //        so we do not have to release/free the stream object here.
-        ThrowJxrlibError("'CreateWS_Memory' failed", err);
-    }
-
-    unique_ptr<WMPStream, void(*)(WMPStream*)> upStream(pStream, [](WMPStream* p)->void {p->Close(&p); });
-
-    PKImageDecode* pDecoder = nullptr;
-    err = JXRLIB_API(PKCodecFactory_CreateDecoderFromStream)(pStream, &pDecoder);
-    if (Failed(err))
-    {
-        // unfortunately, "PKCodecFactory_CreateDecoderFromStream" may fail leaving us with a partially constructed
-        //  decoder object, so we need to release/free the decoder object here.
-        if (pDecoder != nullptr)
+    const auto create_decoder =
+        [ptrData, size]() -> JxrlibDecoderInstance
         {
-            pDecoder->Release(&pDecoder);
-        }
-
-        ThrowJxrlibError("'PKCodecFactory_CreateDecoderFromStream' failed", err);
-    }
-
-    // construct a smart pointer which will destroy the decoder object when it goes out of scope
-    std::unique_ptr<PKImageDecode, void(*)(PKImageDecode*)> upDecoder(pDecoder, [](PKImageDecode* p)->void {p->Release(&p); });
+            JxrlibDecoderInstance instance;
+            WMPStream* pStream = nullptr;
+            ERR err = JXRLIB_API(CreateWS_Memory)(&pStream, const_cast<void*>(ptrData), size);
+            if (Failed(err))
+            {
+                // note: the call "CreateWS_Memory" cannot fail (or the only way it can fail is that the memory allocation fails),
+                //        so we do not have to release/free the stream object here.
+                ThrowJxrlibError("'CreateWS_Memory' failed", err);
+            }
+
+            instance.stream.reset(pStream);
+
+            PKImageDecode* pDecoder = nullptr;
+            err = JXRLIB_API(PKCodecFactory_CreateDecoderFromStream)(pStream, &pDecoder);
+            if (Failed(err))
+            {
+                // unfortunately, "PKCodecFactory_CreateDecoderFromStream" may fail leaving us with a partially constructed
+                //  decoder object, so we need to release/free the decoder object here.
+                if (pDecoder != nullptr)
+                {
+                    pDecoder->Release(&pDecoder);
+                }
+
+                ThrowJxrlibError("'PKCodecFactory_CreateDecoderFromStream' failed", err);
+            }
+
+            instance.decoder.reset(pDecoder);
+            return instance;
+        };
+
+    JxrlibDecoderInstance decoder_instance = create_decoder();
+    PKImageDecode* const pDecoder = decoder_instance.decoder.get();
 
     U32 frame_count;
-    err = upDecoder->GetFrameCount(upDecoder.get(), &frame_count);
+    ERR err = pDecoder->GetFrameCount(pDecoder, &frame_count);
     if (Failed(err))
     {
         ThrowJxrlibError("'decoder::GetFrameCount' failed", err);
@@ -159,14 +183,14 @@ void JxrDecode::Decode(
     }
 
     I32 width, height;
-    upDecoder->GetSize(upDecoder.get(), &width, &height);
+    pDecoder->GetSize(pDecoder, &width, &height);
     if (Failed(err))
     {
         ThrowJxrlibError("'decoder::GetSize' failed", err);
     }
 
     PKPixelFormatGUID pixel_format_of_decoder;
-    upDecoder->GetPixelFormat(upDecoder.get(), &pixel_format_of_decoder);
+    pDecoder->GetPixelFormat(pDecoder, &pixel_format_of_decoder);
     if (Failed(err))
     {
         ThrowJxrlibError("'decoder::GetPixelFormat' failed", err);
@@ -187,15 +211,104 @@ void JxrDecode::Decode(
         width,
         height);
 
-    const PKRect rc{ 0, 0, width, height };
-    err = upDecoder->Copy(
-        upDecoder.get(),
-        &rc,
-        static_cast<U8*>(get<0>(decode_info)),
-        get<1>(decode_info));
-    if (Failed(err))
+    // determine the number of bands we are going to use - every band must have a minimal height, and the
+    //  band boundaries are aligned to macroblock rows (i.e. multiples of 16)
+    const uint32_t minimal_band_height = kMinimalBandHeightForMultiThreadedDecode;
+    const uint32_t max_number_of_bands = (max)(1u, (min)(max_number_of_threads, static_cast<uint32_t>(height) / minimal_band_height));
+    uint32_t band_height = 0;
+    uint32_t number_of_bands = 1;
+    if (max_number_of_bands > 1)
+    {
+        // note that after rounding up the band height, fewer bands may be sufficient to cover the image - and we must
+        //  not have a band starting beyond the image, so the number of bands is determined from the (aligned) band height
+        band_height = (((static_cast<uint32_t>(height) + max_number_of_bands - 1) / max_number_of_bands) + 15) & ~15u;
+        number_of_bands = (static_cast<uint32_t>(height) + band_height - 1) / band_height;
+    }
+
+    if (number_of_bands <= 1)
+    {
+        const PKRect rc{ 0, 0, width, height };
+        err = pDecoder->Copy(
+            pDecoder,
+            &rc,
+            static_cast<U8*>(get<0>(decode_info)),
+            get<1>(decode_info));
+        if (Failed(err))
+        {
+            ThrowJxrlibError("decoder::Copy failed", err);
+        }
+
+        return;
+    }
+
+    const auto decode_band =
+        [&](PKImageDecode* decoder, uint32_t band_no) -> void
+        {
+            const uint32_t y = band_no * band_height;
+            const uint32_t h = (min)(band_height, static_cast<uint32_t>(height) - y);
+
+            // we use the "region decode" functionality of jxrlib - the ROI has to be set before the first call to "Copy", and
+            //  the rectangle passed to "Copy" is then relative to the ROI
+            decoder->WMP.wmiI.cROILeftX = 0;
+            decoder->WMP.wmiI.cROITopY = y;
+            decoder->WMP.wmiI.cROIWidth = width;
+            decoder->WMP.wmiI.cROIHeight = h;
+            const PKRect rc{ 0, 0, width, static_cast<I32>(h) };
+            const ERR error = decoder->Copy(
+                decoder,
+                &rc,
+                static_cast<U8*>(get<0>(decode_info)) + static_cast<size_t>(y) * get<1>(decode_info),
+                get<1>(decode_info));
+            if (Failed(error))
+            {
+                ostringstream string_stream;
+                string_stream << "decoder::Copy failed for band #" << band_no << " (y=" << y << ", height=" << h << ")";
+                ThrowJxrlibError(string_stream, error);
+            }
+        };
+
+    // the bands are decoded on worker threads (each with its own decoder instance), the first band is decoded
+    //  on the calling thread with the decoder instance we already have
+    vector<exception_ptr> exceptions(number_of_bands);
+    vector<thread> threads;
+    threads.reserve(number_of_bands - 1);
+    try
+    {
+        for (uint32_t band_no = 1; band_no < number_of_bands; ++band_no)
+        {
+            threads.emplace_back(
+                [&, band_no]() -> void
+                {
+                    try
+                    {
+                        auto band_decoder_instance = create_decoder();
+                        decode_band(band_decoder_instance.decoder.get(), band_no);
+                    }
+                    catch (...)
+                    {
+                        exceptions[band_no] = current_exception();
+                    }
+                });
+        }
+
+        decode_band(pDecoder, 0);
+    }
+    catch (...)
     {
-        ThrowJxrlibError("decoder::Copy failed", err);
+        exceptions[0] = current_exception();
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto& exception : exceptions)
+    {
+        if (exception)
+        {
+            rethrow_exception(exception);
+        }
     }
 }
 
@@ -98,13 +98,20 @@ namespace libCZI
             /// * The 'get_destination_func' function may choose to throw an exception (if the memory cannot be allocated,  
             ///   or the reported characteristics are determined to be invalid, etc.). 
             ///
+            /// * If 'max_number_of_threads' is greater than one, then the image is split into horizontal bands (aligned to macroblock rows),
+            ///   and the bands are decoded concurrently (using jxrlib's region-decode), each by a separate decoder instance. Bands are
+            ///   only used if the image is large enough for this to be beneficial. The result is identical to decoding the image in one go.
+            ///
             /// \param  ptrData                 Information describing the pointer.
             /// \param  size                    The size.
             /// \param  get_destination_func    The get destination function.
+            /// \param  max_number_of_threads   The maximum number of threads to use for decoding. If 0 or 1, the image is decoded in
+            ///                                 the calling thread only.
             static void Decode(
                     const void* ptrData,
                     size_t size,
-                    const std::function<std::tuple<void*/*destination_bitmap*/, std::uint32_t/*stride*/>(PixelFormat pixel_format, std::uint32_t  width, std::uint32_t  height)>& get_destination_func);
+                    const std::function<std::tuple<void*/*destination_bitmap*/, std::uint32_t/*stride*/>(PixelFormat pixel_format, std::uint32_t  width, std::uint32_t  height)>& get_destination_func,
+                    std::uint32_t max_number_of_threads = 1);
 
             /// Compresses the specified bitmap into the JXR (aka JPEG XR) format.
             /// 
@@ -126,6 +133,10 @@ namespace libCZI
                     const void* ptr_bitmap,
                     float quality = 1.f);
         private:
+            /// The minimal height (in pixels) of a band when decoding with multiple threads. Since every band-decoder has to
+            /// parse the bitstream up to the start of its band, bands must not become too small.
+            static constexpr std::uint32_t kMinimalBandHeightForMultiThreadedDecode = 256;
+
             static void ThrowJxrlibError(const std::string& message, int error_code);
             [[noreturn]] static void ThrowJxrlibError(std::ostringstream& message, int error_code);
             static std::uint8_t GetBytesPerPel(PixelFormat pixel_format);
@@ -249,6 +249,161 @@ using namespace std;
     NNScale2(bmSrc->GetPixelType(), bmDst->GetPixelType(), resizeInfo);
 }
 
+/*static*/void CBitmapOperations::AreaAverageResize(libCZI::IBitmapData* bmSrc, libCZI::IBitmapData* bmDest, const libCZI::DblRect& roiSrc, const libCZI::DblRect& roiDst)
+{
+    const auto horizontal = CBitmapOperations::CalcAreaAverageResamplingTable(roiSrc.x, roiSrc.w, static_cast<int>(bmSrc->GetWidth()), roiDst.x, roiDst.w, static_cast<int>(bmDest->GetWidth()));
+    const auto vertical = CBitmapOperations::CalcAreaAverageResamplingTable(roiSrc.y, roiSrc.h, static_cast<int>(bmSrc->GetHeight()), roiDst.y, roiDst.h, static_cast<int>(bmDest->GetHeight()));
+    CBitmapOperations::SeparableResize(bmSrc, bmDest, horizontal, vertical);
+}
+
+/*static*/void CBitmapOperations::BilinearResize(libCZI::IBitmapData* bmSrc, libCZI::IBitmapData* bmDest, const libCZI::DblRect& roiSrc, const libCZI::DblRect& roiDst)
+{
+    const auto horizontal = CBitmapOperations::CalcBilinearResamplingTable(roiSrc.x, roiSrc.w, static_cast<int>(bmSrc->GetWidth()), roiDst.x, roiDst.w, static_cast<int>(bmDest->GetWidth()));
+    const auto vertical = CBitmapOperations::CalcBilinearResamplingTable(roiSrc.y, roiSrc.h, static_cast<int>(bmSrc->GetHeight()), roiDst.y, roiDst.h, static_cast<int>(bmDest->GetHeight()));
+    CBitmapOperations::SeparableResize(bmSrc, bmDest, horizontal, vertical);
+}
+
+/*static*/void CBitmapOperations::SeparableResize(libCZI::IBitmapData* bmSrc, libCZI::IBitmapData* bmDest, const ResamplingTable& horizontal, const ResamplingTable& vertical)
+{
+    if (bmSrc->GetPixelType() != bmDest->GetPixelType())
+    {
+        throw runtime_error("Currently works only for source and destination having same pixeltype, sorry.");
+    }
+
+    ScopedBitmapLockerP lckSrc{ bmSrc };
+    ScopedBitmapLockerP lckDst{ bmDest };
+    CBitmapOperations::SeparableScale(bmSrc->GetPixelType(), lckSrc.ptrDataRoi, lckSrc.stride, lckDst.ptrDataRoi, lckDst.stride, horizontal, vertical);
+}
+
+/*static*/void CBitmapOperations::SeparableScale(libCZI::PixelType pixelType, const void* srcPtr, int srcStride, void* dstPtr, int dstStride, const ResamplingTable& horizontal, const ResamplingTable& vertical)
+{
+    switch (pixelType)
+    {
+    case PixelType::Gray8:
+        InternalSeparableScale<uint8_t, 1>(srcPtr, srcStride, dstPtr, dstStride, horizontal, vertical);
+        break;
+    case PixelType::Gray16:
+        InternalSeparableScale<uint16_t, 1>(srcPtr, srcStride, dstPtr, dstStride, horizontal, vertical);
+        break;
+    case PixelType::Gray32Float:
+        InternalSeparableScale<float, 1>(srcPtr, srcStride, dstPtr, dstStride, horizontal, vertical);
+        break;
+    case PixelType::Bgr24:
+        InternalSeparableScale<uint8_t, 3>(srcPtr, srcStride, dstPtr, dstStride, horizontal, vertical);
+        break;
+    case PixelType::Bgr48:
+        InternalSeparableScale<uint16_t, 3>(srcPtr, srcStride, dstPtr, dstStride, horizontal, vertical);
+        break;
+    case PixelType::Bgra32:
+        InternalSeparableScale<uint8_t, 4>(srcPtr, srcStride, dstPtr, dstStride, horizontal, vertical);
+        break;
+    default:
+        ThrowUnsupportedConversion(pixelType, pixelType);
+    }
+}
+
+/// Determine the range of destination pixels whose center is inside the destination ROI (and inside the destination bitmap), and
+/// initialize the resampling table accordingly. If the range is empty, the table is left empty and false is returned.
+static bool InitializeResamplingTable(CBitmapOperations::ResamplingTable& table, int* destinationEnd, double srcRoiSize, int srcSize, double dstRoiStart, double dstRoiSize, int dstSize)
+{
+    table.destinationStart = table.sourceStart = table.sourceEnd = 0;
+    table.weightsOffset.push_back(0);
+    const int destinationStart = (max)(static_cast<int>(ceil(dstRoiStart - 0.5)), 0);
+    *destinationEnd = (min)(static_cast<int>(ceil(dstRoiStart + dstRoiSize - 0.5)), dstSize);
+    if (*destinationEnd <= destinationStart || srcSize <= 0 || srcRoiSize <= 0 || dstRoiSize <= 0)
+    {
+        return false;
+    }
+
+    table.destinationStart = destinationStart;
+    table.sourceStart = (numeric_limits<int>::max)();
+    table.sourceEnd = (numeric_limits<int>::min)();
+    table.firstSource.reserve(*destinationEnd - destinationStart);
+    table.weightsOffset.reserve(*destinationEnd - destinationStart + 1);
+    return true;
+}
+
+/// Add the weights for the next destination pixel to the resampling table.
+static void AddToResamplingTable(CBitmapOperations::ResamplingTable& table, int firstSource, const float* weights, int weightsCount)
+{
+    table.firstSource.push_back(firstSource);
+    table.weights.insert(table.weights.end(), weights, weights + weightsCount);
+    table.weightsOffset.push_back(static_cast<int>(table.weights.size()));
+    table.sourceStart = (min)(table.sourceStart, firstSource);
+    table.sourceEnd = (max)(table.sourceEnd, firstSource + weightsCount);
+}
+
+/*static*/CBitmapOperations::ResamplingTable CBitmapOperations::CalcAreaAverageResamplingTable(double srcRoiStart, double srcRoiSize, int srcSize, double dstRoiStart, double dstRoiSize, int dstSize)
+{
+    ResamplingTable table;
+    int destinationEnd;
+    if (!InitializeResamplingTable(table, &destinationEnd, srcRoiSize, srcSize, dstRoiStart, dstRoiSize, dstSize))
+    {
+        return table;
+    }
+
+    const double scale = srcRoiSize / dstRoiSize;
+    vector<float> weights;
+    for (int d = table.destinationStart; d < destinationEnd; ++d)
+    {
+        // this is the interval in the source which is covered by the destination pixel (clipped to the source bitmap)
+        const double start = (max)((d - dstRoiStart) * scale + srcRoiStart, 0.0);
+        const double end = (min)((d + 1 - dstRoiStart) * scale + srcRoiStart, static_cast<double>(srcSize));
+        weights.clear();
+        if (end <= start)
+        {
+            // the destination pixel is outside of the source bitmap (which can only be due to rounding errors), so use the nearest source pixel
+            const int nearest = (min)((max)(static_cast<int>(floor((d + 0.5 - dstRoiStart) * scale + srcRoiStart)), 0), srcSize - 1);
+            weights.push_back(1);
+            AddToResamplingTable(table, nearest, weights.data(), 1);
+            continue;
+        }
+
+        const int first = static_cast<int>(floor(start));
+        const int last = (min)(static_cast<int>(ceil(end)), srcSize);
+        for (int i = first; i < last; ++i)
+        {
+            const double coverage = (min)(end, static_cast<double>(i + 1)) - (max)(start, static_cast<double>(i));
+            weights.push_back(static_cast<float>(coverage / (end - start)));
+        }
+
+        AddToResamplingTable(table, first, weights.data(), static_cast<int>(weights.size()));
+    }
+
+    return table;
+}
+
+/*static*/CBitmapOperations::ResamplingTable CBitmapOperations::CalcBilinearResamplingTable(double srcRoiStart, double srcRoiSize, int srcSize, double dstRoiStart, double dstRoiSize, int dstSize)
+{
+    ResamplingTable table;
+    int destinationEnd;
+    if (!InitializeResamplingTable(table, &destinationEnd, srcRoiSize, srcSize, dstRoiStart, dstRoiSize, dstSize))
+    {
+        return table;
+    }
+
+    const double scale = srcRoiSize / dstRoiSize;
+    for (int d = table.destinationStart; d < destinationEnd; ++d)
+    {
+        // map the center of the destination pixel into the source, where the pixel centers are at "index + 0.5"
+        const double center = (min)((max)((d + 0.5 - dstRoiStart) * scale + srcRoiStart - 0.5, 0.0), static_cast<double>(srcSize - 1));
+        const int first = static_cast<int>(floor(center));
+        const float fraction = static_cast<float>(center - first);
+        if (first >= srcSize - 1 || fraction <= 0)
+        {
+            const float weight = 1;
+            AddToResamplingTable(table, first, &weight, 1);
+        }
+        else
+        {
+            const float weights[2] = { 1 - fraction, fraction };
+            AddToResamplingTable(table, first, weights, 2);
+        }
+    }
+
+    return table;
+}
+
 /*static*/void CBitmapOperations::Fill(libCZI::IBitmapData* bm, const libCZI::RgbFloatColor& floatColor)
 {
     ScopedBitmapLockerP lck{ bm };
@@ -355,7 +510,7 @@ void CBitmapOperations::Fill_Bgra32(int w, int h, void* ptr, int stride, std::ui
     }
 }
 
-/*static*/void CBitmapOperations::RGB48ToBGR48(int w, int h, std::uint16_t* ptr, int stride)
+/*static*/void CBitmapOperations::RGB48ToBGR48_C(int w, int h, std::uint16_t* ptr, int stride)
 {
     for (int y = 0; y < h; ++y)
     {
@@ -368,6 +523,13 @@ void CBitmapOperations::Fill_Bgra32(int w, int h, void* ptr, int stride, std::ui
     }
 }
 
+#if !LIBCZI_HAS_AVXINTRINSICS
+/*static*/void CBitmapOperations::RGB48ToBGR48(int w, int h, std::uint16_t* ptr, int stride)
+{
+    CBitmapOperations::RGB48ToBGR48_C(w, h, ptr, stride);
+}
+#endif
+
 /*static*/void CBitmapOperations::ThrowUnsupportedConversion(libCZI::PixelType srcPixelType, libCZI::PixelType dstPixelType)
 {
     stringstream ss;
@@ -6,6 +6,8 @@
 
 #include <memory>
 #include <algorithm>
+#include <vector>
+#include <type_traits>
 #include "libCZI_Pixels.h"
 
 namespace libCZI {
@@ -39,6 +41,60 @@ namespace libCZI {
             template <typename tFlt>
             static void NNScale2(libCZI::PixelType tSrcPixelType, libCZI::PixelType tDstPixelType, const NNResizeInfo2<tFlt>& resizeInfo);
 
+            /// Resize the specified ROI of the source bitmap into the specified ROI of the destination bitmap using area-averaging (aka "box-filter"),
+            /// i.e. every destination pixel is the average of the source pixels it covers (weighted with the covered area). This does not alias when
+            /// downscaling. Source and destination must have the same pixel type. A destination pixel is written if its center is inside the
+            /// destination ROI, so that adjacent ROIs are drawn without gaps and without overlap.
+            ///
+            /// \param [in]     bmSrc   The source bitmap.
+            /// \param [in,out] bmDest  The destination bitmap.
+            /// \param          roiSrc  The ROI in the source bitmap (in pixels).
+            /// \param          roiDst  The ROI in the destination bitmap (in pixels).
+            static void AreaAverageResize(libCZI::IBitmapData* bmSrc, libCZI::IBitmapData* bmDest, const libCZI::DblRect& roiSrc, const libCZI::DblRect& roiDst);
+
+            /// Resize the specified ROI of the source bitmap into the specified ROI of the destination bitmap using bilinear interpolation. Source and
+            /// destination must have the same pixel type. A destination pixel is written if its center is inside the destination ROI.
+            ///
+            /// \param [in]     bmSrc   The source bitmap.
+            /// \param [in,out] bmDest  The destination bitmap.
+            /// \param          roiSrc  The ROI in the source bitmap (in pixels).
+            /// \param          roiDst  The ROI in the destination bitmap (in pixels).
+            static void BilinearResize(libCZI::IBitmapData* bmSrc, libCZI::IBitmapData* bmDest, const libCZI::DblRect& roiSrc, const libCZI::DblRect& roiDst);
+
+            /// The weights for resampling in one direction (horizontally or vertically) - for each destination pixel the range of source
+            /// pixels contributing to it and their (normalized) weights.
+            struct ResamplingTable
+            {
+                int destinationStart;                   ///< The first destination pixel to be written.
+                int sourceStart;                        ///< The lowest source pixel index referenced in this table.
+                int sourceEnd;                          ///< One past the highest source pixel index referenced in this table.
+                std::vector<int> firstSource;           ///< For each destination pixel the index of the first contributing source pixel.
+                std::vector<int> weightsOffset;         ///< For each destination pixel the offset into "weights", with one additional element at the end.
+                std::vector<float> weights;             ///< The weights of the contributing source pixels (for each destination pixel they sum up to 1).
+
+                /// Gets the number of destination pixels described by this table.
+                int GetDestinationCount() const { return static_cast<int>(this->firstSource.size()); }
+            };
+
+            /// Calculates the resampling table for area-averaging in one direction.
+            ///
+            /// \param  srcRoiStart The start of the source ROI (in pixels).
+            /// \param  srcRoiSize  The size of the source ROI (in pixels).
+            /// \param  srcSize     The size of the source bitmap (in pixels).
+            /// \param  dstRoiStart The start of the destination ROI (in pixels).
+            /// \param  dstRoiSize  The size of the destination ROI (in pixels).
+            /// \param  dstSize     The size of the destination bitmap (in pixels).
+            ///
+            /// \returns    The resampling table.
+            static ResamplingTable CalcAreaAverageResamplingTable(double srcRoiStart, double srcRoiSize, int srcSize, double dstRoiStart, double dstRoiSize, int dstSize);
+
+            /// Calculates the resampling table for bilinear interpolation in one direction (c.f. CalcAreaAverageResamplingTable for the arguments).
+            static ResamplingTable CalcBilinearResamplingTable(double srcRoiStart, double srcRoiSize, int srcSize, double dstRoiStart, double dstRoiSize, int dstSize);
+
+            /// Resample the source into the destination with the specified resampling tables (which is done in two passes, first
+            /// vertically and then horizontally). Source and destination must have the same pixel type.
+            static void SeparableScale(libCZI::PixelType pixelType, const void* srcPtr, int srcStride, void* dstPtr, int dstStride, const ResamplingTable& horizontal, const ResamplingTable& vertical);
+
             /// This structure gathers the information needed to copy a source bitmap into
             /// a destination bitmap at a specified offset.
             struct CopyWithOffsetInfo
@@ -79,10 +135,14 @@ namespace libCZI {
             static void Fill_Bgra32(int w, int h, void* ptr, int stride, std::uint8_t b, std::uint8_t g, std::uint8_t r, std::uint8_t a);
             static void Fill_Bgr48(int w, int h, void* ptr, int stride, std::uint16_t b, std::uint16_t g, std::uint16_t r);
             static void Fill_GrayFloat(int w, int h, void* ptr, int stride, float v);
+            /// Swap the first and the third channel of a 48-bit-per-pixel-bitmap (i.e. convert RGB48 to BGR48 or vice versa) in place.
+            /// On x86/x64 a SIMD-implementation is chosen at runtime (AVX2 or AVX-512).
             static void RGB48ToBGR48(int w, int h, std::uint16_t* ptr, int stride);
 
             static std::shared_ptr<libCZI::IBitmapData> ConvertToBigEndian(libCZI::IBitmapData* source);
             static void CopyConvertBigEndian(libCZI::PixelType pixelType, const void* ptrSrc, int srcStride, void* ptrDst, int dstStride, std::uint32_t width, std::uint32_t height);
+        protected:
+            static void RGB48ToBGR48_C(int w, int h, std::uint16_t* ptr, int stride);
         private:
             template <libCZI::PixelType tSrcPixelType, libCZI::PixelType tDstPixelType, typename tPixelConverter, typename tFlt>
             static void InternalNNScale2(const tPixelConverter& conv, const NNResizeInfo2<tFlt>& resizeInfo);
@@ -94,6 +154,20 @@ namespace libCZI {
                 InternalNNScale2<tSrcPixelType, tDstPixelType, tPixelConverter>(conv, resizeInfo);
             }
 
+            template <libCZI::PixelType tSrcPixelType, libCZI::PixelType tDstPixelType, typename tPixelConverter>
+            static void InternalNNScaleLine(const tPixelConverter& conv, const char* pSrcLine, char* pDst, const int* srcXIndices, int count, std::false_type);
+
+            template <libCZI::PixelType tSrcPixelType, libCZI::PixelType tDstPixelType, typename tPixelConverter>
+            static void InternalNNScaleLine(const tPixelConverter& conv, const char* pSrcLine, char* pDst, const int* srcXIndices, int count, std::true_type);
+
+            template <typename tElement, int tElementsPerPixel>
+            static void NNGatherLine(const char* pSrcLine, char* pDst, const int* srcXIndices, int count);
+
+            template <typename tChannel, int tChannelCount>
+            static void InternalSeparableScale(const void* srcPtr, int srcStride, void* dstPtr, int dstStride, const ResamplingTable& horizontal, const ResamplingTable& vertical);
+
+            static void SeparableResize(libCZI::IBitmapData* bmSrc, libCZI::IBitmapData* bmDest, const ResamplingTable& horizontal, const ResamplingTable& vertical);
+
             static void ThrowUnsupportedConversion(libCZI::PixelType srcPixelType, libCZI::PixelType dstPixelType);
         };
 
@@ -9,6 +9,8 @@
 
 #include <cmath>
 #include <cstring>
+#include <limits>
+#include <type_traits>
 #if defined(_DEBUG)
 #include <assert.h>
 #endif
@@ -434,9 +436,47 @@ namespace libCZI
             const int dstYStartClipped = (std::max)(static_cast<int>(std::ceil(yMin)), dstYStart);
             const int dstYEndClipped = (std::min)(static_cast<int>(std::ceil(yMax)), dstYEnd);
 
+            if (dstXEndClipped < dstXStartClipped || dstYEndClipped < dstYStartClipped)
+            {
+                return;
+            }
+
             const auto srcWidthOverDstWidth = resizeInfo.srcRoiW / resizeInfo.dstRoiW;
             const auto srcHeightOverDstHeight = resizeInfo.srcRoiH / resizeInfo.dstRoiH;
 
+            // the source column for each destination column is the same for all lines, so we determine it only once
+            const int dstCount = dstXEndClipped - dstXStartClipped + 1;
+            std::vector<int> srcXIndices(dstCount);
+            for (int x = dstXStartClipped; x <= dstXEndClipped; ++x)
+            {
+                // now transform this pixel into the source-ROI
+                tFlt srcX = (x - resizeInfo.dstRoiX) * srcWidthOverDstWidth + resizeInfo.srcRoiX;
+                long srcXInt = lround(srcX);
+                if (srcXInt < 0)
+                {
+                    srcXInt = 0;
+                }
+                else if (srcXInt >= resizeInfo.srcWidth)
+                {
+                    srcXInt = resizeInfo.srcWidth - 1;
+                }
+
+                srcXIndices[x - dstXStartClipped] = static_cast<int>(srcXInt);
+            }
+
+            // if the source columns are consecutive (which is the case for a horizontal scale of 1), a line can be copied as a whole
+            bool srcXIndicesAreConsecutive = true;
+            for (int i = 1; i < dstCount; ++i)
+            {
+                if (srcXIndices[i] != srcXIndices[0] + i)
+                {
+                    srcXIndicesAreConsecutive = false;
+                    break;
+                }
+            }
+
+            long previousSrcYInt = -1;
+            const char* pPreviousDstLine = nullptr;
             for (int y = dstYStartClipped; y <= dstYEndClipped; ++y)
             {
                 tFlt srcY = (y - resizeInfo.dstRoiY) * srcHeightOverDstHeight + resizeInfo.srcRoiY;
@@ -450,25 +490,141 @@ namespace libCZI
                     srcYInt = resizeInfo.srcHeight - 1;
                 }
 
+                char* pDst = static_cast<char*>(resizeInfo.dstPtr) + y * static_cast<size_t>(resizeInfo.dstStride) + dstXStartClipped * static_cast<size_t>(bytesPerPelDest);
+                if (srcYInt == previousSrcYInt)
+                {
+                    // when magnifying, consecutive destination lines are taken from the same source line - so we just copy the line we already have
+                    std::memcpy(pDst, pPreviousDstLine, dstCount * static_cast<size_t>(bytesPerPelDest));
+                    continue;
+                }
+
                 const char* pSrcLine = (static_cast<const char*>(resizeInfo.srcPtr) + srcYInt * static_cast<size_t>(resizeInfo.srcStride));
-                char* pDstLine = static_cast<char*>(resizeInfo.dstPtr) + y * static_cast<size_t>(resizeInfo.dstStride);
-                for (int x = dstXStartClipped; x <= dstXEndClipped; ++x)
+                if (tSrcPixelType == tDstPixelType && srcXIndicesAreConsecutive)
                 {
-                    // now transform this pixel into the source-ROI
-                    tFlt srcX = (x - resizeInfo.dstRoiX) * srcWidthOverDstWidth + resizeInfo.srcRoiX;
-                    long srcXInt = lround(srcX);
-                    if (srcXInt < 0)
+                    std::memcpy(pDst, pSrcLine + srcXIndices[0] * static_cast<size_t>(bytesPerPelSrc), dstCount * static_cast<size_t>(bytesPerPelDest));
+                }
+                else
+                {
+                    InternalNNScaleLine<tSrcPixelType, tDstPixelType>(conv, pSrcLine, pDst, srcXIndices.data(), dstCount, std::integral_constant<bool, tSrcPixelType == tDstPixelType>());
+                }
+
+                previousSrcYInt = srcYInt;
+                pPreviousDstLine = pDst;
+            }
+        }
+
+        template <libCZI::PixelType tSrcPixelType, libCZI::PixelType tDstPixelType, typename tPixelConverter>
+        void CBitmapOperations::InternalNNScaleLine(const tPixelConverter& conv, const char* pSrcLine, char* pDst, const int* srcXIndices, int count, std::false_type)
+        {
+            constexpr uint8_t bytesPerPelSrc = CziUtils::BytesPerPel<tSrcPixelType>();
+            constexpr uint8_t bytesPerPelDest = CziUtils::BytesPerPel<tDstPixelType>();
+            for (int i = 0; i < count; ++i)
+            {
+                conv.ConvertPixel(pDst + i * static_cast<size_t>(bytesPerPelDest), pSrcLine + srcXIndices[i] * static_cast<size_t>(bytesPerPelSrc));
+            }
+        }
+
+        template <libCZI::PixelType tSrcPixelType, libCZI::PixelType tDstPixelType, typename tPixelConverter>
+        void CBitmapOperations::InternalNNScaleLine(const tPixelConverter& conv, const char* pSrcLine, char* pDst, const int* srcXIndices, int count, std::true_type)
+        {
+            // for the same pixel type, we gather the pixels with loads/stores of the element type (instead of going through the pixel
+            //  converter), which allows the compiler to use vectorized gather instructions for the 16- and 32-bit types
+            switch (tSrcPixelType)
+            {
+            case libCZI::PixelType::Gray8:
+                NNGatherLine<std::uint8_t, 1>(pSrcLine, pDst, srcXIndices, count);
+                break;
+            case libCZI::PixelType::Gray16:
+                NNGatherLine<std::uint16_t, 1>(pSrcLine, pDst, srcXIndices, count);
+                break;
+            case libCZI::PixelType::Gray32Float:
+                NNGatherLine<float, 1>(pSrcLine, pDst, srcXIndices, count);
+                break;
+            case libCZI::PixelType::Bgr24:
+                NNGatherLine<std::uint8_t, 3>(pSrcLine, pDst, srcXIndices, count);
+                break;
+            case libCZI::PixelType::Bgr48:
+                NNGatherLine<std::uint16_t, 3>(pSrcLine, pDst, srcXIndices, count);
+                break;
+            default:
+                InternalNNScaleLine<tSrcPixelType, tDstPixelType>(conv, pSrcLine, pDst, srcXIndices, count, std::false_type());
+                break;
+            }
+        }
+
+        template <typename tElement, int tElementsPerPixel>
+        void CBitmapOperations::NNGatherLine(const char* pSrcLine, char* pDst, const int* srcXIndices, int count)
+        {
+            const tElement* src = reinterpret_cast<const tElement*>(pSrcLine);
+            tElement* dst = reinterpret_cast<tElement*>(pDst);
+            for (int i = 0; i < count; ++i)
+            {
+                const tElement* pSrc = src + srcXIndices[i] * tElementsPerPixel;
+                for (int c = 0; c < tElementsPerPixel; ++c)
+                {
+                    dst[i * tElementsPerPixel + c] = pSrc[c];
+                }
+            }
+        }
+
+        template <typename tChannel, int tChannelCount>
+        void CBitmapOperations::InternalSeparableScale(const void* srcPtr, int srcStride, void* dstPtr, int dstStride, const ResamplingTable& horizontal, const ResamplingTable& vertical)
+        {
+            // the vertical pass accumulates the contributing source lines (only the range of columns which is referenced) into a line of floats,
+            //  the horizontal pass then gives the destination pixels - the loops of the vertical pass run over contiguous memory without
+            //  dependencies, so that the compiler can vectorize them
+            const int accumulatorWidth = (horizontal.sourceEnd - horizontal.sourceStart) * tChannelCount;
+            if (accumulatorWidth <= 0)
+            {
+                return;
+            }
+
+            std::vector<float> accumulator(accumulatorWidth);
+            float* const pAccumulator = accumulator.data();
+            for (int y = 0; y < vertical.GetDestinationCount(); ++y)
+            {
+                std::fill(accumulator.begin(), accumulator.end(), 0.f);
+                const int weightsStartY = vertical.weightsOffset[y];
+                const int weightsCountY = vertical.weightsOffset[y + 1] - weightsStartY;
+                for (int j = 0; j < weightsCountY; ++j)
+                {
+                    const float weight = vertical.weights[weightsStartY + j];
+                    const tChannel* pSrc = reinterpret_cast<const tChannel*>(static_cast<const char*>(srcPtr) + (vertical.firstSource[y] + j) * static_cast<size_t>(srcStride)) + horizontal.sourceStart * tChannelCount;
+                    for (int i = 0; i < accumulatorWidth; ++i)
                     {
-                        srcXInt = 0;
+                        pAccumulator[i] += weight * static_cast<float>(pSrc[i]);
                     }
-                    else if (srcXInt >= resizeInfo.srcWidth)
+                }
+
+                tChannel* pDst = reinterpret_cast<tChannel*>(static_cast<char*>(dstPtr) + (vertical.destinationStart + y) * static_cast<size_t>(dstStride)) + horizontal.destinationStart * tChannelCount;
+                for (int x = 0; x < horizontal.GetDestinationCount(); ++x)
+                {
+                    const int weightsStartX = horizontal.weightsOffset[x];
+                    const int weightsCountX = horizontal.weightsOffset[x + 1] - weightsStartX;
+                    const float* pAccumulated = pAccumulator + (horizontal.firstSource[x] - horizontal.sourceStart) * tChannelCount;
+                    float sum[tChannelCount] = {};
+                    for (int i = 0; i < weightsCountX; ++i)
                     {
-                        srcXInt = resizeInfo.srcWidth - 1;
+                        const float weight = horizontal.weights[weightsStartX + i];
+                        for (int c = 0; c < tChannelCount; ++c)
+                        {
+                            sum[c] += weight * pAccumulated[i * tChannelCount + c];
+                        }
                     }
 
-                    const char* pSrc = pSrcLine + srcXInt * static_cast<size_t>(bytesPerPelSrc);
-                    char* pDst = pDstLine + x * static_cast<size_t>(bytesPerPelDest);
-                    conv.ConvertPixel(pDst, pSrc);
+                    for (int c = 0; c < tChannelCount; ++c)
+                    {
+                        if (std::is_integral<tChannel>::value)
+                        {
+                            // the weights are normalized, so the result is within the range of the pixel type (except for rounding errors)
+                            const float value = (std::min)((std::max)(sum[c] + 0.5f, 0.f), static_cast<float>((std::numeric_limits<tChannel>::max)()));
+                            pDst[x * tChannelCount + c] = static_cast<tChannel>(value);
+                        }
+                        else
+                        {
+                            pDst[x * tChannelCount + c] = static_cast<tChannel>(sum[c]);
+                        }
+                    }
                 }
             }
         }
@@ -5,7 +5,9 @@
 #include "BitmapOperationsBitonal.h"
 
 #include <cstdint>
+#include <cstring>
 #include <algorithm>
+#include <vector>
 #include <sstream>
 #include <stdexcept>
 
@@ -450,9 +452,54 @@ namespace
         const int dstYStartClipped = (std::max)(static_cast<int>(std::ceil(yMin)), dstYStart);
         const int dstYEndClipped = (std::min)(static_cast<int>(std::ceil(yMax)), dstYEnd);
 
+        if (dstXEndClipped < dstXStartClipped || dstYEndClipped < dstYStartClipped)
+        {
+            return;
+        }
+
         const auto srcWidthOverDstWidth = resize_info.srcRoiW / resize_info.dstRoiW;
         const auto srcHeightOverDstHeight = resize_info.srcRoiH / resize_info.dstRoiH;
 
+        // for each destination column, determine the source column and the byte and the bit to test in a line of the mask once - a
+        //  source column outside of the mask is marked with a bit-mask of zero (so that the pixel is never drawn)
+        struct SourceColumn
+        {
+            int srcX;
+            int maskByte;
+            uint8_t maskBit;
+        };
+
+        std::vector<SourceColumn> source_columns(dstXEndClipped - dstXStartClipped + 1);
+        for (int x = dstXStartClipped; x <= dstXEndClipped; ++x)
+        {
+            // now transform this pixel into the source-ROI
+            tFlt srcX = (x - resize_info.dstRoiX) * srcWidthOverDstWidth + resize_info.srcRoiX;
+            long srcXInt = lround(srcX);
+            if (srcXInt < 0)
+            {
+                srcXInt = 0;
+            }
+            else if (srcXInt >= resize_info.srcWidth)
+            {
+                srcXInt = resize_info.srcWidth - 1;
+            }
+
+            SourceColumn& column = source_columns[x - dstXStartClipped];
+            column.srcX = static_cast<int>(srcXInt);
+            if (srcXInt < resize_info.maskWidth)
+            {
+                column.maskByte = static_cast<int>(srcXInt / 8);
+                column.maskBit = static_cast<uint8_t>(0x80 >> (srcXInt % 8));
+            }
+            else
+            {
+                // the mask may be narrower than the source bitmap - a bit-mask of zero marks the column as "not in the mask", and
+                //  the mask is not read at all for it (which would be beyond the end of the mask's line)
+                column.maskByte = 0;
+                column.maskBit = 0;
+            }
+        }
+
         for (int y = dstYStartClipped; y <= dstYEndClipped; ++y)
         {
             tFlt srcY = (y - resize_info.dstRoiY) * srcHeightOverDstHeight + resize_info.srcRoiY;
@@ -466,30 +513,22 @@ namespace
                 srcYInt = resize_info.srcHeight - 1;
             }
 
+            if (srcYInt >= resize_info.maskHeight)
+            {
+                continue;
+            }
+
             const char* pSrcLine = (static_cast<const char*>(resize_info.srcPtr) + srcYInt * static_cast<size_t>(resize_info.srcStride));
-            char* pDstLine = static_cast<char*>(resize_info.dstPtr) + y * static_cast<size_t>(resize_info.dstStride);
-            for (int x = dstXStartClipped; x <= dstXEndClipped; ++x)
+            const uint8_t* pMaskLine = static_cast<const uint8_t*>(resize_info.srcMaskPtr) + srcYInt * static_cast<size_t>(resize_info.srcMaskStride);
+            char* pDst = static_cast<char*>(resize_info.dstPtr) + y * static_cast<size_t>(resize_info.dstStride) + dstXStartClipped * static_cast<size_t>(bytesPerPelDest);
+            for (const SourceColumn& column : source_columns)
             {
-                // now transform this pixel into the source-ROI
-                tFlt srcX = (x - resize_info.dstRoiX) * srcWidthOverDstWidth + resize_info.srcRoiX;
-                long srcXInt = lround(srcX);
-                if (srcXInt < 0)
-                {
-                    srcXInt = 0;
-                }
-                else if (srcXInt >= resize_info.srcWidth)
+                if (column.maskBit != 0 && (pMaskLine[column.maskByte] & column.maskBit) != 0)
                 {
-                    srcXInt = resize_info.srcWidth - 1;
+                    conv.ConvertPixel(pDst, pSrcLine + column.srcX * static_cast<size_t>(bytesPerPelSrc));
                 }
 
-                if (srcXInt < resize_info.maskWidth &&
-                    srcYInt < resize_info.maskHeight &&
-                    BitmapOperationsBitonal::GetPixelFromBitonalUnchecked(srcXInt, srcYInt, resize_info.srcMaskPtr, resize_info.srcMaskStride))
-                {
-                    const char* pSrc = pSrcLine + srcXInt * static_cast<size_t>(bytesPerPelSrc);
-                    char* pDst = pDstLine + x * static_cast<size_t>(bytesPerPelDest);
-                    conv.ConvertPixel(pDst, pSrc);
-                }
+                pDst += bytesPerPelDest;
             }
         }
     }
@@ -650,6 +689,108 @@ namespace
         bool drawTileBorder;
     };
 
+    /// The blend masks for eight pixels of "tBytesPerPel" bytes each - for every value of a mask byte, all bits of the bytes of
+    /// the i-th pixel are set if the i-th bit of the mask byte is set (where the first pixel corresponds to the most significant bit).
+    template <int tBytesPerPel>
+    struct BlendMaskTable
+    {
+        uint8_t masks[256][8 * tBytesPerPel];
+
+        BlendMaskTable()
+        {
+            for (int value = 0; value < 256; ++value)
+            {
+                for (int i = 0; i < 8; ++i)
+                {
+                    memset(this->masks[value] + i * tBytesPerPel, (value & (0x80 >> i)) != 0 ? 0xff : 0, tBytesPerPel);
+                }
+            }
+        }
+
+        static const BlendMaskTable& Get()
+        {
+            static const BlendMaskTable table;
+            return table;
+        }
+    };
+
+    /// Blend eight pixels from the source into the destination with the specified blend mask (c.f. BlendMaskTable), this
+    /// is done with 64-bit operations without any branches.
+    template <int tBytesPerPel>
+    inline void BlendEightPixels(const char* src, char* dest, const uint8_t* blend_mask)
+    {
+        for (int i = 0; i < tBytesPerPel; ++i)
+        {
+            uint64_t source_bits, destination_bits, mask_bits;
+            memcpy(&source_bits, src + i * 8, 8);
+            memcpy(&destination_bits, dest + i * 8, 8);
+            memcpy(&mask_bits, blend_mask + i * 8, 8);
+            destination_bits = (source_bits & mask_bits) | (destination_bits & ~mask_bits);
+            memcpy(dest + i * 8, &destination_bits, 8);
+        }
+    }
+
+    /// Copy the pixels of a line for which the mask is set. The mask bits for the line start at the bit "mask_bit_offset" of "mask_line".
+    /// Eight pixels are processed per mask byte, where runs of mask bytes with all bits set (or all bits cleared) are copied (or skipped) as a whole.
+    template <int tBytesPerPel>
+    void CopyLineWithMask(const char* src, char* dest, int width, const uint8_t* mask_line, int mask_bit_offset)
+    {
+        const auto copy_pixel_if_set = [&](int x)->void
+        {
+            const int bit = x + mask_bit_offset;
+            if ((mask_line[bit / 8] & (0x80 >> (bit % 8))) != 0)
+            {
+                memcpy(dest + x * tBytesPerPel, src + x * tBytesPerPel, tBytesPerPel);
+            }
+        };
+
+        // pixel by pixel until we arrive at a byte boundary in the mask
+        int x = 0;
+        for (; x < width && (x + mask_bit_offset) % 8 != 0; ++x)
+        {
+            copy_pixel_if_set(x);
+        }
+
+        const BlendMaskTable<tBytesPerPel>& blend_masks = BlendMaskTable<tBytesPerPel>::Get();
+        while (x + 8 <= width)
+        {
+            const uint8_t* mask_bytes = mask_line + (x + mask_bit_offset) / 8;
+            if (x + 32 <= width)
+            {
+                uint32_t four_mask_bytes;
+                memcpy(&four_mask_bytes, mask_bytes, 4);
+                if (four_mask_bytes == 0xffffffff)
+                {
+                    memcpy(dest + x * tBytesPerPel, src + x * tBytesPerPel, 32 * tBytesPerPel);
+                    x += 32;
+                    continue;
+                }
+                else if (four_mask_bytes == 0)
+                {
+                    x += 32;
+                    continue;
+                }
+            }
+
+            const uint8_t mask_byte = *mask_bytes;
+            if (mask_byte == 0xff)
+            {
+                memcpy(dest + x * tBytesPerPel, src + x * tBytesPerPel, 8 * tBytesPerPel);
+            }
+            else if (mask_byte != 0)
+            {
+                BlendEightPixels<tBytesPerPel>(src + x * tBytesPerPel, dest + x * tBytesPerPel, blend_masks.masks[mask_byte]);
+            }
+
+            x += 8;
+        }
+
+        for (; x < width; ++x)
+        {
+            copy_pixel_if_set(x);
+        }
+    }
+
     template <libCZI::PixelType tSrcDstPixelType>
     void CopySamePixelTypeWithMask(const CopyParameters& parameters)
     {
@@ -662,16 +803,8 @@ namespace
             {
                 char* dest = static_cast<char*>(parameters.dstPtr) + y * static_cast<std::ptrdiff_t>(parameters.dstStride);
                 const char* src = static_cast<const char*>(parameters.srcPtr) + y * static_cast<std::ptrdiff_t>(parameters.srcStride);
-
-                for (int x = 0; x < parameters.width; ++x)
-                {
-                    if (BitmapOperationsBitonal::GetPixelFromBitonalUnchecked(x + parameters.maskOffsetX, y + parameters.maskOffsetY, parameters.srcMaskPtr, parameters.srcMaskStride))
-                    {
-                        char* destPixel = dest + x * bytes_per_pel;
-                        const char* srcPixel = src + x * bytes_per_pel;
-                        memcpy(destPixel, srcPixel, bytes_per_pel);
-                    }
-                }
+                const uint8_t* mask_line = static_cast<const uint8_t*>(parameters.srcMaskPtr) + (y + parameters.maskOffsetY) * static_cast<std::ptrdiff_t>(parameters.srcMaskStride);
+                CopyLineWithMask<bytes_per_pel>(src, dest, parameters.width, mask_line, parameters.maskOffsetX);
             }
         }
         else
@@ -713,10 +846,10 @@ namespace
                 {
                     conv.ConvertPixel(dest, src);
                 }
-            }
 
-            dest += CziUtils::BytesPerPel<tDstPixelType>();;
-            src += CziUtils::BytesPerPel<tSrcPixelType>();;
+                dest += CziUtils::BytesPerPel<tDstPixelType>();
+                src += CziUtils::BytesPerPel<tSrcPixelType>();
+            }
         }
     }
 
@@ -36,7 +36,8 @@ static CCZIParse::SubblockDirectoryParseOptions GetParseOptionsFromOpenOptions(c
 CCZIReader::CCZIReader() :
     isOperational(false),
     default_frame_of_reference(CZIFrameOfReference::Invalid),
-    sub_block_directory_info_policy_(ICZIReader::OpenOptions::SubBlockDirectoryInfoPolicy::SubBlockDirectoryPrecedence)
+    sub_block_directory_info_policy_(ICZIReader::OpenOptions::SubBlockDirectoryInfoPolicy::SubBlockDirectoryPrecedence),
+    instance_id_(0)
 {
 }
 
@@ -253,6 +254,11 @@ CCZIReader::CCZIReader() :
     this->stream.reset();
 }
 
+/*virtual*/std::uint64_t CCZIReader::GetRepositoryInstanceId() const
+{
+    return this->instance_id_.load();
+}
+
 /*virtual*/int CCZIReader::GetAttachmentCount() const
 {
     this->ThrowIfNotOperational();
@@ -346,12 +352,6 @@ std::shared_ptr<ISubBlock> CCZIReader::ReadSubBlock(const CCziSubBlockDirectory:
 
     auto subBlkData = CCZIParse::ReadSubBlock(stream_reference.get(), entry.FilePosition, allocateInfo);
 
-    // RAII wrapper to ensure memory cleanup in case of exceptions
-    auto dataDeleter = [freeFunc = allocateInfo.free](void* ptr) { if (ptr) { freeFunc(ptr); } };
-    std::unique_ptr<void, decltype(dataDeleter)> dataGuard(subBlkData.ptrData, dataDeleter);
-    std::unique_ptr<void, decltype(dataDeleter)> attachmentGuard(subBlkData.ptrAttachment, dataDeleter);
-    std::unique_ptr<void, decltype(dataDeleter)> metadataGuard(subBlkData.ptrMetadata, dataDeleter);
-
     // We now use configuration options to determine 
     // - whether we want to use the information from the sub-block-directory or the sub-block-header.
     // - whether we want to ignore discrepancies between the two.
@@ -395,14 +395,7 @@ std::shared_ptr<ISubBlock> CCZIReader::ReadSubBlock(const CCziSubBlockDirectory:
         info.pyramidType = CziUtils::PyramidTypeFromByte(subBlkData.spare[0]);
     }
 
-    auto sub_block = std::make_shared<CCziSubBlock>(info, subBlkData, free);
-
-    // Release the memory from the guards since CCziSubBlock has taken ownership
-    dataGuard.release();
-    attachmentGuard.release();
-    metadataGuard.release();
-
-    return sub_block;
+    return std::make_shared<CCziSubBlock>(info, subBlkData);
 }
 
 std::shared_ptr<libCZI::IAttachment> CCZIReader::ReadAttachment(const CCziAttachmentsDirectory::AttachmentEntry& entry)
@@ -463,4 +456,8 @@ void CCZIReader::ThrowIfNotOperational() const
 void CCZIReader::SetOperationalState(bool operational)
 {
     this->isOperational = operational;
+
+    // every time the reader becomes operational, it gets a new identity - so, cached results (c.f. IRenderedTileCache)
+    //  from a previously opened file are not used
+    this->instance_id_ = operational ? IRepositoryInstanceIdentity::CreateNewRepositoryInstanceId() : 0;
 }
@@ -4,10 +4,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include "libCZI.h"
+#include "rendered_tile_cache.h"
 #include "CziSubBlockDirectory.h"
 #include "CziAttachmentsDirectory.h"
 #include "FileHeaderSegmentData.h"
@@ -17,7 +19,7 @@ namespace libCZI
     namespace detail
     {
 
-        class CCZIReader : public libCZI::ICZIReader, public std::enable_shared_from_this<CCZIReader>
+        class CCZIReader : public libCZI::ICZIReader, public IRepositoryInstanceIdentity, public std::enable_shared_from_this<CCZIReader>
         {
         private:
             std::shared_ptr<libCZI::IStream> stream;
@@ -28,6 +30,7 @@ namespace libCZI
             bool    isOperational;  ///<    If true, then stream, hdrSegmentData and subBlkDir can be considered valid and operational
             libCZI::CZIFrameOfReference default_frame_of_reference;
             libCZI::ICZIReader::OpenOptions::SubBlockDirectoryInfoPolicy sub_block_directory_info_policy_;
+            std::atomic<std::uint64_t> instance_id_;   ///< The identity of the current instance (c.f. IRepositoryInstanceIdentity), 0 if not operational.
         public:
             CCZIReader();
             ~CCZIReader() override = default;
@@ -45,6 +48,9 @@ namespace libCZI
             // interface ISubBlockRepositoryEx
             void EnumerateSubBlocksEx(const std::function<bool(int index, const libCZI::DirectorySubBlockInfo& info)>& funcEnum) override;
 
+            // interface IRepositoryInstanceIdentity
+            std::uint64_t GetRepositoryInstanceId() const override;
+
             // interface ICZIReader
             void Open(const std::shared_ptr<libCZI::IStream>& stream, const ICZIReader::OpenOptions* options) override;
             libCZI::FileHeaderInfo GetFileHeaderInfo() override;
@@ -9,30 +9,72 @@
 #include "inc_libCZI_Config.h"
 #include "CziSubBlock.h"
 #include "decoder_zstd.h"
+#include "decoder.h"
+#include "decoder_jpg.h"
 
 using namespace libCZI;
 using namespace libCZI::detail;
 
 namespace
 {
+    /// Create a bitmap with the specified pixel type and size, and copy the specified bitmap into it (at the top-left corner). The
+    /// area not covered by the source bitmap is filled with zeroes. This implements the "resolution protocol" for the case that
+    /// the size of the decoded bitmap does not match the size described in the subblock.
+    std::shared_ptr<libCZI::IBitmapData> CreateBitmapCroppedOrPaddedToSize(
+            const std::shared_ptr<libCZI::IBitmapData>& decoded_bitmap,
+            libCZI::PixelType pixelType,
+            std::uint32_t width,
+            std::uint32_t height)
+    {
+        // create a bitmap of the size described in the subblock
+        auto adjusted_bitmap = CStdBitmapData::Create(pixelType, width, height);
+        CBitmapOperations::Fill(adjusted_bitmap.get(), RgbFloatColor{ 0,0,0 });
+        const ScopedBitmapLockerSP adjusted_bitmap_lock{ adjusted_bitmap };
+        const ScopedBitmapLockerSP decoded_bitmap_lock{ decoded_bitmap };
+        CBitmapOperations::CopyWithOffsetInfo copy_info;
+        copy_info.xOffset = 0;
+        copy_info.yOffset = 0;
+        copy_info.srcPixelType = decoded_bitmap->GetPixelType();
+        copy_info.srcPtr = decoded_bitmap_lock.ptrDataRoi;
+        copy_info.srcStride = decoded_bitmap_lock.stride;
+        copy_info.srcWidth = decoded_bitmap->GetWidth();
+        copy_info.srcHeight = decoded_bitmap->GetHeight();
+        copy_info.dstPixelType = pixelType;
+        copy_info.dstPtr = adjusted_bitmap_lock.ptrDataRoi;
+        copy_info.dstStride = adjusted_bitmap_lock.stride;
+        copy_info.dstWidth = adjusted_bitmap->GetWidth();
+        copy_info.dstHeight = adjusted_bitmap->GetHeight();
+        copy_info.drawTileBorder = false;
+        CBitmapOperations::CopyWithOffset(copy_info);
+        return adjusted_bitmap;
+    }
+
     std::shared_ptr<libCZI::IBitmapData> CreateBitmapFromSubBlockData_JpgXr(
             const void* pv,
             size_t size,
             libCZI::PixelType pixelType,
             std::uint32_t width,
             std::uint32_t height,
-            bool handle_jxr_bitmap_mismatch)
+            bool handle_jxr_bitmap_mismatch,
+            std::uint32_t jpgxr_max_decode_threads)
     {
         auto dec = GetSite()->GetDecoder(ImageDecoderType::JPXR_JxrLib, nullptr);
+        std::string decoder_arguments;
+        if (jpgxr_max_decode_threads > 1)
+        {
+            decoder_arguments = std::string(CJxrLibDecoder::kOption_max_decode_threads) + "=" + std::to_string(jpgxr_max_decode_threads);
+        }
+
+        const char* additional_arguments = decoder_arguments.empty() ? nullptr : decoder_arguments.c_str();
         if (!handle_jxr_bitmap_mismatch)
         {
-            return dec->Decode(pv, size, pixelType, width, height);
+            return dec->Decode(pv, size, pixelType, width, height, additional_arguments);
         }
         else
         {
             // This means - according to the "resolution protocol", if there is a mismatch between the bitmap encoded as JpgXR and the
             //  description in the subblock, we have to crop or pad the bitmap to the size described in the subblock.
-            auto decoded_bitmap = dec->Decode(pv, size, nullptr, nullptr, nullptr);
+            auto decoded_bitmap = dec->Decode(pv, size, nullptr, nullptr, nullptr, additional_arguments);
             if (decoded_bitmap->GetWidth() == width &&
                 decoded_bitmap->GetHeight() == height &&
                 decoded_bitmap->GetPixelType() == pixelType)
@@ -43,39 +85,74 @@ namespace
             {
                 // ok, we have a discrepancy between the size of the bitmap and the size described in the subblock, so let's crop or pad the bitmap
 
-                // create a bitmap of the size described in the subblock
-                auto adjusted_bitmap = CStdBitmapData::Create(pixelType, width, height);
-                CBitmapOperations::Fill(adjusted_bitmap.get(), RgbFloatColor{ 0,0,0 });
-                const ScopedBitmapLockerSP adjusted_bitmap_lock{ adjusted_bitmap };
-                const ScopedBitmapLockerSP decoded_bitmap_lock{ decoded_bitmap };
-                CBitmapOperations::CopyWithOffsetInfo copy_info;
-                copy_info.xOffset = 0;
-                copy_info.yOffset = 0;
-                copy_info.srcPixelType = decoded_bitmap->GetPixelType();
-                copy_info.srcPtr = decoded_bitmap_lock.ptrDataRoi;
-                copy_info.srcStride = decoded_bitmap_lock.stride;
-                copy_info.srcWidth = decoded_bitmap->GetWidth();
-                copy_info.srcHeight = decoded_bitmap->GetHeight();
-                copy_info.dstPixelType = pixelType;
-                copy_info.dstPtr = adjusted_bitmap_lock.ptrDataRoi;
-                copy_info.dstStride = adjusted_bitmap_lock.stride;
-                copy_info.dstWidth = adjusted_bitmap->GetWidth();
-                copy_info.dstHeight = adjusted_bitmap->GetHeight();
-                copy_info.drawTileBorder = false;
-                CBitmapOperations::CopyWithOffset(copy_info);
-                return adjusted_bitmap;
+                return CreateBitmapCroppedOrPaddedToSize(decoded_bitmap, pixelType, width, height);
             }
         }
     }
 
-    std::shared_ptr<libCZI::IBitmapData> CreateBitmapFromSubBlock_JpgXr(ISubBlock* subBlk, bool handle_jxr_bitmap_mismatch)
+    std::shared_ptr<libCZI::IBitmapData> CreateBitmapFromSubBlock_JpgXr(ISubBlock* subBlk, bool handle_jxr_bitmap_mismatch, std::uint32_t jpgxr_max_decode_threads)
     {
         const void* ptr;
         size_t size;
         subBlk->DangerousGetRawData(ISubBlock::MemBlkType::Data, ptr, size);
         const SubBlockInfo& sub_block_info = subBlk->GetSubBlockInfo();
 
-        return CreateBitmapFromSubBlockData_JpgXr(ptr, size, sub_block_info.pixelType, sub_block_info.physicalSize.w, sub_block_info.physicalSize.h, handle_jxr_bitmap_mismatch);
+        return CreateBitmapFromSubBlockData_JpgXr(ptr, size, sub_block_info.pixelType, sub_block_info.physicalSize.w, sub_block_info.physicalSize.h, handle_jxr_bitmap_mismatch, jpgxr_max_decode_threads);
+    }
+
+    std::shared_ptr<libCZI::IBitmapData> CreateBitmapFromSubBlockData_Jpg(
+            const void* pv,
+            size_t size,
+            libCZI::PixelType pixelType,
+            std::uint32_t width,
+            std::uint32_t height,
+            bool handle_jpg_bitmap_mismatch,
+            std::uint32_t jpg_downscale_denominator)
+    {
+        auto dec = GetSite()->GetDecoder(ImageDecoderType::JPG_LibJpeg, nullptr);
+        if (!dec)
+        {
+            throw std::logic_error("No decoder for JPG-compressed data is available.");
+        }
+
+        if (jpg_downscale_denominator != 1 && jpg_downscale_denominator != 2 && jpg_downscale_denominator != 4 && jpg_downscale_denominator != 8)
+        {
+            throw std::invalid_argument("The downscale denominator for JPG-compressed data must be 1, 2, 4 or 8.");
+        }
+
+        std::string decoder_arguments;
+        if (jpg_downscale_denominator > 1)
+        {
+            decoder_arguments = std::string(CJpgLibJpegDecoder::kOption_scale_denominator) + "=" + std::to_string(jpg_downscale_denominator);
+
+            // the size of the downscaled bitmap is rounded up (which is what libjpeg does)
+            width = (width + jpg_downscale_denominator - 1) / jpg_downscale_denominator;
+            height = (height + jpg_downscale_denominator - 1) / jpg_downscale_denominator;
+        }
+
+        const char* additional_arguments = decoder_arguments.empty() ? nullptr : decoder_arguments.c_str();
+        if (!handle_jpg_bitmap_mismatch)
+        {
+            return dec->Decode(pv, size, pixelType, width, height, additional_arguments);
+        }
+
+        // the decoder converts to the requested pixel type, so we only have to deal with a size mismatch here
+        auto decoded_bitmap = dec->Decode(pv, size, &pixelType, nullptr, nullptr, additional_arguments);
+        if (decoded_bitmap->GetWidth() == width && decoded_bitmap->GetHeight() == height)
+        {
+            return decoded_bitmap;
+        }
+
+        return CreateBitmapCroppedOrPaddedToSize(decoded_bitmap, pixelType, width, height);
+    }
+
+    std::shared_ptr<libCZI::IBitmapData> CreateBitmapFromSubBlock_Jpg(ISubBlock* subBlk, bool handle_jpg_bitmap_mismatch, std::uint32_t jpg_downscale_denominator)
+    {
+        const void* ptr;
+        size_t size;
+        subBlk->DangerousGetRawData(ISubBlock::MemBlkType::Data, ptr, size);
+        const SubBlockInfo& sub_block_info = subBlk->GetSubBlockInfo();
+        return CreateBitmapFromSubBlockData_Jpg(ptr, size, sub_block_info.pixelType, sub_block_info.physicalSize.w, sub_block_info.physicalSize.h, handle_jpg_bitmap_mismatch, jpg_downscale_denominator);
     }
 
     std::shared_ptr<libCZI::IBitmapData> CreateBitmapFromSubBlockData_ZStd0(
@@ -250,7 +327,15 @@ std::shared_ptr<libCZI::IBitmapData> libCZI::CreateBitmapFromSubBlock(ISubBlock*
     switch (subBlk->GetSubBlockInfo().GetCompressionMode())
     {
     case CompressionMode::JpgXr:
-        return CreateBitmapFromSubBlock_JpgXr(subBlk, options != nullptr ? options->handle_jpgxr_bitmap_mismatch : true);
+        return CreateBitmapFromSubBlock_JpgXr(
+                    subBlk,
+                    options != nullptr ? options->handle_jpgxr_bitmap_mismatch : true,
+                    options != nullptr ? options->jpgxr_max_decode_threads : 1);
+    case CompressionMode::Jpg:
+        return CreateBitmapFromSubBlock_Jpg(
+                    subBlk,
+                    options != nullptr ? options->handle_jpg_bitmap_mismatch : true,
+                    options != nullptr ? options->jpg_downscale_denominator : 1);
     case CompressionMode::Zstd0:
         return CreateBitmapFromSubBlock_ZStd0(subBlk, options != nullptr ? options->handle_zstd_data_size_mismatch : true);
     case CompressionMode::Zstd1:
@@ -279,7 +364,23 @@ std::shared_ptr<libCZI::IBitmapData> libCZI::CreateBitmapFromSubBlockData(
     switch (compression_mode)
     {
     case CompressionMode::JpgXr:
-        return CreateBitmapFromSubBlockData_JpgXr(pv, size, pixelType, width, height, options != nullptr ? options->handle_jpgxr_bitmap_mismatch : true);
+        return CreateBitmapFromSubBlockData_JpgXr(
+                    pv,
+                    size,
+                    pixelType,
+                    width,
+                    height,
+                    options != nullptr ? options->handle_jpgxr_bitmap_mismatch : true,
+                    options != nullptr ? options->jpgxr_max_decode_threads : 1);
+    case CompressionMode::Jpg:
+        return CreateBitmapFromSubBlockData_Jpg(
+                    pv,
+                    size,
+                    pixelType,
+                    width,
+                    height,
+                    options != nullptr ? options->handle_jpg_bitmap_mismatch : true,
+                    options != nullptr ? options->jpg_downscale_denominator : 1);
     case CompressionMode::Zstd0:
         return CreateBitmapFromSubBlockData_ZStd0(pv, size, pixelType, width, height, options != nullptr ? options->handle_zstd_data_size_mismatch : true);
     case CompressionMode::Zstd1:
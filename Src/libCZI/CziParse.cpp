@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <cstdint>
 #include "Site.h"
+#include "inc_libCZI_Config.h"
 
 using namespace std;
 using namespace libCZI;
@@ -369,71 +370,65 @@ using namespace libCZI::detail;
     lengthSubblockSegmentData = max(lengthSubblockSegmentData, (uint32_t)SIZE_SUBBLOCKDATA_MINIMUM);
 
     // TODO: if subBlckSegment.data.DataSize > size_t (=4GB for 32Bit) then bail out gracefully
-    auto deleter = [&](void* ptr) -> void {allocateInfo.free(ptr); };
-    std::unique_ptr<void, decltype(deleter)> pMetadataBuffer(subBlckSegment.data.MetadataSize > 0 ? allocateInfo.alloc(subBlckSegment.data.MetadataSize) : nullptr, deleter);
-    std::unique_ptr<void, decltype(deleter)> pDataBuffer(subBlckSegment.data.DataSize > 0 ? allocateInfo.alloc(static_cast<size_t>(subBlckSegment.data.DataSize)) : nullptr, deleter);
-    std::unique_ptr<void, decltype(deleter)> pAttachmentBuffer(subBlckSegment.data.AttachmentSize > 0 ? allocateInfo.alloc(subBlckSegment.data.AttachmentSize) : nullptr, deleter);
-
     // TODO: now get the information from the SubBlockDirectoryEntryDV/DE structure, and figure out their size
     // TODO: compare this information against the information from the SubBlock-directory
-    if (pMetadataBuffer)
-    {
-        try
-        {
-            str->Read(offset + lengthSubblockSegmentData + sizeof(SegmentHeader), pMetadataBuffer.get(), subBlckSegment.data.MetadataSize, &bytesRead);
-        }
-        catch (const std::exception&)
-        {
-            std::throw_with_nested(LibCZIIOException("Error reading FileHeaderSegment", offset + lengthSubblockSegmentData + sizeof(SegmentHeader), subBlckSegment.data.MetadataSize));
-        }
+    IDirectMemoryAccessStream* directMemoryAccess = dynamic_cast<IDirectMemoryAccessStream*>(str);
+    const uint64_t positionMetadata = offset + lengthSubblockSegmentData + sizeof(SegmentHeader);
+    const uint64_t positionData = positionMetadata + subBlckSegment.data.MetadataSize;
+    const uint64_t positionAttachment = positionData + subBlckSegment.data.DataSize;
+    sbd.spMetadata = CCZIParse::ReadSubBlockPart(str, directMemoryAccess, positionMetadata, subBlckSegment.data.MetadataSize, allocateInfo);
+    sbd.spData = CCZIParse::ReadSubBlockPart(str, directMemoryAccess, positionData, subBlckSegment.data.DataSize, allocateInfo);
+    sbd.spAttachment = CCZIParse::ReadSubBlockPart(str, directMemoryAccess, positionAttachment, subBlckSegment.data.AttachmentSize, allocateInfo);
 
-        if (static_cast<int32_t>(bytesRead) != subBlckSegment.data.MetadataSize)
-        {
-            CCZIParse::ThrowNotEnoughDataRead(offset + lengthSubblockSegmentData + sizeof(SegmentHeader), subBlckSegment.data.MetadataSize, bytesRead);
-        }
+    sbd.dataSize = subBlckSegment.data.DataSize;
+    sbd.attachmentSize = subBlckSegment.data.AttachmentSize;
+    sbd.metaDataSize = subBlckSegment.data.MetadataSize;
+    return sbd;
+}
+
+/*static*/std::shared_ptr<const void> CCZIParse::ReadSubBlockPart(libCZI::IStream* str, libCZI::IDirectMemoryAccessStream* directMemoryAccess, std::uint64_t offset, std::uint64_t size, const SubBlockStorageAllocate& allocateInfo)
+{
+    if (size == 0)
+    {
+        return nullptr;
     }
 
-    if (pDataBuffer)
+    if (directMemoryAccess != nullptr)
     {
-        try
-        {
-            str->Read(offset + lengthSubblockSegmentData + sizeof(SegmentHeader) + subBlckSegment.data.MetadataSize, pDataBuffer.get(), subBlckSegment.data.DataSize, &bytesRead);
-        }
-        catch (const std::exception&)
+        // if the stream gives us direct access to its memory, we can avoid the copy and just reference the stream's memory
+        auto memory = directMemoryAccess->TryGetMemory(offset, size);
+#if LIBCZI_SIGBUS_ON_UNALIGNEDINTEGERS
+        // on platforms where unaligned access is not allowed, we only use the memory if it is suitably aligned (the
+        //  decoders may access the data with 16-bit, 32-bit or 64-bit reads), otherwise we copy it into an allocated buffer
+        if (memory && (reinterpret_cast<uintptr_t>(memory.get()) & 7) != 0)
         {
-            std::throw_with_nested(LibCZIIOException("Error reading FileHeaderSegment", offset + lengthSubblockSegmentData + sizeof(SegmentHeader) + subBlckSegment.data.MetadataSize, subBlckSegment.data.DataSize));
+            memory.reset();
         }
-
-        if (static_cast<int32_t>(bytesRead) != subBlckSegment.data.DataSize)
+#endif
+        if (memory)
         {
-            CCZIParse::ThrowNotEnoughDataRead(offset + lengthSubblockSegmentData + sizeof(SegmentHeader) + subBlckSegment.data.MetadataSize, subBlckSegment.data.DataSize, bytesRead);
+            return memory;
         }
     }
 
-    if (pAttachmentBuffer)
+    void* ptrBuffer = allocateInfo.alloc(static_cast<size_t>(size));
+    std::shared_ptr<const void> buffer(ptrBuffer, allocateInfo.free);
+    std::uint64_t bytesRead;
+    try
     {
-        try
-        {
-            str->Read(offset + lengthSubblockSegmentData + sizeof(SegmentHeader) + subBlckSegment.data.MetadataSize + subBlckSegment.data.DataSize, pAttachmentBuffer.get(), subBlckSegment.data.AttachmentSize, &bytesRead);
-        }
-        catch (const std::exception&)
-        {
-            std::throw_with_nested(LibCZIIOException("Error reading FileHeaderSegment", offset + lengthSubblockSegmentData + sizeof(SegmentHeader) + subBlckSegment.data.MetadataSize + subBlckSegment.data.DataSize, subBlckSegment.data.AttachmentSize));
-        }
+        str->Read(offset, ptrBuffer, size, &bytesRead);
+    }
+    catch (const std::exception&)
+    {
+        std::throw_with_nested(LibCZIIOException("Error reading SubBlock-Segment", offset, size));
+    }
 
-        if (static_cast<int32_t>(bytesRead) != subBlckSegment.data.AttachmentSize)
-        {
-            CCZIParse::ThrowNotEnoughDataRead(offset + lengthSubblockSegmentData + sizeof(SegmentHeader) + subBlckSegment.data.MetadataSize + subBlckSegment.data.DataSize, subBlckSegment.data.AttachmentSize, bytesRead);
-        }
+    if (bytesRead != size)
+    {
+        CCZIParse::ThrowNotEnoughDataRead(offset, size, bytesRead);
     }
 
-    sbd.ptrData = pDataBuffer.release();
-    sbd.dataSize = subBlckSegment.data.DataSize;
-    sbd.ptrAttachment = pAttachmentBuffer.release();
-    sbd.attachmentSize = subBlckSegment.data.AttachmentSize;
-    sbd.ptrMetadata = pMetadataBuffer.release();
-    sbd.metaDataSize = subBlckSegment.data.MetadataSize;
-    return sbd;
+    return buffer;
 }
 
 /*static*/CCZIParse::AttachmentData CCZIParse::ReadAttachment(libCZI::IStream* str, std::uint64_t offset, const SubBlockStorageAllocate& allocateInfo)
@@ -165,13 +165,16 @@ namespace libCZI
                 std::function<void(void*)> free;
             };
 
+            /// The data of a subblock as read from the stream. The memory blocks are either allocated with the allocator
+            /// given to ReadSubBlock (and then filled with a copy of the data), or - if the stream gives direct access to its
+            /// memory (i.e. implements libCZI::IDirectMemoryAccessStream) - they are a view into the stream's memory.
             struct SubBlockData
             {
-                void* ptrData;
+                std::shared_ptr<const void> spData;
                 std::uint64_t   dataSize;
-                void* ptrAttachment;
+                std::shared_ptr<const void> spAttachment;
                 std::uint32_t   attachmentSize;
-                void* ptrMetadata;
+                std::shared_ptr<const void> spMetadata;
                 std::uint32_t   metaDataSize;
 
                 int                     compression;
@@ -206,6 +209,8 @@ namespace libCZI
             static CCZIParse::SegmentSizes ReadSegmentHeader(SegmentType type, libCZI::IStream* str, std::uint64_t pos);
             static CCZIParse::SegmentSizes ReadSegmentHeaderAny(libCZI::IStream* str, std::uint64_t pos);
         private:
+            static std::shared_ptr<const void> ReadSubBlockPart(libCZI::IStream* str, libCZI::IDirectMemoryAccessStream* directMemoryAccess, std::uint64_t offset, std::uint64_t size, const SubBlockStorageAllocate& allocateInfo);
+
             static void ParseThroughDirectoryEntries(int count, const std::function<void(int, void*)>& funcRead, const std::function<void(const SubBlockDirectoryEntryDE*, const SubBlockDirectoryEntryDV*)>& funcAddEntry);
 
             static void AddEntryToSubBlockDirectory(const SubBlockDirectoryEntryDE* subBlkDirDE, const std::function<void(const CCziSubBlockDirectoryBase::SubBlkEntry&)>& addFunc);
@@ -680,7 +680,7 @@ void CCziReaderWriter::WriteToOutputStream(std::uint64_t offset, const void* pv,
     info.physicalSize = subBlkData.physicalSize;
     info.pyramidType = CziUtils::PyramidTypeFromByte(subBlkData.spare[0]);
 
-    return std::make_shared<CCziSubBlock>(info, subBlkData, free);
+    return std::make_shared<CCziSubBlock>(info, subBlkData);
 }
 
 /*virtual*/bool CCziReaderWriter::TryGetSubBlockInfo(int index, libCZI::SubBlockInfo* info) const
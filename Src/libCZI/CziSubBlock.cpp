@@ -8,11 +8,11 @@
 using namespace libCZI;
 using namespace libCZI::detail;
 
-CCziSubBlock::CCziSubBlock(const libCZI::SubBlockInfo& info, const CCZIParse::SubBlockData& data, const std::function<void(void*)>& deleter)
+CCziSubBlock::CCziSubBlock(const libCZI::SubBlockInfo& info, const CCZIParse::SubBlockData& data)
     :
-    spData(std::shared_ptr<const void>(data.ptrData, deleter)),
-    spAttachment(std::shared_ptr<const void>(data.ptrAttachment, deleter)),
-    spMetadata(std::shared_ptr<const void>(data.ptrMetadata, deleter)),
+    spData(data.spData),
+    spAttachment(data.spAttachment),
+    spMetadata(data.spMetadata),
     dataSize(data.dataSize),
     attachmentSize(data.attachmentSize),
     metaDataSize(data.metaDataSize),
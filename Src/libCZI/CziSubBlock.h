@@ -22,7 +22,7 @@ namespace libCZI
             std::uint32_t   metaDataSize;
             libCZI::SubBlockInfo    info;
         public:
-            CCziSubBlock(const libCZI::SubBlockInfo& info, const CCZIParse::SubBlockData& data, const std::function<void(void*)>& deleter);
+            CCziSubBlock(const libCZI::SubBlockInfo& info, const CCZIParse::SubBlockData& data);
 
             // interface ISubBlock
             const libCZI::SubBlockInfo& GetSubBlockInfo() const override;
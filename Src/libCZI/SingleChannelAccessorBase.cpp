@@ -6,11 +6,31 @@
 #include "BitmapOperations.h"
 #include "libCZI_Pixels.h"
 #include "utilities.h"
+#include "rendered_tile_cache.h"
+#include "Site.h"
+#include <cstring>
+#include <sstream>
 
 using namespace std;
 using namespace libCZI;
 using namespace libCZI::detail;
 
+static void CopyBitmapOfSameSize(libCZI::IBitmapData* source, libCZI::IBitmapData* destination)
+{
+    ScopedBitmapLockerP source_locker{ source };
+    ScopedBitmapLockerP destination_locker{ destination };
+    CBitmapOperations::Copy(
+        source->GetPixelType(),
+        source_locker.ptrDataRoi,
+        static_cast<int>(source_locker.stride),
+        destination->GetPixelType(),
+        destination_locker.ptrDataRoi,
+        static_cast<int>(destination_locker.stride),
+        static_cast<int>(destination->GetWidth()),
+        static_cast<int>(destination->GetHeight()),
+        false);
+}
+
 bool CSingleChannelAccessorBase::TryGetPixelType(const libCZI::IDimCoordinate* planeCoordinate, libCZI::PixelType& pixeltype)
 {
     int c = (numeric_limits<int>::min)();
@@ -30,6 +50,73 @@ bool CSingleChannelAccessorBase::TryGetPixelType(const libCZI::IDimCoordinate* p
     }
 }
 
+std::string CSingleChannelAccessorBase::CreateRenderedTileCacheKey(
+    libCZI::AccessorType accessor_type,
+    const libCZI::IBitmapData* destination,
+    const libCZI::IntRect& roi,
+    const libCZI::IDimCoordinate* planeCoordinate,
+    const libCZI::RgbFloatColor& background_color,
+    const libCZI::IIndexSet* scene_filter,
+    const std::function<void(std::ostream&)>& append_options) const
+{
+    if (isnan(background_color.r) || isnan(background_color.g) || isnan(background_color.b) || scene_filter != nullptr)
+    {
+        return string();
+    }
+
+    const auto* instance_identity = dynamic_cast<const IRepositoryInstanceIdentity*>(this->sbBlkRepository.get());
+    const uint64_t instance_id = instance_identity != nullptr ? instance_identity->GetRepositoryInstanceId() : 0;
+    if (instance_id == 0)
+    {
+        return string();
+    }
+
+    ostringstream key;
+    key << instance_id << '|' << static_cast<int>(accessor_type) << '|' << Utils::DimCoordinateToString(planeCoordinate) << '|'
+        << roi.x << ',' << roi.y << ',' << roi.w << ',' << roi.h << '|'
+        << static_cast<int>(destination->GetPixelType()) << ',' << destination->GetWidth() << ',' << destination->GetHeight() << '|';
+    CSingleChannelAccessorBase::WriteFloatToRenderedTileCacheKey(key, background_color.r);
+    CSingleChannelAccessorBase::WriteFloatToRenderedTileCacheKey(key, background_color.g);
+    CSingleChannelAccessorBase::WriteFloatToRenderedTileCacheKey(key, background_color.b);
+    key << '|';
+    append_options(key);
+    return key.str();
+}
+
+/*static*/void CSingleChannelAccessorBase::WriteFloatToRenderedTileCacheKey(std::ostream& stream, float value)
+{
+    uint32_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "unexpected size of float");
+    memcpy(&bits, &value, sizeof(bits));
+    stream << hex << bits << dec << ',';
+}
+
+/*static*/void CSingleChannelAccessorBase::RenderUsingRenderedTileCache(libCZI::IRenderedTileCache* cache, const std::string& key, libCZI::IBitmapData* destination, const std::function<void()>& render)
+{
+    if (cache == nullptr || key.empty())
+    {
+        render();
+        return;
+    }
+
+    const auto cached_bitmap = cache->Get(key);
+    if (cached_bitmap &&
+        cached_bitmap->GetPixelType() == destination->GetPixelType() &&
+        cached_bitmap->GetWidth() == destination->GetWidth() &&
+        cached_bitmap->GetHeight() == destination->GetHeight())
+    {
+        CopyBitmapOfSameSize(cached_bitmap.get(), destination);
+        return;
+    }
+
+    render();
+
+    // the destination bitmap is owned by the caller, so we have to add a copy of it to the cache
+    auto copy_of_result = GetSite()->CreateBitmap(destination->GetPixelType(), destination->GetWidth(), destination->GetHeight());
+    CopyBitmapOfSameSize(destination, copy_of_result.get());
+    cache->Add(key, copy_of_result);
+}
+
 void CSingleChannelAccessorBase::CheckPlaneCoordinates(const libCZI::IDimCoordinate* planeCoordinate) const
 {
     // planeCoordinate must not contain S
@@ -122,16 +209,18 @@ std::vector<int> CSingleChannelAccessorBase::CheckForVisibility(const libCZI::In
     for (int i = count - 1; i >= 0; --i) // we start at the end, because that is the subblock which is rendered last (and thus is on top)
     {
         const int subblock_index = get_subblock_index(i);
-        coverage_calculator.AddRectangle(get_rect_of_subblock(subblock_index));
-        const int64_t new_covered_pixel_count = coverage_calculator.CalcAreaOfIntersectionWithRectangle(roi);
-        if (new_covered_pixel_count > covered_pixel_count)  // if the covered pixel count has increased, it means that this subblock covers some new pixels,
-        {                                                   //  some pixels which were not overdrawn by all the previous ones
+
+        // we only add the part of the subblock within the ROI, so that the newly covered area (which is reported by AddRectangle) is the
+        //  number of pixels in the ROI which are covered by this subblock and were not covered by the previous ones
+        const int64_t newly_covered_pixel_count = coverage_calculator.AddRectangle(get_rect_of_subblock(subblock_index).Intersect(roi));
+        if (newly_covered_pixel_count > 0)  // if the covered pixel count has increased, it means that this subblock covers some new pixels,
+        {                                   //  some pixels which were not overdrawn by all the previous ones
             // this means - when drawing this subblock, some new pixels will be covered which were not covered before,
             //  so we need to draw this subblock, therefore we add it to our result vector
             result.push_back(i);
 
-            covered_pixel_count = new_covered_pixel_count;
-            if (new_covered_pixel_count == total_pixel_count)
+            covered_pixel_count += newly_covered_pixel_count;
+            if (covered_pixel_count == total_pixel_count)
             {
                 // if the whole ROI is covered now, then we are done
                 break;
@@ -149,7 +238,10 @@ std::vector<int> CSingleChannelAccessorBase::CheckForVisibility(const libCZI::In
     const std::shared_ptr<libCZI::ISubBlockCacheOperation>& cache,
     int sub_block_index,
     bool only_add_compressed_sub_blocks_to_cache,
-    bool mask_aware_mode)
+    bool do_not_admit_to_cache,
+    bool mask_aware_mode,
+    std::uint32_t jpg_downscale_denominator,
+    bool do_not_admit_bitmap_to_cache)
 {
     SubBlockData result;
 
@@ -157,14 +249,46 @@ std::vector<int> CSingleChannelAccessorBase::CheckForVisibility(const libCZI::In
     if (!cache)
     {
         const auto subblock = sub_block_repository->ReadSubBlock(sub_block_index);
-        result.bitmap = subblock->CreateBitmap();
+        result.bitmap = CSingleChannelAccessorBase::CreateBitmapFromSubBlock(subblock.get(), jpg_downscale_denominator);
         result.subBlockInfo = subblock->GetSubBlockInfo();
         result.mask = mask_aware_mode ? CSingleChannelAccessorBase::TryToGetMaskBitmapFromSubBlock(subblock) : nullptr;
     }
     else
     {
-        const auto bitmap_from_cache = cache->Get(sub_block_index);
-        if (bitmap_from_cache.IsValid())
+        // Concurrent requests for the same subblock are coalesced by the cache (if it supports this), so that
+        //  the subblock is read and decoded only once. If the load-function is not called by us, then the subblock-info
+        //  has to be retrieved from the repository.
+        bool loaded_by_this_call = false;
+        const auto cache_item = cache->GetOrLoad(
+            sub_block_index,
+            [&](bool& add_to_cache)->ISubBlockCacheOperation::CacheItem
+            {
+                loaded_by_this_call = true;
+
+                // if the sub-block is in the compressed tier of the cache, then we only have to decode it
+                auto subblock = cache->GetCompressedSubBlock(sub_block_index);
+                if (!subblock)
+                {
+                    subblock = sub_block_repository->ReadSubBlock(sub_block_index);
+                    if (!do_not_admit_to_cache && subblock->GetSubBlockInfo().GetCompressionMode() != CompressionMode::UnCompressed)
+                    {
+                        cache->AddCompressedSubBlock(sub_block_index, subblock);
+                    }
+                }
+
+                result.subBlockInfo = subblock->GetSubBlockInfo();
+                ISubBlockCacheOperation::CacheItem item;
+                item.bitmap = CSingleChannelAccessorBase::CreateBitmapFromSubBlock(subblock.get(), jpg_downscale_denominator);
+                item.mask = mask_aware_mode ? CSingleChannelAccessorBase::TryToGetMaskBitmapFromSubBlock(subblock) : nullptr;
+
+                // a bitmap decoded at reduced resolution must not go into the cache (where full-resolution bitmaps are expected)
+                const bool is_reduced_resolution = jpg_downscale_denominator > 1 && result.subBlockInfo.GetCompressionMode() == CompressionMode::Jpg;
+                add_to_cache = !do_not_admit_to_cache && !do_not_admit_bitmap_to_cache && !is_reduced_resolution &&
+                    (!only_add_compressed_sub_blocks_to_cache || result.subBlockInfo.GetCompressionMode() != CompressionMode::UnCompressed);
+                return item;
+            });
+
+        if (!loaded_by_this_call)
         {
             const bool b = sub_block_repository->TryGetSubBlockInfo(sub_block_index, &result.subBlockInfo);
             if (!b)
@@ -173,26 +297,27 @@ std::vector<int> CSingleChannelAccessorBase::CheckForVisibility(const libCZI::In
                 ss << "SubBlockInfo not found in repository for subblock index " << sub_block_index << ".";
                 throw logic_error(ss.str());
             }
-
-            result.bitmap = bitmap_from_cache.bitmap;
-            result.mask = bitmap_from_cache.mask;
-        }
-        else
-        {
-            const auto subblock = sub_block_repository->ReadSubBlock(sub_block_index);
-            result.bitmap = subblock->CreateBitmap();
-            result.mask = mask_aware_mode ? CSingleChannelAccessorBase::TryToGetMaskBitmapFromSubBlock(subblock) : nullptr;
-            result.subBlockInfo = subblock->GetSubBlockInfo();
-            if (!only_add_compressed_sub_blocks_to_cache || result.subBlockInfo.GetCompressionMode() != CompressionMode::UnCompressed)
-            {
-                cache->Add(sub_block_index, { result.bitmap, result.mask });
-            }
         }
+
+        result.bitmap = cache_item.bitmap;
+        result.mask = cache_item.mask;
     }
 
     return result;
 }
 
+/*static*/std::shared_ptr<libCZI::IBitmapData> CSingleChannelAccessorBase::CreateBitmapFromSubBlock(libCZI::ISubBlock* sub_block, std::uint32_t jpg_downscale_denominator)
+{
+    if (jpg_downscale_denominator > 1 && sub_block->GetSubBlockInfo().GetCompressionMode() == CompressionMode::Jpg)
+    {
+        CreateBitmapOptions options;
+        options.jpg_downscale_denominator = jpg_downscale_denominator;
+        return sub_block->CreateBitmap(&options);
+    }
+
+    return sub_block->CreateBitmap();
+}
+
 /*static*/std::shared_ptr<libCZI::IBitonalBitmapData> CSingleChannelAccessorBase::TryToGetMaskBitmapFromSubBlock(const std::shared_ptr<libCZI::ISubBlock>& sub_block)
 {
     auto sub_block_metadata = CreateSubBlockMetadataFromSubBlock(sub_block.get());
@@ -210,3 +335,133 @@ std::vector<int> CSingleChannelAccessorBase::CheckForVisibility(const libCZI::In
 
     return {};
 }
+
+CSingleChannelAccessorBase::SubBlockDataLoader::SubBlockDataLoader(int count, std::uint32_t thread_count, std::function<SubBlockData(int)> load)
+    : count_(count), load_(std::move(load))
+{
+    // there is no point in having more worker threads than subblocks
+    const int number_of_threads = static_cast<int>((min)(thread_count, static_cast<uint32_t>((max)(count, 0))));
+    if (number_of_threads > 1)
+    {
+        this->slots_.resize(count);
+
+        // the worker threads are allowed to run ahead of the consumer by this number of subblocks - this limits the amount of
+        //  decoded bitmaps we are holding in memory at the same time
+        this->max_look_ahead_ = 2 * number_of_threads;
+        this->threads_.reserve(number_of_threads);
+        try
+        {
+            for (int i = 0; i < number_of_threads; ++i)
+            {
+                this->threads_.emplace_back(&SubBlockDataLoader::WorkerThread, this);
+            }
+        }
+        catch (...)
+        {
+            this->Shutdown();
+            throw;
+        }
+    }
+}
+
+CSingleChannelAccessorBase::SubBlockDataLoader::~SubBlockDataLoader()
+{
+    this->Shutdown();
+}
+
+CSingleChannelAccessorBase::SubBlockData CSingleChannelAccessorBase::SubBlockDataLoader::Get(int index)
+{
+    if (index < 0 || index >= this->count_)
+    {
+        throw invalid_argument("index out of range");
+    }
+
+    if (this->threads_.empty())
+    {
+        return this->load_(index);
+    }
+
+    unique_lock<mutex> lock(this->mutex_);
+    if (index != this->next_to_consume_)
+    {
+        throw logic_error("subblocks must be retrieved in sequential order");
+    }
+
+    this->slot_ready_.wait(lock, [this, index]()->bool { return this->slots_[index].ready; });
+    Slot& slot = this->slots_[index];
+    SubBlockData data = std::move(slot.data);
+    const exception_ptr exception = slot.exception;
+    slot = Slot();
+    ++this->next_to_consume_;
+    lock.unlock();
+    this->window_advanced_.notify_all();
+
+    if (exception)
+    {
+        rethrow_exception(exception);
+    }
+
+    return data;
+}
+
+void CSingleChannelAccessorBase::SubBlockDataLoader::WorkerThread()
+{
+    for (;;)
+    {
+        int index;
+        {
+            unique_lock<mutex> lock(this->mutex_);
+            this->window_advanced_.wait(
+                lock,
+                [this]()->bool
+                {
+                    return this->abort_ ||
+                        this->next_to_load_ >= this->count_ ||
+                        this->next_to_load_ < this->next_to_consume_ + this->max_look_ahead_;
+                });
+            if (this->abort_ || this->next_to_load_ >= this->count_)
+            {
+                return;
+            }
+
+            index = this->next_to_load_++;
+        }
+
+        SubBlockData data;
+        exception_ptr exception;
+        try
+        {
+            data = this->load_(index);
+        }
+        catch (...)
+        {
+            exception = current_exception();
+        }
+
+        {
+            lock_guard<mutex> lock(this->mutex_);
+            Slot& slot = this->slots_[index];
+            slot.data = std::move(data);
+            slot.exception = exception;
+            slot.ready = true;
+        }
+
+        this->slot_ready_.notify_all();
+    }
+}
+
+void CSingleChannelAccessorBase::SubBlockDataLoader::Shutdown()
+{
+    {
+        lock_guard<mutex> lock(this->mutex_);
+        this->abort_ = true;
+    }
+
+    this->window_advanced_.notify_all();
+    for (auto& thread : this->threads_)
+    {
+        thread.join();
+    }
+
+    this->threads_.clear();
+}
@@ -5,6 +5,14 @@
 #pragma once
 
 #include <memory>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <string>
+#include <ostream>
 #include "libCZI.h"
 
 namespace libCZI
@@ -28,6 +36,48 @@ namespace libCZI
 
             void CheckPlaneCoordinates(const libCZI::IDimCoordinate* planeCoordinate) const;
 
+            /// Creates the key for the result of an accessor-operation in the rendered-tile cache (c.f. IRenderedTileCache). The key
+            /// identifies the reader instance, the accessor type, the plane, the ROI, the destination bitmap (its pixeltype and its size)
+            /// and the background color. The accessor-specific options (which affect the result) are appended by the functor
+            /// 'append_options'. If the result cannot be cached, then an empty string is returned - this is the case if the
+            /// repository does not provide an instance identity, if no background color is given (in which case the result depends
+            /// on the previous content of the destination bitmap) or if a scene-filter is given.
+            ///
+            /// \param  accessor_type       The type of the accessor.
+            /// \param  destination         The destination bitmap.
+            /// \param  roi                 The ROI (in the raw-sub-block-coordinate-system).
+            /// \param  planeCoordinate     The plane coordinate.
+            /// \param  background_color    The background color.
+            /// \param  scene_filter        The scene filter (may be nullptr).
+            /// \param  append_options      Functor which writes the accessor-specific options to the stream.
+            ///
+            /// \returns    The key, or an empty string if the result cannot be cached.
+            std::string CreateRenderedTileCacheKey(
+                libCZI::AccessorType accessor_type,
+                const libCZI::IBitmapData* destination,
+                const libCZI::IntRect& roi,
+                const libCZI::IDimCoordinate* planeCoordinate,
+                const libCZI::RgbFloatColor& background_color,
+                const libCZI::IIndexSet* scene_filter,
+                const std::function<void(std::ostream&)>& append_options) const;
+
+            /// Writes the bit-pattern of the specified float to the stream (for use with a rendered-tile cache key), so that
+            /// only bit-identical values give the same key.
+            ///
+            /// \param  stream  The stream to write to.
+            /// \param  value   The value.
+            static void WriteFloatToRenderedTileCacheKey(std::ostream& stream, float value);
+
+            /// Renders into the destination bitmap, making use of the rendered-tile cache. If the key is found in the cache, then the
+            /// cached result is copied into the destination bitmap. Otherwise, the functor 'render' is called, and a copy of the result is
+            /// added to the cache. If no cache is given or if the key is empty, then 'render' is called and the cache is not used.
+            ///
+            /// \param  cache           The rendered-tile cache (may be nullptr).
+            /// \param  key             The key (c.f. CreateRenderedTileCacheKey).
+            /// \param  destination     The destination bitmap.
+            /// \param  render          Functor which renders the result into the destination bitmap.
+            static void RenderUsingRenderedTileCache(libCZI::IRenderedTileCache* cache, const std::string& key, libCZI::IBitmapData* destination, const std::function<void()>& render);
+
             /// This method is used to do a visibility test of a list of subblocks. The mode of operation is as follows:
             /// - The method is given a ROI, and the number of subblocks to check.  
             /// - The functor 'get_subblock_index' is called with the argument being a counter, starting with count-1 and counting down to zero.  
@@ -109,9 +159,18 @@ namespace libCZI
             ///                                                 are added to the cache. Uncompressed subblocks are not cached
             ///                                                 to avoid unnecessary memory usage for data that doesn't benefit
             ///                                                 significantly from caching.
+            /// \param  do_not_admit_to_cache           When true, the cache is only used for lookups, i.e. subblocks which are
+            ///                                         not in the cache are not added to it.
             /// \param  mask_aware_mode                 When true, attempts to extract and include mask information
             ///                                         from the subblock's attachment data. When false, the mask
             ///                                         field in the returned data will be nullptr.
+            /// \param  jpg_downscale_denominator       If greater than 1 and the subblock is JPG-compressed, then the bitmap is
+            ///                                         decoded at a reduced resolution (the size divided by this number, which
+            ///                                         must be 2, 4 or 8). Such a bitmap is not added to the cache. If the cache
+            ///                                         already contains the full-resolution bitmap, then this one is returned.
+            /// \param  do_not_admit_bitmap_to_cache    When true, the decoded bitmap is not added to the cache - other than with
+            ///                                         "do_not_admit_to_cache", the compressed sub-block is still added to the
+            ///                                         compressed tier (so that decoding it again does not require to read it).
             ///
             /// \returns                                A SubBlockData structure containing:
             ///                                         - bitmap: The decoded pixel data as IBitmapData
@@ -131,9 +190,68 @@ namespace libCZI
                 const std::shared_ptr<libCZI::ISubBlockCacheOperation>& cache,
                 int sub_block_index,
                 bool only_add_compressed_sub_blocks_to_cache,
-                bool mask_aware_mode);
+                bool do_not_admit_to_cache,
+                bool mask_aware_mode,
+                std::uint32_t jpg_downscale_denominator = 1,
+                bool do_not_admit_bitmap_to_cache = false);
+
+            static std::shared_ptr<libCZI::IBitmapData> CreateBitmapFromSubBlock(libCZI::ISubBlock* sub_block, std::uint32_t jpg_downscale_denominator);
 
             static std::shared_ptr<libCZI::IBitonalBitmapData> TryToGetMaskBitmapFromSubBlock(const std::shared_ptr<libCZI::ISubBlock>& sub_block);
+
+            /// This class is used to retrieve the data (i.e. the decoded bitmap, the mask and the subblock-info) for a sequence of
+            /// subblocks, which are then to be drawn in exactly this order. The data for the subblock with number 'i' is retrieved by
+            /// calling the functor 'load' with argument 'i'.  
+            /// If operating with more than one thread, then worker threads are started which call the 'load'-functor concurrently (in 
+            /// ascending order of the argument), while the calling thread can retrieve the results (in ascending order) with the
+            /// 'Get'-method as soon as they are available. In order to limit the memory usage, the worker threads only run ahead
+            /// of the consumer by a bounded number of subblocks.  
+            /// If operating with zero or one thread, then the 'load'-functor is called synchronously from within the 'Get'-method.
+            class SubBlockDataLoader
+            {
+            private:
+                struct Slot
+                {
+                    bool ready{ false };
+                    SubBlockData data;
+                    std::exception_ptr exception;
+                };
+
+                int count_;
+                std::function<SubBlockData(int)> load_;
+                std::vector<Slot> slots_;
+                std::vector<std::thread> threads_;
+                std::mutex mutex_;
+                std::condition_variable slot_ready_;
+                std::condition_variable window_advanced_;
+                int next_to_load_{ 0 };
+                int next_to_consume_{ 0 };
+                int max_look_ahead_{ 0 };
+                bool abort_{ false };
+            public:
+                /// Constructor.
+                ///
+                /// \param  count           The number of subblocks in the sequence.
+                /// \param  thread_count    The number of worker threads to use. If this is 0 or 1, the loading happens synchronously.
+                /// \param  load            The functor which loads the data for the subblock with the specified number (in the range 0 to count-1).
+                SubBlockDataLoader(int count, std::uint32_t thread_count, std::function<SubBlockData(int)> load);
+                ~SubBlockDataLoader();
+
+                /// Gets the data for the subblock with the specified number. This method must be called with the arguments
+                /// 0, 1, 2, ..., count-1 (in this order), and each argument must only be used once. If the 'load'-functor
+                /// threw an exception for this subblock, then this exception is re-thrown here.
+                ///
+                /// \param  index   The number of the subblock in the sequence.
+                ///
+                /// \returns    The data for the specified subblock.
+                SubBlockData Get(int index);
+
+                SubBlockDataLoader(const SubBlockDataLoader&) = delete;
+                SubBlockDataLoader& operator=(const SubBlockDataLoader&) = delete;
+            private:
+                void WorkerThread();
+                void Shutdown();
+            };
         };
 
     } // namespace detail
@@ -0,0 +1,249 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "SingleChannelProjectionAccessor.h"
+#include "Site.h"
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace libCZI;
+using namespace libCZI::detail;
+using namespace std;
+
+namespace
+{
+    /// The type used for accumulating the sum (and the mean) - for integer pixel types, we accumulate exactly with 64-bit integers
+    /// (so that there is no overflow for any plane count which can be specified), and for floating point pixel types we accumulate
+    /// with double precision.
+    template<typename tElement> struct SumType { typedef std::uint64_t type; };
+    template<> struct SumType<float> { typedef double type; };
+
+    // The following line-kernels are written as simple loops without dependencies between the iterations, so that the compiler
+    // is able to vectorize them.
+
+    template<typename tElement>
+    void MaximumLine(const tElement* source, tElement* destination, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            destination[i] = (max)(destination[i], source[i]);
+        }
+    }
+
+    template<typename tElement>
+    void MinimumLine(const tElement* source, tElement* destination, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            destination[i] = (min)(destination[i], source[i]);
+        }
+    }
+
+    template<typename tElement>
+    void AddLine(const tElement* source, typename SumType<tElement>::type* sum, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            sum[i] += source[i];
+        }
+    }
+
+    template<typename tElement>
+    void StoreSumLine(const std::uint64_t* sum, tElement* destination, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            destination[i] = static_cast<tElement>((min)(sum[i], static_cast<std::uint64_t>((numeric_limits<tElement>::max)())));
+        }
+    }
+
+    void StoreSumLine(const double* sum, float* destination, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            destination[i] = static_cast<float>(sum[i]);
+        }
+    }
+
+    template<typename tElement>
+    void StoreMeanLine(const std::uint64_t* sum, tElement* destination, size_t count, std::uint32_t planeCount)
+    {
+        // the mean is rounded to the nearest integer (and since it cannot exceed the maximum of the sum's operands, no clamping is necessary)
+        const std::uint64_t half_plane_count = planeCount / 2;
+        for (size_t i = 0; i < count; ++i)
+        {
+            destination[i] = static_cast<tElement>((sum[i] + half_plane_count) / planeCount);
+        }
+    }
+
+    void StoreMeanLine(const double* sum, float* destination, size_t count, std::uint32_t planeCount)
+    {
+        const double plane_count = static_cast<double>(planeCount);
+        for (size_t i = 0; i < count; ++i)
+        {
+            destination[i] = static_cast<float>(sum[i] / plane_count);
+        }
+    }
+
+    template<typename tElement>
+    tElement* GetLine(ScopedBitmapLockerP& locker, std::uint32_t y)
+    {
+        return reinterpret_cast<tElement*>(static_cast<std::uint8_t*>(locker.ptrDataRoi) + static_cast<size_t>(y) * locker.stride);
+    }
+
+    /// Creates the projection of the planes 0 to planeCount-1 (as given by the functor 'renderPlane') in the destination bitmap.
+    ///
+    /// \tparam tElement           The type of the elements (i.e. of a channel of a pixel) of the destination bitmap.
+    /// \param  pDest              The destination bitmap.
+    /// \param  elementsPerPixel   The number of elements (channels) of a pixel.
+    /// \param  planeCount         The number of planes.
+    /// \param  operation          The reduction operation.
+    /// \param  renderPlane        Functor which composes the specified plane into the specified bitmap.
+    template<typename tElement>
+    void Project(IBitmapData* pDest, int elementsPerPixel, int planeCount, ProjectionOperation operation, const std::function<void(int, IBitmapData*)>& renderPlane)
+    {
+        const IntSize size = pDest->GetSize();
+        const size_t elements_per_line = static_cast<size_t>(size.w) * elementsPerPixel;
+
+        if (operation == ProjectionOperation::Maximum || operation == ProjectionOperation::Minimum)
+        {
+            // the destination bitmap is the accumulator here, so the first plane is composed directly into it
+            renderPlane(0, pDest);
+            if (planeCount > 1)
+            {
+                const auto plane = GetSite()->CreateBitmap(pDest->GetPixelType(), size.w, size.h);
+                for (int i = 1; i < planeCount; ++i)
+                {
+                    renderPlane(i, plane.get());
+                    ScopedBitmapLockerP lck_plane{ plane.get() };
+                    ScopedBitmapLockerP lck_dest{ pDest };
+                    for (uint32_t y = 0; y < size.h; ++y)
+                    {
+                        if (operation == ProjectionOperation::Maximum)
+                        {
+                            MaximumLine(GetLine<tElement>(lck_plane, y), GetLine<tElement>(lck_dest, y), elements_per_line);
+                        }
+                        else
+                        {
+                            MinimumLine(GetLine<tElement>(lck_plane, y), GetLine<tElement>(lck_dest, y), elements_per_line);
+                        }
+                    }
+                }
+            }
+
+            return;
+        }
+
+        // for sum and mean, the planes are composed into the destination bitmap (one after the other) and added to the sum
+        vector<typename SumType<tElement>::type> sum(elements_per_line * size.h);
+        for (int i = 0; i < planeCount; ++i)
+        {
+            renderPlane(i, pDest);
+            ScopedBitmapLockerP lck_dest{ pDest };
+            for (uint32_t y = 0; y < size.h; ++y)
+            {
+                AddLine(GetLine<tElement>(lck_dest, y), sum.data() + y * elements_per_line, elements_per_line);
+            }
+        }
+
+        ScopedBitmapLockerP lck_dest{ pDest };
+        for (uint32_t y = 0; y < size.h; ++y)
+        {
+            if (operation == ProjectionOperation::Sum)
+            {
+                StoreSumLine(sum.data() + y * elements_per_line, GetLine<tElement>(lck_dest, y), elements_per_line);
+            }
+            else
+            {
+                StoreMeanLine(sum.data() + y * elements_per_line, GetLine<tElement>(lck_dest, y), elements_per_line, static_cast<uint32_t>(planeCount));
+            }
+        }
+    }
+}
+
+CSingleChannelProjectionAccessor::CSingleChannelProjectionAccessor(const std::shared_ptr<libCZI::ISubBlockRepository>& sbBlkRepository)
+    : CSingleChannelAccessorBase(sbBlkRepository), tileAccessor(sbBlkRepository)
+{
+}
+
+/*virtual*/std::shared_ptr<libCZI::IBitmapData> CSingleChannelProjectionAccessor::Get(libCZI::PixelType pixeltype, const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, libCZI::ProjectionOperation operation, const Options* pOptions)
+{
+    const IntRect roi_raw_sub_block_cs = this->sbBlkRepository->TransformRectangle(roi, CZIFrameOfReference::RawSubBlockCoordinateSystem).rectangle;
+    auto bmDest = GetSite()->CreateBitmap(pixeltype, roi_raw_sub_block_cs.w, roi_raw_sub_block_cs.h);
+    this->Get(bmDest.get(), IntPointAndFrameOfReference{ CZIFrameOfReference::RawSubBlockCoordinateSystem, { roi_raw_sub_block_cs.x, roi_raw_sub_block_cs.y } }, planeCoordinate, range, operation, pOptions);
+    return bmDest;
+}
+
+/*virtual*/void CSingleChannelProjectionAccessor::Get(libCZI::IBitmapData* pDest, const libCZI::IntPointAndFrameOfReference& position, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, libCZI::ProjectionOperation operation, const Options* pOptions)
+{
+    const IntPoint point_raw_sub_block_cs = this->sbBlkRepository->TransformPoint(position, CZIFrameOfReference::RawSubBlockCoordinateSystem).point;
+    if (pOptions == nullptr)
+    {
+        Options options; options.Clear();
+        this->InternalGet(point_raw_sub_block_cs.x, point_raw_sub_block_cs.y, pDest, planeCoordinate, range, operation, options);
+    }
+    else
+    {
+        this->InternalGet(point_raw_sub_block_cs.x, point_raw_sub_block_cs.y, pDest, planeCoordinate, range, operation, *pOptions);
+    }
+}
+
+void CSingleChannelProjectionAccessor::InternalGet(int xPos, int yPos, libCZI::IBitmapData* pDest, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, libCZI::ProjectionOperation operation, const Options& options)
+{
+    if (range.count <= 0)
+    {
+        throw invalid_argument("The range must contain at least one plane.");
+    }
+
+    ISingleChannelTileAccessor::Options tile_accessor_options;
+    tile_accessor_options.Clear();
+    tile_accessor_options.backGroundColor = options.backGroundColor;
+    if (isnan(options.backGroundColor.r) || isnan(options.backGroundColor.g) || isnan(options.backGroundColor.b))
+    {
+        // the planes are composed into the same bitmap one after the other, so it must be cleared for every plane
+        tile_accessor_options.backGroundColor = RgbFloatColor{ 0, 0, 0 };
+    }
+
+    tile_accessor_options.sortByM = options.sortByM;
+    tile_accessor_options.useVisibilityCheckOptimization = options.useVisibilityCheckOptimization;
+    tile_accessor_options.subBlockCache = options.subBlockCache;
+    tile_accessor_options.onlyUseSubBlockCacheForCompressedData = options.onlyUseSubBlockCacheForCompressedData;
+    tile_accessor_options.doNotAdmitToSubBlockCache = options.doNotAdmitToSubBlockCache;
+    tile_accessor_options.maskAware = options.maskAware;
+    tile_accessor_options.decodeThreadCount = options.decodeThreadCount;
+    tile_accessor_options.composeThreadCount = options.composeThreadCount;
+
+    CDimCoordinate plane = planeCoordinate != nullptr ? CDimCoordinate(planeCoordinate) : CDimCoordinate();
+    const IntPointAndFrameOfReference position{ CZIFrameOfReference::RawSubBlockCoordinateSystem, { xPos, yPos } };
+    const auto render_plane = [&](int index, IBitmapData* bitmap)->void
+    {
+        plane.Set(range.dimension, range.start + index);
+        this->tileAccessor.Get(bitmap, position, &plane, &tile_accessor_options);
+    };
+
+    switch (pDest->GetPixelType())
+    {
+    case PixelType::Gray8:
+        Project<uint8_t>(pDest, 1, range.count, operation, render_plane);
+        break;
+    case PixelType::Gray16:
+        Project<uint16_t>(pDest, 1, range.count, operation, render_plane);
+        break;
+    case PixelType::Gray32Float:
+        Project<float>(pDest, 1, range.count, operation, render_plane);
+        break;
+    case PixelType::Bgr24:
+        Project<uint8_t>(pDest, 3, range.count, operation, render_plane);
+        break;
+    case PixelType::Bgr48:
+        Project<uint16_t>(pDest, 3, range.count, operation, render_plane);
+        break;
+    default:
+        throw invalid_argument("The pixeltype is not supported by the projection accessor.");
+    }
+}
@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include <memory>
+#include "libCZI.h"
+#include "SingleChannelAccessorBase.h"
+#include "SingleChannelTileAccessor.h"
+
+namespace libCZI
+{
+    namespace detail
+    {
+        /// Implementation of the single-channel-projection accessor. The planes of the range are composed one after the other with
+        /// a single-channel-tile accessor, and every plane is combined with a running accumulator (which is the destination bitmap
+        /// itself for maximum and minimum, and a buffer of sums for sum and mean).
+        class CSingleChannelProjectionAccessor : public CSingleChannelAccessorBase, public libCZI::ISingleChannelProjectionAccessor
+        {
+        private:
+            CSingleChannelTileAccessor tileAccessor;
+        public:
+            explicit CSingleChannelProjectionAccessor(const std::shared_ptr<libCZI::ISubBlockRepository>& sbBlkRepository);
+
+        public: // interface ISingleChannelProjectionAccessor
+            std::shared_ptr<libCZI::IBitmapData> Get(libCZI::PixelType pixeltype, const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, libCZI::ProjectionOperation operation, const Options* pOptions) override;
+            void Get(libCZI::IBitmapData* pDest, const libCZI::IntPointAndFrameOfReference& position, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, libCZI::ProjectionOperation operation, const Options* pOptions) override;
+        private:
+            void InternalGet(int xPos, int yPos, libCZI::IBitmapData* pDest, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, libCZI::ProjectionOperation operation, const Options& options);
+        };
+    } // namespace detail
+} // namespace libCZI
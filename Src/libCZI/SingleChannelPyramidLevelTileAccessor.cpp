@@ -76,23 +76,46 @@ CSingleChannelPyramidLevelTileAccessor::CSingleChannelPyramidLevelTileAccessor(c
 void CSingleChannelPyramidLevelTileAccessor::InternalGet(libCZI::IBitmapData* pDest, int xPos, int yPos, int sizeOfPixelOnLayer0, const libCZI::IDimCoordinate* planeCoordinate, const PyramidLayerInfo& pyramidInfo, const Options& options)
 {
     this->CheckPlaneCoordinates(planeCoordinate);
-    Clear(pDest, options.backGroundColor);
     const auto sizeBitmap = pDest->GetSize();
-    const auto subSet = GetSubBlocksSubset(IntRect{ xPos,yPos,static_cast<int>(sizeBitmap.w) * sizeOfPixelOnLayer0,static_cast<int>(sizeBitmap.h) * sizeOfPixelOnLayer0 }, planeCoordinate, pyramidInfo, options.sceneFilter.get(), options.sortByM);
-    if (subSet.empty())
-    {	// no subblocks were found in the requested plane/ROI, so there is nothing to do
-        return;
-    }
+    const IntRect roi{ xPos,yPos,static_cast<int>(sizeBitmap.w) * sizeOfPixelOnLayer0,static_cast<int>(sizeBitmap.h) * sizeOfPixelOnLayer0 };
+    const string rendered_tile_cache_key = options.renderedTileCache ?
+        this->CreateRenderedTileCacheKey(
+            AccessorType::SingleChannelPyramidLayerTileAccessor,
+            pDest,
+            roi,
+            planeCoordinate,
+            options.backGroundColor,
+            options.sceneFilter.get(),
+            [&](ostream& key)
+            {
+                key << static_cast<int>(pyramidInfo.minificationFactor) << ',' << static_cast<int>(pyramidInfo.pyramidLayerNo) << ','
+                    << options.sortByM << options.drawTileBorder << options.maskAware;
+            }) :
+        string();
+
+    CSingleChannelAccessorBase::RenderUsingRenderedTileCache(
+        options.renderedTileCache.get(),
+        rendered_tile_cache_key,
+        pDest,
+        [&]()
+        {
+            Clear(pDest, options.backGroundColor);
+            const auto subSet = GetSubBlocksSubset(roi, planeCoordinate, pyramidInfo, options.sceneFilter.get(), options.sortByM);
+            if (subSet.empty())
+            {	// no subblocks were found in the requested plane/ROI, so there is nothing to do
+                return;
+            }
 
-    const auto byLayer = CalcByLayer(subSet, pyramidInfo.minificationFactor);
-    // ok, now we just have to look at our requested pyramid-layer
-    const auto& indices = byLayer.at(pyramidInfo.pyramidLayerNo).indices;
+            const auto byLayer = CalcByLayer(subSet, pyramidInfo.minificationFactor);
+            // ok, now we just have to look at our requested pyramid-layer
+            const auto& indices = byLayer.at(pyramidInfo.pyramidLayerNo).indices;
 
-    // and now... copy...
-    this->ComposeTiles(pDest, xPos, yPos, sizeOfPixelOnLayer0, static_cast<int>(indices.size()), options,
-        [&](int idx)->SbInfo
-        {
-            return subSet.at(indices.at(idx));
+            // and now... copy...
+            this->ComposeTiles(pDest, xPos, yPos, sizeOfPixelOnLayer0, static_cast<int>(indices.size()), options,
+                [&](int idx)->SbInfo
+                {
+                    return subSet.at(indices.at(idx));
+                });
         });
 }
 
@@ -101,19 +124,29 @@ void CSingleChannelPyramidLevelTileAccessor::ComposeTiles(libCZI::IBitmapData* b
     Compositors::ComposeSingleTileOptions composeOptions;
     composeOptions.Clear();
     composeOptions.drawTileBorder = options.drawTileBorder;
+    composeOptions.composeThreadCount = options.composeThreadCount;
+
+    SubBlockDataLoader loader(
+        bitmapCnt,
+        options.decodeThreadCount,
+        [&](int index)->SubBlockData
+        {
+            const SbInfo sub_block_info = getSbInfo(index);
+            return CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
+                this->sbBlkRepository,
+                options.subBlockCache,
+                sub_block_info.index,
+                options.onlyUseSubBlockCacheForCompressedData,
+                options.doNotAdmitToSubBlockCache,
+                options.maskAware);
+        });
 
     Compositors::ComposeSingleChannelTilesMaskAware(
         [&](int index, std::shared_ptr<libCZI::IBitmapData>& out_bitmap, std::shared_ptr<libCZI::IBitonalBitmapData>& out_mask_bitmap, int& tile_x_position, int& tile_y_position)->bool
         {
             if (index < bitmapCnt)
             {
-                const SbInfo sub_block_info = getSbInfo(index);
-                const auto subblock_bitmap_data = CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
-                        this->sbBlkRepository,
-                        options.subBlockCache,
-                        sub_block_info.index,
-                        options.onlyUseSubBlockCacheForCompressedData,
-                        options.maskAware);
+                const auto subblock_bitmap_data = loader.Get(index);
                 out_bitmap = subblock_bitmap_data.bitmap;
                 out_mask_bitmap = subblock_bitmap_data.mask;
                 tile_x_position = (subblock_bitmap_data.subBlockInfo.logicalRect.x - xPos) / sizeOfPixel;
@@ -82,14 +82,8 @@ CSingleChannelScalingTileAccessor::CSingleChannelScalingTileAccessor(const std::
     return IntSize{ static_cast<uint32_t>(roi.w * zoom),static_cast<uint32_t>(roi.h * zoom) };
 }
 
-void CSingleChannelScalingTileAccessor::ScaleBlt(libCZI::IBitmapData* bmDest, float zoom, const libCZI::IntRect& roi, const SbInfo& sbInfo, const libCZI::ISingleChannelScalingTileAccessor::Options& options)
+void CSingleChannelScalingTileAccessor::ScaleBlt(libCZI::IBitmapData* bmDest, float zoom, const libCZI::IntRect& roi, const SbInfo& sbInfo, const SubBlockData& subblock_bitmap_data, const libCZI::ISingleChannelScalingTileAccessor::Options& options)
 {
-    auto subblock_bitmap_data = CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
-                                                                            this->sbBlkRepository,
-                                                                            options.subBlockCache,
-                                                                            sbInfo.index,
-                                                                            options.onlyUseSubBlockCacheForCompressedData,
-                                                                            options.maskAware);
     if (GetSite()->IsEnabled(LOGLEVEL_CHATTYINFORMATION))
     {
         stringstream ss;
@@ -152,10 +146,12 @@ void CSingleChannelScalingTileAccessor::ScaleBlt(libCZI::IBitmapData* bmDest, fl
         DblRect srcRoi{ roiSrcTopLeftX ,roiSrcTopLeftY,roiSrcBttmRightX - roiSrcTopLeftX ,roiSrcBttmRightY - roiSrcTopLeftY };
         DblRect dstRoi{ destTopLeftX ,destTopLeftY,destBttmRightX - destTopLeftX ,destBttmRightY - destTopLeftY };
 
-        srcRoi.x *= sbInfo.physicalSize.w;
-        srcRoi.y *= sbInfo.physicalSize.h;
-        srcRoi.w *= sbInfo.physicalSize.w;
-        srcRoi.h *= sbInfo.physicalSize.h;
+        // note that we use the size of the source bitmap here (and not the physical size of the subblock), since the
+        //  bitmap may have been decoded at a reduced resolution
+        srcRoi.x *= source->GetWidth();
+        srcRoi.y *= source->GetHeight();
+        srcRoi.w *= source->GetWidth();
+        srcRoi.h *= source->GetHeight();
 
         dstRoi.x *= bmDest->GetWidth();
         dstRoi.y *= bmDest->GetHeight();
@@ -166,6 +162,14 @@ void CSingleChannelScalingTileAccessor::ScaleBlt(libCZI::IBitmapData* bmDest, fl
         {
             BitmapOperationsBitonal::NNResizeMaskAware(source.get(), source_mask.get(), bmDest, srcRoi, dstRoi);
         }
+        else if (options.resamplingMode == ResamplingMode::AreaAverage && source->GetPixelType() == bmDest->GetPixelType())
+        {
+            CBitmapOperations::AreaAverageResize(source.get(), bmDest, srcRoi, dstRoi);
+        }
+        else if (options.resamplingMode == ResamplingMode::Bilinear && source->GetPixelType() == bmDest->GetPixelType())
+        {
+            CBitmapOperations::BilinearResize(source.get(), bmDest, srcRoi, dstRoi);
+        }
         else
         {
             CBitmapOperations::NNResize(source.get(), bmDest, srcRoi, dstRoi);
@@ -173,6 +177,97 @@ void CSingleChannelScalingTileAccessor::ScaleBlt(libCZI::IBitmapData* bmDest, fl
     }
 }
 
+/*static*/std::uint32_t CSingleChannelScalingTileAccessor::DetermineJpgDownscaleDenominator(const SbInfo& sbInfo, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options)
+{
+    if (!options.useReducedResolutionDecode || options.maskAware || zoom >= 1)
+    {
+        return 1;
+    }
+
+    // this is the factor by which the subblock (at its physical resolution) gets scaled - we choose the largest
+    //  denominator for which the reduced resolution is still at least as large as what ends up in the destination
+    const float scale = zoom / sbInfo.GetZoom();
+    for (std::uint32_t denominator = 8; denominator > 1; denominator /= 2)
+    {
+        if (scale * static_cast<float>(denominator) <= 1)
+        {
+            return denominator;
+        }
+    }
+
+    return 1;
+}
+
+/*static*/std::uint8_t CSingleChannelScalingTileAccessor::DetermineDownscaledRenditionScaleLevel(const SbInfo& sbInfo, float zoom)
+{
+    // this is the factor by which the subblock (at its physical resolution) gets scaled
+    const float scale = zoom / sbInfo.GetZoom();
+    std::uint8_t scale_level = 0;
+    while (scale_level < 15 && scale * static_cast<float>(2u << scale_level) <= 1)
+    {
+        ++scale_level;
+    }
+
+    return scale_level;
+}
+
+CSingleChannelAccessorBase::SubBlockData CSingleChannelScalingTileAccessor::GetSubBlockDataForZoom(const SbInfo& sbInfo, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options)
+{
+    const std::uint8_t scale_level = options.useDownscaledSubBlockCache && options.subBlockCache && !options.maskAware ?
+        CSingleChannelScalingTileAccessor::DetermineDownscaledRenditionScaleLevel(sbInfo, zoom) :
+        0;
+    if (scale_level > 0)
+    {
+        const auto rendition_from_cache = options.subBlockCache->GetDownscaled(sbInfo.index, scale_level);
+        if (rendition_from_cache.IsValid())
+        {
+            SubBlockData result;
+            if (!this->sbBlkRepository->TryGetSubBlockInfo(sbInfo.index, &result.subBlockInfo))
+            {
+                stringstream ss;
+                ss << "SubBlockInfo not found in repository for subblock index " << sbInfo.index << ".";
+                throw logic_error(ss.str());
+            }
+
+            result.bitmap = rendition_from_cache.bitmap;
+            return result;
+        }
+    }
+
+    // if we are going to add a downscaled rendition to the cache, then the full-resolution bitmap is not added - it would take up
+    //  4^scale_level times the memory of the rendition (and it is not needed for drawing at this zoom anyway)
+    SubBlockData result = CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
+        this->sbBlkRepository,
+        options.subBlockCache,
+        sbInfo.index,
+        options.onlyUseSubBlockCacheForCompressedData,
+        options.doNotAdmitToSubBlockCache,
+        options.maskAware,
+        CSingleChannelScalingTileAccessor::DetermineJpgDownscaleDenominator(sbInfo, zoom, options),
+        scale_level > 0);
+
+    if (scale_level > 0)
+    {
+        // the rendition has the physical size divided by 2^scale_level (rounded up) - note that the bitmap we got may already
+        //  have this size (if it was decoded at a reduced resolution)
+        const uint32_t rendition_width = (sbInfo.physicalSize.w + (1u << scale_level) - 1) >> scale_level;
+        const uint32_t rendition_height = (sbInfo.physicalSize.h + (1u << scale_level) - 1) >> scale_level;
+        if (result.bitmap->GetWidth() != rendition_width || result.bitmap->GetHeight() != rendition_height)
+        {
+            auto rendition = GetSite()->CreateBitmap(result.bitmap->GetPixelType(), rendition_width, rendition_height);
+            CBitmapOperations::NNResize(result.bitmap.get(), rendition.get());
+            result.bitmap = rendition;
+        }
+
+        if (!options.doNotAdmitToSubBlockCache)
+        {
+            options.subBlockCache->AddDownscaled(sbInfo.index, scale_level, { result.bitmap });
+        }
+    }
+
+    return result;
+}
+
 int CSingleChannelScalingTileAccessor::GetIdxOf1stSubBlockWithZoomGreater(const std::vector<SbInfo>& sbBlks, const std::vector<int>& byZoom, float zoom)
 {
     // now, skip until the zoom of the subBlock is greater than the specified zoom
@@ -208,7 +303,9 @@ std::vector<int> CSingleChannelScalingTileAccessor::CreateSortByZoom(const std::
 
     if (sortByM)
     {
-        std::sort(
+        // the sorting by M-index is only applied to layer-0 subblocks, the subblocks on a pyramid-layer with the same zoom compare
+        //  equal - so, we need "stable_sort" here as well in order to get a deterministic order for them (given by the order of 'sbBlks')
+        std::stable_sort(
             byZoom.begin(),
             byZoom.end(),
             [&](const int i1, const int i2)->bool
@@ -242,7 +339,6 @@ std::vector<int> CSingleChannelScalingTileAccessor::CreateSortByZoom(const std::
     {
         // Sort by zoom only - note that we use "stable_sort" here, because otherwise the order of subblocks with the same zoom-level would be arbitrary.
         // This would mean that the result is not idem-potent, i.e. if we call this function twice with the same input, we would get different results.
-        // This is not a problem for the "sort by M-index" case, because there we have a deterministic sorting.
         // With "stable_sort" we ensure that the order of subblocks with the same zoom-level is preserved. This randomness was actually observed
         // in case of with stdlibc++ - with MSVC on Windows, the order was always the same.
         std::stable_sort(byZoom.begin(), byZoom.end(), [&](const int i1, const int i2)->bool {return sbBlks.at(i1).GetZoom() < sbBlks.at(i2).GetZoom(); });
@@ -286,6 +382,33 @@ std::vector<CSingleChannelScalingTileAccessor::SbInfo> CSingleChannelScalingTile
 void CSingleChannelScalingTileAccessor::InternalGet(libCZI::IBitmapData* bmDest, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options)
 {
     this->CheckPlaneCoordinates(planeCoordinate);
+    const string rendered_tile_cache_key = options.renderedTileCache ?
+        this->CreateRenderedTileCacheKey(
+            AccessorType::SingleChannelScalingTileAccessor,
+            bmDest,
+            roi,
+            planeCoordinate,
+            options.backGroundColor,
+            options.sceneFilter.get(),
+            [&](ostream& key)
+            {
+                CSingleChannelAccessorBase::WriteFloatToRenderedTileCacheKey(key, zoom);
+                key << options.sortByM << options.drawTileBorder << options.maskAware << options.useReducedResolutionDecode << options.useDownscaledSubBlockCache << static_cast<int>(options.resamplingMode);
+            }) :
+        string();
+
+    CSingleChannelAccessorBase::RenderUsingRenderedTileCache(
+        options.renderedTileCache.get(),
+        rendered_tile_cache_key,
+        bmDest,
+        [&]()
+        {
+            this->InternalRender(bmDest, roi, planeCoordinate, zoom, options);
+        });
+}
+
+void CSingleChannelScalingTileAccessor::InternalRender(libCZI::IBitmapData* bmDest, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options)
+{
     Clear(bmDest, options.backGroundColor);
     std::vector<int> scenesInvolved = this->DetermineInvolvedScenes(roi, options.sceneFilter.get());
 
@@ -319,28 +442,70 @@ void CSingleChannelScalingTileAccessor::InternalGet(libCZI::IBitmapData* bmDest,
     }
 
 
+    for (const auto& subblocks_to_draw : this->DetermineSubBlocksToDrawPerScene(roi, planeCoordinate, zoom, scenesInvolved, options.sortByM))
+    {
+        this->Paint(bmDest, roi, subblocks_to_draw, zoom, options);
+    }
+}
+
+std::vector<int> CSingleChannelScalingTileAccessor::DetermineSubBlocksToDraw(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const libCZI::IIndexSet* sceneFilter, bool sortByM)
+{
+    std::vector<int> result;
+    const std::vector<int> scenesInvolved = this->DetermineInvolvedScenes(roi, sceneFilter);
+    for (const auto& subblocks_to_draw : this->DetermineSubBlocksToDrawPerScene(roi, planeCoordinate, zoom, scenesInvolved, sortByM))
+    {
+        for (const auto& sbInfo : subblocks_to_draw)
+        {
+            result.push_back(sbInfo.index);
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::vector<CSingleChannelScalingTileAccessor::SbInfo>> CSingleChannelScalingTileAccessor::DetermineSubBlocksToDrawPerScene(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const std::vector<int>& scenesInvolved, bool sortByM)
+{
+    std::vector<std::vector<SbInfo>> result;
+    const auto layer_index = this->GetLayerIndex();
     if (scenesInvolved.size() <= 1)
     {
         // we only have to deal with a single scene (or: the document does not include a scene-dimension at all), in this
         //  case we do not have group by scene and save some cycles
-        auto sbSetsortedByZoom = this->GetSubSetFilteredBySceneSortedByZoom(roi, planeCoordinate, scenesInvolved, options.sortByM);
-        this->Paint(bmDest, roi, sbSetsortedByZoom, zoom, options);
+        const auto sbSetSortedByZoom = layer_index ?
+            CSingleChannelScalingTileAccessor::GetSubSetSortedByZoomFromLayerIndex(*layer_index, roi, planeCoordinate, &scenesInvolved, zoom, sortByM) :
+            this->GetSubSetFilteredBySceneSortedByZoom(roi, planeCoordinate, scenesInvolved, sortByM);
+        result.push_back(CSingleChannelScalingTileAccessor::SelectSubBlocksToDraw(sbSetSortedByZoom, roi, zoom));
+    }
+    else if (layer_index)
+    {
+        CDimCoordinate coord(planeCoordinate);
+        for (const auto sceneIdx : scenesInvolved)
+        {
+            // same as with "GetSubSetSortedByZoomPerScene" - we explicitly set the S-coordinate so that we only get subblocks of this scene
+            coord.Set(DimensionIndex::S, sceneIdx);
+            const auto sbSetSortedByZoom = CSingleChannelScalingTileAccessor::GetSubSetSortedByZoomFromLayerIndex(*layer_index, roi, &coord, nullptr, zoom, sortByM);
+            result.push_back(CSingleChannelScalingTileAccessor::SelectSubBlocksToDraw(sbSetSortedByZoom, roi, zoom));
+        }
     }
     else
     {
-        const auto sbSetSortedByZoomPerScene = this->GetSubSetSortedByZoomPerScene(scenesInvolved, roi, planeCoordinate, options.sortByM);
+        const auto sbSetSortedByZoomPerScene = this->GetSubSetSortedByZoomPerScene(scenesInvolved, roi, planeCoordinate, sortByM);
         for (const auto& it : sbSetSortedByZoomPerScene)
         {
-            this->Paint(bmDest, roi, get<1>(it), zoom, options);
+            result.push_back(CSingleChannelScalingTileAccessor::SelectSubBlocksToDraw(get<1>(it), roi, zoom));
         }
     }
+
+    return result;
 }
 
-void CSingleChannelScalingTileAccessor::Paint(libCZI::IBitmapData* bmDest, const libCZI::IntRect& roi, const SubSetSortedByZoom& sbSetSortedByZoom, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options)
+/*static*/std::vector<CSingleChannelScalingTileAccessor::SbInfo> CSingleChannelScalingTileAccessor::SelectSubBlocksToDraw(const SubSetSortedByZoom& sbSetSortedByZoom, const libCZI::IntRect& roi, float zoom)
 {
+    std::vector<SbInfo> subblocks_to_draw;
+
     // make the pyramid-layer limit a bit smaller (5% smaller) so that right at the edge of a pyramid layer, we do not
     //  exclude subblocks which happen to have an inaccurate zoom-level (e.g. due to quantization)
-    const int idxOf1stSubBlockOfZoomGreater = CSingleChannelScalingTileAccessor::GetIdxOf1stSubBlockWithZoomGreater(sbSetSortedByZoom.subBlocks, sbSetSortedByZoom.sortedByZoom, zoom / 1.05f);
+    const int idxOf1stSubBlockOfZoomGreater = CSingleChannelScalingTileAccessor::GetIdxOf1stSubBlockWithZoomGreater(sbSetSortedByZoom.subBlocks, sbSetSortedByZoom.sortedByZoom, zoom / kPyramidLayerZoomTolerance);
     if (idxOf1stSubBlockOfZoomGreater < 0)
     {
         // this means that we would need to overzoom (i.e. the requested zoom is less than the lowest level we find in the subblock-repository)
@@ -348,7 +513,7 @@ void CSingleChannelScalingTileAccessor::Paint(libCZI::IBitmapData* bmDest, const
         // ...we end up here e.g. when lowest level does not cover all the range, so - this is not
         //    something where we want to throw an exception
         //throw LibCZIAccessorException("Overzoom not supported", LibCZIAccessorException::ErrorType::Unspecified);
-        return;
+        return subblocks_to_draw;
     }
 
     // start_iterator points into the "sortedByZoom" vector, which contains indices into the "subBlocks" vector
@@ -362,55 +527,95 @@ void CSingleChannelScalingTileAccessor::Paint(libCZI::IBitmapData* bmDest, const
     {
         const SbInfo& sbInfo = sbSetSortedByZoom.subBlocks.at(*end_iterator);
         // as an interim solution (in fact... this seems to be a rather good solution...), stop when we arrive at subblocks with a zoom-level about twice that what we started with
-        if (sbInfo.GetZoom() >= startZoom * 1.9f)
+        if (sbInfo.GetZoom() >= startZoom * kPyramidLayerZoomRange)
         {
             break;
         }
     }
 
-    if (!options.useVisibilityCheckOptimization)
+    subblocks_to_draw.reserve(distance(start_iterator, end_iterator));
+    for (auto it = start_iterator; it != end_iterator; ++it)
+    {
+        subblocks_to_draw.push_back(sbSetSortedByZoom.subBlocks.at(*it));
+    }
+
+    if (end_iterator != sbSetSortedByZoom.sortedByZoom.cend())
     {
-        for (auto it = start_iterator; it != end_iterator; ++it)
+        // If the subblocks of the chosen zoom-levels leave holes in the ROI, we fill them with subblocks from the finer layers (the
+        //  nearest layer first) - we only use subblocks which cover some part of the ROI which is not covered so far. Those subblocks are
+        //  drawn first (the finest one first), so that the subblocks of the chosen zoom-levels end up on top.
+        RectangleCoverageCalculator coverage_calculator;
+        for (const auto& sbInfo : subblocks_to_draw)
         {
-            const SbInfo& sbInfo = sbSetSortedByZoom.subBlocks.at(*it);
+            coverage_calculator.AddRectangle(Utilities::Intersect(sbInfo.logicalRect, roi));
+        }
 
-            if (GetSite()->IsEnabled(LOGLEVEL_CHATTYINFORMATION))
+        std::vector<SbInfo> subblocks_filling_holes;
+        for (auto it = end_iterator; it != sbSetSortedByZoom.sortedByZoom.cend() && !coverage_calculator.IsCompletelyCovered(roi); ++it)
+        {
+            const SbInfo& sbInfo = sbSetSortedByZoom.subBlocks.at(*it);
+            if (coverage_calculator.AddRectangle(Utilities::Intersect(sbInfo.logicalRect, roi)) > 0)
             {
-                stringstream ss;
-                ss << " Drawing subblock: idx=" << sbInfo.index << " Log.: " << sbInfo.logicalRect << " Phys.Size: " << sbInfo.physicalSize;
-                GetSite()->Log(LOGLEVEL_CHATTYINFORMATION, ss);
+                subblocks_filling_holes.push_back(sbInfo);
             }
+        }
+
+        subblocks_to_draw.insert(subblocks_to_draw.begin(), subblocks_filling_holes.crbegin(), subblocks_filling_holes.crend());
+    }
+
+    return subblocks_to_draw;
+}
 
-            this->ScaleBlt(bmDest, zoom, roi, sbInfo, options);
+void CSingleChannelScalingTileAccessor::Paint(libCZI::IBitmapData* bmDest, const libCZI::IntRect& roi, const std::vector<SbInfo>& subblocks, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options)
+{
+    // gather the subblocks to be drawn (in the order in which they are to be drawn)
+    std::vector<const SbInfo*> subblocks_to_draw;
+    if (!options.useVisibilityCheckOptimization)
+    {
+        subblocks_to_draw.reserve(subblocks.size());
+        for (const auto& sbInfo : subblocks)
+        {
+            subblocks_to_draw.push_back(&sbInfo);
         }
     }
     else
     {
         const auto indices_of_visible_tiles = this->CheckForVisibility(
             roi,
-            static_cast<int>(distance(start_iterator, end_iterator)),           // how many subblocks we have in the range [start_iterator, end_iterator)
+            static_cast<int>(subblocks.size()),
             [&](int index)->int
             {
-                // dereference the iterator (advanced by the index we get), this gives us an index into the 
-                // subBlocks-vector, which we then use to get the subblock-index of the subblock
-                return sbSetSortedByZoom.subBlocks[*(start_iterator + index)].index;
+                return subblocks[index].index;
             });
 
         // Now, draw only the subblocks which are visible - the vector "indices_of_visible_tiles" contains the indices "as they were passed to the lambda".
+        subblocks_to_draw.reserve(indices_of_visible_tiles.size());
         for (const auto i : indices_of_visible_tiles)
         {
-            // dereference the iterator (advanced by the index from out loop variable), this gives us an index into the
-            // subBlocks-vector
-            const SbInfo& sbInfo = sbSetSortedByZoom.subBlocks.at(*(start_iterator + i));
-            if (GetSite()->IsEnabled(LOGLEVEL_CHATTYINFORMATION))
-            {
-                stringstream ss;
-                ss << " Drawing subblock: idx=" << sbInfo.index << " Log.: " << sbInfo.logicalRect << " Phys.Size: " << sbInfo.physicalSize;
-                GetSite()->Log(LOGLEVEL_CHATTYINFORMATION, ss);
-            }
+            subblocks_to_draw.push_back(&subblocks[i]);
+        }
+    }
+
+    // the loader reads and decodes the subblocks (concurrently if so configured), and we draw them in the required order
+    SubBlockDataLoader loader(
+        static_cast<int>(subblocks_to_draw.size()),
+        options.decodeThreadCount,
+        [&](int index)->SubBlockData
+        {
+            return this->GetSubBlockDataForZoom(*subblocks_to_draw[index], zoom, options);
+        });
 
-            this->ScaleBlt(bmDest, zoom, roi, sbInfo, options);
+    for (size_t i = 0; i < subblocks_to_draw.size(); ++i)
+    {
+        const SbInfo& sbInfo = *subblocks_to_draw[i];
+        if (GetSite()->IsEnabled(LOGLEVEL_CHATTYINFORMATION))
+        {
+            stringstream ss;
+            ss << " Drawing subblock: idx=" << sbInfo.index << " Log.: " << sbInfo.logicalRect << " Phys.Size: " << sbInfo.physicalSize;
+            GetSite()->Log(LOGLEVEL_CHATTYINFORMATION, ss);
         }
+
+        this->ScaleBlt(bmDest, zoom, roi, sbInfo, loader.Get(static_cast<int>(i)), options);
     }
 }
 
@@ -485,3 +690,138 @@ std::vector<std::tuple<int, CSingleChannelScalingTileAccessor::SubSetSortedByZoo
 
     return result;
 }
+
+std::shared_ptr<const SubBlockLayerIndex> CSingleChannelScalingTileAccessor::GetLayerIndex()
+{
+    const auto* instance_identity = dynamic_cast<const IRepositoryInstanceIdentity*>(this->sbBlkRepository.get());
+    const uint64_t instance_id = instance_identity != nullptr ? instance_identity->GetRepositoryInstanceId() : 0;
+    if (instance_id == 0)
+    {
+        // without an identity, we cannot tell whether the repository has changed, so we must not keep an index
+        return nullptr;
+    }
+
+    lock_guard<mutex> lck(this->layerIndexMutex);
+    if (!this->layerIndex || this->layerIndexRepositoryInstanceId != instance_id)
+    {
+        // the index is shared with all other users of the same repository-instance (e.g. other accessors or a prefetcher)
+        this->layerIndex = SubBlockLayerIndex::GetOrCreate(this->sbBlkRepository.get(), instance_id);
+        this->layerIndexRepositoryInstanceId = instance_id;
+    }
+
+    return this->layerIndex;
+}
+
+/*static*/CSingleChannelScalingTileAccessor::SubSetSortedByZoom CSingleChannelScalingTileAccessor::GetSubSetSortedByZoomFromLayerIndex(const SubBlockLayerIndex& layerIndex, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const std::vector<int>* allowedScenes, float zoom, bool sortByM)
+{
+    const auto is_scene_allowed = [allowedScenes](const SubBlockLayerIndex::Entry* entry)->bool
+    {
+        // the same filtering as in "GetSubSet" - subblocks without an S-index are always included
+        return allowedScenes == nullptr ||
+            entry->sceneIndex == (numeric_limits<int>::max)() ||
+            find(allowedScenes->cbegin(), allowedScenes->cend(), entry->sceneIndex) != allowedScenes->cend();
+    };
+
+    // the same limits as used in "SelectSubBlocksToDraw" - we start with the lowest zoom which is larger than "zoom/1.05", and the subblocks up to
+    //  a zoom of about twice this zoom are drawn
+    const float minimal_zoom = zoom / kPyramidLayerZoomTolerance;
+    float start_zoom = -1;
+    size_t start_layer = 0;
+    vector<const SubBlockLayerIndex::Entry*> entries;
+    vector<const SubBlockLayerIndex::Entry*> entries_of_layer;
+    for (size_t layer = 0; layer < layerIndex.GetLayerCount(); ++layer)
+    {
+        const auto& layer_info = layerIndex.GetLayerInfo(layer);
+        if (layer_info.maxZoom < minimal_zoom)
+        {
+            continue;
+        }
+
+        if (start_zoom > 0 && layer_info.minZoom >= start_zoom * kPyramidLayerZoomRange)
+        {
+            break;
+        }
+
+        entries_of_layer.clear();
+        layerIndex.Query(layer, roi, planeCoordinate, nullptr, entries_of_layer);
+        if (start_zoom < 0)
+        {
+            for (const auto* entry : entries_of_layer)
+            {
+                if (entry->zoom >= minimal_zoom && is_scene_allowed(entry) && (start_zoom < 0 || entry->zoom < start_zoom))
+                {
+                    start_zoom = entry->zoom;
+                }
+            }
+
+            if (start_zoom < 0)
+            {
+                continue;
+            }
+
+            start_layer = layer;
+        }
+
+        for (const auto* entry : entries_of_layer)
+        {
+            if (entry->zoom >= minimal_zoom && entry->zoom < start_zoom * kPyramidLayerZoomRange && is_scene_allowed(entry))
+            {
+                entries.push_back(entry);
+            }
+        }
+    }
+
+    if (start_zoom > 0)
+    {
+        // now check whether there are holes, and if so, add the subblocks of the finer layers which might be used to fill them - we
+        //  only look at the grid-cells which are not yet covered, and "SelectSubBlocksToDraw" then makes the final decision
+        RectangleCoverageCalculator coverage_calculator;
+        for (const auto* entry : entries)
+        {
+            coverage_calculator.AddRectangle(Utilities::Intersect(entry->logicalRect, roi));
+        }
+
+        for (size_t layer = start_layer; layer < layerIndex.GetLayerCount() && !coverage_calculator.IsCompletelyCovered(roi); ++layer)
+        {
+            if (layerIndex.GetLayerInfo(layer).maxZoom < start_zoom * kPyramidLayerZoomRange)
+            {
+                continue;
+            }
+
+            entries_of_layer.clear();
+            layerIndex.Query(
+                layer,
+                roi,
+                planeCoordinate,
+                [&](const IntRect& cell)->bool { return !coverage_calculator.IsCompletelyCovered(cell); },
+                entries_of_layer);
+            for (const auto* entry : entries_of_layer)
+            {
+                if (entry->zoom >= start_zoom * kPyramidLayerZoomRange && is_scene_allowed(entry))
+                {
+                    entries.push_back(entry);
+                    coverage_calculator.AddRectangle(Utilities::Intersect(entry->logicalRect, roi));
+                }
+            }
+        }
+    }
+
+    // bring the subblocks into the order in which "EnumSubset" would report them, so that the sorting by zoom gives
+    //  exactly the same order as with "GetSubSet"
+    sort(entries.begin(), entries.end(), [](const SubBlockLayerIndex::Entry* a, const SubBlockLayerIndex::Entry* b)->bool { return a->index < b->index; });
+
+    SubSetSortedByZoom result;
+    result.subBlocks.reserve(entries.size());
+    for (const auto* entry : entries)
+    {
+        SbInfo sbinfo;
+        sbinfo.logicalRect = entry->logicalRect;
+        sbinfo.physicalSize = entry->physicalSize;
+        sbinfo.mIndex = entry->mIndex;
+        sbinfo.index = entry->index;
+        result.subBlocks.push_back(sbinfo);
+    }
+
+    result.sortedByZoom = CSingleChannelScalingTileAccessor::CreateSortByZoom(result.subBlocks, sortByM);
+    return result;
+}
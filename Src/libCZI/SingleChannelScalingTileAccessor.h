@@ -7,9 +7,11 @@
 #include <tuple>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include "CZIReader.h"
 #include "libCZI.h"
 #include "SingleChannelAccessorBase.h"
+#include "subblock_layer_index.h"
 
 namespace libCZI
 {
@@ -29,9 +31,33 @@ namespace libCZI
                 float	GetZoom() const { return libCZI::Utils::CalcZoom(this->logicalRect, this->physicalSize); }
             };
 
+            std::mutex layerIndexMutex;
+            std::shared_ptr<const SubBlockLayerIndex> layerIndex;      ///< The layer-index (guarded by layerIndexMutex), created on first use.
+            std::uint64_t layerIndexRepositoryInstanceId{ 0 };         ///< The instance-id of the repository for which the layer-index was created.
+
+            /// The pyramid-layer to be used is the one with the lowest zoom which is larger than the requested zoom divided by this
+            /// factor (i.e. we allow for the zoom of a subblock to be up to 5% smaller than the requested zoom).
+            static constexpr float kPyramidLayerZoomTolerance = 1.05f;
+
+            /// Subblocks with a zoom up to this factor times the zoom of the chosen pyramid-layer are drawn (together with the subblocks of the chosen layer).
+            static constexpr float kPyramidLayerZoomRange = 1.9f;
+
         public:
             explicit CSingleChannelScalingTileAccessor(const std::shared_ptr<libCZI::ISubBlockRepository>& sbBlkRepository);
 
+            /// Determines the subblocks which are drawn for the specified request - this is the same selection (of the pyramid-layer, and of
+            /// the subblocks filling the holes in it) as done by the "Get"-methods (before the visibility check is applied). The subblocks
+            /// are given (per scene) in the order in which they are drawn.
+            ///
+            /// \param  roi             The ROI (in the raw-sub-block-coordinate-system).
+            /// \param  planeCoordinate The plane coordinate.
+            /// \param  zoom            The zoom.
+            /// \param  sceneFilter     The scene filter (may be null).
+            /// \param  sortByM         Whether to sort the subblocks by their zoom level AND the M-Index or only by zoom level.
+            ///
+            /// \returns    The subblock indices.
+            std::vector<int> DetermineSubBlocksToDraw(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const libCZI::IIndexSet* sceneFilter, bool sortByM);
+
         public:	// interface ISingleChannelScalingTileAccessor
             libCZI::IntSize CalcSize(const libCZI::IntRect& roi, float zoom) const override;
             std::shared_ptr<libCZI::IBitmapData> Get(const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options* pOptions) override;
@@ -43,9 +69,23 @@ namespace libCZI
             static std::vector<int> CreateSortByZoom(const std::vector<SbInfo>& sbBlks, bool sortByM);
             std::vector<SbInfo> GetSubSet(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const std::vector<int>* allowedScenes);
             static int GetIdxOf1stSubBlockWithZoomGreater(const std::vector<SbInfo>& sbBlks, const std::vector<int>& byZoom, float zoom);
-            void ScaleBlt(libCZI::IBitmapData* bmDest, float zoom, const libCZI::IntRect& roi, const SbInfo& sbInfo, const libCZI::ISingleChannelScalingTileAccessor::Options& options);
+
+            /// Determine by which factor (1, 2, 4 or 8) a JPG-compressed subblock can be downscaled while decoding without
+            /// affecting the result, i.e. such that the reduced resolution is still at least the resolution of the destination.
+            static std::uint32_t DetermineJpgDownscaleDenominator(const SbInfo& sbInfo, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options);
+            /// Determine the scale level (i.e. the exponent of the power-of-two downscale factor) of the downscaled rendition to be used
+            /// for the specified subblock at the specified zoom - this is the largest level for which the rendition still has at least
+            /// the resolution of the destination. A return value of 0 means that no downscaled rendition can be used.
+            static std::uint8_t DetermineDownscaledRenditionScaleLevel(const SbInfo& sbInfo, float zoom);
+
+            /// Gets the bitmap (and mask) of the specified subblock for drawing it at the specified zoom. If so configured, a downscaled
+            /// rendition is retrieved from (or added to) the subblock cache.
+            SubBlockData GetSubBlockDataForZoom(const SbInfo& sbInfo, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options);
+
+            void ScaleBlt(libCZI::IBitmapData* bmDest, float zoom, const libCZI::IntRect& roi, const SbInfo& sbInfo, const SubBlockData& subblock_bitmap_data, const libCZI::ISingleChannelScalingTileAccessor::Options& options);
 
             void InternalGet(libCZI::IBitmapData* bmDest, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options);
+            void InternalRender(libCZI::IBitmapData* bmDest, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options);
 
             std::vector<int> DetermineInvolvedScenes(const libCZI::IntRect& roi, const libCZI::IIndexSet* pSceneIndexSet);
 
@@ -60,7 +100,35 @@ namespace libCZI
             SubSetSortedByZoom GetSubSetFilteredBySceneSortedByZoom(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const std::vector<int>& allowedScenes, bool sortByM);
 
             std::vector<std::tuple<int, SubSetSortedByZoom>> GetSubSetSortedByZoomPerScene(const std::vector<int>& scenes, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, bool sortByM);
-            void Paint(libCZI::IBitmapData* bmDest, const libCZI::IntRect& roi, const SubSetSortedByZoom& sbSetSortedByZoom, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options);
+            /// Gets the layer-index for the repository. The index is only available (and the return value is non-null) if the
+            /// repository can report an instance-identity - the index is created on first use, and re-created if the identity changed.
+            std::shared_ptr<const SubBlockLayerIndex> GetLayerIndex();
+
+            /// Gets the subblocks to be drawn for the specified zoom from the layer-index. Instead of gathering all subblocks intersecting
+            /// with the ROI, only the layers with the zoom-levels that "SelectSubBlocksToDraw" will actually use are queried. Finer layers are
+            /// queried only in case the ROI is not completely covered, and then only in the regions which are not covered. The
+            /// result contains (at least) all the subblocks which "SelectSubBlocksToDraw" would use from the complete subset.
+            ///
+            /// \param  layerIndex      The layer-index.
+            /// \param  roi             The region-of-interest rectangle.
+            /// \param  planeCoordinate The plane coordinate.
+            /// \param  allowedScenes   If non-null, the list of allowed scenes (same semantic as with "GetSubSet").
+            /// \param  zoom            The zoom.
+            /// \param  sortByM         Whether to sort the subblocks by their zoom level AND the M-Index or only by zoom level.
+            ///
+            /// \returns    The subset of subblocks, sorted by their zoom.
+            static SubSetSortedByZoom GetSubSetSortedByZoomFromLayerIndex(const SubBlockLayerIndex& layerIndex, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const std::vector<int>* allowedScenes, float zoom, bool sortByM);
+
+            /// Determines the subblocks to be drawn - for every scene (or only one, if the scenes need not be distinguished) the list of
+            /// subblocks in the order in which they are to be drawn.
+            std::vector<std::vector<SbInfo>> DetermineSubBlocksToDrawPerScene(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const std::vector<int>& scenesInvolved, bool sortByM);
+
+            /// Selects the subblocks to be drawn from the specified subset - these are the subblocks from the lowest zoom which is suitable for
+            /// the requested zoom up to (about) twice this zoom. If they leave holes in the ROI, subblocks of the finer layers covering them are
+            /// added (and drawn first). The result is in the order in which the subblocks are to be drawn.
+            static std::vector<SbInfo> SelectSubBlocksToDraw(const SubSetSortedByZoom& sbSetSortedByZoom, const libCZI::IntRect& roi, float zoom);
+
+            void Paint(libCZI::IBitmapData* bmDest, const libCZI::IntRect& roi, const std::vector<SbInfo>& subblocks, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options& options);
         };
 
     } // namespace detail
@@ -45,12 +45,141 @@ CSingleChannelTileAccessor::CSingleChannelTileAccessor(const std::shared_ptr<ISu
     this->InternalGet(point_raw_sub_block_cs.x, point_raw_sub_block_cs.y, pDest, planeCoordinate, pOptions);
 }
 
+/*virtual*/std::vector<std::shared_ptr<libCZI::IBitmapData>> CSingleChannelTileAccessor::GetMultiplePlanes(libCZI::PixelType pixeltype, const libCZI::IntRectAndFrameOfReference& roi, const std::vector<libCZI::CDimCoordinate>& planeCoordinates, const Options* pOptions)
+{
+    if (pOptions == nullptr)
+    {
+        ISingleChannelTileAccessor::Options options; options.Clear();
+        return this->GetMultiplePlanes(pixeltype, roi, planeCoordinates, &options);
+    }
+
+    if (pOptions->renderedTileCache)
+    {
+        // with a rendered-tile cache, every plane may or may not be found in the cache - so we deal with the planes one by one
+        return ISingleChannelTileAccessor::GetMultiplePlanes(pixeltype, roi, planeCoordinates, pOptions);
+    }
+
+    for (const auto& planeCoordinate : planeCoordinates)
+    {
+        this->CheckPlaneCoordinates(&planeCoordinate);
+    }
+
+    const IntRect roi_raw_sub_block_cs = this->sbBlkRepository->TransformRectangle(roi, CZIFrameOfReference::RawSubBlockCoordinateSystem).rectangle;
+
+    // determine the subblocks of all planes with one pass over the subblock-directory
+    vector<vector<IndexAndM>> subBlocksSetPerPlane(planeCoordinates.size());
+    this->sbBlkRepository->EnumSubset(nullptr, &roi_raw_sub_block_cs, true,
+        [&](int idx, const SubBlockInfo& info)->bool
+        {
+            for (size_t i = 0; i < planeCoordinates.size(); ++i)
+            {
+                if (CziUtils::CompareCoordinate(&planeCoordinates[i], &info.coordinate))
+                {
+                    subBlocksSetPerPlane[i].emplace_back(IndexAndM{ idx, info.mIndex });
+                }
+            }
+
+            return true;
+        });
+
+    // now, gather the subblocks to be drawn for all planes in one list (in the order in which they are drawn), so that the loader
+    //  can read and decode the subblocks of the following planes while we are still composing the current one
+    vector<int> subBlocksToDraw;
+    vector<size_t> firstSubBlockOfPlane;
+    firstSubBlockOfPlane.reserve(planeCoordinates.size() + 1);
+    for (auto& subBlocksSet : subBlocksSetPerPlane)
+    {
+        if (pOptions->sortByM)
+        {
+            CSingleChannelTileAccessor::SortByM(subBlocksSet);
+        }
+
+        firstSubBlockOfPlane.push_back(subBlocksToDraw.size());
+        const auto subBlocksToDrawForPlane = this->DetermineSubBlocksToDraw(roi_raw_sub_block_cs, subBlocksSet, *pOptions);
+        subBlocksToDraw.insert(subBlocksToDraw.end(), subBlocksToDrawForPlane.cbegin(), subBlocksToDrawForPlane.cend());
+    }
+
+    firstSubBlockOfPlane.push_back(subBlocksToDraw.size());
+
+    SubBlockDataLoader loader(
+        static_cast<int>(subBlocksToDraw.size()),
+        pOptions->decodeThreadCount,
+        [&](int index)->SubBlockData
+        {
+            return this->LoadSubBlockData(subBlocksToDraw[index], *pOptions);
+        });
+
+    vector<shared_ptr<IBitmapData>> result;
+    result.reserve(planeCoordinates.size());
+    for (size_t i = 0; i < planeCoordinates.size(); ++i)
+    {
+        auto bmDest = GetSite()->CreateBitmap(pixeltype, roi_raw_sub_block_cs.w, roi_raw_sub_block_cs.h);
+        Clear(bmDest.get(), pOptions->backGroundColor);
+        this->ComposeTiles(
+            bmDest.get(),
+            roi_raw_sub_block_cs.x,
+            roi_raw_sub_block_cs.y,
+            loader,
+            static_cast<int>(firstSubBlockOfPlane[i]),
+            static_cast<int>(firstSubBlockOfPlane[i + 1] - firstSubBlockOfPlane[i]),
+            *pOptions);
+        result.emplace_back(std::move(bmDest));
+    }
+
+    return result;
+}
+
 void CSingleChannelTileAccessor::ComposeTiles(libCZI::IBitmapData* pBm, int xPos, int yPos, const std::vector<IndexAndM>& subBlocksSet, const ISingleChannelTileAccessor::Options& options)
+{
+    const auto subBlocksToDraw = this->DetermineSubBlocksToDraw(
+        { xPos, yPos, static_cast<int>(pBm->GetWidth()), static_cast<int>(pBm->GetHeight()) },
+        subBlocksSet,
+        options);
+
+    // the loader gives us the subblocks in the order in which they are to be rendered - if so configured, they are read and decoded
+    //  concurrently by worker threads, and we can draw a subblock as soon as it (and all its predecessors) are available
+    SubBlockDataLoader loader(
+        static_cast<int>(subBlocksToDraw.size()),
+        options.decodeThreadCount,
+        [&](int index)->SubBlockData
+        {
+            return this->LoadSubBlockData(subBlocksToDraw[index], options);
+        });
+
+    this->ComposeTiles(pBm, xPos, yPos, loader, 0, static_cast<int>(subBlocksToDraw.size()), options);
+}
+
+void CSingleChannelTileAccessor::ComposeTiles(libCZI::IBitmapData* pBm, int xPos, int yPos, SubBlockDataLoader& loader, int first, int count, const libCZI::ISingleChannelTileAccessor::Options& options)
 {
     Compositors::ComposeSingleTileOptions composeOptions;
     composeOptions.Clear();
     composeOptions.drawTileBorder = options.drawTileBorder;
+    composeOptions.composeThreadCount = options.composeThreadCount;
 
+    Compositors::ComposeSingleChannelTilesMaskAware(
+        [&](int index, std::shared_ptr<libCZI::IBitmapData>& spBm, std::shared_ptr<libCZI::IBitonalBitmapData>& spMask, int& xPosTile, int& yPosTile)->bool
+        {
+            if (index < count)
+            {
+                const auto subblock_data = loader.Get(first + index);
+                spBm = subblock_data.bitmap;
+                spMask = subblock_data.mask;
+                xPosTile = subblock_data.subBlockInfo.logicalRect.x;
+                yPosTile = subblock_data.subBlockInfo.logicalRect.y;
+                return true;
+            }
+
+            return false;
+        },
+        pBm,
+        xPos,
+        yPos,
+        &composeOptions);
+}
+
+std::vector<int> CSingleChannelTileAccessor::DetermineSubBlocksToDraw(const libCZI::IntRect& roi, const std::vector<IndexAndM>& subBlocksSet, const libCZI::ISingleChannelTileAccessor::Options& options)
+{
+    vector<int> subBlocksToDraw;
     if (options.useVisibilityCheckOptimization)
     {
         // Try to reduce the number of subblocks to be rendered by doing a visibility check, and only rendering those which are visible.
@@ -60,66 +189,40 @@ void CSingleChannelTileAccessor::ComposeTiles(libCZI::IBitmapData* pBm, int xPos
         // We get a vector with the indices of the subblocks to be rendered, and then render them in the order as given in this vector 
         // (index here means - the number as passed to the lambda).
         const auto indices_of_visible_tiles = this->CheckForVisibility(
-            { xPos, yPos, static_cast<int>(pBm->GetWidth()), static_cast<int>(pBm->GetHeight()) },
+            roi,
             static_cast<int>(subBlocksSet.size()),
             [&](int index)->int
             {
                 return subBlocksSet[index].index;
             });
 
-
-        Compositors::ComposeSingleChannelTilesMaskAware(
-                [&](int index, std::shared_ptr<libCZI::IBitmapData>& spBm, std::shared_ptr<libCZI::IBitonalBitmapData>& spMask, int& xPosTile, int& yPosTile)->bool
-                {
-                    if (index < static_cast<int>(indices_of_visible_tiles.size()))
-                    {
-                        const auto subblock_data = CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
-                            this->sbBlkRepository,
-                            options.subBlockCache,
-                            subBlocksSet[indices_of_visible_tiles[index]].index,
-                            options.onlyUseSubBlockCacheForCompressedData,
-                            options.maskAware);
-                        spBm = subblock_data.bitmap;
-                        spMask = subblock_data.mask;
-                        xPosTile = subblock_data.subBlockInfo.logicalRect.x;
-                        yPosTile = subblock_data.subBlockInfo.logicalRect.y;
-                        return true;
-                    }
-
-                    return false;
-                },
-                pBm,
-                xPos,
-                yPos,
-                &composeOptions);
+        subBlocksToDraw.reserve(indices_of_visible_tiles.size());
+        for (const int i : indices_of_visible_tiles)
+        {
+            subBlocksToDraw.push_back(subBlocksSet[i].index);
+        }
     }
     else
     {
-        Compositors::ComposeSingleChannelTilesMaskAware(
-            [&](int index, std::shared_ptr<libCZI::IBitmapData>& spBm, std::shared_ptr<libCZI::IBitonalBitmapData>& spMask, int& xPosTile, int& yPosTile)->bool
-            {
-                if (index < static_cast<int>(subBlocksSet.size()))
-                {
-                    const auto subblock_data = CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
-                        this->sbBlkRepository,
-                        options.subBlockCache,
-                        subBlocksSet[index].index,
-                        options.onlyUseSubBlockCacheForCompressedData,
-                        options.maskAware);
-                    spBm = subblock_data.bitmap;
-                    spMask = subblock_data.mask;
-                    xPosTile = subblock_data.subBlockInfo.logicalRect.x;
-                    yPosTile = subblock_data.subBlockInfo.logicalRect.y;
-                    return true;
-                }
-
-                return false;
-            },
-            pBm,
-            xPos,
-            yPos,
-            &composeOptions);
+        subBlocksToDraw.reserve(subBlocksSet.size());
+        for (const auto& item : subBlocksSet)
+        {
+            subBlocksToDraw.push_back(item.index);
+        }
     }
+
+    return subBlocksToDraw;
+}
+
+CSingleChannelAccessorBase::SubBlockData CSingleChannelTileAccessor::LoadSubBlockData(int subBlockIndex, const libCZI::ISingleChannelTileAccessor::Options& options)
+{
+    return CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
+        this->sbBlkRepository,
+        options.subBlockCache,
+        subBlockIndex,
+        options.onlyUseSubBlockCacheForCompressedData,
+        options.doNotAdmitToSubBlockCache,
+        options.maskAware);
 }
 
 void CSingleChannelTileAccessor::InternalGet(int xPos, int yPos, libCZI::IBitmapData* pBm, const IDimCoordinate* planeCoordinate, const ISingleChannelTileAccessor::Options* pOptions)
@@ -132,12 +235,32 @@ void CSingleChannelTileAccessor::InternalGet(int xPos, int yPos, libCZI::IBitmap
     }
 
     this->CheckPlaneCoordinates(planeCoordinate);
-    Clear(pBm, pOptions->backGroundColor);
     const IntSize sizeBm = pBm->GetSize();
     const IntRect roi{ xPos,yPos,static_cast<int>(sizeBm.w),static_cast<int>(sizeBm.h) };
-    const std::vector<IndexAndM> subBlocksSet = this->GetSubBlocksSubset(roi, planeCoordinate, pOptions->sortByM);
+    const string rendered_tile_cache_key = pOptions->renderedTileCache ?
+        this->CreateRenderedTileCacheKey(
+            AccessorType::SingleChannelTileAccessor,
+            pBm,
+            roi,
+            planeCoordinate,
+            pOptions->backGroundColor,
+            pOptions->sceneFilter.get(),
+            [pOptions](ostream& key)
+            {
+                key << pOptions->sortByM << pOptions->drawTileBorder << pOptions->maskAware;
+            }) :
+        string();
 
-    this->ComposeTiles(pBm, xPos, yPos, subBlocksSet, *pOptions);
+    CSingleChannelAccessorBase::RenderUsingRenderedTileCache(
+        pOptions->renderedTileCache.get(),
+        rendered_tile_cache_key,
+        pBm,
+        [&]()
+        {
+            Clear(pBm, pOptions->backGroundColor);
+            const std::vector<IndexAndM> subBlocksSet = this->GetSubBlocksSubset(roi, planeCoordinate, pOptions->sortByM);
+            this->ComposeTiles(pBm, xPos, yPos, subBlocksSet, *pOptions);
+        });
 }
 
 std::vector<CSingleChannelTileAccessor::IndexAndM> CSingleChannelTileAccessor::GetSubBlocksSubset(const IntRect& roi, const IDimCoordinate* planeCoordinate, bool sortByM)
@@ -148,19 +271,24 @@ std::vector<CSingleChannelTileAccessor::IndexAndM> CSingleChannelTileAccessor::G
     this->GetAllSubBlocks(roi, planeCoordinate, [&](int index, int mIndex)->void {subBlocksSet.emplace_back(IndexAndM{ index,mIndex }); });
     if (sortByM == true)
     {
-        // sort ascending-by-M-index (-> lowest M-index first, highest last)
-        std::sort(subBlocksSet.begin(), subBlocksSet.end(), [](const IndexAndM& i1, const IndexAndM& i2)->bool
-            {
-                // an invalid mIndex should go before a valid one (just to have a deterministic sorting) - and "invalid mIndex" is represented by both maximum int and minimum int
-                const int mIndex1 = Utils::IsValidMindex(i1.mIndex) ? i1.mIndex : (numeric_limits<int>::min)();
-                const int mIndex2 = Utils::IsValidMindex(i2.mIndex) ? i2.mIndex : (numeric_limits<int>::min)();
-                return mIndex1 < mIndex2;
-            });
+        CSingleChannelTileAccessor::SortByM(subBlocksSet);
     }
 
     return subBlocksSet;
 }
 
+/*static*/void CSingleChannelTileAccessor::SortByM(std::vector<IndexAndM>& subBlocksSet)
+{
+    // sort ascending-by-M-index (-> lowest M-index first, highest last)
+    std::sort(subBlocksSet.begin(), subBlocksSet.end(), [](const IndexAndM& i1, const IndexAndM& i2)->bool
+        {
+            // an invalid mIndex should go before a valid one (just to have a deterministic sorting) - and "invalid mIndex" is represented by both maximum int and minimum int
+            const int mIndex1 = Utils::IsValidMindex(i1.mIndex) ? i1.mIndex : (numeric_limits<int>::min)();
+            const int mIndex2 = Utils::IsValidMindex(i2.mIndex) ? i2.mIndex : (numeric_limits<int>::min)();
+            return mIndex1 < mIndex2;
+        });
+}
+
 void CSingleChannelTileAccessor::GetAllSubBlocks(const IntRect& roi, const IDimCoordinate* planeCoordinate, const std::function<void(int index, int mIndex)>& appender) const
 {
     this->sbBlkRepository->EnumSubset(planeCoordinate, nullptr, true,
@@ -24,6 +24,7 @@ namespace libCZI
             std::shared_ptr<libCZI::IBitmapData> Get(const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, const libCZI::ISingleChannelTileAccessor::Options* pOptions) override;
             std::shared_ptr<libCZI::IBitmapData> Get(libCZI::PixelType pixeltype, const  libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, const Options* pOptions) override;
             void Get(libCZI::IBitmapData* pDest, const libCZI::IntPointAndFrameOfReference& position, const libCZI::IDimCoordinate* planeCoordinate, const Options* pOptions) override;
+            std::vector<std::shared_ptr<libCZI::IBitmapData>> GetMultiplePlanes(libCZI::PixelType pixeltype, const libCZI::IntRectAndFrameOfReference& roi, const std::vector<libCZI::CDimCoordinate>& planeCoordinates, const Options* pOptions) override;
         private:
             void InternalGet(int xPos, int yPos, libCZI::IBitmapData* pBm, const libCZI::IDimCoordinate* planeCoordinate, const libCZI::ISingleChannelTileAccessor::Options* pOptions);
             void GetAllSubBlocks(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const std::function<void(int index, int mIndex)>& appender) const;
@@ -35,7 +36,17 @@ namespace libCZI
             };
 
             std::vector<CSingleChannelTileAccessor::IndexAndM> GetSubBlocksSubset(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, bool sortByM);
+            static void SortByM(std::vector<IndexAndM>& subBlocksSet);
             void ComposeTiles(libCZI::IBitmapData* pBm, int xPos, int yPos, const std::vector<IndexAndM>& subBlocksSet, const libCZI::ISingleChannelTileAccessor::Options& options);
+
+            /// Draws the subblocks with the numbers "first" to "first+count-1" (as given by the loader) into the specified bitmap.
+            void ComposeTiles(libCZI::IBitmapData* pBm, int xPos, int yPos, SubBlockDataLoader& loader, int first, int count, const libCZI::ISingleChannelTileAccessor::Options& options);
+
+            /// Determines the subblocks (from the specified set) which are to be drawn, in the order in which they are to be drawn. If the
+            /// visibility-check-optimization is enabled, only the subblocks which are visible in the specified ROI are returned.
+            std::vector<int> DetermineSubBlocksToDraw(const libCZI::IntRect& roi, const std::vector<IndexAndM>& subBlocksSet, const libCZI::ISingleChannelTileAccessor::Options& options);
+
+            SubBlockData LoadSubBlockData(int subBlockIndex, const libCZI::ISingleChannelTileAccessor::Options& options);
         };
 
     } // namespace detail
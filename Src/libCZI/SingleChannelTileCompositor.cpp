@@ -6,6 +6,13 @@
 #include "SingleChannelTileCompositor.h"
 #include "BitmapOperations.h"
 #include "BitmapOperationsBitonal.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace libCZI;
 using namespace libCZI::detail;
@@ -71,6 +78,213 @@ using namespace libCZI::detail;
     BitmapOperationsBitonal::CopyWithOffsetAndMask(info);
 }
 
+namespace
+{
+    /// A tile which has been retrieved for composition - the bitmap (and the mask) are locked for as long as this object exists.
+    struct LockedTile
+    {
+        std::shared_ptr<libCZI::IBitmapData> bitmap;
+        std::shared_ptr<libCZI::IBitonalBitmapData> mask;
+        std::unique_ptr<ScopedBitmapLockerSP> bitmap_locker;
+        std::unique_ptr<ScopedBitonalBitmapLockerSP> mask_locker;
+        int x;                                  ///< The x-position of the tile relative to the destination.
+        int y;                                  ///< The y-position of the tile relative to the destination.
+        std::atomic<int> bands_pending{ 0 };    ///< The number of bands which have not yet drawn this tile.
+    };
+
+    /// Draws the specified tile into the specified horizontal band of the (locked) destination.
+    void ComposeTileIntoBand(const LockedTile& tile, const ScopedBitmapLockerP& destination_locker, libCZI::PixelType destination_pixel_type, int destination_width, int band_y, int band_height)
+    {
+        BitmapOperationsBitonal::CopyWithOffsetAndMaskInfo info;
+        info.xOffset = tile.x;
+        info.yOffset = tile.y - band_y;
+        info.srcPixelType = tile.bitmap->GetPixelType();
+        info.srcPtr = tile.bitmap_locker->ptrDataRoi;
+        info.srcStride = tile.bitmap_locker->stride;
+        info.srcWidth = tile.bitmap->GetWidth();
+        info.srcHeight = tile.bitmap->GetHeight();
+
+        // the band is addressed as a bitmap of its own, which starts at the line "band_y" of the destination
+        info.dstPixelType = destination_pixel_type;
+        info.dstPtr = static_cast<char*>(destination_locker.ptrDataRoi) + band_y * static_cast<size_t>(destination_locker.stride);
+        info.dstStride = destination_locker.stride;
+        info.dstWidth = destination_width;
+        info.dstHeight = band_height;
+
+        info.drawTileBorder = false;
+
+        if (tile.mask)
+        {
+            info.maskPtr = tile.mask_locker->ptrData;
+            info.maskStride = tile.mask_locker->stride;
+            info.maskWidth = tile.mask->GetWidth();
+            info.maskHeight = tile.mask->GetHeight();
+        }
+        else
+        {
+            info.maskPtr = nullptr;
+            info.maskStride = info.maskWidth = info.maskHeight = 0;
+        }
+
+        BitmapOperationsBitonal::CopyWithOffsetAndMask(info);
+    }
+
+    /// Gets the number of horizontal bands to use for composing - this is the requested number of threads, clamped to the number
+    /// of hardware threads and to the number of rows of the destination.
+    ///
+    /// \param requested_thread_count  The requested number of threads (c.f. ComposeSingleTileOptions::composeThreadCount).
+    /// \param destination_height      The height of the destination.
+    ///
+    /// \returns The number of bands to use - if this is less than 2, the composition should be done in the calling thread.
+    std::uint32_t GetNumberOfBandsForComposing(std::uint32_t requested_thread_count, std::uint32_t destination_height)
+    {
+        std::uint32_t band_count = (std::min)(requested_thread_count, destination_height);
+        const std::uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+        if (hardware_thread_count > 0)
+        {
+            band_count = (std::min)(band_count, hardware_thread_count);
+        }
+
+        return band_count;
+    }
+
+    /// Composes the tiles with the specified number of horizontal bands, each of which is drawn by its own worker thread. The tiles are
+    /// retrieved in the calling thread and are put into a list, from which every band takes them in order (so that the Z-order is the
+    /// same as with sequential composition) and draws the part of the tile which falls into the band. A tile is released when all bands
+    /// have processed it, and the number of tiles which have been retrieved but not yet released is limited (so that the memory usage
+    /// is bounded).
+    void ComposeSingleChannelTilesMaskAwareInBands(
+        const std::function<bool(int, std::shared_ptr<libCZI::IBitmapData>&, std::shared_ptr<libCZI::IBitonalBitmapData>&, int&, int&)>& getTilesAndMask,
+        libCZI::IBitmapData* dest,
+        int xPos,
+        int yPos,
+        std::uint32_t number_of_bands)
+    {
+        const IntSize destination_size = dest->GetSize();
+        const int band_count = static_cast<int>(number_of_bands);
+        const int max_tiles_in_flight = 4 * band_count;
+        const ScopedBitmapLockerP destination_locker{ dest };
+
+        std::mutex mutex;
+        std::condition_variable tile_added;
+        std::condition_variable tile_released;
+        std::vector<std::shared_ptr<LockedTile>> tiles;     // guarded by mutex, a tile is reset when all bands have drawn it
+        int tiles_in_flight = 0;                            // guarded by mutex
+        bool all_tiles_retrieved = false;                   // guarded by mutex
+        std::exception_ptr exception;                       // guarded by mutex
+
+        const auto band_worker = [&](int band_y, int band_height)->void
+        {
+            for (size_t next_tile = 0;; ++next_tile)
+            {
+                std::shared_ptr<LockedTile> tile;
+                {
+                    std::unique_lock<std::mutex> lck(mutex);
+                    tile_added.wait(lck, [&] { return next_tile < tiles.size() || all_tiles_retrieved; });
+                    if (next_tile >= tiles.size())
+                    {
+                        return;
+                    }
+
+                    tile = tiles[next_tile];
+                }
+
+                try
+                {
+                    // tiles which do not intersect with the band are skipped
+                    if (tile->y < band_y + band_height && tile->y + static_cast<int>(tile->bitmap->GetHeight()) > band_y)
+                    {
+                        ComposeTileIntoBand(*tile, destination_locker, dest->GetPixelType(), static_cast<int>(destination_size.w), band_y, band_height);
+                    }
+                }
+                catch (...)
+                {
+                    // we continue with the other tiles (so that they get released), the exception is rethrown in the calling thread
+                    std::lock_guard<std::mutex> lck(mutex);
+                    if (!exception)
+                    {
+                        exception = std::current_exception();
+                    }
+                }
+
+                if (--tile->bands_pending == 0)
+                {
+                    std::lock_guard<std::mutex> lck(mutex);
+                    tiles[next_tile].reset();
+                    --tiles_in_flight;
+                    tile_released.notify_one();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(band_count);
+        for (int i = 0; i < band_count; ++i)
+        {
+            const int band_y = static_cast<int>(static_cast<std::uint64_t>(destination_size.h) * i / band_count);
+            const int band_end = static_cast<int>(static_cast<std::uint64_t>(destination_size.h) * (i + 1) / band_count);
+            threads.emplace_back(band_worker, band_y, band_end - band_y);
+        }
+
+        const auto stop_workers = [&]()->void
+        {
+            {
+                std::lock_guard<std::mutex> lck(mutex);
+                all_tiles_retrieved = true;
+            }
+
+            tile_added.notify_all();
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        };
+
+        try
+        {
+            for (int i = 0;; ++i)
+            {
+                auto tile = std::make_shared<LockedTile>();
+                int posXTile, posYTile;
+                if (!getTilesAndMask(i, tile->bitmap, tile->mask, posXTile, posYTile))
+                {
+                    break;
+                }
+
+                tile->x = posXTile - xPos;
+                tile->y = posYTile - yPos;
+                tile->bitmap_locker.reset(new ScopedBitmapLockerSP(tile->bitmap));
+                if (tile->mask)
+                {
+                    tile->mask_locker.reset(new ScopedBitonalBitmapLockerSP(tile->mask));
+                }
+
+                tile->bands_pending = band_count;
+
+                {
+                    std::unique_lock<std::mutex> lck(mutex);
+                    tile_released.wait(lck, [&] { return tiles_in_flight < max_tiles_in_flight; });
+                    tiles.emplace_back(std::move(tile));
+                    ++tiles_in_flight;
+                }
+
+                tile_added.notify_all();
+            }
+        }
+        catch (...)
+        {
+            stop_workers();
+            throw;
+        }
+
+        stop_workers();
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
 /*-----------------------------------------------------------------------------------------------*/
 
 /*static*/void libCZI::Compositors::ComposeSingleChannelTiles(
@@ -88,6 +302,22 @@ using namespace libCZI::detail;
         return;
     }
 
+    const std::uint32_t band_count = pOptions->drawTileBorder ? 1 : GetNumberOfBandsForComposing(pOptions->composeThreadCount, dest->GetHeight());
+    if (band_count > 1)
+    {
+        ComposeSingleChannelTilesMaskAwareInBands(
+            [&](int index, std::shared_ptr<libCZI::IBitmapData>& src, std::shared_ptr<libCZI::IBitonalBitmapData>& src_mask, int& x, int& y)->bool
+            {
+                src_mask.reset();
+                return getTiles(index, src, x, y);
+            },
+            dest,
+            xPos,
+            yPos,
+            band_count);
+        return;
+    }
+
     for (int i = 0;; ++i)
     {
         int posXTile, posYTile;
@@ -118,6 +348,13 @@ using namespace libCZI::detail;
         return;
     }
 
+    const std::uint32_t band_count = pOptions->drawTileBorder ? 1 : GetNumberOfBandsForComposing(pOptions->composeThreadCount, dest->GetHeight());
+    if (band_count > 1)
+    {
+        ComposeSingleChannelTilesMaskAwareInBands(getTilesAndMask, dest, xPos, yPos, band_count);
+        return;
+    }
+
     for (int i = 0;; ++i)
     {
         int posXTile, posYTile;
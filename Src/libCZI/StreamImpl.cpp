@@ -162,6 +162,17 @@ CStreamImplInMemory::CStreamImplInMemory(libCZI::IAttachment* attachement)
     }
 }
 
+/*virtual*/std::shared_ptr<const void> CStreamImplInMemory::TryGetMemory(std::uint64_t offset, std::uint64_t size)
+{
+    if (offset > this->dataBufferSize || size > this->dataBufferSize - offset)
+    {
+        return nullptr;
+    }
+
+    // use the aliasing constructor, so that the returned pointer keeps the buffer alive
+    return std::shared_ptr<const void>(this->rawData, static_cast<const char*>(this->rawData.get()) + offset);
+}
+
 //----------------------------------------------------------------------------
 CSimpleOutputStreamStreams::CSimpleOutputStreamStreams(const wchar_t* filename, bool overwriteExisting) : fp(nullptr)
 {
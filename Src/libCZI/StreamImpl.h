@@ -61,7 +61,7 @@ namespace libCZI
 #endif
 
         /// <summary>   A stream implementation (based on a memory-block). </summary>
-        class CStreamImplInMemory : public libCZI::IStream
+        class CStreamImplInMemory : public libCZI::IStream, public libCZI::IDirectMemoryAccessStream
         {
         private:
             std::shared_ptr<const void> rawData;
@@ -72,6 +72,8 @@ namespace libCZI
             explicit CStreamImplInMemory(libCZI::IAttachment* attachement);
         public: // interface libCZI::IStream
             void Read(std::uint64_t offset, void* pv, std::uint64_t size, std::uint64_t* ptrBytesRead) override;
+        public: // interface libCZI::IDirectMemoryAccessStream
+            std::shared_ptr<const void> TryGetMemory(std::uint64_t offset, std::uint64_t size) override;
         };
 
 #if LIBCZI_USE_PREADPWRITEBASED_STREAMIMPL
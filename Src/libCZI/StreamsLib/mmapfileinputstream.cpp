@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "mmapfileinputstream.h"
+
+#if LIBCZI_USE_PREADPWRITEBASED_STREAMIMPL
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cstring>
+#include <limits>
+
+#include "../utilities.h"
+
+using namespace libCZI;
+using namespace libCZI::detail;
+
+MmapFileInputStream::MmapFileInputStream(const std::string& filename) : fileSize(0)
+{
+    const int fileDescriptor = open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        auto err = errno;
+        std::stringstream ss;
+        ss << "Error opening the file \"" << filename << "\" -> errno=" << err << " (" << strerror(err) << ")";
+        throw std::runtime_error(ss.str());
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        auto err = errno;
+        close(fileDescriptor);
+        std::stringstream ss;
+        ss << "Error determining the size of the file \"" << filename << "\" -> errno=" << err << " (" << strerror(err) << ")";
+        throw std::runtime_error(ss.str());
+    }
+
+    this->fileSize = static_cast<std::uint64_t>(fileStatus.st_size);
+    if (this->fileSize > (std::numeric_limits<size_t>::max)())
+    {
+        // this can only happen on a 32-bit platform - the file cannot be mapped as a whole then (and the size of the mapping
+        //  would be truncated), so the regular file stream has to be used instead
+        close(fileDescriptor);
+        std::stringstream ss;
+        ss << "The file \"" << filename << "\" is too large to be memory-mapped (size=" << this->fileSize << " bytes).";
+        throw std::runtime_error(ss.str());
+    }
+
+    if (this->fileSize > 0)
+    {
+        void* ptr = mmap(nullptr, static_cast<size_t>(this->fileSize), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (ptr == MAP_FAILED)
+        {
+            auto err = errno;
+            close(fileDescriptor);
+            std::stringstream ss;
+            ss << "Error memory-mapping the file \"" << filename << "\" -> errno=" << err << " (" << strerror(err) << ")";
+            throw std::runtime_error(ss.str());
+        }
+
+        const size_t sizeOfMapping = static_cast<size_t>(this->fileSize);
+        this->mapping = std::shared_ptr<const void>(ptr, [sizeOfMapping](void* p) { munmap(p, sizeOfMapping); });
+    }
+
+    // the mapping remains valid after the file descriptor is closed
+    close(fileDescriptor);
+}
+
+MmapFileInputStream::MmapFileInputStream(const wchar_t* filename)
+    : MmapFileInputStream(Utilities::convertWchar_tToUtf8(filename))
+{
+}
+
+/*virtual*/void MmapFileInputStream::Read(std::uint64_t offset, void* pv, std::uint64_t size, std::uint64_t* ptrBytesRead)
+{
+    std::uint64_t sizeToCopy = 0;
+    if (offset < this->fileSize)
+    {
+        sizeToCopy = (std::min)(size, this->fileSize - offset);
+        std::memcpy(pv, static_cast<const std::uint8_t*>(this->mapping.get()) + offset, static_cast<size_t>(sizeToCopy));
+    }
+
+    if (ptrBytesRead != nullptr)
+    {
+        *ptrBytesRead = sizeToCopy;
+    }
+}
+
+/*virtual*/std::shared_ptr<const void> MmapFileInputStream::TryGetMemory(std::uint64_t offset, std::uint64_t size)
+{
+    if (!this->mapping || offset > this->fileSize || size > this->fileSize - offset)
+    {
+        return nullptr;
+    }
+
+    // use the aliasing constructor, so that the returned pointer keeps the mapping alive
+    return std::shared_ptr<const void>(this->mapping, static_cast<const std::uint8_t*>(this->mapping.get()) + offset);
+}
+
+#endif // LIBCZI_USE_PREADPWRITEBASED_STREAMIMPL
@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+#include <libCZI_Config.h>
+
+#if LIBCZI_USE_PREADPWRITEBASED_STREAMIMPL
+#include "../libCZI.h"
+
+namespace libCZI
+{
+    namespace detail
+    {
+        /// Implementation of the IStream-interface for files based on memory-mapping the file (with the mmap-API).
+        /// The whole file is mapped (read-only) into the address space when the stream is constructed. This stream
+        /// implements the IDirectMemoryAccessStream-interface, so the data of sub-blocks is not copied, but referenced
+        /// directly in the mapping. The mapping is kept alive for as long as there are references to it, i.e. it may
+        /// outlive the stream object. If the size of the file exceeds the range of size_t (which is only possible on a 32-bit
+        /// platform), the file cannot be mapped and the constructor throws a runtime_error.
+        class MmapFileInputStream : public libCZI::IStream, public libCZI::IDirectMemoryAccessStream
+        {
+        private:
+            std::shared_ptr<const void> mapping;
+            std::uint64_t fileSize;
+        public:
+            MmapFileInputStream() = delete;
+            explicit MmapFileInputStream(const wchar_t* filename);
+            explicit MmapFileInputStream(const std::string& filename);
+            ~MmapFileInputStream() override = default;
+        public: // interface libCZI::IStream
+            void Read(std::uint64_t offset, void* pv, std::uint64_t size, std::uint64_t* ptrBytesRead) override;
+        public: // interface libCZI::IDirectMemoryAccessStream
+            std::shared_ptr<const void> TryGetMemory(std::uint64_t offset, std::uint64_t size) override;
+        };
+    }   // namespace detail
+}   // namespace libCZI
+
+#endif
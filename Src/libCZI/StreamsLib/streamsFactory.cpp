@@ -12,6 +12,7 @@
 #include "uwpfileinputstream.h"
 #include "simplefileinputstream.h"
 #include "preadfileinputstream.h"
+#include "mmapfileinputstream.h"
 #include "azureblobinputstream.h"
 #include "../utilities.h"
 
@@ -98,6 +99,15 @@ static const struct
             },
             nullptr
         },
+        {
+            { "mmap_file_inputstream", "stream implementation based on memory-mapping the file (mmap-API)", nullptr, nullptr },
+            [](const StreamsFactory::CreateStreamInfo& stream_info, const std::string& file_name) -> std::shared_ptr<libCZI::IStream>
+            {
+                (void)stream_info;
+                return std::make_shared<MmapFileInputStream>(file_name);
+            },
+            nullptr
+        },
 #endif // LIBCZI_USE_PREADPWRITEBASED_STREAMIMPL
         {
             { "c_runtime_file_inputstream", "stream implementation based on C-runtime library", nullptr, nullptr },
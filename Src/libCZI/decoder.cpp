@@ -8,6 +8,10 @@
 #include "stdAllocator.h"
 #include "BitmapOperations.h"
 #include "Site.h"
+#include "utilities.h"
+#include <cstring>
+#include <sstream>
+#include <string>
 
 using namespace libCZI;
 using namespace libCZI::detail;
@@ -33,6 +37,8 @@ static libCZI::PixelType PixelTypeFromJxrPixelFormat(JxrDecode::PixelFormat pixe
     }
 }
 
+/*static*/const char* CJxrLibDecoder::kOption_max_decode_threads = "max_decode_threads";
+
 /*static*/std::shared_ptr<CJxrLibDecoder> CJxrLibDecoder::Create()
 {
     return make_shared<CJxrLibDecoder>();
@@ -40,7 +46,8 @@ static libCZI::PixelType PixelTypeFromJxrPixelFormat(JxrDecode::PixelFormat pixe
 
 std::shared_ptr<libCZI::IBitmapData> CJxrLibDecoder::Decode(const void* ptrData, size_t size, const libCZI::PixelType* pixelType, const uint32_t* width, const uint32_t* height, const char* additional_arguments)
 {
-    (void)additional_arguments;
+    uint32_t max_decode_threads = 1;
+    Utilities::TryGetUnsignedIntegerOption(additional_arguments, kOption_max_decode_threads, max_decode_threads);
 
     std::shared_ptr<IBitmapData> bitmap;
     bool bitmap_is_locked = false;
@@ -84,7 +91,8 @@ std::shared_ptr<libCZI::IBitmapData> CJxrLibDecoder::Decode(const void* ptrData,
                 const auto lock_info = bitmap->Lock();
                 bitmap_is_locked = true;
                 return make_tuple(lock_info.ptrDataRoi, lock_info.stride);
-            });
+            },
+            max_decode_threads);
     }
     catch (const std::exception& e)
     {
@@ -17,6 +17,10 @@ namespace libCZI
         class CJxrLibDecoder : public libCZI::IDecoder
         {
         public:
+            /// The key for the option specifying the maximum number of threads to be used for decoding. The option is given
+            /// in the "additional_arguments" as "max_decode_threads=<number>" (in a semicolon-separated list).
+            static const char* kOption_max_decode_threads;
+
             static std::shared_ptr<CJxrLibDecoder> Create();
 
             std::shared_ptr<libCZI::IBitmapData> Decode(const void* ptrData, size_t size, const libCZI::PixelType* pixelType, const std::uint32_t* width, const std::uint32_t* height, const char* additional_arguments) override;
@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "decoder_jpg.h"
+#include "inc_libCZI_Config.h"
+#include <cstdio>
+#include <csetjmp>
+#include <sstream>
+#include <stdexcept>
+#if LIBCZI_LIBJPEG_BASED_DECODER_AVAILABLE
+#include <jpeglib.h>
+#endif
+#include "bitmapData.h"
+#include "Site.h"
+#include "utilities.h"
+#include "libCZI_Utilities.h"
+
+using namespace std;
+using namespace libCZI;
+using namespace libCZI::detail;
+
+/*static*/const char* CJpgLibJpegDecoder::kOption_scale_denominator = "scale_denominator";
+
+#if LIBCZI_LIBJPEG_BASED_DECODER_AVAILABLE
+
+namespace
+{
+    /// The libjpeg-library reports errors by calling the "error_exit"-function, which must not return. We
+    /// use the standard approach of doing a longjmp back to the caller. In order to be safe with this, the
+    /// functions which call into libjpeg (and have a setjmp) must not have local objects with non-trivial
+    /// destructors - so, those functions only report success or failure, and the exception is thrown by
+    /// the caller.
+    struct ErrorManager
+    {
+        struct jpeg_error_mgr pub;
+        jmp_buf setjmp_buffer;
+        char message[JMSG_LENGTH_MAX];
+    };
+
+    void ErrorExit(j_common_ptr cinfo)
+    {
+        ErrorManager* error_manager = reinterpret_cast<ErrorManager*>(cinfo->err);
+        (*cinfo->err->format_message)(cinfo, error_manager->message);
+        longjmp(error_manager->setjmp_buffer, 1);
+    }
+
+    void OutputMessage(j_common_ptr cinfo)
+    {
+        // we do not want warnings to be printed to stderr
+        (void)cinfo;
+    }
+
+    bool ReadHeader(jpeg_decompress_struct* cinfo, ErrorManager* error_manager, const void* ptrData, size_t size)
+    {
+        if (setjmp(error_manager->setjmp_buffer))
+        {
+            return false;
+        }
+
+        jpeg_mem_src(cinfo, static_cast<unsigned char*>(const_cast<void*>(ptrData)), static_cast<unsigned long>(size));
+        jpeg_read_header(cinfo, TRUE);
+        return true;
+    }
+
+    bool StartDecompress(jpeg_decompress_struct* cinfo, ErrorManager* error_manager)
+    {
+        if (setjmp(error_manager->setjmp_buffer))
+        {
+            return false;
+        }
+
+        jpeg_start_decompress(cinfo);
+        return true;
+    }
+
+    bool ReadScanlinesAndFinish(jpeg_decompress_struct* cinfo, ErrorManager* error_manager, std::uint8_t* ptrDestination, std::uint32_t stride)
+    {
+        if (setjmp(error_manager->setjmp_buffer))
+        {
+            return false;
+        }
+
+        // libjpeg delivers at most "rec_outbuf_height" lines per call (which is 1, 2 or 4), so
+        //  we pass in pointers for up to 4 lines
+        JSAMPROW rows[4];
+        while (cinfo->output_scanline < cinfo->output_height)
+        {
+            const JDIMENSION lines_to_read = (min)(static_cast<JDIMENSION>(4), cinfo->output_height - cinfo->output_scanline);
+            for (JDIMENSION i = 0; i < lines_to_read; ++i)
+            {
+                rows[i] = ptrDestination + static_cast<size_t>(cinfo->output_scanline + i) * stride;
+            }
+
+            jpeg_read_scanlines(cinfo, rows, lines_to_read);
+        }
+
+        jpeg_finish_decompress(cinfo);
+        return true;
+    }
+
+    void ThrowDecodeError(const char* operation, const ErrorManager& error_manager)
+    {
+        ostringstream ss;
+        ss << "JPG decoding failed (" << operation << "): " << error_manager.message;
+        throw runtime_error(ss.str());
+    }
+
+#if !defined(JCS_EXTENSIONS)
+    void SwapRedAndBlue(std::uint32_t width, std::uint32_t height, std::uint8_t* ptr, std::uint32_t stride)
+    {
+        for (std::uint32_t y = 0; y < height; ++y)
+        {
+            std::uint8_t* p = ptr + static_cast<size_t>(y) * stride;
+            for (std::uint32_t x = 0; x < width; ++x)
+            {
+                std::swap(p[0], p[2]);
+                p += 3;
+            }
+        }
+    }
+#endif
+
+    /// This class guarantees that the decompress-object is destroyed.
+    struct DecompressObjectGuard
+    {
+        jpeg_decompress_struct* cinfo;
+
+        explicit DecompressObjectGuard(jpeg_decompress_struct* cinfo) : cinfo(cinfo)
+        {
+        }
+
+        ~DecompressObjectGuard()
+        {
+            jpeg_destroy_decompress(this->cinfo);
+        }
+
+        DecompressObjectGuard(const DecompressObjectGuard&) = delete;
+        DecompressObjectGuard& operator=(const DecompressObjectGuard&) = delete;
+    };
+}
+
+/*static*/std::shared_ptr<CJpgLibJpegDecoder> CJpgLibJpegDecoder::Create()
+{
+    return make_shared<CJpgLibJpegDecoder>();
+}
+
+std::shared_ptr<libCZI::IBitmapData> CJpgLibJpegDecoder::Decode(const void* ptrData, size_t size, const libCZI::PixelType* pixelType, const std::uint32_t* width, const std::uint32_t* height, const char* additional_arguments)
+{
+    if (ptrData == nullptr || size == 0)
+    {
+        throw invalid_argument("No data given for JPG decoding.");
+    }
+
+    if (pixelType != nullptr && *pixelType != PixelType::Gray8 && *pixelType != PixelType::Bgr24)
+    {
+        ostringstream ss;
+        ss << "JPG decoding is not supported for pixel type \"" << Utils::PixelTypeToInformalString(*pixelType) << "\"";
+        throw invalid_argument(ss.str());
+    }
+
+    uint32_t scale_denominator = 1;
+    Utilities::TryGetUnsignedIntegerOption(additional_arguments, kOption_scale_denominator, scale_denominator);
+    if (scale_denominator != 1 && scale_denominator != 2 && scale_denominator != 4 && scale_denominator != 8)
+    {
+        ostringstream ss;
+        ss << "Invalid scale denominator " << scale_denominator << " (must be 1, 2, 4 or 8).";
+        throw invalid_argument(ss.str());
+    }
+
+    jpeg_decompress_struct cinfo;
+    ErrorManager error_manager;
+    cinfo.err = jpeg_std_error(&error_manager.pub);
+    error_manager.pub.error_exit = ErrorExit;
+    error_manager.pub.output_message = OutputMessage;
+    jpeg_create_decompress(&cinfo);
+    DecompressObjectGuard decompress_object_guard(&cinfo);
+
+    if (!ReadHeader(&cinfo, &error_manager, ptrData, size))
+    {
+        ThrowDecodeError("reading header", error_manager);
+    }
+
+    PixelType pixel_type_of_bitmap;
+    if (pixelType != nullptr)
+    {
+        pixel_type_of_bitmap = *pixelType;
+    }
+    else
+    {
+        pixel_type_of_bitmap = cinfo.num_components == 1 ? PixelType::Gray8 : PixelType::Bgr24;
+    }
+
+    if (cinfo.jpeg_color_space == JCS_CMYK || cinfo.jpeg_color_space == JCS_YCCK)
+    {
+        throw runtime_error("JPG decoding failed: CMYK-encoded images are not supported.");
+    }
+
+    if (pixel_type_of_bitmap == PixelType::Gray8)
+    {
+        cinfo.out_color_space = JCS_GRAYSCALE;
+    }
+    else
+    {
+#if defined(JCS_EXTENSIONS)
+        cinfo.out_color_space = JCS_EXT_BGR;
+#else
+        cinfo.out_color_space = JCS_RGB;
+#endif
+    }
+
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = scale_denominator;
+    cinfo.dct_method = JDCT_ISLOW;
+    if (!StartDecompress(&cinfo, &error_manager))
+    {
+        ThrowDecodeError("starting decompression", error_manager);
+    }
+
+    if (width != nullptr && cinfo.output_width != *width)
+    {
+        ostringstream ss;
+        ss << "width mismatch: expected " << *width << ", but got " << cinfo.output_width;
+        throw logic_error(ss.str());
+    }
+
+    if (height != nullptr && cinfo.output_height != *height)
+    {
+        ostringstream ss;
+        ss << "height mismatch: expected " << *height << ", but got " << cinfo.output_height;
+        throw logic_error(ss.str());
+    }
+
+    auto bitmap = GetSite()->CreateBitmap(pixel_type_of_bitmap, cinfo.output_width, cinfo.output_height);
+    {
+        const ScopedBitmapLockerSP bitmap_locker{ bitmap };
+        if (!ReadScanlinesAndFinish(&cinfo, &error_manager, static_cast<uint8_t*>(bitmap_locker.ptrDataRoi), bitmap_locker.stride))
+        {
+            ThrowDecodeError("reading scanlines", error_manager);
+        }
+
+#if !defined(JCS_EXTENSIONS)
+        if (pixel_type_of_bitmap == PixelType::Bgr24)
+        {
+            SwapRedAndBlue(cinfo.output_width, cinfo.output_height, static_cast<uint8_t*>(bitmap_locker.ptrDataRoi), bitmap_locker.stride);
+        }
+#endif
+    }
+
+    return bitmap;
+}
+
+#endif
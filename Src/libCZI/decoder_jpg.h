@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include <memory>
+#include "libCZI_Pixels.h"
+#include "libCZI_Site.h"
+
+namespace libCZI
+{
+    namespace detail
+    {
+        /// Decoder for JPG-compressed images, based on the libjpeg-library. If libjpeg-turbo is used, then
+        /// the IDCT and the color conversion are SIMD-accelerated. Note that this decoder is only operational
+        /// if libCZI is built with libjpeg-support (i.e. LIBCZI_LIBJPEG_BASED_DECODER_AVAILABLE is 1).
+        class CJpgLibJpegDecoder : public libCZI::IDecoder
+        {
+        public:
+            /// The key for the option specifying that the image is to be decoded at a reduced resolution. The option is given
+            /// in the "additional_arguments" as "scale_denominator=<number>" (in a semicolon-separated list), where the number
+            /// must be 1, 2, 4 or 8. The downscaling is done in the DCT-domain, which is considerably faster than decoding the
+            /// image at full resolution and downscaling it afterwards. The size of the resulting bitmap is the size of the image
+            /// divided by the denominator, rounded up.
+            static const char* kOption_scale_denominator;
+
+            static std::shared_ptr<CJpgLibJpegDecoder> Create();
+
+            /// Passing in a block of JPG-compressed data, decode the image and return a bitmap object.
+            /// If `pixelType` is given, it must be either Gray8 or Bgr24, and the image is converted into this pixel type (i.e. a
+            /// color image can be decoded into a Gray8-bitmap and vice versa). If it is not given, then the pixel type is chosen
+            /// according to the number of components in the compressed data. The `width` and `height` parameters (if given)
+            /// refer to the size of the resulting bitmap, i.e. to the size after a downscaling has been applied.
+            ///
+            /// \param ptrData              Pointer to a block of memory (which contains the JPG-compressed data).
+            /// \param size                 The size of the memory block pointed by `ptrData`.
+            /// \param pixelType            If non-null, the pixel type of the expected bitmap.
+            /// \param width                If non-null, the width of the expected bitmap.
+            /// \param height               If non-null, the height of the expected bitmap.
+            /// \param additional_arguments If non-null, additional arguments for the decoder.
+            ///
+            /// \return A bitmap object with the decoded data.
+            std::shared_ptr<libCZI::IBitmapData> Decode(const void* ptrData, size_t size, const libCZI::PixelType* pixelType, const std::uint32_t* width, const std::uint32_t* height, const char* additional_arguments) override;
+
+            std::shared_ptr<libCZI::IBitmapData> Decode(const void* ptrData, size_t size, libCZI::PixelType pixelType, std::uint32_t width, std::uint32_t height, const char* additional_arguments = nullptr)
+            {
+                return this->Decode(ptrData, size, &pixelType, &width, &height, additional_arguments);
+            }
+        };
+    } // namespace detail
+} // namespace libCZI
@@ -138,6 +138,21 @@ namespace libCZI
         /// In case of zstd compressed pixel data, apply the resolution protocol for zstd-compressed data.
         /// If false, an exception is thrown  (in case of a discrepancy).
         bool handle_zstd_data_size_mismatch{ true };
+
+        /// The maximum number of threads to be used for decoding JpgXR compressed pixel data. If greater than one, 
+        /// large images are split into horizontal bands which are decoded concurrently. Note that this option is
+        /// ignored by decoders which do not support multithreaded operation.
+        std::uint32_t jpgxr_max_decode_threads{ 1 };
+
+        /// In case of JPG compressed pixel data, apply the resolution protocol for JPG-compressed data.
+        /// If false, an exception is thrown  (in case of a discrepancy).
+        bool handle_jpg_bitmap_mismatch{ true };
+
+        /// In case of JPG compressed pixel data, the image can be decoded at a reduced resolution, where the width and height
+        /// are divided by this number (and rounded up). Valid values are 1, 2, 4 and 8. The downscaling is done as part of the
+        /// decoding (in the DCT-domain), which is a lot faster than decoding at full resolution. Note that the size of the
+        /// resulting bitmap then does not match the physical size of the sub-block.
+        std::uint32_t jpg_downscale_denominator{ 1 };
     };
 
     /// Creates bitmap from sub block.
@@ -223,6 +238,40 @@ namespace libCZI
     /// \returns    The newly created sub block cache.
     LIBCZI_API std::shared_ptr<ISubBlockCache> CreateSubBlockCache();
 
+    /// Creates a sub block cache object with the specified options.
+    /// \param options Options for the cache (e.g. a capacity which is enforced automatically).
+    /// \returns    The newly created sub block cache.
+    LIBCZI_API std::shared_ptr<ISubBlockCache> CreateSubBlockCache(const SubBlockCacheOptions& options);
+
+    /// Creates a sub block cache object which can be shared between multiple files (c.f. IMultiFileSubBlockCache). The
+    /// options (in particular the capacity) apply to the cache as a whole, i.e. to all files together.
+    /// \param options Options for the cache.
+    /// \returns    The newly created multi-file sub block cache.
+    LIBCZI_API std::shared_ptr<IMultiFileSubBlockCache> CreateMultiFileSubBlockCache(const SubBlockCacheOptions& options);
+
+    /// Creates a cache of rendered accessor results (c.f. IRenderedTileCache). The capacity is enforced with every Add-operation.
+    /// \param capacity The capacity of the cache (where "maxSubBlockCount" gives the maximum number of tiles).
+    /// \returns    The newly created rendered-tile cache.
+    LIBCZI_API std::shared_ptr<IRenderedTileCache> CreateRenderedTileCache(const ISubBlockCacheControl::PruneOptions& capacity);
+
+    /// Creates a prefetcher which loads sub-blocks from the specified repository into the specified cache in the background (c.f. ISubBlockPrefetcher).
+    /// \param repository   The sub-block repository.
+    /// \param cache        The sub-block cache (which is then to be used with the accessors).
+    /// \param options      Options for the prefetcher.
+    /// \returns    The newly created prefetcher.
+    LIBCZI_API std::shared_ptr<ISubBlockPrefetcher> CreateSubBlockPrefetcher(const std::shared_ptr<ISubBlockRepository>& repository, const std::shared_ptr<ISubBlockCacheOperation>& cache, const SubBlockPrefetcherOptions& options);
+
+    /// Creates a plane-tile iterator which produces the tile composites for a regular grid of tiles covering the specified ROI (c.f. IPlaneTileIterator).
+    /// \param repository       The sub-block repository.
+    /// \param pixeltype        The pixeltype of the tiles. If this is PixelType::Invalid, then the pixeltype is determined by examining
+    ///                         an arbitrary sub-block of the plane's channel.
+    /// \param roi              The ROI (in the raw-sub-block-coordinate-system).
+    /// \param planeCoordinate  The plane coordinate.
+    /// \param tileSize         The size of the tiles (width and height must be greater than zero).
+    /// \param options          Options for the iterator.
+    /// \returns    The newly created plane-tile iterator.
+    LIBCZI_API std::shared_ptr<IPlaneTileIterator> CreatePlaneTileIterator(const std::shared_ptr<ISubBlockRepository>& repository, libCZI::PixelType pixeltype, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const libCZI::IntSize& tileSize, const PlaneTileIteratorOptions& options);
+
     /// Creates metadata builder object from the specified UTF8-encoded XML-string. If the XML is
     /// invalid or if the root-node "ImageDocument" is not present, then an exception is thrown.
     /// \param  xml The UTF8-encoded XML string.
@@ -272,6 +321,29 @@ namespace libCZI
         virtual ~IStream() = default;
     };
 
+    /// This is an optional interface which can be implemented by a stream object (in addition to IStream) if the
+    /// stream's data is directly accessible in memory (e.g. a memory-mapped file or an in-memory stream). If a stream
+    /// implements this interface, then libCZI will (where possible) not copy data out of the stream, but instead
+    /// reference the stream's memory directly - e.g. the data of a sub-block is then a view into the stream's memory.
+    /// The presence of this interface is determined by a dynamic_cast of the IStream-object.
+    class IDirectMemoryAccessStream
+    {
+    public:
+        /// Try to get a pointer to the memory which holds the specified range of the stream. The returned shared_ptr
+        /// must keep the memory valid (and unchanged) for as long as it (or a copy of it) is alive, independently of the
+        /// lifetime of the stream object. If the specified range cannot be accessed directly (e.g. because it is beyond
+        /// the end of the stream), then an empty shared_ptr is to be returned, and the caller will then fall back to
+        /// using the Read-method. This method must be thread-safe.
+        ///
+        /// \param offset The offset of the range.
+        /// \param size   The size of the range (in bytes).
+        ///
+        /// \returns A shared_ptr pointing to the memory of the specified range, or an empty shared_ptr if the range is not accessible directly.
+        virtual std::shared_ptr<const void> TryGetMemory(std::uint64_t offset, std::uint64_t size) = 0;
+
+        virtual ~IDirectMemoryAccessStream() = default;
+    };
+
     /// Interface used for writing a data-stream. The abstraction used is:
     /// - It is possible to write to arbitrary positions.  
     /// - The end of the stream is defined by the highest position written to.  
@@ -891,6 +963,13 @@ namespace libCZI
         {
             return std::dynamic_pointer_cast<ISingleChannelScalingTileAccessor, IAccessor>(this->CreateAccessor(libCZI::AccessorType::SingleChannelScalingTileAccessor));
         }
+
+        /// Creates a single channel projection accessor.
+        /// \return The new single channel projection accessor.
+        std::shared_ptr<ISingleChannelProjectionAccessor> CreateSingleChannelProjectionAccessor()
+        {
+            return std::dynamic_pointer_cast<ISingleChannelProjectionAccessor, IAccessor>(this->CreateAccessor(libCZI::AccessorType::SingleChannelProjectionAccessor));
+        }
     };
 }
 
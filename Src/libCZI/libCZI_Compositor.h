@@ -6,23 +6,28 @@
 
 #include "ImportExport.h"
 #include <cstring>
+#include <functional>
 #include <limits>
+#include <string>
 #include <vector>
 #include <memory>
 #include "libCZI_Pixels.h"
 #include "libCZI_Metadata.h"
+#include "libCZI_Utilities.h"
 
 namespace libCZI
 {
     class IBitmapData;
     class IDimCoordinate;
+    class ISubBlock;
 
     /// Values that represent the accessor types.
     enum class AccessorType : std::uint8_t
     {
         SingleChannelTileAccessor,              ///< The single-channel-tile accessor (associated interface: ISingleChannelTileAccessor).
         SingleChannelPyramidLayerTileAccessor,  ///< The single-channel-pyramid-layer-tile accessor (associated interface: ISingleChannelPyramidLayerTileAccessor).
-        SingleChannelScalingTileAccessor        ///< The scaling-single-channel-tile accessor (associated interface: ISingleChannelScalingTileAccessor).
+        SingleChannelScalingTileAccessor,       ///< The scaling-single-channel-tile accessor (associated interface: ISingleChannelScalingTileAccessor).
+        SingleChannelProjectionAccessor         ///< The single-channel-projection accessor (associated interface: ISingleChannelProjectionAccessor).
     };
 
     /// This interface defines how status information about the cache-state can be queried.
@@ -31,6 +36,11 @@ namespace libCZI
     public:
         static constexpr std::uint8_t kMemoryUsage = 1;     ///< Bit-mask identifying the memory-usage field in the statistics struct.
         static constexpr std::uint8_t kElementsCount = 2;   ///< Bit-mask identifying the elements-count field in the statistics struct.
+        static constexpr std::uint8_t kCounters = 4;        ///< Bit-mask identifying the counters (hits, misses, insertions, evictions and bytesEvicted) in the statistics struct.
+        static constexpr std::uint8_t kLoadLatencyHistogram = 8;    ///< Bit-mask identifying the load-latency histogram in the statistics struct.
+
+        /// The number of buckets of the load-latency histogram.
+        static constexpr int kLoadLatencyHistogramBucketCount = 24;
 
         /// This struct defines the statistics which can be queried from the cache. There is a bitfield which
         /// defines which elements are valid. If the bit is set, then the corresponding member is valid.
@@ -44,11 +54,39 @@ namespace libCZI
 
             /// The number of elements in the cache. This field is only valid if the bit kElementsCount is set in the validityMask.
             std::uint32_t elementsCount;
+
+            /// The number of lookups which found the requested element in the cache (including lookups which waited for a
+            /// concurrent load-operation of the same element). This field is only valid if the bit kCounters is set in the validityMask.
+            std::uint64_t hits;
+
+            /// The number of lookups which did not find the requested element in the cache. This field is only valid if the
+            /// bit kCounters is set in the validityMask.
+            std::uint64_t misses;
+
+            /// The number of elements which have been added to the cache (not counting the replacement of an existing element, and
+            /// not counting elements which were rejected by the admission policy). This field is only valid if the bit kCounters
+            /// is set in the validityMask.
+            std::uint64_t insertions;
+
+            /// The number of elements which have been evicted from the cache (because of the capacity or because of a Prune-operation).
+            /// This field is only valid if the bit kCounters is set in the validityMask.
+            std::uint64_t evictions;
+
+            /// The sum of the sizes (in bytes) of the evicted elements. This field is only valid if the bit kCounters is set
+            /// in the validityMask.
+            std::uint64_t bytesEvicted;
+
+            /// A histogram of the durations of the load-operations (c.f. ISubBlockCacheOperation::GetOrLoad). The first bucket
+            /// counts loads which took less than one microsecond, and bucket i (for i>0) counts loads which took at least 2^(i-1)
+            /// and less than 2^i microseconds - with the exception of the last bucket, which counts all loads which took longer. This
+            /// field is only valid if the bit kLoadLatencyHistogram is set in the validityMask.
+            std::uint64_t loadLatencyHistogram[kLoadLatencyHistogramBucketCount];
         };
 
         /// Gets momentarily valid statistics about the cache. The mask defines which statistic/s is/are to be retrieved.
         /// In case of multiple fields being requested, it is guaranteed that all requested fields are a transactional 
-        /// snapshot of the state.
+        /// snapshot of the state - with the exception of the counters and the load-latency histogram, which are updated
+        /// without a lock (and therefore may be slightly ahead of or behind the other fields).
         ///
         /// \param  mask A bitmask specifying which fields are requested. Only the fields requested are guaranteed to be valid
         ///              in the returned struct.
@@ -56,6 +94,19 @@ namespace libCZI
         /// \returns A consistent snapshot of the statistics.
         virtual Statistics GetStatistics(std::uint8_t mask) const = 0;
 
+        /// Gets the statistics (in the same way as GetStatistics), and resets the counters and the load-latency histogram (as far
+        /// as they are requested by the mask) to zero. The reset happens atomically for each value, so no event is lost or counted
+        /// twice if this method is called periodically (e.g. in order to report the hit rate for an interval). The default
+        /// implementation does not reset anything.
+        ///
+        /// \param  mask A bitmask specifying which fields are requested.
+        ///
+        /// \returns The statistics.
+        virtual Statistics GetStatisticsAndResetCounters(std::uint8_t mask)
+        {
+            return this->GetStatistics(mask);
+        }
+
         virtual ~ISubBlockCacheStatistics() = default;
 
         ISubBlockCacheStatistics() = default;
@@ -90,7 +141,7 @@ namespace libCZI
 
         /// Prunes the cache. This means that sub-blocks are removed from the cache until the cache satisfies the conditions given in the options.
         /// Note that the prune operation is not done automatically - it must be called manually. I.e. when adding an element to the cache, the cache
-        /// is **not** pruned automatically.
+        /// is **not** pruned automatically - unless a capacity was specified when creating the cache (c.f. SubBlockCacheOptions).
         /// \param  options Options for controlling the operation.
         virtual void Prune(const PruneOptions& options) = 0;
 
@@ -147,6 +198,90 @@ namespace libCZI
         /// \param  cache_item      The cache item to be added.
         virtual void Add(int subblock_index, const CacheItem& cache_item) = 0;
 
+        /// Gets the bitmap for the specified subblock-index from the cache, or - if it is not in the cache - calls the load-function
+        /// and adds the item it returns to the cache. The load-function may set its argument `add_to_cache` to false (it is initialized
+        /// to true) in order to indicate that the item is not to be added to the cache. 
+        /// Implementations may guarantee "single-flight" semantics: if multiple threads request the same subblock-index concurrently (and
+        /// it is not in the cache), then only one of them calls the load-function, and the others wait for it to finish and then get the
+        /// loaded item. If the loaded item is not added to the cache (or if the load-function throws), the waiting threads call their
+        /// own load-function. The cache objects created by libCZI::CreateSubBlockCache implement this. The default implementation given
+        /// here is a simple combination of Get and Add (without single-flight semantics).
+        /// Exceptions thrown by the load-function are propagated to the caller.
+        ///
+        /// \param  subblock_index  The subblock index.
+        /// \param  load_function   The function to be called in order to load the item (in case of a cache miss).
+        ///
+        /// \returns    The cache item - either retrieved from the cache or as returned by the load-function.
+        virtual CacheItem GetOrLoad(int subblock_index, const std::function<CacheItem(bool& add_to_cache)>& load_function)
+        {
+            CacheItem item = this->Get(subblock_index);
+            if (!item.IsValid())
+            {
+                bool add_to_cache = true;
+                item = load_function(add_to_cache);
+                if (add_to_cache && item.IsValid())
+                {
+                    this->Add(subblock_index, item);
+                }
+            }
+
+            return item;
+        }
+
+        /// Gets a downscaled rendition of the bitmap for the specified subblock-index (c.f. AddDownscaled). The renditions are
+        /// optional - the default implementation given here does not store them and always returns an invalid item.
+        ///
+        /// \param  subblock_index  The subblock index to get.
+        /// \param  scale_level     The scale level of the rendition, where the rendition is downscaled by a factor of 2^scale_level (so,
+        ///                         it must be in the range 1 to 15).
+        ///
+        /// \returns    If the rendition is in the cache, then a valid CacheItem is returned, otherwise an invalid CacheItem.
+        virtual CacheItem GetDownscaled(int subblock_index, std::uint8_t scale_level)
+        {
+            (void)subblock_index;
+            (void)scale_level;
+            return {};
+        }
+
+        /// Adds a downscaled rendition of the bitmap for the specified subblock-index to the cache. The rendition is a bitmap
+        /// with the size of the subblock's physical size divided by 2^scale_level (rounded up). Renditions are stored in addition to
+        /// the full-resolution bitmap (c.f. Add), and they share the capacity of the cache with the full-resolution bitmaps. If
+        /// the cache does not support renditions (as is the case with the default implementation given here), this is a no-op.
+        ///
+        /// \param  subblock_index  The subblock index to add.
+        /// \param  scale_level     The scale level of the rendition (in the range 1 to 15).
+        /// \param  cache_item      The cache item to be added.
+        virtual void AddDownscaled(int subblock_index, std::uint8_t scale_level, const CacheItem& cache_item)
+        {
+            (void)subblock_index;
+            (void)scale_level;
+            (void)cache_item;
+        }
+
+        /// Gets the sub-block (i.e. its compressed data) for the specified subblock-index from the "compressed tier" of the cache.
+        /// The compressed tier is optional - the default implementation given here does not provide it and always returns nullptr.
+        /// With the sub-block from this tier, a miss in the decoded tier (c.f. Get) only requires decoding, but no I/O.
+        ///
+        /// \param  subblock_index  The subblock index to get.
+        ///
+        /// \returns    If the sub-block is in the compressed tier, then it is returned, otherwise nullptr.
+        virtual std::shared_ptr<ISubBlock> GetCompressedSubBlock(int subblock_index)
+        {
+            (void)subblock_index;
+            return nullptr;
+        }
+
+        /// Adds the specified sub-block (i.e. its compressed data) to the "compressed tier" of the cache. If the cache does
+        /// not provide a compressed tier (as is the case with the default implementation given here), this is a no-op.
+        ///
+        /// \param  subblock_index  The subblock index to add.
+        /// \param  sub_block       The sub-block to be added.
+        virtual void AddCompressedSubBlock(int subblock_index, const std::shared_ptr<ISubBlock>& sub_block)
+        {
+            (void)subblock_index;
+            (void)sub_block;
+        }
+
         virtual ~ISubBlockCacheOperation() = default;
 
         ISubBlockCacheOperation() = default;
@@ -161,8 +296,9 @@ namespace libCZI
     ///   to a cache object, where the subblock-index is the key.
     /// * Whenever a bitmap is needed (for a given subblock-index), the cache object is first queried whether it contains the bitmap. If yes, then the bitmap  
     ///   returned may be used instead of executing the subblock-read-and-decode operation.
-    /// In order to control the memory usage of the cache, the cache object must be pruned (i.e. subblocks are removed from the cache). Currently, this means,
-    /// that the Prune-method must be called manually. The cache object does not do any pruning automatically.
+    /// In order to control the memory usage of the cache, the cache object must be pruned (i.e. subblocks are removed from the cache). This can either
+    /// be done by calling the Prune-method manually, or by specifying a capacity when creating the cache object (c.f. SubBlockCacheOptions) - in which case
+    /// the cache is pruned automatically whenever an element is added.
     /// The operations of Adding, Querying and Pruning the cache object are thread-safe.
     class ISubBlockCache : public ISubBlockCacheStatistics, public ISubBlockCacheControl, public ISubBlockCacheOperation
     {
@@ -176,6 +312,251 @@ namespace libCZI
         ISubBlockCache& operator=(ISubBlockCache&&) noexcept = delete;
     };
 
+    /// Options for the construction of a sub-block cache object (c.f. libCZI::CreateSubBlockCache).
+    struct SubBlockCacheOptions
+    {
+        /// The capacity of the cache. If a limit is given here, then the cache enforces it with every Add-operation, i.e.
+        /// least recently used elements are evicted (as with the Prune-operation) whenever the limit is exceeded. The
+        /// default is "no limit" - in which case the cache must be pruned manually.
+        ISubBlockCacheControl::PruneOptions capacity;
+
+        /// The number of shards. If greater than one, then the cache is split into this number of independent parts (each
+        /// one with its own lock, its own LRU-list and its own share of the capacity), where the sub-block index determines
+        /// the shard to be used. This reduces lock contention if the cache is accessed concurrently from many threads. Note that
+        /// the LRU-order is then only maintained within a shard, and the limits (for the capacity and for the Prune-operation)
+        /// are split evenly between the shards - so the eviction is an approximation of a global LRU-strategy.
+        std::uint32_t numberOfShards{ 1 };
+
+        /// The admission policies which can be used by the cache.
+        enum class AdmissionPolicy : std::uint8_t
+        {
+            /// Every element which is added is admitted to the cache, and (if necessary) least recently used elements are
+            /// evicted. This is a plain LRU-strategy.
+            AdmitAll,
+
+            /// A "TinyLFU"-admission policy is used: the cache maintains an (approximate and aging) count of how often
+            /// each sub-block is accessed (by Get-, GetOrLoad- and Add-operations). If adding a new element would require
+            /// evicting another one, then the new element is only admitted if it has been accessed more often than the
+            /// least recently used element (which would be evicted). So, sub-blocks which are only accessed once (as e.g. in
+            /// a scan over a whole plane) do not displace the frequently used ones. This policy is only effective if a
+            /// capacity is given.
+            TinyLfu,
+        };
+
+        /// The admission policy of the cache.
+        AdmissionPolicy admissionPolicy{ AdmissionPolicy::AdmitAll };
+
+        /// The maximum memory usage (in bytes) of the "compressed tier" of the cache. In addition to the decoded bitmaps, the cache
+        /// can keep the sub-blocks as read from the file (i.e. with their compressed data, which is typically a lot smaller than the
+        /// decoded bitmap). If a bitmap is not in the cache, but the sub-block is in the compressed tier, then the bitmap can be
+        /// decoded without reading the sub-block from the file again. Only sub-blocks with compressed data are added to this tier, and
+        /// the least recently used ones are evicted when this limit is exceeded. A value of 0 (the default) disables the compressed tier.
+        /// Note that the statistics and the Prune-operation refer to the decoded bitmaps only.
+        std::uint64_t compressedTierMaxMemoryUsage{ 0 };
+    };
+
+    /// Interface for a sub-block cache which is shared between multiple files - e.g. a process-wide cache which is used for
+    /// all files opened by an application. The keys of this cache are composed of an identifier of the file and the sub-block
+    /// index, and there is one capacity (or one set of limits for the Prune-operation) for all files.
+    /// In order to use the cache with an accessor, a cache object for a specific file is retrieved with GetCacheForFile, and
+    /// this object is then given to the accessor (c.f. ISingleChannelTileAccessor::Options::subBlockCache).
+    /// The file identity used here would typically be the file-GUID (c.f. FileHeaderInfo::fileGuid), but any other GUID which
+    /// identifies the content of the file can be used as well. Note that files with the same identity share the cached
+    /// bitmaps, so the identity must be unique for different contents. All operations are thread-safe.
+    class IMultiFileSubBlockCache : public ISubBlockCacheStatistics, public ISubBlockCacheControl
+    {
+    public:
+        /// Gets a cache object for the file with the specified identity. The operations on the returned object
+        /// refer only to the entries belonging to this file, whereas the statistics and the pruning of the multi-file
+        /// cache object refer to all entries (of all files). The returned object keeps the multi-file cache alive.
+        ///
+        /// \param  file_identity   The identity of the file.
+        ///
+        /// \returns    The cache object for the specified file.
+        virtual std::shared_ptr<ISubBlockCacheOperation> GetCacheForFile(const libCZI::GUID& file_identity) = 0;
+
+        /// Removes all entries for the file with the specified identity from the cache. This should be called e.g.
+        /// when a file is closed and it is not expected to be opened again.
+        ///
+        /// \param  file_identity   The identity of the file.
+        virtual void RemoveFile(const libCZI::GUID& file_identity) = 0;
+
+        ~IMultiFileSubBlockCache() override = default;
+
+        IMultiFileSubBlockCache() = default;
+        IMultiFileSubBlockCache(const IMultiFileSubBlockCache&) = delete;
+        IMultiFileSubBlockCache& operator=(const IMultiFileSubBlockCache&) = delete;
+        IMultiFileSubBlockCache(IMultiFileSubBlockCache&&) noexcept = delete;
+        IMultiFileSubBlockCache& operator=(IMultiFileSubBlockCache&&) noexcept = delete;
+    };
+
+    /// Interface for a cache of rendered accessor results (i.e. of the final tile-composites). Viewers tend to request the very same
+    /// tiles over and over again, and with this cache an identical request is served by copying the result of the previous request
+    /// (instead of reading, decoding, composing and scaling the sub-blocks again). The cache is given to an accessor with its options
+    /// (c.f. ISingleChannelTileAccessor::Options::renderedTileCache), and the accessor determines the key - which comprises the accessor
+    /// type, the reader instance, the plane coordinate, the ROI, the size of the output bitmap, the zoom and all options which affect
+    /// the result. The reader instance is part of the key, so when a reader is closed (or destroyed), its entries are never
+    /// returned again (and they are eventually evicted). Note that only readers created by libCZI (c.f. CreateCZIReader) provide
+    /// an identity, and that a result is only cached if a background color is given and no scene-filter is used.
+    /// All operations are thread-safe.
+    class IRenderedTileCache : public ISubBlockCacheStatistics, public ISubBlockCacheControl
+    {
+    public:
+        /// Gets the bitmap stored for the specified key. The bitmap is owned by the cache and must not be modified.
+        ///
+        /// \param  key The key.
+        ///
+        /// \returns    The bitmap if found, an empty shared_ptr otherwise.
+        virtual std::shared_ptr<libCZI::IBitmapData> Get(const std::string& key) = 0;
+
+        /// Adds the specified bitmap to the cache (or replaces the bitmap stored for the key). The cache keeps a reference
+        /// to the bitmap, so the bitmap must not be modified afterwards.
+        ///
+        /// \param  key     The key.
+        /// \param  bitmap  The bitmap.
+        virtual void Add(const std::string& key, const std::shared_ptr<libCZI::IBitmapData>& bitmap) = 0;
+
+        ~IRenderedTileCache() override = default;
+
+        IRenderedTileCache() = default;
+        IRenderedTileCache(const IRenderedTileCache&) = delete;
+        IRenderedTileCache& operator=(const IRenderedTileCache&) = delete;
+        IRenderedTileCache(IRenderedTileCache&&) noexcept = delete;
+        IRenderedTileCache& operator=(IRenderedTileCache&&) noexcept = delete;
+    };
+
+    /// Options for the sub-block prefetcher (c.f. ISubBlockPrefetcher).
+    struct SubBlockPrefetcherOptions
+    {
+        /// The number of worker threads which read and decode the sub-blocks.
+        std::uint32_t numberOfThreads{ 1 };
+
+        /// The maximum number of sub-blocks which are queued for prefetching. If the queue is full, then further sub-blocks
+        /// are not prefetched - so the amount of speculative work is bounded.
+        std::uint32_t maxQueueLength{ 256 };
+
+        /// The width of the ring around the requested ROI which is prefetched, given in units of the size of the ROI. With
+        /// the default of 1, the eight neighbouring tiles (of the same size as the requested ROI) are prefetched. With 0,
+        /// no ring is prefetched.
+        std::uint32_t ringWidth{ 1 };
+
+        /// The number of adjacent Z-planes (on either side of the requested plane) for which the requested ROI is prefetched.
+        std::uint32_t adjacentZPlanes{ 1 };
+
+        /// The number of adjacent T-planes (on either side of the requested plane) for which the requested ROI is prefetched.
+        std::uint32_t adjacentTPlanes{ 0 };
+
+        /// If true, then sub-blocks which were queued for a previous prefetch-request (and whose loading has not yet started)
+        /// are discarded when a new prefetch-request is made - the assumption being that the user has moved on.
+        bool discardPendingOnNewRequest{ true };
+
+        /// If true, then only sub-blocks with compressed data are prefetched - uncompressed sub-blocks are skipped, since they are not added
+        /// to the cache then (c.f. ISingleChannelTileAccessor::Options::onlyUseSubBlockCacheForCompressedData). This should match the
+        /// setting used with the accessors.
+        bool onlyUseSubBlockCacheForCompressedData{ true };
+
+        /// If true, then the masks (if present) are loaded as well. This should match the setting used with the accessors
+        /// (c.f. ISingleChannelTileAccessor::Options::maskAware).
+        bool maskAware{ false };
+    };
+
+    /// A prefetcher reads and decodes sub-blocks into a sub-block cache in the background - anticipating the next requests of an
+    /// interactive viewer. For an accessor request (given by the plane, the ROI and the zoom), the sub-blocks of the
+    /// surrounding ring of tiles and of the adjacent Z- and T-planes (c.f. SubBlockPrefetcherOptions) are loaded by worker
+    /// threads, and they are added to the cache (in exactly the same way as an accessor would do it). The accessor then
+    /// finds the sub-blocks in the cache if the user pans or scrolls through the planes. The sub-blocks are selected from
+    /// the pyramid-layer which the scaling accessor would use for the given zoom. Errors during prefetching are ignored.
+    /// All operations are thread-safe.
+    class ISubBlockPrefetcher
+    {
+    public:
+        /// Schedules the prefetching for the specified accessor request. The method returns immediately - the sub-blocks to be
+        /// prefetched are determined by the worker threads (only the transformation of the ROI into the raw-sub-block-coordinate-system
+        /// is done by the calling thread).
+        ///
+        /// \param  roi                 The ROI of the accessor request.
+        /// \param  planeCoordinate     The plane coordinate of the accessor request.
+        /// \param  zoom                The zoom of the accessor request (1 for the non-scaling accessors).
+        virtual void Prefetch(const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom) = 0;
+
+        /// Schedules the prefetching for the specified accessor request. The method returns immediately (c.f. above).
+        ///
+        /// \param  roi                 The ROI of the accessor request (in the raw-sub-block-coordinate-system).
+        /// \param  planeCoordinate     The plane coordinate of the accessor request.
+        /// \param  zoom                The zoom of the accessor request (1 for the non-scaling accessors).
+        void Prefetch(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom)
+        {
+            this->Prefetch(libCZI::IntRectAndFrameOfReference{ libCZI::CZIFrameOfReference::RawSubBlockCoordinateSystem, roi }, planeCoordinate, zoom);
+        }
+
+        /// Discards all queued sub-blocks whose loading has not yet started (and the prefetch-requests which have not yet been processed).
+        virtual void CancelPending() = 0;
+
+        /// Waits until all prefetch-requests have been processed and all queued sub-blocks have been loaded.
+        virtual void WaitUntilIdle() = 0;
+
+        virtual ~ISubBlockPrefetcher() = default;
+
+        ISubBlockPrefetcher() = default;
+        ISubBlockPrefetcher(const ISubBlockPrefetcher&) = delete;
+        ISubBlockPrefetcher& operator=(const ISubBlockPrefetcher&) = delete;
+        ISubBlockPrefetcher(ISubBlockPrefetcher&&) noexcept = delete;
+        ISubBlockPrefetcher& operator=(ISubBlockPrefetcher&&) noexcept = delete;
+    };
+
+    /// Options for the plane-tile iterator (c.f. IPlaneTileIterator).
+    struct PlaneTileIteratorOptions
+    {
+        /// The background color (c.f. ISingleChannelTileAccessor::Options::backGroundColor). Since the tiles are newly allocated,
+        /// black is used if any of R, G or B is NaN.
+        RgbFloatColor backGroundColor{ 0, 0, 0 };
+
+        /// If true, then the sub-blocks are sorted by their M-index (sub-block with highest M-index will be 'on top').
+        /// Otherwise, the Z-order is arbitrary.
+        bool sortByM{ true };
+
+        /// If specified, only sub-blocks with a scene-index contained in the set will be considered.
+        std::shared_ptr<libCZI::IIndexSet> sceneFilter;
+
+        /// If specified, then the sub-block cache is used for lookups (c.f. ISingleChannelTileAccessor::Options::subBlockCache). Since
+        /// every sub-block is decoded only once by the iterator, sub-blocks are not added to the cache.
+        std::shared_ptr<libCZI::ISubBlockCacheOperation> subBlockCache;
+
+        /// If true, then masks (if present) are taken into account when composing the tiles.
+        bool maskAware{ false };
+
+        /// The number of threads used for reading and decoding the sub-blocks, c.f. ISingleChannelTileAccessor::Options::decodeThreadCount.
+        std::uint32_t decodeThreadCount{ 0 };
+    };
+
+    /// A plane-tile iterator creates the tile composites (in the raw-sub-block-coordinate-system, i.e. at full resolution, as
+    /// with the ISingleChannelTileAccessor) for all tiles of a regular grid covering a ROI of a plane. This is intended for exporting
+    /// (or re-tiling) a whole plane: the tiles are produced row by row (and from left to right within a row), and every sub-block is
+    /// read and decoded only once - it is drawn into all tiles of the current row it intersects, and it is kept (for the next row)
+    /// only if it extends into the next row. So, the memory usage is bounded by one row of tiles and the sub-blocks crossing the
+    /// boundary between two rows.\n
+    /// The result for a tile is the same as the one given by the ISingleChannelTileAccessor (with the same options).
+    class IPlaneTileIterator
+    {
+    public:
+        /// Gets the next tile. The tiles are numbered row by row, the tiles in the last column and in the last row are
+        /// clipped to the ROI (and may therefore be smaller than the tile size).
+        ///
+        /// \param [out] tileRect   If non-null, the rectangle of the tile (in the raw-sub-block-coordinate-system) is put here.
+        /// \param [out] tile       If non-null, the tile composite is put here.
+        ///
+        /// \returns    True if a tile was retrieved, false if there are no more tiles.
+        virtual bool GetNext(libCZI::IntRect* tileRect, std::shared_ptr<libCZI::IBitmapData>* tile) = 0;
+
+        virtual ~IPlaneTileIterator() = default;
+
+        IPlaneTileIterator() = default;
+        IPlaneTileIterator(const IPlaneTileIterator&) = delete;
+        IPlaneTileIterator& operator=(const IPlaneTileIterator&) = delete;
+        IPlaneTileIterator(IPlaneTileIterator&&) noexcept = delete;
+        IPlaneTileIterator& operator=(IPlaneTileIterator&&) noexcept = delete;
+    };
+
     /// The base interface (all accessor interfaces must derive from this).
     class IAccessor
     {
@@ -237,9 +618,26 @@ namespace libCZI
             /// increased memory usage.
             bool onlyUseSubBlockCacheForCompressedData;
 
+            /// If true, then the sub-block cache is only used for lookups, i.e. bitmaps which are not found in the cache are
+            /// not added to it. This is intended for batch operations (e.g. an export of a whole plane), which access every
+            /// sub-block once and would otherwise evict the working set of other (interactive) users of the cache.
+            bool doNotAdmitToSubBlockCache;
+
+            /// If specified, then the final result is looked up in (and added to) this cache of rendered tiles, c.f. IRenderedTileCache.
+            std::shared_ptr<libCZI::IRenderedTileCache> renderedTileCache;
+
             /// If true, then masks (if present) are taken into account when composing the tile-composite.
             bool maskAware;
 
+            /// The number of threads used for reading and decoding the sub-blocks. If this is 0 or 1, the sub-blocks are
+            /// read and decoded one after the other in the calling thread. Otherwise, up to the specified number of worker threads
+            /// are reading and decoding concurrently, while the calling thread draws the sub-blocks (in the required Z-order) as
+            /// soon as they become available. The result is the same as with sequential operation.
+            std::uint32_t decodeThreadCount;
+
+            /// The number of threads used for drawing the sub-blocks into the destination, c.f. Compositors::ComposeSingleTileOptions::composeThreadCount.
+            std::uint32_t composeThreadCount;
+
             /// Clears this object to its blank state.
             void Clear()
             {
@@ -250,7 +648,11 @@ namespace libCZI
                 this->sceneFilter.reset();
                 this->subBlockCache.reset();
                 this->onlyUseSubBlockCacheForCompressedData = true;
+                this->doNotAdmitToSubBlockCache = false;
+                this->renderedTileCache.reset();
                 this->maskAware = false;
+                this->decodeThreadCount = 0;
+                this->composeThreadCount = 0;
             }
         };
 
@@ -285,6 +687,29 @@ namespace libCZI
         /// \param pOptions        Options for controlling the operation.
         virtual void Get(libCZI::IBitmapData* pDest, const IntPointAndFrameOfReference& position, const IDimCoordinate* planeCoordinate, const Options* pOptions) = 0;
 
+        /// Gets the tile composites of the same ROI for a list of planes (e.g. all Z-planes of a stack). The result is the same as
+        /// calling Get for every plane, but the sub-blocks are determined with a single pass over the sub-block directory, and
+        /// reading and decoding of the sub-blocks is scheduled across all planes (so that with Options::decodeThreadCount > 1, the
+        /// sub-blocks of the next planes are decoded while the current plane is composed).
+        ///
+        /// \param pixeltype        The pixeltype.
+        /// \param roi              The ROI and the coordinate system it is defined in.
+        /// \param planeCoordinates The plane coordinates.
+        /// \param pOptions         Options for controlling the operation.
+        ///
+        /// \return A vector with the tile-composites (one for each plane coordinate, in the same order).
+        virtual std::vector<std::shared_ptr<libCZI::IBitmapData>> GetMultiplePlanes(libCZI::PixelType pixeltype, const libCZI::IntRectAndFrameOfReference& roi, const std::vector<libCZI::CDimCoordinate>& planeCoordinates, const Options* pOptions)
+        {
+            std::vector<std::shared_ptr<libCZI::IBitmapData>> result;
+            result.reserve(planeCoordinates.size());
+            for (const auto& planeCoordinate : planeCoordinates)
+            {
+                result.emplace_back(this->Get(pixeltype, roi, &planeCoordinate, pOptions));
+            }
+
+            return result;
+        }
+
         /// Gets the tile composite of the specified plane and the specified ROI.
         /// The pixeltype is determined by examining the first subblock found in the
         /// specified plane (which is an arbitrary subblock). A newly allocated
@@ -355,6 +780,32 @@ namespace libCZI
             this->Get(pDest, libCZI::IntPointAndFrameOfReference{ libCZI::CZIFrameOfReference::RawSubBlockCoordinateSystem, { xPos, yPos } }, planeCoordinate, pOptions);
         }
 
+        /// Copy the tile composite into the memory described by the specified descriptor (which determines the width and the height of the
+        /// ROI and the pixeltype). No bitmap object is allocated, the composite is rendered directly into this memory.
+        ///
+        /// \param destination     The descriptor of the destination memory.
+        /// \param position        The x-position and y-position of the ROI, and the coordinate system they are defined in.
+        /// \param planeCoordinate The plane coordinate.
+        /// \param pOptions        Options for controlling the operation.
+        void Get(const libCZI::BitmapMemoryDescriptor& destination, const IntPointAndFrameOfReference& position, const IDimCoordinate* planeCoordinate, const Options* pOptions)
+        {
+            libCZI::ExternalBitmapData bitmap(destination);
+            this->Get(&bitmap, position, planeCoordinate, pOptions);
+        }
+
+        /// Gets the tile composites of the same ROI for a list of planes.
+        ///
+        /// \param pixeltype        The pixeltype.
+        /// \param roi              The ROI (given in _raw-subblock-coordinate-system_, c.f. [Coordinate Systems](../pages/coordinate_systems.html)).
+        /// \param planeCoordinates The plane coordinates.
+        /// \param pOptions         Options for controlling the operation.
+        ///
+        /// \return A vector with the tile-composites (one for each plane coordinate, in the same order).
+        std::vector<std::shared_ptr<libCZI::IBitmapData>> GetMultiplePlanes(libCZI::PixelType pixeltype, const libCZI::IntRect& roi, const std::vector<libCZI::CDimCoordinate>& planeCoordinates, const Options* pOptions)
+        {
+            return this->GetMultiplePlanes(pixeltype, libCZI::IntRectAndFrameOfReference{ libCZI::CZIFrameOfReference::RawSubBlockCoordinateSystem, roi }, planeCoordinates, pOptions);
+        }
+
     protected:
         ~ISingleChannelTileAccessor() override = default;
     };
@@ -393,9 +844,26 @@ namespace libCZI
             /// If true, then only bitmaps from sub-blocks with compressed data are added to the cache.
             bool onlyUseSubBlockCacheForCompressedData;
 
+            /// If true, then the sub-block cache is only used for lookups, i.e. bitmaps which are not found in the cache are
+            /// not added to it. This is intended for batch operations (e.g. an export of a whole plane), which access every
+            /// sub-block once and would otherwise evict the working set of other (interactive) users of the cache.
+            bool doNotAdmitToSubBlockCache;
+
+            /// If specified, then the final result is looked up in (and added to) this cache of rendered tiles, c.f. IRenderedTileCache.
+            std::shared_ptr<libCZI::IRenderedTileCache> renderedTileCache;
+
             /// If true, then masks (if present) are taken into account when composing the tile-composite.
             bool maskAware;
 
+            /// The number of threads used for reading and decoding the sub-blocks. If this is 0 or 1, the sub-blocks are
+            /// read and decoded one after the other in the calling thread. Otherwise, up to the specified number of worker threads
+            /// are reading and decoding concurrently, while the calling thread draws the sub-blocks (in the required Z-order) as
+            /// soon as they become available. The result is the same as with sequential operation.
+            std::uint32_t decodeThreadCount;
+
+            /// The number of threads used for drawing the sub-blocks, c.f. ISingleChannelTileAccessor::Options::composeThreadCount.
+            std::uint32_t composeThreadCount;
+
             /// Clears this object to its blank state.
             void Clear()
             {
@@ -405,7 +873,11 @@ namespace libCZI
                 this->sceneFilter.reset();
                 this->subBlockCache.reset();
                 this->onlyUseSubBlockCacheForCompressedData = true;
+                this->doNotAdmitToSubBlockCache = false;
+                this->renderedTileCache.reset();
                 this->maskAware = false;
+                this->decodeThreadCount = 0;
+                this->composeThreadCount = 0;
             }
         };
 
@@ -485,13 +957,34 @@ namespace libCZI
         {
             this->Get(pDest, libCZI::IntPointAndFrameOfReference{ libCZI::CZIFrameOfReference::RawSubBlockCoordinateSystem, { xPos, yPos } }, planeCoordinate, pyramidInfo, pOptions);
         }
+
+        /// Copy the composite into the memory described by the specified descriptor (which determines the width and the height of the
+        /// ROI and the pixeltype). No bitmap object is allocated, the composite is rendered directly into this memory.
+        /// \param destination     The descriptor of the destination memory.
+        /// \param position        The x- and y-position and the coordinate system it is defined in.
+        /// \param planeCoordinate The plane coordinate.
+        /// \param pyramidInfo     Information describing the pyramid-layer.
+        /// \param pOptions        Options for controlling the operation.
+        void Get(const libCZI::BitmapMemoryDescriptor& destination, const libCZI::IntPointAndFrameOfReference& position, const IDimCoordinate* planeCoordinate, const PyramidLayerInfo& pyramidInfo, const Options* pOptions)
+        {
+            libCZI::ExternalBitmapData bitmap(destination);
+            this->Get(&bitmap, position, planeCoordinate, pyramidInfo, pOptions);
+        }
+    };
+
+    /// Values that represent the resampling method used when scaling a sub-block into the destination.
+    enum class ResamplingMode : std::uint8_t
+    {
+        NearestNeighbor = 0,    ///< Nearest-neighbor - every destination pixel is taken from one source pixel. This is the fastest method, but it aliases when downscaling.
+        AreaAverage = 1,        ///< Area-averaging (aka "box filter") - every destination pixel is the average of the source pixels it covers. This does not alias when downscaling.
+        Bilinear = 2            ///< Bilinear interpolation between the four source pixels nearest to the center of the destination pixel.
     };
 
     /// Interface for single channel scaling tile accessors.
     /// This accessor creates a multi-tile composite of a single channel (and a single plane) with a given zoom-factor.
     /// It will use pyramid sub-blocks (if present) in order to create the destination bitmap. In this operation, it will use
     /// the pyramid-layer just above the specified zoom-factor and scale down to the requested size.\n
-    /// The scaling operation employed here is a simple nearest-neighbor algorithm.
+    /// The scaling operation employed here is by default a simple nearest-neighbor algorithm, c.f. Options::resamplingMode.
     class ISingleChannelScalingTileAccessor : public IAccessor
     {
     public:
@@ -530,9 +1023,45 @@ namespace libCZI
             /// If true, then only bitmaps from sub-blocks with compressed data are added to the cache.
             bool onlyUseSubBlockCacheForCompressedData;
 
+            /// If true, then the sub-block cache is only used for lookups, i.e. bitmaps which are not found in the cache are
+            /// not added to it. This is intended for batch operations (e.g. an export of a whole plane), which access every
+            /// sub-block once and would otherwise evict the working set of other (interactive) users of the cache.
+            bool doNotAdmitToSubBlockCache;
+
+            /// If specified, then the final result is looked up in (and added to) this cache of rendered tiles, c.f. IRenderedTileCache.
+            std::shared_ptr<libCZI::IRenderedTileCache> renderedTileCache;
+
             /// If true, then masks (if present) are taken into account when composing the tile-composite.
             bool maskAware;
 
+            /// The number of threads used for reading and decoding the sub-blocks. If this is 0 or 1, the sub-blocks are
+            /// read and decoded one after the other in the calling thread. Otherwise, up to the specified number of worker threads
+            /// are reading and decoding concurrently, while the calling thread draws the sub-blocks (in the required Z-order) as
+            /// soon as they become available. The result is the same as with sequential operation.
+            std::uint32_t decodeThreadCount;
+
+            /// If true, then JPG-compressed sub-blocks are decoded at a reduced resolution (1/2, 1/4 or 1/8 of the physical size)
+            /// if the zoom allows for this without loss (i.e. if the sub-block is to be downscaled by at least this factor anyway).
+            /// This reduction is done in the DCT-domain while decoding and is a lot faster than decoding at full resolution. Bitmaps
+            /// decoded at reduced resolution are not added to the sub-block cache. This option is ignored in mask-aware mode.
+            bool useReducedResolutionDecode;
+
+            /// If true (and a sub-block cache is given), then downscaled renditions of the sub-blocks are kept in the sub-block cache
+            /// (c.f. ISubBlockCacheOperation::AddDownscaled). When a sub-block is to be drawn downscaled by at least a factor of two,
+            /// then a rendition with the largest power-of-two downscale factor (which still has at least the resolution of the
+            /// destination) is created and cached, and subsequent requests at the same (or a similar) zoom use this small bitmap
+            /// instead of decoding and scaling the full-resolution bitmap again. The full-resolution bitmap is not added to the cache
+            /// in this case (only the compressed sub-block, if the cache has a compressed tier). Since the rendition is created by nearest-neighbor
+            /// downscaling, the result may differ slightly from the result without this option. This option is ignored in
+            /// mask-aware mode.
+            bool useDownscaledSubBlockCache;
+
+            /// The resampling method used for scaling the sub-blocks. Area-averaging gives a result free of aliasing at only moderately higher
+            /// cost, since the sub-blocks are taken from the pyramid-layer with the lowest resolution which is still at least the resolution of the
+            /// destination. Area-averaging and bilinear interpolation are only available if the pixel type of the sub-block is the same as the pixel
+            /// type of the destination, and not in mask-aware mode - otherwise nearest-neighbor is used.
+            ResamplingMode resamplingMode;
+
             /// Clears this object to its blank state.
             void Clear()
             {
@@ -544,6 +1073,12 @@ namespace libCZI
                 this->maskAware = false;
                 this->subBlockCache.reset();
                 this->onlyUseSubBlockCacheForCompressedData = true;
+                this->doNotAdmitToSubBlockCache = false;
+                this->renderedTileCache.reset();
+                this->decodeThreadCount = 0;
+                this->useReducedResolutionDecode = false;
+                this->useDownscaledSubBlockCache = false;
+                this->resamplingMode = ResamplingMode::NearestNeighbor;
             }
         };
 
@@ -623,6 +1158,150 @@ namespace libCZI
         {
             this->Get(pDest, libCZI::IntRectAndFrameOfReference{ libCZI::CZIFrameOfReference::RawSubBlockCoordinateSystem, roi }, planeCoordinate, zoom, pOptions);
         }
+
+        /// Copy the composite into the memory described by the specified descriptor. No bitmap object is allocated, the composite is
+        /// rendered directly into this memory. The width and the height given with the descriptor must exactly match the size reported
+        /// by the method "CalcSize" (for the same ROI and zoom), otherwise an invalid_argument-exception is thrown.
+        /// \param destination      The descriptor of the destination memory.
+        /// \param roi              The ROI and the coordinate system it is defined in.
+        /// \param planeCoordinate  The plane coordinate.
+        /// \param zoom             The zoom factor.
+        /// \param pOptions         Options controlling the operation. May be nullptr.
+        void Get(const libCZI::BitmapMemoryDescriptor& destination, const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom, const libCZI::ISingleChannelScalingTileAccessor::Options* pOptions)
+        {
+            libCZI::ExternalBitmapData bitmap(destination);
+            this->Get(&bitmap, roi, planeCoordinate, zoom, pOptions);
+        }
+    };
+
+    /// Values that represent the reduction operations of a projection.
+    enum class ProjectionOperation : std::uint8_t
+    {
+        Maximum = 0,    ///< Maximum intensity projection - every pixel (and every channel of a pixel) is the maximum over all planes.
+        Minimum = 1,    ///< Minimum intensity projection - every pixel (and every channel of a pixel) is the minimum over all planes.
+        Mean = 2,       ///< Every pixel (and every channel of a pixel) is the mean over all planes (rounded to the nearest integer for integer pixel types).
+        Sum = 3         ///< Every pixel (and every channel of a pixel) is the sum over all planes (saturated to the range of the pixel type).
+    };
+
+    /// Interface for single channel projection accessors.
+    /// This accessor creates a projection (e.g. a maximum intensity projection) of a range of planes (e.g. a Z-stack or a time series) of
+    /// a single channel. For every plane of the range, the multi-tile composite is created (in the same way as with the ISingleChannelTileAccessor),
+    /// and it is then combined with a running accumulator. So, only one plane is held in memory at any time, irrespective of the size of the range.\n
+    /// Note that if a plane (or part of it) contains no sub-blocks, then the background color is used for the respective pixels.
+    class ISingleChannelProjectionAccessor : public IAccessor
+    {
+    public:
+        /// The range of planes to be projected - the plane coordinate given with the request is used as a template, and the coordinate
+        /// in the dimension 'dimension' is set to the values 'start' to 'start+count-1'.
+        struct Range
+        {
+            libCZI::DimensionIndex dimension;   ///< The dimension (typically Z or T).
+            int start;                          ///< The first coordinate in the dimension.
+            int count;                          ///< The number of planes (which must be greater than zero).
+        };
+
+        /// Options used for this accessor.
+        struct Options
+        {
+            /// The background color. If the destination bitmap is a grayscale-type, then the mean from R, G and B is calculated and multiplied
+            /// with the maximum pixel value (of the specific pixeltype). If it is an RGB-color type, then R, G and B are separately multiplied with
+            /// the maximum pixel value. If any of R, G or B is NaN, then black is used (since the planes must be cleared before composing).
+            RgbFloatColor backGroundColor;
+
+            /// If true, then the tiles are sorted by their M-index (tile with highest M-index will be 'on top').
+            /// Otherwise, the Z-order is arbitrary.
+            bool sortByM;
+
+            /// If true, then the tile-visibility-check-optimization is used, c.f. ISingleChannelTileAccessor::Options::useVisibilityCheckOptimization.
+            bool useVisibilityCheckOptimization;
+
+            /// If specified, then the sub-block cache is used, c.f. ISingleChannelTileAccessor::Options::subBlockCache.
+            std::shared_ptr<libCZI::ISubBlockCacheOperation> subBlockCache;
+
+            /// If true, then only bitmaps from sub-blocks with compressed data are added to the cache.
+            bool onlyUseSubBlockCacheForCompressedData;
+
+            /// If true, then the sub-block cache is only used for lookups, i.e. bitmaps which are not found in the cache are
+            /// not added to it. Since a projection accesses every sub-block of the range once, this is usually advisable.
+            bool doNotAdmitToSubBlockCache;
+
+            /// If true, then masks (if present) are taken into account when composing the planes.
+            bool maskAware;
+
+            /// The number of threads used for reading and decoding the sub-blocks, c.f. ISingleChannelTileAccessor::Options::decodeThreadCount.
+            std::uint32_t decodeThreadCount;
+
+            /// The number of threads used for drawing the sub-blocks, c.f. ISingleChannelTileAccessor::Options::composeThreadCount.
+            std::uint32_t composeThreadCount;
+
+            /// Clears this object to its blank state.
+            void Clear()
+            {
+                this->backGroundColor.r = this->backGroundColor.g = this->backGroundColor.b = std::numeric_limits<float>::quiet_NaN();
+                this->sortByM = true;
+                this->useVisibilityCheckOptimization = false;
+                this->subBlockCache.reset();
+                this->onlyUseSubBlockCacheForCompressedData = true;
+                this->doNotAdmitToSubBlockCache = false;
+                this->maskAware = false;
+                this->decodeThreadCount = 0;
+                this->composeThreadCount = 0;
+            }
+        };
+
+        /// Gets the projection of the specified range of planes for the specified ROI. The supported pixeltypes are Gray8, Gray16,
+        /// Gray32Float, Bgr24 and Bgr48 - the planes are composed in this pixeltype, and the projection operates on every channel separately.
+        ///
+        /// \param pixeltype       The pixeltype (of the destination bitmap).
+        /// \param roi             The ROI and the coordinate system it is defined in.
+        /// \param planeCoordinate The plane coordinate which is used as a template for the planes in the range.
+        /// \param range           The range of planes.
+        /// \param operation       The reduction operation.
+        /// \param pOptions        Options for controlling the operation (may be nullptr).
+        ///
+        /// \return A `std::shared_ptr<libCZI::IBitmapData>` containing the projection.
+        virtual std::shared_ptr<libCZI::IBitmapData> Get(libCZI::PixelType pixeltype, const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, ProjectionOperation operation, const Options* pOptions) = 0;
+
+        /// Copy the projection of the specified range of planes into the specified bitmap. The bitmap passed in here determines the width
+        /// and the height of the ROI (and the pixeltype).
+        ///
+        /// \param [in] pDest      The destination bitmap.
+        /// \param position        The x-position and y-position of the ROI (width and height are given by pDest), and the coordinate system they are defined in.
+        /// \param planeCoordinate The plane coordinate which is used as a template for the planes in the range.
+        /// \param range           The range of planes.
+        /// \param operation       The reduction operation.
+        /// \param pOptions        Options for controlling the operation (may be nullptr).
+        virtual void Get(libCZI::IBitmapData* pDest, const libCZI::IntPointAndFrameOfReference& position, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, ProjectionOperation operation, const Options* pOptions) = 0;
+
+        /// Gets the projection of the specified range of planes for the specified ROI.
+        ///
+        /// \param pixeltype       The pixeltype (of the destination bitmap).
+        /// \param roi             The ROI (given in _raw-subblock-coordinate-system_, c.f. [Coordinate Systems](../pages/coordinate_systems.html)).
+        /// \param planeCoordinate The plane coordinate which is used as a template for the planes in the range.
+        /// \param range           The range of planes.
+        /// \param operation       The reduction operation.
+        /// \param pOptions        Options for controlling the operation (may be nullptr).
+        ///
+        /// \return A `std::shared_ptr<libCZI::IBitmapData>` containing the projection.
+        std::shared_ptr<libCZI::IBitmapData> Get(libCZI::PixelType pixeltype, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, ProjectionOperation operation, const Options* pOptions)
+        {
+            return this->Get(pixeltype, libCZI::IntRectAndFrameOfReference{ libCZI::CZIFrameOfReference::RawSubBlockCoordinateSystem, roi }, planeCoordinate, range, operation, pOptions);
+        }
+
+        /// Copy the projection into the memory described by the specified descriptor (which determines the width and the height of the
+        /// ROI and the pixeltype). No bitmap object is allocated, the projection is rendered directly into this memory.
+        ///
+        /// \param destination     The descriptor of the destination memory.
+        /// \param position        The x-position and y-position of the ROI, and the coordinate system they are defined in.
+        /// \param planeCoordinate The plane coordinate which is used as a template for the planes in the range.
+        /// \param range           The range of planes.
+        /// \param operation       The reduction operation.
+        /// \param pOptions        Options for controlling the operation (may be nullptr).
+        void Get(const libCZI::BitmapMemoryDescriptor& destination, const libCZI::IntPointAndFrameOfReference& position, const libCZI::IDimCoordinate* planeCoordinate, const Range& range, ProjectionOperation operation, const Options* pOptions)
+        {
+            libCZI::ExternalBitmapData bitmap(destination);
+            this->Get(&bitmap, position, planeCoordinate, range, operation, pOptions);
+        }
     };
 
     /// Composition operations are found in this class: multi-tile compositor and multi-channel compositor.
@@ -636,8 +1315,23 @@ namespace libCZI
             /// each tile (in black color).
             bool drawTileBorder;
 
+            /// The number of threads used for composing. If this is 0 or 1, the tiles are drawn one after the other into the
+            /// destination in the calling thread. Otherwise, the destination is split into horizontal bands, and each band is drawn
+            /// by its own worker thread. The number of bands is this number, clamped to the number of hardware threads and to the
+            /// height of the destination (if this leaves only one band, the tiles are drawn in the calling thread). Note that the
+            /// work is not partitioned by tiles - every worker goes through all tiles (in the same order, so that the result is the
+            /// same as with sequential operation) and draws the part of each tile which falls into its band, skipping the tiles which
+            /// do not intersect with it. So, the speed-up is for the drawing of tiles which span several bands. The tiles are still
+            /// retrieved (in ascending order) in the calling thread, and a tile is released as soon as all bands have processed it.
+            /// If drawTileBorder is true, this is ignored.
+            std::uint32_t composeThreadCount;
+
             /// Clears this object to its blank/initial state.
-            void Clear() { this->drawTileBorder = false; }
+            void Clear()
+            {
+                this->drawTileBorder = false;
+                this->composeThreadCount = 0;
+            }
         };
 
         /// Composes a set of tiles (which are retrieved by calling the getTiles-functor) in the
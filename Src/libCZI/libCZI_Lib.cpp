@@ -8,6 +8,7 @@
 #include "SingleChannelTileAccessor.h"
 #include "SingleChannelPyramidLevelTileAccessor.h"
 #include "SingleChannelScalingTileAccessor.h"
+#include "SingleChannelProjectionAccessor.h"
 #include "StreamImpl.h"
 #include "CziWriter.h"
 #include "CziReaderWriter.h"
@@ -86,6 +87,8 @@ std::shared_ptr<IAccessor> libCZI::CreateAccesor(std::shared_ptr<ISubBlockReposi
         return std::make_shared<CSingleChannelPyramidLevelTileAccessor>(repository);
     case AccessorType::SingleChannelScalingTileAccessor:
         return std::make_shared<CSingleChannelScalingTileAccessor>(repository);
+    case AccessorType::SingleChannelProjectionAccessor:
+        return std::make_shared<CSingleChannelProjectionAccessor>(repository);
     }
 
     throw std::invalid_argument("unknown accessorType");
@@ -6,6 +6,7 @@
 
 #include "bitmapData.h"
 #include "BitmapOperationsBitonal.h"
+#include "CziUtils.h"
 
 using namespace libCZI;
 using namespace libCZI::detail;
@@ -39,6 +40,20 @@ namespace
     }
 }
 
+ExternalBitmapData::ExternalBitmapData(const BitmapMemoryDescriptor& descriptor) : descriptor_(descriptor)
+{
+    if (descriptor.ptrData == nullptr)
+    {
+        throw std::invalid_argument("descriptor.ptrData must not be null.");
+    }
+
+    const std::uint64_t minimal_stride = static_cast<std::uint64_t>(descriptor.width) * CziUtils::GetBytesPerPel(descriptor.pixelType);
+    if (descriptor.stride < minimal_stride)
+    {
+        throw std::invalid_argument("descriptor.stride is too small for the specified width and pixel type.");
+    }
+}
+
 bool BitonalBitmapOperations::GetPixelValue(const BitonalBitmapLockInfo& lock_info, const libCZI::IntSize& extent, std::uint32_t x, std::uint32_t y)
 {
     CheckLockInfoAndThrow(lock_info, extent);
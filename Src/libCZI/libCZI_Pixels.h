@@ -5,8 +5,10 @@
 #pragma once
 
 #include "ImportExport.h"
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <algorithm>
 #include <ostream>
 #include <utility>
@@ -425,6 +427,59 @@ namespace libCZI
     /// Defines an alias representing the scoped bitmap locker for use with a shared_ptr of type libCZI::IBitmapData.
     typedef ScopedBitmapLocker<std::shared_ptr<IBitmapData>> ScopedBitmapLockerSP;
 
+    /// Describes a bitmap in memory which is owned by the caller (e.g. the buffer of a NumPy-array or a pinned buffer
+    /// for a GPU-upload). It can be passed to the accessors in order to have them render directly into this memory.
+    struct BitmapMemoryDescriptor
+    {
+        PixelType       pixelType;  ///< The pixel type.
+        std::uint32_t   width;      ///< The width in pixels.
+        std::uint32_t   height;     ///< The height in pixels.
+        void*           ptrData;    ///< Pointer to the first (top-left) pixel.
+        std::uint32_t   stride;     ///< The stride in bytes (which must be at least the width times the size of a pixel).
+    };
+
+    /// An implementation of the IBitmapData-interface which refers to memory owned by the caller (as described by a BitmapMemoryDescriptor).
+    /// No memory is allocated by this object, and it is intended to be used as an automatic variable - the memory described by the
+    /// descriptor must remain valid for the lifetime of the object.
+    class LIBCZI_API ExternalBitmapData final : public IBitmapData
+    {
+    private:
+        BitmapMemoryDescriptor descriptor_;
+        std::atomic<int> lock_count_{ 0 };
+    public:
+        /// Constructor. The descriptor is validated, and an std::invalid_argument-exception is thrown if
+        /// the pointer is null, if the pixel type is invalid or if the stride is less than the width times the
+        /// size of a pixel.
+        ///
+        /// \param descriptor The descriptor of the memory.
+        explicit ExternalBitmapData(const BitmapMemoryDescriptor& descriptor);
+
+        PixelType GetPixelType() const override { return this->descriptor_.pixelType; }
+        IntSize GetSize() const override { return IntSize{ this->descriptor_.width, this->descriptor_.height }; }
+
+        BitmapLockInfo Lock() override
+        {
+            ++this->lock_count_;
+            BitmapLockInfo lock_info;
+            lock_info.ptrData = this->descriptor_.ptrData;
+            lock_info.ptrDataRoi = this->descriptor_.ptrData;
+            lock_info.stride = this->descriptor_.stride;
+            lock_info.size = static_cast<std::uint64_t>(this->descriptor_.stride) * this->descriptor_.height;
+            return lock_info;
+        }
+
+        void Unlock() override
+        {
+            if (--this->lock_count_ < 0)
+            {
+                ++this->lock_count_;
+                throw std::logic_error("Lock/Unlock-semantic was violated.");
+            }
+        }
+
+        int GetLockCount() const override { return this->lock_count_.load(); }
+    };
+
     //-------------------------------------------------------------------------
 
     /// Information about a locked bitonal bitmap - allowing direct access to the image data in memory.
@@ -6,6 +6,7 @@
 #include "inc_libCZI_Config.h"
 #include "decoder.h"
 #include "decoder_zstd.h"
+#include "decoder_jpg.h"
 #include <mutex>
 #include <cstdlib>
 #include "bitmapData.h"
@@ -66,6 +67,10 @@ private:
     std::shared_ptr<IDecoder> zstd0decoder;
     std::once_flag  zstd1DecoderInitialized;
     std::shared_ptr<IDecoder> zstd1decoder;
+#if LIBCZI_LIBJPEG_BASED_DECODER_AVAILABLE
+    std::once_flag  jpgDecoderInitialized;
+    std::shared_ptr<IDecoder> jpgdecoder;
+#endif
 public:
     std::shared_ptr<IDecoder> GetDecoder(ImageDecoderType type, const char* arguments) override
     {
@@ -103,6 +108,20 @@ public:
 
             return this->zstd1decoder;
         }
+#if LIBCZI_LIBJPEG_BASED_DECODER_AVAILABLE
+        case ImageDecoderType::JPG_LibJpeg:
+        {
+            std::call_once(jpgDecoderInitialized,
+                [this]()
+                {
+                    this->jpgdecoder = CJpgLibJpegDecoder::Create();
+                });
+
+            return this->jpgdecoder;
+        }
+#endif
+        default:
+            break;
         }
 
         return shared_ptr<IDecoder>();
@@ -119,6 +138,10 @@ private:
     std::shared_ptr<IDecoder> zstd0decoder;
     std::once_flag  zstd1DecoderInitialized;
     std::shared_ptr<IDecoder> zstd1decoder;
+#if LIBCZI_LIBJPEG_BASED_DECODER_AVAILABLE
+    std::once_flag  jpgDecoderInitialized;
+    std::shared_ptr<IDecoder> jpgdecoder;
+#endif
 public:
     std::shared_ptr<IDecoder> GetDecoder(ImageDecoderType type, const char* arguments) override
     {
@@ -156,6 +179,20 @@ public:
 
             return this->zstd1decoder;
         }
+#if LIBCZI_LIBJPEG_BASED_DECODER_AVAILABLE
+        case ImageDecoderType::JPG_LibJpeg:
+        {
+            std::call_once(jpgDecoderInitialized,
+                [this]()
+                {
+                    this->jpgdecoder = CJpgLibJpegDecoder::Create();
+                });
+
+            return this->jpgdecoder;
+        }
+#endif
+        default:
+            break;
         }
 
         return shared_ptr<IDecoder>();
@@ -19,7 +19,9 @@ namespace libCZI
 
         ZStd0,          ///< Identifies a decoder capable of decoding a zstd compressed image (type "zstd0").
 
-        ZStd1           ///< Identifies a decoder capable of decoding a zstd compressed image (type "zstd1").
+        ZStd1,          ///< Identifies a decoder capable of decoding a zstd compressed image (type "zstd1").
+
+        JPG_LibJpeg     ///< Identifies a decoder capable of decoding a JPG compressed image. Note that this decoder is only available if libCZI was built with libjpeg-support.
     };
 
     class IBitmapData;
@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "plane_tile_iterator.h"
+#include "Site.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace libCZI;
+using namespace libCZI::detail;
+using namespace std;
+
+std::shared_ptr<IPlaneTileIterator> libCZI::CreatePlaneTileIterator(const std::shared_ptr<ISubBlockRepository>& repository, libCZI::PixelType pixeltype, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const libCZI::IntSize& tileSize, const PlaneTileIteratorOptions& options)
+{
+    if (!repository)
+    {
+        throw invalid_argument("A repository must be given.");
+    }
+
+    if (tileSize.w == 0 || tileSize.h == 0)
+    {
+        throw invalid_argument("The tile size must not be empty.");
+    }
+
+    return make_shared<PlaneTileIterator>(repository, pixeltype, roi, planeCoordinate, tileSize, options);
+}
+
+PlaneTileIterator::PlaneTileIterator(const std::shared_ptr<libCZI::ISubBlockRepository>& repository, libCZI::PixelType pixeltype, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const libCZI::IntSize& tileSize, const libCZI::PlaneTileIteratorOptions& options)
+    : CSingleChannelAccessorBase(repository), pixel_type_(pixeltype), roi_(roi), tile_size_(tileSize), options_(options)
+{
+    this->CheckPlaneCoordinates(planeCoordinate);
+    if (this->pixel_type_ == PixelType::Invalid && !this->TryGetPixelType(planeCoordinate, this->pixel_type_))
+    {
+        throw LibCZIAccessorException("Unable to determine the pixeltype.", LibCZIAccessorException::ErrorType::CouldntDeterminePixelType);
+    }
+
+    if (isnan(this->options_.backGroundColor.r) || isnan(this->options_.backGroundColor.g) || isnan(this->options_.backGroundColor.b))
+    {
+        this->options_.backGroundColor = RgbFloatColor{ 0, 0, 0 };
+    }
+
+    const bool is_roi_non_empty = this->roi_.IsNonEmpty();
+    this->columns_count_ = is_roi_non_empty ? (this->roi_.w + static_cast<int>(tileSize.w) - 1) / static_cast<int>(tileSize.w) : 0;
+    this->rows_count_ = is_roi_non_empty ? (this->roi_.h + static_cast<int>(tileSize.h) - 1) / static_cast<int>(tileSize.h) : 0;
+    this->DetermineSubBlocks(planeCoordinate);
+}
+
+/*virtual*/bool PlaneTileIterator::GetNext(libCZI::IntRect* tileRect, std::shared_ptr<libCZI::IBitmapData>* tile)
+{
+    if (this->next_column_ >= static_cast<int>(this->tiles_of_current_row_.size()))
+    {
+        if (this->current_row_ + 1 >= this->rows_count_)
+        {
+            return false;
+        }
+
+        ++this->current_row_;
+        this->ComposeRow(this->current_row_);
+        this->next_column_ = 0;
+    }
+
+    if (tileRect != nullptr)
+    {
+        *tileRect = this->GetTileRect(this->next_column_, this->current_row_);
+    }
+
+    // the iterator does not keep a reference to the tile once it has been handed out
+    if (tile != nullptr)
+    {
+        *tile = std::move(this->tiles_of_current_row_[this->next_column_]);
+    }
+
+    this->tiles_of_current_row_[this->next_column_].reset();
+    ++this->next_column_;
+    return true;
+}
+
+void PlaneTileIterator::DetermineSubBlocks(const libCZI::IDimCoordinate* planeCoordinate)
+{
+    if (this->rows_count_ == 0)
+    {
+        return;
+    }
+
+    struct FirstAndLastRow
+    {
+        int firstRow;
+        int lastRow;
+    };
+
+    vector<FirstAndLastRow> rows_of_sub_blocks;
+    this->sbBlkRepository->EnumSubset(
+        planeCoordinate,
+        &this->roi_,
+        true,
+        [&](int index, const SubBlockInfo& info)->bool
+        {
+            if (this->options_.sceneFilter)
+            {
+                int scene_index;
+                if (info.coordinate.TryGetPosition(DimensionIndex::S, &scene_index) && !this->options_.sceneFilter->IsContained(scene_index))
+                {
+                    return true;
+                }
+            }
+
+            // the intersection with the ROI is not empty here (otherwise the sub-block would not have been reported)
+            const int top = (max)(info.logicalRect.y, this->roi_.y);
+            const int bottom = (min)(info.logicalRect.y + info.logicalRect.h, this->roi_.y + this->roi_.h) - 1;
+            this->sub_blocks_.push_back(SubBlockEntry{ index, info.mIndex, (bottom - this->roi_.y) / static_cast<int>(this->tile_size_.h) });
+            rows_of_sub_blocks.push_back(FirstAndLastRow{ (top - this->roi_.y) / static_cast<int>(this->tile_size_.h), this->sub_blocks_.back().lastRow });
+            return true;
+        });
+
+    // determine the order in which the sub-blocks are to be drawn - the same as with the tile accessor
+    vector<int> order(this->sub_blocks_.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = static_cast<int>(i);
+    }
+
+    if (this->options_.sortByM)
+    {
+        stable_sort(order.begin(), order.end(), [this](int i1, int i2)->bool
+            {
+                // an invalid mIndex should go before a valid one - and "invalid mIndex" is represented by both maximum int and minimum int
+                const int mIndex1 = Utils::IsValidMindex(this->sub_blocks_[i1].mIndex) ? this->sub_blocks_[i1].mIndex : (numeric_limits<int>::min)();
+                const int mIndex2 = Utils::IsValidMindex(this->sub_blocks_[i2].mIndex) ? this->sub_blocks_[i2].mIndex : (numeric_limits<int>::min)();
+                return mIndex1 < mIndex2;
+            });
+    }
+
+    vector<SubBlockEntry> sub_blocks_in_order;
+    sub_blocks_in_order.reserve(order.size());
+    this->sub_blocks_per_row_.resize(this->rows_count_);
+    for (const int i : order)
+    {
+        const int position = static_cast<int>(sub_blocks_in_order.size());
+        sub_blocks_in_order.push_back(this->sub_blocks_[i]);
+        for (int row = rows_of_sub_blocks[i].firstRow; row <= rows_of_sub_blocks[i].lastRow; ++row)
+        {
+            this->sub_blocks_per_row_[row].push_back(position);
+        }
+    }
+
+    this->sub_blocks_ = std::move(sub_blocks_in_order);
+}
+
+void PlaneTileIterator::ComposeRow(int row)
+{
+    this->tiles_of_current_row_.clear();
+    for (int column = 0; column < this->columns_count_; ++column)
+    {
+        const IntRect tile_rect = this->GetTileRect(column, row);
+        auto tile = GetSite()->CreateBitmap(this->pixel_type_, tile_rect.w, tile_rect.h);
+        Clear(tile.get(), this->options_.backGroundColor);
+        this->tiles_of_current_row_.emplace_back(std::move(tile));
+    }
+
+    const vector<int>& sub_blocks_of_row = this->sub_blocks_per_row_[row];
+    vector<pair<int, SubBlockData>> sub_blocks_to_retain;
+
+    {
+        // the loader reads the sub-blocks (which are not already available from the previous row) in the order in which they are
+        //  to be drawn - note that 'retained_sub_blocks_' must not be modified while the loader's worker threads are running
+        SubBlockDataLoader loader(
+            static_cast<int>(sub_blocks_of_row.size()),
+            this->options_.decodeThreadCount,
+            [&](int index)->SubBlockData
+            {
+                const int position = sub_blocks_of_row[index];
+                const auto retained_sub_block = this->retained_sub_blocks_.find(position);
+                if (retained_sub_block != this->retained_sub_blocks_.cend())
+                {
+                    return retained_sub_block->second;
+                }
+
+                return CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
+                    this->sbBlkRepository,
+                    this->options_.subBlockCache,
+                    this->sub_blocks_[position].index,
+                    true,
+                    true,
+                    this->options_.maskAware);
+            });
+
+        Compositors::ComposeSingleTileOptions compose_options;
+        compose_options.Clear();
+        for (int i = 0; i < static_cast<int>(sub_blocks_of_row.size()); ++i)
+        {
+            SubBlockData sub_block_data = loader.Get(i);
+            const IntRect& logical_rect = sub_block_data.subBlockInfo.logicalRect;
+            const int first_column = ((max)(logical_rect.x, this->roi_.x) - this->roi_.x) / static_cast<int>(this->tile_size_.w);
+            const int last_column = ((min)(logical_rect.x + logical_rect.w, this->roi_.x + this->roi_.w) - 1 - this->roi_.x) / static_cast<int>(this->tile_size_.w);
+            for (int column = first_column; column <= last_column; ++column)
+            {
+                const IntRect tile_rect = this->GetTileRect(column, row);
+                Compositors::ComposeSingleChannelTilesMaskAware(
+                    [&](int index, std::shared_ptr<libCZI::IBitmapData>& spBm, std::shared_ptr<libCZI::IBitonalBitmapData>& spMask, int& xPosTile, int& yPosTile)->bool
+                    {
+                        if (index == 0)
+                        {
+                            spBm = sub_block_data.bitmap;
+                            spMask = sub_block_data.mask;
+                            xPosTile = logical_rect.x;
+                            yPosTile = logical_rect.y;
+                            return true;
+                        }
+
+                        return false;
+                    },
+                    this->tiles_of_current_row_[column].get(),
+                    tile_rect.x,
+                    tile_rect.y,
+                    &compose_options);
+            }
+
+            if (this->sub_blocks_[sub_blocks_of_row[i]].lastRow > row)
+            {
+                sub_blocks_to_retain.emplace_back(sub_blocks_of_row[i], std::move(sub_block_data));
+            }
+        }
+    }
+
+    // now release the sub-blocks which are not needed for the rows to come, and keep the ones which are
+    for (auto iterator = this->retained_sub_blocks_.begin(); iterator != this->retained_sub_blocks_.end();)
+    {
+        if (this->sub_blocks_[iterator->first].lastRow <= row)
+        {
+            iterator = this->retained_sub_blocks_.erase(iterator);
+        }
+        else
+        {
+            ++iterator;
+        }
+    }
+
+    for (auto& sub_block_to_retain : sub_blocks_to_retain)
+    {
+        this->retained_sub_blocks_[sub_block_to_retain.first] = std::move(sub_block_to_retain.second);
+    }
+}
+
+libCZI::IntRect PlaneTileIterator::GetTileRect(int column, int row) const
+{
+    const int tile_width = static_cast<int>(this->tile_size_.w);
+    const int tile_height = static_cast<int>(this->tile_size_.h);
+    return IntRect
+    {
+        this->roi_.x + column * tile_width,
+        this->roi_.y + row * tile_height,
+        (min)(tile_width, this->roi_.w - column * tile_width),
+        (min)(tile_height, this->roi_.h - row * tile_height)
+    };
+}
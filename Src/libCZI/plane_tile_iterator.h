@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include "libCZI.h"
+#include "SingleChannelAccessorBase.h"
+#include <unordered_map>
+#include <vector>
+
+namespace libCZI
+{
+    namespace detail
+    {
+        /// Implementation of the plane-tile iterator. When the iterator is constructed, the sub-blocks of the ROI are determined (once),
+        /// sorted into their Z-order, and for every row of tiles the list of sub-blocks intersecting this row is gathered. The tiles
+        /// are then composed row by row - the sub-blocks of a row are loaded (with the SubBlockDataLoader) in Z-order, and every
+        /// sub-block is drawn into all tiles of the row it intersects. A sub-block which extends into the next row is kept until
+        /// this row has been composed, so that every sub-block is loaded exactly once.
+        class PlaneTileIterator : public CSingleChannelAccessorBase, public libCZI::IPlaneTileIterator
+        {
+        private:
+            struct SubBlockEntry
+            {
+                int index;          ///< The index of the sub-block (in the repository).
+                int mIndex;         ///< The M-index of the sub-block.
+                int lastRow;        ///< The last row of tiles which the sub-block intersects.
+            };
+
+            libCZI::PixelType pixel_type_;
+            libCZI::IntRect roi_;
+            libCZI::IntSize tile_size_;
+            libCZI::PlaneTileIteratorOptions options_;
+            int columns_count_;
+            int rows_count_;
+
+            std::vector<SubBlockEntry> sub_blocks_;                         ///< The sub-blocks of the ROI, in the order in which they are to be drawn.
+            std::vector<std::vector<int>> sub_blocks_per_row_;              ///< For every row of tiles, the (ascending) positions in 'sub_blocks_' of the sub-blocks intersecting it.
+            std::unordered_map<int, SubBlockData> retained_sub_blocks_;     ///< The data of the sub-blocks which intersect the rows still to come (keyed by position in 'sub_blocks_').
+
+            int current_row_{ -1 };
+            int next_column_{ 0 };
+            std::vector<std::shared_ptr<libCZI::IBitmapData>> tiles_of_current_row_;
+        public:
+            PlaneTileIterator(const std::shared_ptr<libCZI::ISubBlockRepository>& repository, libCZI::PixelType pixeltype, const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, const libCZI::IntSize& tileSize, const libCZI::PlaneTileIteratorOptions& options);
+
+            bool GetNext(libCZI::IntRect* tileRect, std::shared_ptr<libCZI::IBitmapData>* tile) override;
+        private:
+            void DetermineSubBlocks(const libCZI::IDimCoordinate* planeCoordinate);
+            void ComposeRow(int row);
+            libCZI::IntRect GetTileRect(int column, int row) const;
+        };
+    } // namespace detail
+} // namespace libCZI
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "rendered_tile_cache.h"
+#include <atomic>
+
+using namespace libCZI;
+using namespace libCZI::detail;
+using namespace std;
+
+std::shared_ptr<IRenderedTileCache> libCZI::CreateRenderedTileCache(const ISubBlockCacheControl::PruneOptions& capacity)
+{
+    return make_shared<RenderedTileCache>(capacity);
+}
+
+/*static*/std::uint64_t IRepositoryInstanceIdentity::CreateNewRepositoryInstanceId()
+{
+    static atomic<uint64_t> last_instance_id{ 0 };
+    return ++last_instance_id;
+}
+
+RenderedTileCache::RenderedTileCache(const PruneOptions& capacity)
+    : capacity_(capacity)
+{
+}
+
+std::shared_ptr<libCZI::IBitmapData> RenderedTileCache::Get(const std::string& key)
+{
+    lock_guard<mutex> lck(this->mutex_);
+    const auto element = this->cache_.find(key);
+    if (element == this->cache_.end())
+    {
+        this->counters_.IncrementMisses();
+        return nullptr;
+    }
+
+    this->counters_.IncrementHits();
+
+    // mark the entry as the most recently used one
+    this->lru_.splice(this->lru_.begin(), this->lru_, element->second.lru_position);
+    return element->second.bitmap;
+}
+
+void RenderedTileCache::Add(const std::string& key, const std::shared_ptr<libCZI::IBitmapData>& bitmap)
+{
+    const IntSize size = bitmap->GetSize();
+    const uint64_t size_in_bytes = static_cast<uint64_t>(size.w) * size.h * Utils::GetBytesPerPixel(bitmap->GetPixelType());
+
+    lock_guard<mutex> lck(this->mutex_);
+    const auto result = this->cache_.emplace(key, CacheEntry{});
+    CacheEntry& entry = result.first->second;
+    if (result.second)
+    {
+        this->lru_.push_front(key);
+        this->counters_.IncrementInsertions();
+    }
+    else
+    {
+        this->cache_size_in_bytes_ -= entry.size_in_bytes;
+        this->lru_.splice(this->lru_.begin(), this->lru_, entry.lru_position);
+    }
+
+    entry.bitmap = bitmap;
+    entry.size_in_bytes = size_in_bytes;
+    entry.lru_position = this->lru_.begin();
+    this->cache_size_in_bytes_ += size_in_bytes;
+
+    this->PruneByMemoryUsageAndElementCount(this->capacity_.maxMemoryUsage, this->capacity_.maxSubBlockCount);
+}
+
+void RenderedTileCache::Prune(const PruneOptions& options)
+{
+    lock_guard<mutex> lck(this->mutex_);
+    this->PruneByMemoryUsageAndElementCount(options.maxMemoryUsage, options.maxSubBlockCount);
+}
+
+ISubBlockCacheStatistics::Statistics RenderedTileCache::GetStatistics(std::uint8_t mask) const
+{
+    Statistics result = this->GetMemoryUsageAndElementsCount(mask);
+    this->counters_.AddToStatistics(mask, result);
+    return result;
+}
+
+ISubBlockCacheStatistics::Statistics RenderedTileCache::GetStatisticsAndResetCounters(std::uint8_t mask)
+{
+    Statistics result = this->GetMemoryUsageAndElementsCount(mask);
+    this->counters_.AddToStatisticsAndReset(mask, result);
+    return result;
+}
+
+ISubBlockCacheStatistics::Statistics RenderedTileCache::GetMemoryUsageAndElementsCount(std::uint8_t mask) const
+{
+    Statistics result{};
+    lock_guard<mutex> lck(this->mutex_);
+    if ((mask & ISubBlockCacheStatistics::kMemoryUsage) != 0)
+    {
+        result.validityMask |= ISubBlockCacheStatistics::kMemoryUsage;
+        result.memoryUsage = this->cache_size_in_bytes_;
+    }
+
+    if ((mask & ISubBlockCacheStatistics::kElementsCount) != 0)
+    {
+        result.validityMask |= ISubBlockCacheStatistics::kElementsCount;
+        result.elementsCount = static_cast<uint32_t>(this->cache_.size());
+    }
+
+    return result;
+}
+
+void RenderedTileCache::PruneByMemoryUsageAndElementCount(std::uint64_t max_memory_usage, std::uint32_t max_element_count)
+{
+    // note: the caller must hold the lock
+    while (this->cache_size_in_bytes_ > max_memory_usage || this->cache_.size() > max_element_count)
+    {
+        const auto element = this->cache_.find(this->lru_.back());
+        this->cache_size_in_bytes_ -= element->second.size_in_bytes;
+        this->counters_.AddEviction(element->second.size_in_bytes);
+        this->cache_.erase(element);
+        this->lru_.pop_back();
+    }
+}
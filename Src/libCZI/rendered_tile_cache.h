@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include "libCZI.h"
+#include "subblock_cache.h"
+#include <unordered_map>
+#include <list>
+#include <string>
+#include <cstdint>
+#include <mutex>
+
+namespace libCZI
+{
+    namespace detail
+    {
+        /// This interface is implemented by sub-block repositories which can give an identity of their current "instance", i.e. of
+        /// the content they are operating on. The identity is unique within the process and it changes whenever the content may
+        /// have changed (e.g. when the repository is closed and opened again). It is used in order to tie the entries of a
+        /// rendered-tile cache to the reader they have been rendered from.
+        class IRepositoryInstanceIdentity
+        {
+        public:
+            /// Gets the identity of the current instance. A value of 0 indicates that there is no valid identity (e.g. because
+            /// the repository is not operational), in which case the results must not be cached.
+            ///
+            /// \returns    The identity of the instance (or 0 if not available).
+            virtual std::uint64_t GetRepositoryInstanceId() const = 0;
+
+            /// Gets a new instance identity - every call gives a different (non-zero) value.
+            ///
+            /// \returns    The new identity.
+            static std::uint64_t CreateNewRepositoryInstanceId();
+
+            virtual ~IRepositoryInstanceIdentity() = default;
+        };
+
+        /// A simplistic implementation of the rendered-tile cache. It is thread-safe and uses a LRU eviction strategy, the
+        /// capacity given at construction is enforced with every Add-operation.
+        class RenderedTileCache : public libCZI::IRenderedTileCache
+        {
+        private:
+            struct CacheEntry
+            {
+                std::shared_ptr<libCZI::IBitmapData> bitmap;        ///< The cached bitmap.
+                std::uint64_t size_in_bytes{ 0 };                   ///< The size of the bitmap in bytes.
+                std::list<std::string>::iterator lru_position;      ///< The position of this entry's key in the LRU-list.
+            };
+
+            std::unordered_map<std::string, CacheEntry> cache_;
+            std::list<std::string> lru_;                            ///< The keys ordered by the time of last access, the most recently used one first.
+            mutable std::mutex mutex_;
+            std::uint64_t cache_size_in_bytes_{ 0 };                ///< The current size of the cache in bytes (guarded by mutex_).
+            PruneOptions capacity_;                                 ///< The capacity of the cache, which is enforced with every Add-operation.
+            CacheCounters counters_;                                ///< The counters (hits, misses, insertions and evictions).
+        public:
+            explicit RenderedTileCache(const PruneOptions& capacity);
+            ~RenderedTileCache() override = default;
+
+            std::shared_ptr<libCZI::IBitmapData> Get(const std::string& key) override;
+            void Add(const std::string& key, const std::shared_ptr<libCZI::IBitmapData>& bitmap) override;
+            void Prune(const PruneOptions& options) override;
+            Statistics GetStatistics(std::uint8_t mask) const override;
+            Statistics GetStatisticsAndResetCounters(std::uint8_t mask) override;
+        private:
+            Statistics GetMemoryUsageAndElementsCount(std::uint8_t mask) const;
+            void PruneByMemoryUsageAndElementCount(std::uint64_t max_memory_usage, std::uint32_t max_element_count);
+        };
+    } // namespace detail
+} // namespace libCZI
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "subblock_cache.h"
+#include <sstream>
 
 using namespace libCZI;
 using namespace libCZI::detail;
@@ -13,9 +14,53 @@ std::shared_ptr<ISubBlockCache> libCZI::CreateSubBlockCache()
     return make_shared<SubBlockCache>();
 }
 
+std::shared_ptr<ISubBlockCache> libCZI::CreateSubBlockCache(const SubBlockCacheOptions& options)
+{
+    if (options.numberOfShards > 1)
+    {
+        return make_shared<ShardedSubBlockCache>(options);
+    }
+
+    return make_shared<SubBlockCache>(options);
+}
+
+std::shared_ptr<IMultiFileSubBlockCache> libCZI::CreateMultiFileSubBlockCache(const SubBlockCacheOptions& options)
+{
+    return make_shared<MultiFileSubBlockCache>(options);
+}
+
+SubBlockCache::SubBlockCache(const libCZI::SubBlockCacheOptions& options)
+    : capacity_(options.capacity), compressed_max_memory_usage_(options.compressedTierMaxMemoryUsage)
+{
+    if (options.admissionPolicy == SubBlockCacheOptions::AdmissionPolicy::TinyLfu && SubBlockCache::IsLimitGiven(options.capacity))
+    {
+        // if only a memory limit is given, we do not know the number of elements to expect - so we use a default
+        const uint32_t expected_number_of_elements =
+            options.capacity.maxSubBlockCount != (numeric_limits<decltype(options.capacity.maxSubBlockCount)>::max)() ?
+            options.capacity.maxSubBlockCount :
+            4096;
+        this->frequency_sketch_.reset(new FrequencySketch(expected_number_of_elements));
+    }
+}
+
 ISubBlockCacheStatistics::Statistics SubBlockCache::GetStatistics(std::uint8_t mask) const
+{
+    Statistics result = this->GetMemoryUsageAndElementsCount(mask);
+    this->counters_.AddToStatistics(mask, result);
+    return result;
+}
+
+ISubBlockCacheStatistics::Statistics SubBlockCache::GetStatisticsAndResetCounters(std::uint8_t mask)
+{
+    Statistics result = this->GetMemoryUsageAndElementsCount(mask);
+    this->counters_.AddToStatisticsAndReset(mask, result);
+    return result;
+}
+
+ISubBlockCacheStatistics::Statistics SubBlockCache::GetMemoryUsageAndElementsCount(std::uint8_t mask) const
 {
     Statistics result{};
+    mask &= (ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount);
     if (mask == ISubBlockCacheStatistics::kMemoryUsage)
     {
         result.validityMask = ISubBlockCacheStatistics::kMemoryUsage;
@@ -41,67 +86,431 @@ ISubBlockCacheStatistics::Statistics SubBlockCache::GetStatistics(std::uint8_t m
 
 ISubBlockCacheOperation::CacheItem SubBlockCache::Get(int subblock_index)
 {
+    return this->GetByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index));
+}
+
+void SubBlockCache::Add(int subblock_index, const ISubBlockCacheOperation::CacheItem& cache_item)
+{
+    this->AddByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index), cache_item);
+}
+
+ISubBlockCacheOperation::CacheItem SubBlockCache::GetOrLoad(int subblock_index, const std::function<CacheItem(bool& add_to_cache)>& load_function)
+{
+    return this->GetOrLoadByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index), load_function);
+}
+
+ISubBlockCacheOperation::CacheItem SubBlockCache::GetDownscaled(int subblock_index, std::uint8_t scale_level)
+{
+    SubBlockCache::ThrowIfScaleLevelIsInvalid(scale_level);
+    return this->GetByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index, scale_level));
+}
+
+void SubBlockCache::AddDownscaled(int subblock_index, std::uint8_t scale_level, const CacheItem& cache_item)
+{
+    SubBlockCache::ThrowIfScaleLevelIsInvalid(scale_level);
+    this->AddByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index, scale_level), cache_item);
+}
+
+std::shared_ptr<libCZI::ISubBlock> SubBlockCache::GetCompressedSubBlock(int subblock_index)
+{
+    return this->GetCompressedSubBlockByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index));
+}
+
+void SubBlockCache::AddCompressedSubBlock(int subblock_index, const std::shared_ptr<libCZI::ISubBlock>& sub_block)
+{
+    this->AddCompressedSubBlockByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index), sub_block);
+}
+
+ISubBlockCacheOperation::CacheItem SubBlockCache::GetByKey(std::uint64_t key)
+{
+    CacheItem item;
     lock_guard<mutex> lck(this->mutex_);
-    const auto element = this->cache_.find(subblock_index);
-    if (element != this->cache_.end())
+    this->RecordAccess(key);
+    if (this->TryGetAndMarkAsUsed(key, item))
+    {
+        this->counters_.IncrementHits();
+    }
+    else
     {
-        element->second.lru_value = this->lru_counter_.fetch_add(1);
-        return { element->second.bitmap, element->second.mask };
+        this->counters_.IncrementMisses();
     }
 
-    return {};
+    return item;
 }
 
-void SubBlockCache::Add(int subblock_index, const ISubBlockCacheOperation::CacheItem& cache_item)
+ISubBlockCacheOperation::CacheItem SubBlockCache::GetOrLoadByKey(std::uint64_t key, const std::function<CacheItem(bool& add_to_cache)>& load_function)
+{
+    shared_ptr<InFlightLoad> in_flight_load;
+    {
+        unique_lock<mutex> lck(this->mutex_);
+        this->RecordAccess(key);
+        for (;;)
+        {
+            CacheItem item;
+            if (this->TryGetAndMarkAsUsed(key, item))
+            {
+                this->counters_.IncrementHits();
+                return item;
+            }
+
+            const auto in_flight_element = this->in_flight_loads_.find(key);
+            if (in_flight_element == this->in_flight_loads_.end())
+            {
+                break;
+            }
+
+            // another thread is loading this sub-block, so we wait for it to finish
+            const auto other_load = in_flight_element->second;
+            other_load->done_condition.wait(lck, [&other_load] { return other_load->done; });
+            if (other_load->item_valid)
+            {
+                this->counters_.IncrementHits();
+                return other_load->item;
+            }
+
+            // The other load-operation did not give an item we can use (either it failed, or its result is not
+            //  to be added to the cache), so we start over - and most likely do the load ourselves.
+        }
+
+        in_flight_load = make_shared<InFlightLoad>();
+        this->in_flight_loads_.emplace(key, in_flight_load);
+        this->counters_.IncrementMisses();
+    }
+
+    // now we are responsible for loading the sub-block, which we do without holding the lock
+    CacheItem item;
+    bool add_to_cache = true;
+    try
+    {
+        const auto start_time = chrono::steady_clock::now();
+        item = load_function(add_to_cache);
+        this->counters_.AddLoadLatency(chrono::steady_clock::now() - start_time);
+    }
+    catch (...)
+    {
+        this->PublishLoadResult(key, in_flight_load, false, CacheItem());
+        throw;
+    }
+
+    // the item is added to the cache when publishing the result (under the same lock), so that a removal of the entry while
+    //  the load was in progress cannot be undone by adding the (stale) item afterwards
+    const bool item_is_to_be_shared = add_to_cache && item.IsValid();
+    this->PublishLoadResult(key, in_flight_load, item_is_to_be_shared, item);
+    return item;
+}
+
+void SubBlockCache::AddByKey(std::uint64_t key, const ISubBlockCacheOperation::CacheItem& cache_item)
 {
     const auto size_of_added_cache_item = SubBlockCache::CalculateSizeInBytes(cache_item.bitmap.get(), cache_item.mask.get());
-    const auto entry_to_be_added = CacheEntry{ cache_item.bitmap, cache_item.mask, this->lru_counter_.fetch_add(1) };
 
     lock_guard<mutex> lck(this->mutex_);
-    const auto result = this->cache_.insert({ subblock_index, entry_to_be_added });
+    this->AddEntry(key, cache_item, size_of_added_cache_item);
+}
+
+void SubBlockCache::AddEntry(std::uint64_t key, const CacheItem& cache_item, std::uint64_t size_of_added_cache_item)
+{
+    // note: the caller must hold the lock
+    this->RecordAccess(key);
+    if (this->frequency_sketch_ && this->cache_.find(key) == this->cache_.end() && !this->IsToBeAdmitted(key, size_of_added_cache_item))
+    {
+        return;
+    }
+
+    const auto result = this->cache_.emplace(key, CacheEntry{});
+    CacheEntry* entry = &result.first->second;
     if (result.second)
     {
         // New element inserted
+        entry->key = key;
         this->cache_size_in_bytes_ += size_of_added_cache_item;
         ++this->cache_subblock_count_;
+        this->counters_.IncrementInsertions();
     }
     else
     {
         // Element with the same key already existed
-        this->cache_size_in_bytes_ -= SubBlockCache::CalculateSizeInBytes(result.first->second.bitmap.get(), result.first->second.mask.get());
-        result.first->second = entry_to_be_added;
+        this->cache_size_in_bytes_ -= entry->size_in_bytes;
         this->cache_size_in_bytes_ += size_of_added_cache_item;
+        SubBlockCache::Unlink(this->lru_, entry);
+    }
+
+    entry->bitmap = cache_item.bitmap;
+    entry->mask = cache_item.mask;
+    entry->size_in_bytes = size_of_added_cache_item;
+    SubBlockCache::LinkAsMostRecentlyUsed(this->lru_, entry);
+
+    if (SubBlockCache::IsLimitGiven(this->capacity_))
+    {
+        this->PruneByMemoryUsageAndElementCount(this->capacity_.maxMemoryUsage, this->capacity_.maxSubBlockCount);
+    }
+}
+
+std::shared_ptr<libCZI::ISubBlock> SubBlockCache::GetCompressedSubBlockByKey(std::uint64_t key)
+{
+    if (this->compressed_max_memory_usage_ == 0)
+    {
+        return nullptr;
+    }
+
+    lock_guard<mutex> lck(this->mutex_);
+    const auto element = this->compressed_cache_.find(key);
+    if (element == this->compressed_cache_.end())
+    {
+        return nullptr;
+    }
+
+    CacheEntry* entry = &element->second;
+    SubBlockCache::Unlink(this->compressed_lru_, entry);
+    SubBlockCache::LinkAsMostRecentlyUsed(this->compressed_lru_, entry);
+    return entry->sub_block;
+}
+
+void SubBlockCache::AddCompressedSubBlockByKey(std::uint64_t key, const std::shared_ptr<libCZI::ISubBlock>& sub_block)
+{
+    if (this->compressed_max_memory_usage_ == 0)
+    {
+        return;
+    }
+
+    const auto size_of_sub_block = SubBlockCache::CalculateSizeInBytes(sub_block.get());
+    if (size_of_sub_block > this->compressed_max_memory_usage_)
+    {
+        // this one would not fit even into an empty compressed tier
+        return;
+    }
+
+    lock_guard<mutex> lck(this->mutex_);
+    const auto result = this->compressed_cache_.emplace(key, CacheEntry{});
+    CacheEntry* entry = &result.first->second;
+    if (result.second)
+    {
+        entry->key = key;
+    }
+    else
+    {
+        this->compressed_size_in_bytes_ -= entry->size_in_bytes;
+        SubBlockCache::Unlink(this->compressed_lru_, entry);
+    }
+
+    entry->sub_block = sub_block;
+    entry->size_in_bytes = size_of_sub_block;
+    this->compressed_size_in_bytes_ += size_of_sub_block;
+    SubBlockCache::LinkAsMostRecentlyUsed(this->compressed_lru_, entry);
+
+    while (this->compressed_size_in_bytes_ > this->compressed_max_memory_usage_)
+    {
+        CacheEntry* oldest_element = this->compressed_lru_.tail;
+        SubBlockCache::Unlink(this->compressed_lru_, oldest_element);
+        this->compressed_size_in_bytes_ -= oldest_element->size_in_bytes;
+        this->compressed_cache_.erase(oldest_element->key);
+    }
+}
+
+void SubBlockCache::RemoveEntries(const std::function<bool(std::uint64_t key)>& predicate)
+{
+    lock_guard<mutex> lck(this->mutex_);
+    for (const auto& in_flight_load : this->in_flight_loads_)
+    {
+        if (predicate(in_flight_load.first))
+        {
+            in_flight_load.second->invalidated = true;
+        }
+    }
+
+    for (auto iterator = this->cache_.begin(); iterator != this->cache_.end();)
+    {
+        if (predicate(iterator->first))
+        {
+            CacheEntry* entry = &iterator->second;
+            SubBlockCache::Unlink(this->lru_, entry);
+            this->cache_size_in_bytes_ -= entry->size_in_bytes;
+            --this->cache_subblock_count_;
+            iterator = this->cache_.erase(iterator);
+        }
+        else
+        {
+            ++iterator;
+        }
+    }
+
+    for (auto iterator = this->compressed_cache_.begin(); iterator != this->compressed_cache_.end();)
+    {
+        if (predicate(iterator->first))
+        {
+            CacheEntry* entry = &iterator->second;
+            SubBlockCache::Unlink(this->compressed_lru_, entry);
+            this->compressed_size_in_bytes_ -= entry->size_in_bytes;
+            iterator = this->compressed_cache_.erase(iterator);
+        }
+        else
+        {
+            ++iterator;
+        }
     }
 }
 
 void SubBlockCache::Prune(const PruneOptions& options)
 {
-    if (options.maxMemoryUsage != numeric_limits<decltype(options.maxMemoryUsage)>::max() ||
-        options.maxSubBlockCount != numeric_limits<decltype(options.maxSubBlockCount)>::max())
+    if (SubBlockCache::IsLimitGiven(options))
     {
         lock_guard<mutex> lck(this->mutex_);
         this->PruneByMemoryUsageAndElementCount(options.maxMemoryUsage, options.maxSubBlockCount);
     }
 }
 
+bool SubBlockCache::TryGetAndMarkAsUsed(std::uint64_t key, CacheItem& item)
+{
+    // note: the caller must hold the lock
+    const auto element = this->cache_.find(key);
+    if (element == this->cache_.end())
+    {
+        return false;
+    }
+
+    CacheEntry* entry = &element->second;
+    SubBlockCache::Unlink(this->lru_, entry);
+    SubBlockCache::LinkAsMostRecentlyUsed(this->lru_, entry);
+    item.bitmap = entry->bitmap;
+    item.mask = entry->mask;
+    return true;
+}
+
+bool SubBlockCache::IsToBeAdmitted(std::uint64_t key, std::uint64_t size_in_bytes) const
+{
+    // note: the caller must hold the lock
+    if (this->cache_size_in_bytes_.load() + size_in_bytes <= this->capacity_.maxMemoryUsage &&
+        this->cache_subblock_count_.load() < this->capacity_.maxSubBlockCount)
+    {
+        // there is room for the new element, so nothing has to be evicted
+        return true;
+    }
+
+    // The new element would displace the least recently used elements (as many as are necessary in order to make room for it), which
+    //  we only allow if the new element is used more often than each one of them. Note that in case of a tie, we keep the element which
+    //  is already in the cache.
+    const auto frequency_of_new_element = this->frequency_sketch_->Estimate(key);
+    uint64_t size_in_bytes_after_eviction = this->cache_size_in_bytes_.load();
+    uint32_t count_after_eviction = this->cache_subblock_count_.load();
+    for (const CacheEntry* victim = this->lru_.tail;
+        victim != nullptr && (size_in_bytes_after_eviction + size_in_bytes > this->capacity_.maxMemoryUsage || count_after_eviction >= this->capacity_.maxSubBlockCount);
+        victim = victim->lru_previous)
+    {
+        if (frequency_of_new_element <= this->frequency_sketch_->Estimate(victim->key))
+        {
+            return false;
+        }
+
+        size_in_bytes_after_eviction -= victim->size_in_bytes;
+        --count_after_eviction;
+    }
+
+    return true;
+}
+
+void SubBlockCache::RecordAccess(std::uint64_t key)
+{
+    // note: the caller must hold the lock
+    if (this->frequency_sketch_)
+    {
+        this->frequency_sketch_->Increment(key);
+    }
+}
+
+void SubBlockCache::PublishLoadResult(std::uint64_t key, const std::shared_ptr<InFlightLoad>& in_flight_load, bool item_valid, const CacheItem& item)
+{
+    const auto size_of_item = item_valid ? SubBlockCache::CalculateSizeInBytes(item.bitmap.get(), item.mask.get()) : 0;
+    {
+        lock_guard<mutex> lck(this->mutex_);
+        if (item_valid && !in_flight_load->invalidated)
+        {
+            this->AddEntry(key, item, size_of_item);
+        }
+
+        this->in_flight_loads_.erase(key);
+        in_flight_load->done = true;
+        in_flight_load->item_valid = item_valid;
+        if (item_valid)
+        {
+            in_flight_load->item = item;
+        }
+    }
+
+    in_flight_load->done_condition.notify_all();
+}
+
 void SubBlockCache::PruneByMemoryUsageAndElementCount(std::uint64_t max_memory_usage, std::uint32_t max_element_count)
 {
-    // TODO(JBL): This is a very simple implementation of the prune operation. We determine the oldest element and remove it.
-    //            This is repeated until the cache size is below the maximum memory usage and the element count is below the maximum element count.
-    //            Detrimental is the fact that we have to iterate over all elements in the cache to determine the oldest element, and we might have 
-    //            to do this multiple times. If the number of elements in the cache is large, this might be a performance bottleneck.
+    // the least recently used element is the tail of the LRU-list, so we remove elements from the tail until both conditions are met
     while (this->cache_size_in_bytes_.load() > max_memory_usage || this->cache_subblock_count_.load() > max_element_count)
     {
-        auto oldest_element = std::min_element(this->cache_.begin(), this->cache_.end(), SubBlockCache::CompareForLruValue);
-        if (oldest_element == this->cache_.end())
+        CacheEntry* oldest_element = this->lru_.tail;
+        if (oldest_element == nullptr)
         {
             break;
         }
 
-        this->cache_size_in_bytes_ -= SubBlockCache::CalculateSizeInBytes(oldest_element->second); /// SubBlockCache::CalculateSizeInBytes(oldest_element->second.bitmap.get());
+        SubBlockCache::Unlink(this->lru_, oldest_element);
+        this->cache_size_in_bytes_ -= oldest_element->size_in_bytes;
         --this->cache_subblock_count_;
-        this->cache_.erase(oldest_element);
+        this->counters_.AddEviction(oldest_element->size_in_bytes);
+        this->cache_.erase(oldest_element->key);
+    }
+}
+
+/*static*/void SubBlockCache::ThrowIfScaleLevelIsInvalid(std::uint8_t scale_level)
+{
+    if (scale_level < 1 || scale_level > 15)
+    {
+        stringstream ss;
+        ss << "The scale level " << static_cast<int>(scale_level) << " is invalid, it must be in the range 1 to 15.";
+        throw invalid_argument(ss.str());
+    }
+}
+
+/*static*/bool SubBlockCache::IsLimitGiven(const PruneOptions& options)
+{
+    return options.maxMemoryUsage != numeric_limits<decltype(options.maxMemoryUsage)>::max() ||
+        options.maxSubBlockCount != numeric_limits<decltype(options.maxSubBlockCount)>::max();
+}
+
+/*static*/void SubBlockCache::LinkAsMostRecentlyUsed(LruList& list, CacheEntry* entry)
+{
+    entry->lru_previous = nullptr;
+    entry->lru_next = list.head;
+    if (list.head != nullptr)
+    {
+        list.head->lru_previous = entry;
+    }
+    else
+    {
+        list.tail = entry;
+    }
+
+    list.head = entry;
+}
+
+/*static*/void SubBlockCache::Unlink(LruList& list, CacheEntry* entry)
+{
+    if (entry->lru_previous != nullptr)
+    {
+        entry->lru_previous->lru_next = entry->lru_next;
+    }
+    else
+    {
+        list.head = entry->lru_next;
+    }
+
+    if (entry->lru_next != nullptr)
+    {
+        entry->lru_next->lru_previous = entry->lru_previous;
     }
+    else
+    {
+        list.tail = entry->lru_previous;
+    }
+
+    entry->lru_previous = nullptr;
+    entry->lru_next = nullptr;
 }
 
 /*static*/std::uint64_t SubBlockCache::CalculateSizeInBytes(const libCZI::IBitmapData* bitmap)
@@ -121,17 +530,475 @@ void SubBlockCache::PruneByMemoryUsageAndElementCount(std::uint64_t max_memory_u
     return static_cast<uint64_t>((size.w + 7) / 8) * size.h;
 }
 
+/*static*/std::uint64_t SubBlockCache::CalculateSizeInBytes(const libCZI::ISubBlock* sub_block)
+{
+    uint64_t size_in_bytes = 0;
+    for (const auto type : { ISubBlock::MemBlkType::Metadata, ISubBlock::MemBlkType::Data, ISubBlock::MemBlkType::Attachment })
+    {
+        const void* ptr;
+        size_t size;
+        sub_block->DangerousGetRawData(type, ptr, size);
+        size_in_bytes += size;
+    }
+
+    return size_in_bytes;
+}
+
 /*static*/std::uint64_t SubBlockCache::CalculateSizeInBytes(const libCZI::IBitmapData* bitmap, const libCZI::IBitonalBitmapData* mask)
 {
     return SubBlockCache::CalculateSizeInBytes(bitmap) + SubBlockCache::CalculateSizeInBytes(mask);
 }
 
-/*static*/std::uint64_t SubBlockCache::CalculateSizeInBytes(const CacheEntry& entry)
+//----------------------------------------------------------------------------
+
+FrequencySketch::FrequencySketch(std::uint32_t expected_number_of_elements)
+{
+    // The width is the next power of two of eight times the expected number of elements (within some reasonable bounds), so
+    //  that the estimates are not dominated by collisions. The counters are aged after ten times the number of elements
+    //  have been counted.
+    const uint32_t clamped_number_of_elements = (min)((max)(expected_number_of_elements, 64u), 1u << 18);
+    uint32_t width = 1;
+    while (width < clamped_number_of_elements * 8)
+    {
+        width <<= 1;
+    }
+
+    this->counters_.resize(static_cast<size_t>(width) * kDepth);
+    this->width_mask_ = width - 1;
+    this->sample_size_ = clamped_number_of_elements * 10;
+}
+
+void FrequencySketch::Increment(std::uint64_t key)
+{
+    uint32_t indices[kDepth];
+    this->GetCounterIndices(key, indices);
+    bool incremented = false;
+    for (int i = 0; i < kDepth; ++i)
+    {
+        uint8_t& counter = this->counters_[indices[i]];
+        if (counter < kMaxCount)
+        {
+            ++counter;
+            incremented = true;
+        }
+    }
+
+    if (incremented && ++this->additions_ >= this->sample_size_)
+    {
+        this->Age();
+    }
+}
+
+std::uint8_t FrequencySketch::Estimate(std::uint64_t key) const
+{
+    uint32_t indices[kDepth];
+    this->GetCounterIndices(key, indices);
+    uint8_t estimate = kMaxCount;
+    for (int i = 0; i < kDepth; ++i)
+    {
+        estimate = (min)(estimate, this->counters_[indices[i]]);
+    }
+
+    return estimate;
+}
+
+void FrequencySketch::GetCounterIndices(std::uint64_t key, std::uint32_t(&indices)[kDepth]) const
 {
-    return SubBlockCache::CalculateSizeInBytes(entry.bitmap.get(), entry.mask.get());
+    // we derive the indices for the rows from one 64-bit hash (the finalizer of the 64-bit MurmurHash3) by
+    //  double hashing, and each row is a separate section of the counters-array
+    uint64_t hash = key;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    const uint32_t hash1 = static_cast<uint32_t>(hash);
+    const uint32_t hash2 = static_cast<uint32_t>(hash >> 32) | 1;
+    for (int i = 0; i < kDepth; ++i)
+    {
+        indices[i] = i * (this->width_mask_ + 1) + ((hash1 + i * hash2) & this->width_mask_);
+    }
+}
+
+void FrequencySketch::Age()
+{
+    for (auto& counter : this->counters_)
+    {
+        counter >>= 1;
+    }
+
+    this->additions_ /= 2;
+}
+
+//----------------------------------------------------------------------------
+
+ShardedSubBlockCache::ShardedSubBlockCache(const libCZI::SubBlockCacheOptions& options)
+{
+    const uint32_t number_of_shards = (max)(options.numberOfShards, 1u);
+    this->shards_.reserve(number_of_shards);
+    SubBlockCacheOptions options_for_shard;
+    options_for_shard.capacity = ShardedSubBlockCache::DivideLimitsAmongShards(options.capacity, number_of_shards);
+    options_for_shard.admissionPolicy = options.admissionPolicy;
+    options_for_shard.compressedTierMaxMemoryUsage =
+        options.compressedTierMaxMemoryUsage / number_of_shards + (options.compressedTierMaxMemoryUsage % number_of_shards != 0 ? 1 : 0);
+    for (uint32_t i = 0; i < number_of_shards; ++i)
+    {
+        this->shards_.emplace_back(new SubBlockCache(options_for_shard));
+    }
+}
+
+ISubBlockCacheOperation::CacheItem ShardedSubBlockCache::Get(int subblock_index)
+{
+    return this->GetByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index));
+}
+
+void ShardedSubBlockCache::Add(int subblock_index, const ISubBlockCacheOperation::CacheItem& cache_item)
+{
+    this->AddByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index), cache_item);
+}
+
+ISubBlockCacheOperation::CacheItem ShardedSubBlockCache::GetOrLoad(int subblock_index, const std::function<CacheItem(bool& add_to_cache)>& load_function)
+{
+    return this->GetOrLoadByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index), load_function);
+}
+
+ISubBlockCacheOperation::CacheItem ShardedSubBlockCache::GetByKey(std::uint64_t key)
+{
+    return this->GetShard(key)->GetByKey(key);
+}
+
+void ShardedSubBlockCache::AddByKey(std::uint64_t key, const ISubBlockCacheOperation::CacheItem& cache_item)
+{
+    this->GetShard(key)->AddByKey(key, cache_item);
+}
+
+ISubBlockCacheOperation::CacheItem ShardedSubBlockCache::GetOrLoadByKey(std::uint64_t key, const std::function<CacheItem(bool& add_to_cache)>& load_function)
+{
+    return this->GetShard(key)->GetOrLoadByKey(key, load_function);
+}
+
+ISubBlockCacheOperation::CacheItem ShardedSubBlockCache::GetDownscaled(int subblock_index, std::uint8_t scale_level)
+{
+    SubBlockCache::ThrowIfScaleLevelIsInvalid(scale_level);
+    return this->GetByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index, scale_level));
+}
+
+void ShardedSubBlockCache::AddDownscaled(int subblock_index, std::uint8_t scale_level, const CacheItem& cache_item)
+{
+    SubBlockCache::ThrowIfScaleLevelIsInvalid(scale_level);
+    this->AddByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index, scale_level), cache_item);
+}
+
+std::shared_ptr<libCZI::ISubBlock> ShardedSubBlockCache::GetCompressedSubBlock(int subblock_index)
+{
+    return this->GetCompressedSubBlockByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index));
+}
+
+void ShardedSubBlockCache::AddCompressedSubBlock(int subblock_index, const std::shared_ptr<libCZI::ISubBlock>& sub_block)
+{
+    this->AddCompressedSubBlockByKey(SubBlockCache::KeyFromSubBlockIndex(subblock_index), sub_block);
+}
+
+std::shared_ptr<libCZI::ISubBlock> ShardedSubBlockCache::GetCompressedSubBlockByKey(std::uint64_t key)
+{
+    return this->GetShard(key)->GetCompressedSubBlockByKey(key);
+}
+
+void ShardedSubBlockCache::AddCompressedSubBlockByKey(std::uint64_t key, const std::shared_ptr<libCZI::ISubBlock>& sub_block)
+{
+    this->GetShard(key)->AddCompressedSubBlockByKey(key, sub_block);
+}
+
+void ShardedSubBlockCache::RemoveEntries(const std::function<bool(std::uint64_t key)>& predicate)
+{
+    for (const auto& shard : this->shards_)
+    {
+        shard->RemoveEntries(predicate);
+    }
+}
+
+void ShardedSubBlockCache::Prune(const PruneOptions& options)
+{
+    const auto options_for_shard = ShardedSubBlockCache::DivideLimitsAmongShards(options, static_cast<uint32_t>(this->shards_.size()));
+    for (const auto& shard : this->shards_)
+    {
+        shard->Prune(options_for_shard);
+    }
+}
+
+ISubBlockCacheStatistics::Statistics ShardedSubBlockCache::GetStatistics(std::uint8_t mask) const
+{
+    Statistics result = this->GetMemoryUsageAndElementsCount(mask);
+    for (const auto& shard : this->shards_)
+    {
+        shard->counters_.AddToStatistics(mask, result);
+    }
+
+    return result;
+}
+
+ISubBlockCacheStatistics::Statistics ShardedSubBlockCache::GetStatisticsAndResetCounters(std::uint8_t mask)
+{
+    Statistics result = this->GetMemoryUsageAndElementsCount(mask);
+    for (const auto& shard : this->shards_)
+    {
+        shard->counters_.AddToStatisticsAndReset(mask, result);
+    }
+
+    return result;
+}
+
+ISubBlockCacheStatistics::Statistics ShardedSubBlockCache::GetMemoryUsageAndElementsCount(std::uint8_t mask) const
+{
+    Statistics result{};
+    mask &= (ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount);
+    if (mask == (ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount))
+    {
+        // In order to give a consistent snapshot, we need to lock all shards. Since all other operations only ever
+        //  hold the lock of one shard, there is no danger of a deadlock here.
+        vector<unique_lock<mutex>> locks;
+        locks.reserve(this->shards_.size());
+        for (const auto& shard : this->shards_)
+        {
+            locks.emplace_back(shard->mutex_);
+        }
+
+        result.validityMask = mask;
+        for (const auto& shard : this->shards_)
+        {
+            result.memoryUsage += shard->cache_size_in_bytes_.load();
+            result.elementsCount += shard->cache_subblock_count_.load();
+        }
+    }
+    else if (mask == ISubBlockCacheStatistics::kMemoryUsage || mask == ISubBlockCacheStatistics::kElementsCount)
+    {
+        // for a single value, we just add up the momentary values of the shards (without locking)
+        result.validityMask = mask;
+        for (const auto& shard : this->shards_)
+        {
+            const auto statistics_of_shard = shard->GetMemoryUsageAndElementsCount(mask);
+            result.memoryUsage += statistics_of_shard.memoryUsage;
+            result.elementsCount += statistics_of_shard.elementsCount;
+        }
+    }
+
+    return result;
 }
 
-/*static*/bool SubBlockCache::CompareForLruValue(const std::pair<int, CacheEntry>& a, const std::pair<int, CacheEntry>& b)
+SubBlockCache* ShardedSubBlockCache::GetShard(std::uint64_t key) const
 {
-    return a.second.lru_value < b.second.lru_value;
+    // Sub-block indices are usually consecutive, and interleaved in regular patterns (e.g. for multiple channels), so we
+    //  scramble the bits of the key before choosing the shard (the finalizer of the 64-bit MurmurHash3).
+    uint64_t hash = key;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return this->shards_[hash % this->shards_.size()].get();
+}
+
+/*static*/ISubBlockCacheControl::PruneOptions ShardedSubBlockCache::DivideLimitsAmongShards(const PruneOptions& options, std::uint32_t number_of_shards)
+{
+    // the limits are divided (rounding up), so that the sum of the shard's limits is not smaller than the overall limit
+    PruneOptions options_for_shard;
+    if (options.maxMemoryUsage != numeric_limits<decltype(options.maxMemoryUsage)>::max())
+    {
+        options_for_shard.maxMemoryUsage = options.maxMemoryUsage / number_of_shards + (options.maxMemoryUsage % number_of_shards != 0 ? 1 : 0);
+    }
+
+    if (options.maxSubBlockCount != numeric_limits<decltype(options.maxSubBlockCount)>::max())
+    {
+        options_for_shard.maxSubBlockCount = options.maxSubBlockCount / number_of_shards + (options.maxSubBlockCount % number_of_shards != 0 ? 1 : 0);
+    }
+
+    return options_for_shard;
+}
+
+//----------------------------------------------------------------------------
+
+MultiFileSubBlockCache::MultiFileSubBlockCache(const libCZI::SubBlockCacheOptions& options)
+    : cache_(options)
+{
+}
+
+std::shared_ptr<ISubBlockCacheOperation> MultiFileSubBlockCache::GetCacheForFile(const libCZI::GUID& file_identity)
+{
+    uint32_t file_number;
+    this->TryGetFileNumber(file_identity, true, file_number);
+    return make_shared<FileSubBlockCache>(this->shared_from_this(), file_number);
+}
+
+void MultiFileSubBlockCache::RemoveFile(const libCZI::GUID& file_identity)
+{
+    // Note that we keep the number assigned to the file-identity, so that cache objects for this file (which may still
+    //  be in use) continue to work.
+    uint32_t file_number;
+    if (this->TryGetFileNumber(file_identity, false, file_number))
+    {
+        this->cache_.RemoveEntries(
+            [file_number](uint64_t key)->bool
+            {
+                return static_cast<uint32_t>(key >> SubBlockCache::kNumberOfBitsForSubBlockIndexAndScaleLevel) == file_number;
+            });
+    }
+}
+
+void MultiFileSubBlockCache::Prune(const PruneOptions& options)
+{
+    this->cache_.Prune(options);
+}
+
+ISubBlockCacheStatistics::Statistics MultiFileSubBlockCache::GetStatistics(std::uint8_t mask) const
+{
+    return this->cache_.GetStatistics(mask);
+}
+
+ISubBlockCacheStatistics::Statistics MultiFileSubBlockCache::GetStatisticsAndResetCounters(std::uint8_t mask)
+{
+    return this->cache_.GetStatisticsAndResetCounters(mask);
+}
+
+bool MultiFileSubBlockCache::TryGetFileNumber(const libCZI::GUID& file_identity, bool create_if_not_existing, std::uint32_t& file_number)
+{
+    lock_guard<mutex> lck(this->file_numbers_mutex_);
+    const auto iterator = this->file_numbers_.find(file_identity);
+    if (iterator != this->file_numbers_.end())
+    {
+        file_number = iterator->second;
+        return true;
+    }
+
+    if (!create_if_not_existing)
+    {
+        return false;
+    }
+
+    if (this->next_file_number_ == (1u << (64 - SubBlockCache::kNumberOfBitsForSubBlockIndexAndScaleLevel)))
+    {
+        throw runtime_error("The maximum number of files for the multi-file cache has been exceeded.");
+    }
+
+    file_number = this->next_file_number_++;
+    this->file_numbers_.emplace(file_identity, file_number);
+    return true;
+}
+
+MultiFileSubBlockCache::FileSubBlockCache::FileSubBlockCache(std::shared_ptr<MultiFileSubBlockCache> multi_file_cache, std::uint32_t file_number)
+    : multi_file_cache_(std::move(multi_file_cache)), key_prefix_(static_cast<uint64_t>(file_number) << SubBlockCache::kNumberOfBitsForSubBlockIndexAndScaleLevel)
+{
+}
+
+ISubBlockCacheOperation::CacheItem MultiFileSubBlockCache::FileSubBlockCache::Get(int subblock_index)
+{
+    return this->multi_file_cache_->cache_.GetByKey(this->GetKey(subblock_index));
+}
+
+void MultiFileSubBlockCache::FileSubBlockCache::Add(int subblock_index, const CacheItem& cache_item)
+{
+    this->multi_file_cache_->cache_.AddByKey(this->GetKey(subblock_index), cache_item);
+}
+
+ISubBlockCacheOperation::CacheItem MultiFileSubBlockCache::FileSubBlockCache::GetOrLoad(int subblock_index, const std::function<CacheItem(bool& add_to_cache)>& load_function)
+{
+    return this->multi_file_cache_->cache_.GetOrLoadByKey(this->GetKey(subblock_index), load_function);
+}
+
+ISubBlockCacheOperation::CacheItem MultiFileSubBlockCache::FileSubBlockCache::GetDownscaled(int subblock_index, std::uint8_t scale_level)
+{
+    SubBlockCache::ThrowIfScaleLevelIsInvalid(scale_level);
+    return this->multi_file_cache_->cache_.GetByKey(this->GetKey(subblock_index, scale_level));
+}
+
+void MultiFileSubBlockCache::FileSubBlockCache::AddDownscaled(int subblock_index, std::uint8_t scale_level, const CacheItem& cache_item)
+{
+    SubBlockCache::ThrowIfScaleLevelIsInvalid(scale_level);
+    this->multi_file_cache_->cache_.AddByKey(this->GetKey(subblock_index, scale_level), cache_item);
+}
+
+std::shared_ptr<libCZI::ISubBlock> MultiFileSubBlockCache::FileSubBlockCache::GetCompressedSubBlock(int subblock_index)
+{
+    return this->multi_file_cache_->cache_.GetCompressedSubBlockByKey(this->GetKey(subblock_index));
+}
+
+void MultiFileSubBlockCache::FileSubBlockCache::AddCompressedSubBlock(int subblock_index, const std::shared_ptr<libCZI::ISubBlock>& sub_block)
+{
+    this->multi_file_cache_->cache_.AddCompressedSubBlockByKey(this->GetKey(subblock_index), sub_block);
+}
+
+std::uint64_t MultiFileSubBlockCache::FileSubBlockCache::GetKey(int subblock_index, std::uint8_t scale_level) const
+{
+    return this->key_prefix_ | SubBlockCache::KeyFromSubBlockIndex(subblock_index, scale_level);
+}
+
+//----------------------------------------------------------------------------
+
+CacheCounters::CacheCounters()
+{
+    for (auto& bucket : this->load_latency_histogram_)
+    {
+        bucket.store(0, memory_order_relaxed);
+    }
+}
+
+void CacheCounters::AddLoadLatency(std::chrono::steady_clock::duration duration)
+{
+    this->load_latency_histogram_[CacheCounters::GetLoadLatencyHistogramBucket(duration)].fetch_add(1, memory_order_relaxed);
+}
+
+void CacheCounters::AddToStatistics(std::uint8_t mask, libCZI::ISubBlockCacheStatistics::Statistics& statistics) const
+{
+    if ((mask & ISubBlockCacheStatistics::kCounters) != 0)
+    {
+        statistics.validityMask |= ISubBlockCacheStatistics::kCounters;
+        statistics.hits += this->hits_.load(memory_order_relaxed);
+        statistics.misses += this->misses_.load(memory_order_relaxed);
+        statistics.insertions += this->insertions_.load(memory_order_relaxed);
+        statistics.evictions += this->evictions_.load(memory_order_relaxed);
+        statistics.bytesEvicted += this->bytes_evicted_.load(memory_order_relaxed);
+    }
+
+    if ((mask & ISubBlockCacheStatistics::kLoadLatencyHistogram) != 0)
+    {
+        statistics.validityMask |= ISubBlockCacheStatistics::kLoadLatencyHistogram;
+        for (int i = 0; i < ISubBlockCacheStatistics::kLoadLatencyHistogramBucketCount; ++i)
+        {
+            statistics.loadLatencyHistogram[i] += this->load_latency_histogram_[i].load(memory_order_relaxed);
+        }
+    }
+}
+
+void CacheCounters::AddToStatisticsAndReset(std::uint8_t mask, libCZI::ISubBlockCacheStatistics::Statistics& statistics)
+{
+    if ((mask & ISubBlockCacheStatistics::kCounters) != 0)
+    {
+        statistics.validityMask |= ISubBlockCacheStatistics::kCounters;
+        statistics.hits += this->hits_.exchange(0, memory_order_relaxed);
+        statistics.misses += this->misses_.exchange(0, memory_order_relaxed);
+        statistics.insertions += this->insertions_.exchange(0, memory_order_relaxed);
+        statistics.evictions += this->evictions_.exchange(0, memory_order_relaxed);
+        statistics.bytesEvicted += this->bytes_evicted_.exchange(0, memory_order_relaxed);
+    }
+
+    if ((mask & ISubBlockCacheStatistics::kLoadLatencyHistogram) != 0)
+    {
+        statistics.validityMask |= ISubBlockCacheStatistics::kLoadLatencyHistogram;
+        for (int i = 0; i < ISubBlockCacheStatistics::kLoadLatencyHistogramBucketCount; ++i)
+        {
+            statistics.loadLatencyHistogram[i] += this->load_latency_histogram_[i].exchange(0, memory_order_relaxed);
+        }
+    }
+}
+
+/*static*/int CacheCounters::GetLoadLatencyHistogramBucket(std::chrono::steady_clock::duration duration)
+{
+    // bucket 0 is for "less than 1 microsecond", bucket i is for [2^(i-1), 2^i) microseconds, and the last bucket takes everything above
+    const auto microseconds = chrono::duration_cast<chrono::microseconds>(duration).count();
+    int bucket = 0;
+    for (auto value = microseconds; value > 0 && bucket < ISubBlockCacheStatistics::kLoadLatencyHistogramBucketCount - 1; value >>= 1)
+    {
+        ++bucket;
+    }
+
+    return bucket;
 }
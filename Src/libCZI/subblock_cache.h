@@ -5,17 +5,102 @@
 #pragma once
 
 #include "libCZI.h"
+#include <unordered_map>
 #include <map>
+#include <vector>
 #include <cstdint>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
+#include <chrono>
 
 namespace libCZI
 {
     namespace detail
     {
 
+        /// A count-min sketch with 4-bit counters (and with aging), which gives an estimate of the frequency
+        /// with which a key has been used recently. This is the frequency filter of the TinyLFU admission policy. When
+        /// the number of increments reaches ten times the expected number of elements, then all counters are halved - so,
+        /// the history of the accesses decays over time.
+        class FrequencySketch
+        {
+        private:
+            static constexpr int kDepth = 4;
+            static constexpr std::uint8_t kMaxCount = 15;
+
+            std::vector<std::uint8_t> counters_;        ///< The counters, kDepth rows of the width of the sketch.
+            std::uint32_t width_mask_;                  ///< The width of the sketch minus one (the width is a power of two).
+            std::uint32_t additions_{ 0 };              ///< The number of increments since the last aging.
+            std::uint32_t sample_size_;                 ///< The number of increments after which the counters are halved.
+        public:
+            /// Constructor.
+            /// \param  expected_number_of_elements The expected number of elements in the cache, the width of the sketch is chosen accordingly.
+            explicit FrequencySketch(std::uint32_t expected_number_of_elements);
+
+            void Increment(std::uint64_t key);
+            std::uint8_t Estimate(std::uint64_t key) const;
+        private:
+            void GetCounterIndices(std::uint64_t key, std::uint32_t(&indices)[kDepth]) const;
+            void Age();
+        };
+
+        /// The counters and the load-latency histogram of a cache (c.f. ISubBlockCacheStatistics::kCounters and
+        /// ISubBlockCacheStatistics::kLoadLatencyHistogram). All operations are lock-free, the counters are incremented
+        /// with relaxed memory ordering - they are statistics, and do not synchronize anything.
+        class CacheCounters
+        {
+        private:
+            std::atomic<std::uint64_t> hits_{ 0 };
+            std::atomic<std::uint64_t> misses_{ 0 };
+            std::atomic<std::uint64_t> insertions_{ 0 };
+            std::atomic<std::uint64_t> evictions_{ 0 };
+            std::atomic<std::uint64_t> bytes_evicted_{ 0 };
+            std::atomic<std::uint64_t> load_latency_histogram_[libCZI::ISubBlockCacheStatistics::kLoadLatencyHistogramBucketCount];
+        public:
+            CacheCounters();
+
+            void IncrementHits() { this->hits_.fetch_add(1, std::memory_order_relaxed); }
+            void IncrementMisses() { this->misses_.fetch_add(1, std::memory_order_relaxed); }
+            void IncrementInsertions() { this->insertions_.fetch_add(1, std::memory_order_relaxed); }
+            void AddEviction(std::uint64_t size_in_bytes)
+            {
+                this->evictions_.fetch_add(1, std::memory_order_relaxed);
+                this->bytes_evicted_.fetch_add(size_in_bytes, std::memory_order_relaxed);
+            }
+
+            /// Records the duration of a load-operation in the load-latency histogram.
+            /// \param  duration    The duration of the load-operation.
+            void AddLoadLatency(std::chrono::steady_clock::duration duration);
+
+            /// Adds the values requested by the mask (i.e. the counters if kCounters is set, and the histogram if kLoadLatencyHistogram
+            /// is set) to the respective fields of the statistics struct, and sets the corresponding bits in its validity mask. Since
+            /// the values are added, the statistics of multiple caches (e.g. of the shards of a cache) can be accumulated.
+            ///
+            /// \param          mask        The mask specifying the requested fields.
+            /// \param [in,out] statistics  The statistics struct to which the values are added.
+            void AddToStatistics(std::uint8_t mask, libCZI::ISubBlockCacheStatistics::Statistics& statistics) const;
+
+            /// Same as AddToStatistics, but the values which are reported are also reset to zero (atomically).
+            ///
+            /// \param          mask        The mask specifying the requested fields.
+            /// \param [in,out] statistics  The statistics struct to which the values are added.
+            void AddToStatisticsAndReset(std::uint8_t mask, libCZI::ISubBlockCacheStatistics::Statistics& statistics);
+
+            /// Gets the number of the bucket of the load-latency histogram for the specified duration.
+            /// \param  duration    The duration of the load-operation.
+            /// \returns    The number of the bucket.
+            static int GetLoadLatencyHistogramBucket(std::chrono::steady_clock::duration duration);
+        };
+
         /// A simplistic sub-block cache implementation. It is thread-safe and uses a LRU eviction strategy.
+        /// The entries are kept in a hash map, and in addition they are linked into an (intrusive) doubly-linked list
+        /// which is ordered by the time of last access - the head is the most recently used entry, the tail the least
+        /// recently used one. So, marking an entry as "used" and determining the entry to be evicted are O(1) operations.
+        /// If a capacity is given at construction, then it is enforced with every Add-operation.
+        /// Optionally, a TinyLFU admission policy is used (where a FrequencySketch is maintained), c.f. SubBlockCacheOptions::AdmissionPolicy.
+        /// The GetOrLoad-operation has "single-flight" semantics, i.e. concurrent misses on the same sub-block wait for one
+        /// load-operation to complete (instead of all of them loading the sub-block).
         class SubBlockCache : public libCZI::ISubBlockCache
         {
         private:
@@ -23,29 +108,199 @@ namespace libCZI
             {
                 std::shared_ptr<libCZI::IBitmapData> bitmap;        ///< The cached bitmap.
                 std::shared_ptr<libCZI::IBitonalBitmapData> mask;   ///< The cached bitonal mask (if any).
-                std::uint64_t lru_value;                            ///< The "LRU value" - when marking a cache entry as "used", this value is set to the current value of the "LRU counter".
+                std::shared_ptr<libCZI::ISubBlock> sub_block;       ///< The cached sub-block (for entries of the compressed tier).
+                std::uint64_t size_in_bytes{ 0 };                   ///< The size of the bitmap and the mask (or of the sub-block's data) in bytes.
+                std::uint64_t key{ 0 };                             ///< The key of this entry.
+                CacheEntry* lru_previous{ nullptr };                ///< The previous (i.e. more recently used) entry in the LRU-list.
+                CacheEntry* lru_next{ nullptr };                    ///< The next (i.e. less recently used) entry in the LRU-list.
+            };
+
+            /// The state of a load-operation in progress (c.f. GetOrLoad). Threads which request a sub-block for which a load
+            /// is in progress wait on the condition variable until "done" is set.
+            struct InFlightLoad
+            {
+                std::condition_variable done_condition;     ///< Signalled when the load-operation has finished.
+                bool done{ false };                         ///< Whether the load-operation has finished.
+                bool item_valid{ false };                   ///< Whether the load-operation gave an item which can be handed out to the waiting threads.
+                bool invalidated{ false };                  ///< Set if the entry was removed (c.f. RemoveEntries) while the load was in progress, the result is then not added to the cache.
+                CacheItem item;                             ///< The item which was loaded (if item_valid is true).
             };
 
-            std::map<int, CacheEntry> cache_;
+            /// An LRU-list - the head is the most recently used entry, the tail the least recently used one.
+            struct LruList
+            {
+                CacheEntry* head{ nullptr };                        ///< The most recently used entry.
+                CacheEntry* tail{ nullptr };                        ///< The least recently used entry.
+            };
+
+            /// The cache entries. Note that references to elements of an unordered_map remain valid when other elements
+            /// are inserted or erased, so we can link the elements into the LRU-list directly.
+            std::unordered_map<std::uint64_t, CacheEntry> cache_;
+            LruList lru_;                                           ///< The LRU-list of the entries in cache_.
             mutable std::mutex mutex_;
-            std::atomic<std::uint64_t> lru_counter_{ 0 };           ///< The "LRU counter" - when marking a cache entry as "used", this counter is incremented and the new value is stored in the cache entry.
             std::atomic<std::uint64_t> cache_size_in_bytes_{ 0 };   ///< The current size of the cache in bytes.
             std::atomic<std::uint32_t> cache_subblock_count_{ 0 };  ///< The current number of sub-blocks in the cache.
+            PruneOptions capacity_;                                 ///< The capacity of the cache, which is enforced with every Add-operation.
+            std::unordered_map<std::uint64_t, std::shared_ptr<InFlightLoad>> in_flight_loads_;   ///< The load-operations currently in progress (guarded by mutex_).
+            std::unique_ptr<FrequencySketch> frequency_sketch_;     ///< The frequency sketch for the TinyLFU admission policy (nullptr if not used).
+
+            std::unordered_map<std::uint64_t, CacheEntry> compressed_cache_;    ///< The entries of the compressed tier (guarded by mutex_).
+            LruList compressed_lru_;                                ///< The LRU-list of the entries in compressed_cache_.
+            std::uint64_t compressed_size_in_bytes_{ 0 };           ///< The current size of the compressed tier in bytes (guarded by mutex_).
+            std::uint64_t compressed_max_memory_usage_{ 0 };        ///< The capacity of the compressed tier in bytes (0 if the compressed tier is disabled).
+            CacheCounters counters_;                                ///< The counters and the load-latency histogram.
+
+            friend class ShardedSubBlockCache;
         public:
             SubBlockCache() = default;
+            explicit SubBlockCache(const libCZI::SubBlockCacheOptions& options);
             ~SubBlockCache() override = default;
 
             CacheItem Get(int subblock_index) override;
             void Add(int subblock_index, const CacheItem& cache_item) override;
+            CacheItem GetOrLoad(int subblock_index, const std::function<CacheItem(bool& add_to_cache)>& load_function) override;
+            CacheItem GetDownscaled(int subblock_index, std::uint8_t scale_level) override;
+            void AddDownscaled(int subblock_index, std::uint8_t scale_level, const CacheItem& cache_item) override;
+            std::shared_ptr<libCZI::ISubBlock> GetCompressedSubBlock(int subblock_index) override;
+            void AddCompressedSubBlock(int subblock_index, const std::shared_ptr<libCZI::ISubBlock>& sub_block) override;
             void Prune(const PruneOptions& options) override;
             Statistics GetStatistics(std::uint8_t mask) const override;
+            Statistics GetStatisticsAndResetCounters(std::uint8_t mask) override;
+
+            /// The operations with a 64-bit key - the ISubBlockCacheOperation-methods use the sub-block index as key. Those methods
+            /// are used in order to share one cache between multiple files (where the key contains a file-identifier in addition
+            /// to the sub-block index).
+            CacheItem GetByKey(std::uint64_t key);
+            void AddByKey(std::uint64_t key, const CacheItem& cache_item);
+            CacheItem GetOrLoadByKey(std::uint64_t key, const std::function<CacheItem(bool& add_to_cache)>& load_function);
+            std::shared_ptr<libCZI::ISubBlock> GetCompressedSubBlockByKey(std::uint64_t key);
+            void AddCompressedSubBlockByKey(std::uint64_t key, const std::shared_ptr<libCZI::ISubBlock>& sub_block);
+
+            /// Removes all entries (of both tiers) from the cache for which the specified predicate (which is given the key) returns true.
+            /// The results of load-operations (c.f. GetOrLoad) for those keys which are in progress are not added to the cache.
+            /// \param  predicate   The predicate.
+            void RemoveEntries(const std::function<bool(std::uint64_t key)>& predicate);
+
+            /// The number of bits (counting from the least significant bit) of the key which are used by the sub-block index
+            /// and the scale level - the bits above are available for other purposes (c.f. MultiFileSubBlockCache).
+            static constexpr int kNumberOfBitsForSubBlockIndexAndScaleLevel = 36;
+
+            /// Gets the key which is used for the specified sub-block index by the ISubBlockCacheOperation-methods. The
+            /// sub-block index is in the lower 32 bits, and the scale level (of a downscaled rendition, c.f. GetDownscaled) in
+            /// the next 4 bits.
+            static std::uint64_t KeyFromSubBlockIndex(int subblock_index, std::uint8_t scale_level = 0)
+            {
+                return static_cast<std::uint32_t>(subblock_index) | (static_cast<std::uint64_t>(scale_level & 0xf) << 32);
+            }
+
+            /// Checks that the specified scale level is valid for a downscaled rendition, and throws an exception if not.
+            static void ThrowIfScaleLevelIsInvalid(std::uint8_t scale_level);
         private:
+            Statistics GetMemoryUsageAndElementsCount(std::uint8_t mask) const;
+            bool TryGetAndMarkAsUsed(std::uint64_t key, CacheItem& item);
+            void AddEntry(std::uint64_t key, const CacheItem& cache_item, std::uint64_t size_in_bytes);
+            /// Decides (for the TinyLFU admission policy) whether a new element is to be added - this is the case if there is room for it, or
+            /// if it is used more often than all the elements which would have to be evicted in order to make room for it.
+            bool IsToBeAdmitted(std::uint64_t key, std::uint64_t size_in_bytes) const;
+            void RecordAccess(std::uint64_t key);
+            /// Completes a load-operation (c.f. GetOrLoad) - the item is added to the cache (if it is valid, and unless the entry was removed while
+            /// loading), and the threads waiting for the load-operation are woken up.
+            void PublishLoadResult(std::uint64_t key, const std::shared_ptr<InFlightLoad>& in_flight_load, bool item_valid, const CacheItem& item);
             void PruneByMemoryUsageAndElementCount(std::uint64_t max_memory_usage, std::uint32_t max_element_count);
+            static bool IsLimitGiven(const PruneOptions& options);
+            static void LinkAsMostRecentlyUsed(LruList& list, CacheEntry* entry);
+            static void Unlink(LruList& list, CacheEntry* entry);
+            static std::uint64_t CalculateSizeInBytes(const libCZI::ISubBlock* sub_block);
             static std::uint64_t CalculateSizeInBytes(const libCZI::IBitmapData* bitmap);
             static std::uint64_t CalculateSizeInBytes(const libCZI::IBitonalBitmapData* mask);
             static std::uint64_t CalculateSizeInBytes(const libCZI::IBitmapData* bitmap, const libCZI::IBitonalBitmapData* mask);
-            static std::uint64_t CalculateSizeInBytes(const CacheEntry& entry);
-            static bool CompareForLruValue(const std::pair<int, CacheEntry>& a, const std::pair<int, CacheEntry>& b);
+        };
+
+        /// A sub-block cache which consists of a number of independent shards (each one being a SubBlockCache-instance).
+        /// The shard is determined from the sub-block index, so concurrent operations on different sub-blocks do
+        /// (most likely) not contend for the same lock.
+        class ShardedSubBlockCache : public libCZI::ISubBlockCache
+        {
+        private:
+            std::vector<std::unique_ptr<SubBlockCache>> shards_;
+        public:
+            ShardedSubBlockCache() = delete;
+            explicit ShardedSubBlockCache(const libCZI::SubBlockCacheOptions& options);
+            ~ShardedSubBlockCache() override = default;
+
+            CacheItem Get(int subblock_index) override;
+            void Add(int subblock_index, const CacheItem& cache_item) override;
+            CacheItem GetOrLoad(int subblock_index, const std::function<CacheItem(bool& add_to_cache)>& load_function) override;
+            CacheItem GetDownscaled(int subblock_index, std::uint8_t scale_level) override;
+            void AddDownscaled(int subblock_index, std::uint8_t scale_level, const CacheItem& cache_item) override;
+            std::shared_ptr<libCZI::ISubBlock> GetCompressedSubBlock(int subblock_index) override;
+            void AddCompressedSubBlock(int subblock_index, const std::shared_ptr<libCZI::ISubBlock>& sub_block) override;
+            void Prune(const PruneOptions& options) override;
+            Statistics GetStatistics(std::uint8_t mask) const override;
+            Statistics GetStatisticsAndResetCounters(std::uint8_t mask) override;
+
+            CacheItem GetByKey(std::uint64_t key);
+            void AddByKey(std::uint64_t key, const CacheItem& cache_item);
+            CacheItem GetOrLoadByKey(std::uint64_t key, const std::function<CacheItem(bool& add_to_cache)>& load_function);
+            std::shared_ptr<libCZI::ISubBlock> GetCompressedSubBlockByKey(std::uint64_t key);
+            void AddCompressedSubBlockByKey(std::uint64_t key, const std::shared_ptr<libCZI::ISubBlock>& sub_block);
+            void RemoveEntries(const std::function<bool(std::uint64_t key)>& predicate);
+        private:
+            Statistics GetMemoryUsageAndElementsCount(std::uint8_t mask) const;
+            SubBlockCache* GetShard(std::uint64_t key) const;
+            static PruneOptions DivideLimitsAmongShards(const PruneOptions& options, std::uint32_t number_of_shards);
+        };
+
+        /// A sub-block cache which is shared between multiple files. All entries are kept in one (sharded) cache, where the key
+        /// is composed of a number which is assigned to the file-identity (in the upper 28 bits) and the key of the sub-block (as
+        /// given by SubBlockCache::KeyFromSubBlockIndex, in the lower 36 bits). So, the capacity of the cache applies to all files together.
+        class MultiFileSubBlockCache : public libCZI::IMultiFileSubBlockCache, public std::enable_shared_from_this<MultiFileSubBlockCache>
+        {
+        private:
+            /// The cache object for a specific file, which maps the sub-block index to the key in the shared cache.
+            class FileSubBlockCache : public libCZI::ISubBlockCacheOperation
+            {
+            private:
+                std::shared_ptr<MultiFileSubBlockCache> multi_file_cache_;
+                std::uint64_t key_prefix_;
+            public:
+                FileSubBlockCache(std::shared_ptr<MultiFileSubBlockCache> multi_file_cache, std::uint32_t file_number);
+
+                CacheItem Get(int subblock_index) override;
+                void Add(int subblock_index, const CacheItem& cache_item) override;
+                CacheItem GetOrLoad(int subblock_index, const std::function<CacheItem(bool& add_to_cache)>& load_function) override;
+                CacheItem GetDownscaled(int subblock_index, std::uint8_t scale_level) override;
+                void AddDownscaled(int subblock_index, std::uint8_t scale_level, const CacheItem& cache_item) override;
+                std::shared_ptr<libCZI::ISubBlock> GetCompressedSubBlock(int subblock_index) override;
+                void AddCompressedSubBlock(int subblock_index, const std::shared_ptr<libCZI::ISubBlock>& sub_block) override;
+            private:
+                std::uint64_t GetKey(int subblock_index, std::uint8_t scale_level = 0) const;
+            };
+
+            struct GuidLess
+            {
+                bool operator()(const libCZI::GUID& a, const libCZI::GUID& b) const
+                {
+                    return a.compare(b) < 0;
+                }
+            };
+
+            ShardedSubBlockCache cache_;
+            std::mutex file_numbers_mutex_;
+            std::map<libCZI::GUID, std::uint32_t, GuidLess> file_numbers_;  ///< The numbers assigned to the file identities (guarded by file_numbers_mutex_).
+            std::uint32_t next_file_number_{ 0 };                           ///< The number to be assigned to the next file identity (guarded by file_numbers_mutex_).
+        public:
+            MultiFileSubBlockCache() = delete;
+            explicit MultiFileSubBlockCache(const libCZI::SubBlockCacheOptions& options);
+            ~MultiFileSubBlockCache() override = default;
+
+            std::shared_ptr<ISubBlockCacheOperation> GetCacheForFile(const libCZI::GUID& file_identity) override;
+            void RemoveFile(const libCZI::GUID& file_identity) override;
+            void Prune(const PruneOptions& options) override;
+            Statistics GetStatistics(std::uint8_t mask) const override;
+            Statistics GetStatisticsAndResetCounters(std::uint8_t mask) override;
+        private:
+            bool TryGetFileNumber(const libCZI::GUID& file_identity, bool create_if_not_existing, std::uint32_t& file_number);
         };
 
     } // namespace detail
@@ -0,0 +1,310 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "subblock_layer_index.h"
+#include "CziUtils.h"
+#include "utilities.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+
+using namespace libCZI;
+using namespace libCZI::detail;
+using namespace std;
+
+SubBlockLayerIndex::SubBlockLayerIndex(libCZI::ISubBlockRepository* repository)
+{
+    // gather the sub-blocks, grouped by their plane-coordinate (without the S-index) - the key of the map is a list of
+    //  "dimension, position"-pairs, and gives the index of the group
+    map<vector<int>, size_t> group_for_key;
+    vector<vector<Entry>> entries_per_group;
+    vector<float> zooms;
+    repository->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo& info)->bool
+        {
+            if (!info.logicalRect.IsNonEmpty() || info.physicalSize.w == 0 || info.physicalSize.h == 0)
+            {
+                // such a sub-block would never be found by "EnumSubset" with a ROI, so we do not need to include it
+                return true;
+            }
+
+            Entry entry{ info.logicalRect, info.physicalSize, info.mIndex, index, 0, Utils::CalcZoom(info.logicalRect, info.physicalSize) };
+            if (!info.coordinate.TryGetPosition(DimensionIndex::S, &entry.sceneIndex))
+            {
+                entry.sceneIndex = (numeric_limits<int>::max)();
+            }
+
+            vector<int> key;
+            CDimCoordinate coordinate;
+            CziUtils::EnumAllCoordinateDimensions(
+                [&](DimensionIndex dimension)->bool
+                {
+                    int position;
+                    if (dimension != DimensionIndex::S && info.coordinate.TryGetPosition(dimension, &position))
+                    {
+                        key.push_back(static_cast<int>(dimension));
+                        key.push_back(position);
+                        coordinate.Set(dimension, position);
+                    }
+
+                    return true;
+                });
+
+            const auto group = group_for_key.find(key);
+            size_t group_index;
+            if (group == group_for_key.cend())
+            {
+                group_index = this->groups_.size();
+                group_for_key[key] = group_index;
+                this->groups_.push_back(PlaneGroup{ coordinate, {} });
+                entries_per_group.emplace_back();
+            }
+            else
+            {
+                group_index = group->second;
+            }
+
+            entries_per_group[group_index].push_back(entry);
+            zooms.push_back(entry.zoom);
+            return true;
+        });
+
+    // determine the layers - sort the zoom-levels and start a new layer whenever there is a gap of more than 25%
+    sort(zooms.begin(), zooms.end());
+    for (const float zoom : zooms)
+    {
+        if (this->layers_.empty() || zoom >= this->layers_.back().maxZoom * 1.25f)
+        {
+            this->layers_.push_back(LayerInfo{ zoom, zoom });
+        }
+        else
+        {
+            this->layers_.back().maxZoom = zoom;
+        }
+    }
+
+    // and now, distribute the entries to the layers and build the grids
+    for (size_t group_index = 0; group_index < this->groups_.size(); ++group_index)
+    {
+        PlaneGroup& group = this->groups_[group_index];
+        group.layers.resize(this->layers_.size());
+        for (const auto& entry : entries_per_group[group_index])
+        {
+            const auto layer = upper_bound(
+                this->layers_.cbegin(),
+                this->layers_.cend(),
+                entry.zoom,
+                [](float zoom, const LayerInfo& layer_info)->bool { return zoom < layer_info.minZoom; });
+            group.layers[distance(this->layers_.cbegin(), layer) - 1].entries.push_back(entry);
+        }
+
+        for (auto& grid : group.layers)
+        {
+            SubBlockLayerIndex::BuildGrid(grid);
+        }
+    }
+}
+
+/*static*/std::shared_ptr<const SubBlockLayerIndex> SubBlockLayerIndex::GetOrCreate(libCZI::ISubBlockRepository* repository, std::uint64_t instanceId)
+{
+    static mutex registry_mutex;
+    static map<uint64_t, weak_ptr<const SubBlockLayerIndex>> registry;
+
+    lock_guard<mutex> lck(registry_mutex);
+    auto index = registry[instanceId].lock();
+    if (!index)
+    {
+        // an instance-identity is never re-used, so we can get rid of the entries whose index is no longer in use
+        for (auto it = registry.begin(); it != registry.end();)
+        {
+            if (it->second.expired() && it->first != instanceId)
+            {
+                it = registry.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        index = make_shared<SubBlockLayerIndex>(repository);
+        registry[instanceId] = index;
+    }
+
+    return index;
+}
+
+void SubBlockLayerIndex::Query(
+    size_t layer,
+    const libCZI::IntRect& roi,
+    const libCZI::IDimCoordinate* planeCoordinate,
+    const std::function<bool(const libCZI::IntRect&)>& isCellOfInterest,
+    std::vector<const Entry*>& result) const
+{
+    if (layer >= this->layers_.size())
+    {
+        return;
+    }
+
+    int requested_scene_index;
+    const bool check_scene_index = planeCoordinate != nullptr && planeCoordinate->TryGetPosition(DimensionIndex::S, &requested_scene_index);
+    vector<int> found;
+    for (const auto& group : this->groups_)
+    {
+        if (!SubBlockLayerIndex::IsPlaneMatching(group.coordinate, planeCoordinate))
+        {
+            continue;
+        }
+
+        const Grid& grid = group.layers[layer];
+        const IntRect roi_in_grid = Utilities::Intersect(roi, grid.boundingBox);
+        if (grid.entries.empty() || roi_in_grid.w <= 0 || roi_in_grid.h <= 0)
+        {
+            continue;
+        }
+
+        found.clear();
+        const int first_column = (roi_in_grid.x - grid.boundingBox.x) / grid.cellWidth;
+        const int last_column = (roi_in_grid.x + roi_in_grid.w - 1 - grid.boundingBox.x) / grid.cellWidth;
+        const int first_row = (roi_in_grid.y - grid.boundingBox.y) / grid.cellHeight;
+        const int last_row = (roi_in_grid.y + roi_in_grid.h - 1 - grid.boundingBox.y) / grid.cellHeight;
+        for (int row = first_row; row <= last_row; ++row)
+        {
+            for (int column = first_column; column <= last_column; ++column)
+            {
+                const auto& cell = grid.cells[static_cast<size_t>(row) * grid.columns + column];
+                if (cell.empty())
+                {
+                    continue;
+                }
+
+                if (isCellOfInterest)
+                {
+                    const IntRect cell_rect{ grid.boundingBox.x + column * grid.cellWidth, grid.boundingBox.y + row * grid.cellHeight, grid.cellWidth, grid.cellHeight };
+                    if (!isCellOfInterest(Utilities::Intersect(cell_rect, roi)))
+                    {
+                        continue;
+                    }
+                }
+
+                found.insert(found.end(), cell.cbegin(), cell.cend());
+            }
+        }
+
+        found.insert(found.end(), grid.largeEntries.cbegin(), grid.largeEntries.cend());
+
+        // an entry is contained in all the cells it intersects with, so we have to remove duplicates here
+        sort(found.begin(), found.end());
+        found.erase(unique(found.begin(), found.end()), found.end());
+        for (const int i : found)
+        {
+            const Entry& entry = grid.entries[i];
+            if ((!check_scene_index || entry.sceneIndex == requested_scene_index) &&
+                Utilities::DoIntersect(roi, entry.logicalRect))
+            {
+                result.push_back(&entry);
+            }
+        }
+    }
+}
+
+/*static*/bool SubBlockLayerIndex::IsPlaneMatching(const libCZI::CDimCoordinate& groupCoordinate, const libCZI::IDimCoordinate* planeCoordinate)
+{
+    if (planeCoordinate == nullptr)
+    {
+        return true;
+    }
+
+    // this is the same check as in "CziUtils::CompareCoordinate", except for the S-index which is checked per entry
+    bool is_matching = true;
+    CziUtils::EnumAllCoordinateDimensions(
+        [&](DimensionIndex dimension)->bool
+        {
+            int position, position_of_group;
+            if (dimension != DimensionIndex::S && planeCoordinate->TryGetPosition(dimension, &position))
+            {
+                if (!groupCoordinate.TryGetPosition(dimension, &position_of_group) || position != position_of_group)
+                {
+                    is_matching = false;
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+    return is_matching;
+}
+
+/*static*/void SubBlockLayerIndex::BuildGrid(Grid& grid)
+{
+    if (grid.entries.empty())
+    {
+        return;
+    }
+
+    int64_t x_min = (numeric_limits<int64_t>::max)(), y_min = (numeric_limits<int64_t>::max)();
+    int64_t x_max = (numeric_limits<int64_t>::min)(), y_max = (numeric_limits<int64_t>::min)();
+    int64_t sum_of_widths = 0, sum_of_heights = 0;
+    for (const auto& entry : grid.entries)
+    {
+        x_min = (min)(x_min, static_cast<int64_t>(entry.logicalRect.x));
+        y_min = (min)(y_min, static_cast<int64_t>(entry.logicalRect.y));
+        x_max = (max)(x_max, static_cast<int64_t>(entry.logicalRect.x) + entry.logicalRect.w);
+        y_max = (max)(y_max, static_cast<int64_t>(entry.logicalRect.y) + entry.logicalRect.h);
+        sum_of_widths += entry.logicalRect.w;
+        sum_of_heights += entry.logicalRect.h;
+    }
+
+    const int64_t count = static_cast<int64_t>(grid.entries.size());
+    grid.boundingBox = IntRect{ static_cast<int>(x_min), static_cast<int>(y_min), static_cast<int>(x_max - x_min), static_cast<int>(y_max - y_min) };
+
+    // the cell size is the average size of the sub-blocks - if the sub-blocks are sparsely distributed, we increase the
+    //  cell size so that the number of cells remains proportional to the number of sub-blocks
+    int64_t cell_width = (max)(sum_of_widths / count, static_cast<int64_t>(1));
+    int64_t cell_height = (max)(sum_of_heights / count, static_cast<int64_t>(1));
+    int64_t columns, rows;
+    for (;;)
+    {
+        columns = (grid.boundingBox.w + cell_width - 1) / cell_width;
+        rows = (grid.boundingBox.h + cell_height - 1) / cell_height;
+        if (columns * rows <= 4 * count + 16)
+        {
+            break;
+        }
+
+        cell_width *= 2;
+        cell_height *= 2;
+    }
+
+    grid.cellWidth = static_cast<int>(cell_width);
+    grid.cellHeight = static_cast<int>(cell_height);
+    grid.columns = static_cast<int>(columns);
+    grid.rows = static_cast<int>(rows);
+    grid.cells.resize(static_cast<size_t>(columns * rows));
+    for (size_t i = 0; i < grid.entries.size(); ++i)
+    {
+        const IntRect& rect = grid.entries[i].logicalRect;
+        const int first_column = static_cast<int>((rect.x - grid.boundingBox.x) / cell_width);
+        const int last_column = static_cast<int>((rect.x + rect.w - 1 - grid.boundingBox.x) / cell_width);
+        const int first_row = static_cast<int>((rect.y - grid.boundingBox.y) / cell_height);
+        const int last_row = static_cast<int>((rect.y + rect.h - 1 - grid.boundingBox.y) / cell_height);
+
+        // sub-blocks which would occupy a lot of cells are kept in a separate list (which is always checked)
+        if ((last_column - first_column + 1) * (last_row - first_row + 1) > 16)
+        {
+            grid.largeEntries.push_back(static_cast<int>(i));
+            continue;
+        }
+
+        for (int row = first_row; row <= last_row; ++row)
+        {
+            for (int column = first_column; column <= last_column; ++column)
+            {
+                grid.cells[static_cast<size_t>(row) * grid.columns + column].push_back(static_cast<int>(i));
+            }
+        }
+    }
+}
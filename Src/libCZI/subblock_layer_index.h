@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include "libCZI.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace libCZI
+{
+    namespace detail
+    {
+        /// A spatial index of the sub-blocks of a repository, organized by pyramid-layer. The sub-blocks are grouped by their
+        /// plane-coordinate (not including the S-index) and by their zoom - consecutive zoom levels which differ by less than
+        /// a factor of 1.25 are put into the same layer. For every plane and layer, the sub-blocks are put into a uniform grid
+        /// (with a cell size of about the average sub-block size of the layer), so that a query only has to look at the sub-blocks
+        /// in the vicinity of the ROI on the layer in question.
+        class SubBlockLayerIndex
+        {
+        public:
+            /// The information about a sub-block kept in the index.
+            struct Entry
+            {
+                libCZI::IntRect logicalRect;    ///< The logical rectangle of the sub-block.
+                libCZI::IntSize physicalSize;   ///< The physical size of the sub-block.
+                int mIndex;                     ///< The M-index of the sub-block.
+                int index;                      ///< The index of the sub-block (in the repository).
+                int sceneIndex;                 ///< The S-index of the sub-block, or "max int" if the sub-block has no S-index.
+                float zoom;                     ///< The zoom of the sub-block.
+            };
+
+            /// Information about a layer.
+            struct LayerInfo
+            {
+                float minZoom;  ///< The smallest zoom of a sub-block in this layer.
+                float maxZoom;  ///< The largest zoom of a sub-block in this layer.
+            };
+        private:
+            struct Grid
+            {
+                libCZI::IntRect boundingBox{ 0, 0, 0, 0 };  ///< The bounding box of all entries in the grid.
+                int cellWidth{ 1 };
+                int cellHeight{ 1 };
+                int columns{ 0 };
+                int rows{ 0 };
+                std::vector<Entry> entries;                 ///< The entries (in ascending order of their sub-block index).
+                std::vector<std::vector<int>> cells;        ///< For every cell (row-major), the indices into 'entries' of the entries intersecting the cell.
+                std::vector<int> largeEntries;              ///< The indices into 'entries' of entries which are too large to be put into the cells.
+            };
+
+            struct PlaneGroup
+            {
+                libCZI::CDimCoordinate coordinate;          ///< The plane-coordinate of the group (without S-index).
+                std::vector<Grid> layers;                   ///< The grids, one for each layer.
+            };
+
+            std::vector<LayerInfo> layers_;
+            std::vector<PlaneGroup> groups_;
+        public:
+            /// Constructs the index for the sub-blocks of the specified repository (which are enumerated once here).
+            ///
+            /// \param  repository  The repository.
+            explicit SubBlockLayerIndex(libCZI::ISubBlockRepository* repository);
+
+            /// Gets the index for the specified repository-instance. The indices are kept (as long as they are in use) in a
+            /// process-wide registry keyed by the instance-identity, so that all users of the same repository-instance (e.g. the
+            /// scaling accessor and the prefetcher) share one index. If there is no index for the instance yet, it is created.
+            ///
+            /// \param  repository  The repository.
+            /// \param  instanceId  The instance-identity of the repository (as reported by "IRepositoryInstanceIdentity"), which must be non-zero.
+            ///
+            /// \returns    The index.
+            static std::shared_ptr<const SubBlockLayerIndex> GetOrCreate(libCZI::ISubBlockRepository* repository, std::uint64_t instanceId);
+
+            /// Gets the number of layers. The layers are sorted by ascending zoom (i.e. the layer with the lowest resolution comes first),
+            /// and the ranges of zoom of the layers are disjoint.
+            ///
+            /// \returns    The number of layers.
+            size_t GetLayerCount() const { return this->layers_.size(); }
+
+            /// Gets information about the specified layer.
+            ///
+            /// \param  layer   The layer.
+            ///
+            /// \returns    The layer information.
+            const LayerInfo& GetLayerInfo(size_t layer) const { return this->layers_.at(layer); }
+
+            /// Gets the entries of the specified layer which are on the specified plane and intersect with the ROI. The matching of the
+            /// plane-coordinate is the same as with "ISubBlockRepository::EnumSubset". Optionally, a function can be given which decides
+            /// for every grid-cell (more precisely: for the intersection of a cell with the ROI) whether the entries in it are to be
+            /// considered - entries which are only found in cells for which this function returns false are not reported (entries too
+            /// large to be put into the grid are always reported).
+            ///
+            /// \param          layer               The layer.
+            /// \param          roi                 The ROI.
+            /// \param          planeCoordinate     The plane coordinate (may be null, in which case all planes are included).
+            /// \param          isCellOfInterest    If non-null, a function which is called for the intersection of a cell with the ROI and
+            ///                                     which determines whether the entries in the cell are to be considered.
+            /// \param [in,out] result              The entries found are added to this vector, per plane in ascending order of their sub-block index.
+            void Query(
+                size_t layer,
+                const libCZI::IntRect& roi,
+                const libCZI::IDimCoordinate* planeCoordinate,
+                const std::function<bool(const libCZI::IntRect&)>& isCellOfInterest,
+                std::vector<const Entry*>& result) const;
+        private:
+            static bool IsPlaneMatching(const libCZI::CDimCoordinate& groupCoordinate, const libCZI::IDimCoordinate* planeCoordinate);
+            static void BuildGrid(Grid& grid);
+        };
+    } // namespace detail
+} // namespace libCZI
@@ -0,0 +1,272 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "subblock_prefetcher.h"
+
+using namespace libCZI;
+using namespace libCZI::detail;
+using namespace std;
+
+std::shared_ptr<ISubBlockPrefetcher> libCZI::CreateSubBlockPrefetcher(const std::shared_ptr<ISubBlockRepository>& repository, const std::shared_ptr<ISubBlockCacheOperation>& cache, const SubBlockPrefetcherOptions& options)
+{
+    if (!repository || !cache)
+    {
+        throw invalid_argument("A repository and a cache must be given.");
+    }
+
+    return make_shared<SubBlockPrefetcher>(repository, cache, options);
+}
+
+SubBlockPrefetcher::SubBlockPrefetcher(const std::shared_ptr<libCZI::ISubBlockRepository>& repository, const std::shared_ptr<libCZI::ISubBlockCacheOperation>& cache, const libCZI::SubBlockPrefetcherOptions& options)
+    : CSingleChannelAccessorBase(repository), cache_(cache), options_(options), scaling_accessor_(repository)
+{
+    const uint32_t number_of_threads = (max)(options.numberOfThreads, 1u);
+    this->threads_.reserve(number_of_threads);
+    for (uint32_t i = 0; i < number_of_threads; ++i)
+    {
+        this->threads_.emplace_back(&SubBlockPrefetcher::WorkerThread, this);
+    }
+}
+
+SubBlockPrefetcher::~SubBlockPrefetcher()
+{
+    {
+        lock_guard<mutex> lck(this->mutex_);
+        this->stop_ = true;
+    }
+
+    this->work_available_.notify_all();
+    for (auto& thread : this->threads_)
+    {
+        thread.join();
+    }
+}
+
+void SubBlockPrefetcher::Prefetch(const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom)
+{
+    // determining the sub-blocks to be prefetched requires a couple of queries of the repository, so we leave this to the
+    //  worker threads as well
+    Request request{ this->sbBlkRepository->TransformRectangle(roi, CZIFrameOfReference::RawSubBlockCoordinateSystem).rectangle, CDimCoordinate(planeCoordinate), zoom };
+    {
+        lock_guard<mutex> lck(this->mutex_);
+        if (this->options_.discardPendingOnNewRequest)
+        {
+            this->DiscardPendingWork();
+        }
+
+        this->requests_.push_back(std::move(request));
+    }
+
+    this->work_available_.notify_one();
+}
+
+void SubBlockPrefetcher::CancelPending()
+{
+    lock_guard<mutex> lck(this->mutex_);
+    this->DiscardPendingWork();
+    if (this->IsIdle())
+    {
+        this->idle_.notify_all();
+    }
+}
+
+void SubBlockPrefetcher::WaitUntilIdle()
+{
+    unique_lock<mutex> lck(this->mutex_);
+    this->idle_.wait(lck, [this] { return this->IsIdle(); });
+}
+
+void SubBlockPrefetcher::DiscardPendingWork()
+{
+    // note: the caller must hold the lock
+    this->requests_.clear();
+    this->queue_.clear();
+    this->queued_indices_.clear();
+
+    // the prefetch-requests which are currently being processed must not add their sub-blocks to the queue
+    ++this->generation_;
+}
+
+bool SubBlockPrefetcher::IsIdle() const
+{
+    // note: the caller must hold the lock
+    return this->requests_.empty() && this->queue_.empty() && this->loads_in_progress_ == 0;
+}
+
+std::vector<int> SubBlockPrefetcher::DetermineSubBlocksToPrefetch(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom)
+{
+    vector<int> result;
+    if (!roi.IsValid() || roi.w <= 0 || roi.h <= 0 || zoom <= 0)
+    {
+        return result;
+    }
+
+    // the sub-blocks which are needed for the request itself are loaded by the accessor anyway
+    const auto sub_blocks_of_request = this->GetSubBlocksForZoom(roi, planeCoordinate, zoom);
+    unordered_set<int> already_included(sub_blocks_of_request.cbegin(), sub_blocks_of_request.cend());
+    const auto add_to_result = [&](const vector<int>& indices)->void
+    {
+        for (const int index : indices)
+        {
+            if (already_included.insert(index).second)
+            {
+                // uncompressed sub-blocks are not added to the cache in this case, so there is no point in loading them
+                SubBlockInfo info;
+                if (this->options_.onlyUseSubBlockCacheForCompressedData &&
+                    this->sbBlkRepository->TryGetSubBlockInfo(index, &info) &&
+                    info.GetCompressionMode() == CompressionMode::UnCompressed)
+                {
+                    continue;
+                }
+
+                result.push_back(index);
+            }
+        }
+    };
+
+    if (this->options_.ringWidth > 0)
+    {
+        const int ring_width = static_cast<int>(this->options_.ringWidth);
+        const IntRect roi_including_ring{ roi.x - ring_width * roi.w, roi.y - ring_width * roi.h, (2 * ring_width + 1) * roi.w, (2 * ring_width + 1) * roi.h };
+        add_to_result(this->GetSubBlocksForZoom(roi_including_ring, planeCoordinate, zoom));
+    }
+
+    const auto statistics = this->sbBlkRepository->GetStatistics();
+    const auto add_adjacent_planes = [&](DimensionIndex dimension, uint32_t number_of_adjacent_planes, uint32_t distance)->void
+    {
+        int position, start, size;
+        if (distance > number_of_adjacent_planes ||
+            !planeCoordinate->TryGetPosition(dimension, &position) ||
+            !statistics.dimBounds.TryGetInterval(dimension, &start, &size))
+        {
+            return;
+        }
+
+        for (const int adjacent_position : { position + static_cast<int>(distance), position - static_cast<int>(distance) })
+        {
+            if (adjacent_position >= start && adjacent_position < start + size)
+            {
+                CDimCoordinate adjacent_plane(planeCoordinate);
+                adjacent_plane.Set(dimension, adjacent_position);
+                add_to_result(this->GetSubBlocksForZoom(roi, &adjacent_plane, zoom));
+            }
+        }
+    };
+
+    // the nearest planes first, alternating between Z and T
+    const uint32_t max_distance = (max)(this->options_.adjacentZPlanes, this->options_.adjacentTPlanes);
+    for (uint32_t distance = 1; distance <= max_distance; ++distance)
+    {
+        add_adjacent_planes(DimensionIndex::Z, this->options_.adjacentZPlanes, distance);
+        add_adjacent_planes(DimensionIndex::T, this->options_.adjacentTPlanes, distance);
+    }
+
+    return result;
+}
+
+std::vector<int> SubBlockPrefetcher::GetSubBlocksForZoom(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom)
+{
+    // we use the very same selection as the scaling accessor (with its default options, i.e. no scene-filter and sorting by M-index),
+    //  so that we prefetch exactly the sub-blocks which it is going to draw
+    return this->scaling_accessor_.DetermineSubBlocksToDraw(roi, planeCoordinate, zoom, nullptr, true);
+}
+
+void SubBlockPrefetcher::WorkerThread()
+{
+    for (;;)
+    {
+        int sub_block_index;
+        {
+            unique_lock<mutex> lck(this->mutex_);
+            this->work_available_.wait(lck, [this] { return this->stop_ || !this->requests_.empty() || !this->queue_.empty(); });
+            if (this->stop_)
+            {
+                return;
+            }
+
+            ++this->loads_in_progress_;
+            if (!this->requests_.empty())
+            {
+                // the prefetch-requests are processed first, so that the most relevant sub-blocks are queued as early as possible
+                const Request request = std::move(this->requests_.front());
+                this->requests_.pop_front();
+                const uint64_t generation = this->generation_;
+                lck.unlock();
+                this->ProcessRequest(request, generation);
+                sub_block_index = -1;
+            }
+            else
+            {
+                sub_block_index = this->queue_.front();
+                this->queue_.pop_front();
+                this->queued_indices_.erase(sub_block_index);
+            }
+        }
+
+        if (sub_block_index >= 0)
+        {
+            try
+            {
+                CSingleChannelAccessorBase::GetSubBlockDataIncludingMaskForSubBlockIndex(
+                    this->sbBlkRepository,
+                    this->cache_,
+                    sub_block_index,
+                    this->options_.onlyUseSubBlockCacheForCompressedData,
+                    false,
+                    this->options_.maskAware);
+            }
+            catch (...)
+            {
+                // prefetching is speculative - if loading fails, the accessor will run into the same problem and report it
+            }
+        }
+
+        {
+            lock_guard<mutex> lck(this->mutex_);
+            --this->loads_in_progress_;
+            if (this->IsIdle())
+            {
+                this->idle_.notify_all();
+            }
+        }
+    }
+}
+
+void SubBlockPrefetcher::ProcessRequest(const Request& request, std::uint64_t generation)
+{
+    vector<int> sub_blocks_to_prefetch;
+    try
+    {
+        sub_blocks_to_prefetch = this->DetermineSubBlocksToPrefetch(request.roi, &request.planeCoordinate, request.zoom);
+    }
+    catch (...)
+    {
+        // same as with loading - errors are ignored here
+        return;
+    }
+
+    {
+        lock_guard<mutex> lck(this->mutex_);
+        if (generation != this->generation_)
+        {
+            // the pending work was discarded in the meantime (i.e. there is a newer request, or the request was cancelled)
+            return;
+        }
+
+        for (const int index : sub_blocks_to_prefetch)
+        {
+            if (this->queue_.size() >= this->options_.maxQueueLength)
+            {
+                break;
+            }
+
+            if (this->queued_indices_.insert(index).second)
+            {
+                this->queue_.push_back(index);
+            }
+        }
+    }
+
+    this->work_available_.notify_all();
+}
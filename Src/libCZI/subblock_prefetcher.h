@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include "libCZI.h"
+#include "SingleChannelAccessorBase.h"
+#include "SingleChannelScalingTileAccessor.h"
+#include <deque>
+#include <unordered_set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace libCZI
+{
+    namespace detail
+    {
+        /// Implementation of the sub-block prefetcher. A prefetch-request is put into a queue, and the sub-blocks to be prefetched
+        /// for it are determined by a worker thread (so that the caller is not blocked) and put into a (bounded) queue, from
+        /// which the worker threads take them. The worker threads load the sub-blocks with the same function which
+        /// is used by the accessors (so that the cache entries are exactly the same as if an accessor had loaded them). If there
+        /// is nothing to do, the worker threads are waiting (and do not consume CPU).
+        class SubBlockPrefetcher : public CSingleChannelAccessorBase, public libCZI::ISubBlockPrefetcher
+        {
+        private:
+            std::shared_ptr<libCZI::ISubBlockCacheOperation> cache_;
+            libCZI::SubBlockPrefetcherOptions options_;
+            CSingleChannelScalingTileAccessor scaling_accessor_;    ///< The scaling accessor, used to determine the sub-blocks it would draw.
+            std::vector<std::thread> threads_;
+            std::mutex mutex_;
+            std::condition_variable work_available_;
+            std::condition_variable idle_;
+            /// A prefetch-request, for which the sub-blocks to be prefetched have not yet been determined.
+            struct Request
+            {
+                libCZI::IntRect roi;                        ///< The ROI (in the raw-sub-block-coordinate-system).
+                libCZI::CDimCoordinate planeCoordinate;     ///< The plane coordinate.
+                float zoom;                                 ///< The zoom.
+            };
+
+            std::deque<Request> requests_;                  ///< The prefetch-requests to be processed (guarded by mutex_).
+            std::uint64_t generation_{ 0 };                 ///< Incremented whenever the pending work is discarded (guarded by mutex_).
+            std::deque<int> queue_;                         ///< The sub-block indices to be loaded (guarded by mutex_).
+            std::unordered_set<int> queued_indices_;        ///< The sub-block indices in the queue (guarded by mutex_).
+            int loads_in_progress_{ 0 };                    ///< The number of loads and of prefetch-requests being processed (guarded by mutex_).
+            bool stop_{ false };                            ///< Whether the worker threads are to terminate (guarded by mutex_).
+        public:
+            SubBlockPrefetcher(const std::shared_ptr<libCZI::ISubBlockRepository>& repository, const std::shared_ptr<libCZI::ISubBlockCacheOperation>& cache, const libCZI::SubBlockPrefetcherOptions& options);
+            ~SubBlockPrefetcher() override;
+
+            using ISubBlockPrefetcher::Prefetch;
+            void Prefetch(const libCZI::IntRectAndFrameOfReference& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom) override;
+            void CancelPending() override;
+            void WaitUntilIdle() override;
+
+            /// Determines the sub-blocks which are to be prefetched for the specified accessor request, in the order in which they
+            /// are to be loaded: first the sub-blocks of the ring around the ROI (on the same plane), then the sub-blocks of the
+            /// ROI on the adjacent planes (the nearest ones first). Sub-blocks which are required for the request itself are not included,
+            /// and neither are uncompressed sub-blocks if "onlyUseSubBlockCacheForCompressedData" is set (since they would not be added
+            /// to the cache).
+            ///
+            /// \param  roi             The ROI (in the raw-sub-block-coordinate-system).
+            /// \param  planeCoordinate The plane coordinate.
+            /// \param  zoom            The zoom.
+            ///
+            /// \returns    The sub-block indices.
+            std::vector<int> DetermineSubBlocksToPrefetch(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom);
+        private:
+            /// Gets the sub-blocks in the specified ROI and plane which the scaling accessor would use for the specified zoom, i.e.
+            /// for each scene the sub-blocks of the pyramid-layer which is chosen for this zoom (and the sub-blocks filling its holes).
+            std::vector<int> GetSubBlocksForZoom(const libCZI::IntRect& roi, const libCZI::IDimCoordinate* planeCoordinate, float zoom);
+            void WorkerThread();
+            void ProcessRequest(const Request& request, std::uint64_t generation);
+            void DiscardPendingWork();
+            bool IsIdle() const;
+        };
+    } // namespace detail
+} // namespace libCZI
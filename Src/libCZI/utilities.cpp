@@ -9,6 +9,8 @@
 #include <sstream>
 #include <cstring>
 #include <array>
+#include <algorithm>
+#include <iterator>
 #if LIBCZI_WINDOWSAPI_AVAILABLE || LIBCZI_WINDOWS_UWPAPI_AVAILABLE
 #include <Windows.h>
 #else
@@ -225,6 +227,41 @@ tString trimImpl(const tString& str, const tString& whitespace)
     return color_text;
 }
 
+/*static*/bool Utilities::TryGetUnsignedIntegerOption(const char* input, const char* key, std::uint32_t& value)
+{
+    if (input == nullptr)
+    {
+        return false;
+    }
+
+    istringstream string_stream(input);
+    string item;
+    const size_t key_length = strlen(key);
+    while (getline(string_stream, item, ';'))
+    {
+        // remove leading whitespace
+        const auto first_non_whitespace = item.find_first_not_of(" \t");
+        if (first_non_whitespace == string::npos)
+        {
+            continue;
+        }
+
+        item.erase(0, first_non_whitespace);
+        if (item.compare(0, key_length, key) == 0 && item.size() > key_length && item[key_length] == '=')
+        {
+            char* end_ptr;
+            const unsigned long parsed_value = strtoul(item.c_str() + key_length + 1, &end_ptr, 10);
+            if (end_ptr != item.c_str() + key_length + 1)
+            {
+                value = static_cast<uint32_t>(parsed_value);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 /*static*/bool Utilities::TryGetRgb8ColorFromString(const std::wstring& strXml, libCZI::Rgb8Color& color)
 {
     const auto str = Utilities::Trim(strXml);
@@ -590,144 +627,167 @@ tString trimImpl(const tString& str, const tString& whitespace)
 }
 #endif
 
-void RectangleCoverageCalculator::AddRectangle(const libCZI::IntRect& rectangle)
+std::int64_t RectangleCoverageCalculator::AddRectangle(const libCZI::IntRect& rectangle)
 {
-    if (!rectangle.IsValid())
+    if (!rectangle.IsNonEmpty())
     {
-        return;
+        return 0;
     }
 
-    if (this->splitters_.empty())
+    const int top = rectangle.y;
+    const int bottom = rectangle.y + rectangle.h;
+    const int left = rectangle.x;
+    const int right = rectangle.x + rectangle.w;
+
+    // only the bands intersecting with the rectangle (and their immediate neighbors, with which a new band may be coalesced) are
+    //  affected - we locate them with a binary search and build the replacement for this range: the bands intersecting with the
+    //  rectangle are split (at the top and the bottom of the rectangle) and the interval is added to them, and the gaps between
+    //  the bands are filled with new bands
+    const size_t index_first_intersecting = this->GetFirstBandEndingBelow(top) - this->bands_.cbegin();
+    const size_t index_replace_begin = index_first_intersecting > 0 ? index_first_intersecting - 1 : 0;
+    int64_t newly_covered_area = 0;
+    vector<Band> bands;
+    auto band = this->bands_.begin() + index_replace_begin;
+    for (; band != this->bands_.begin() + index_first_intersecting; ++band)
     {
-        this->splitters_.push_back(rectangle);
+        RectangleCoverageCalculator::AppendBand(bands, std::move(*band));
     }
-    else
+
+    int y = top;
+    while (y < bottom)
     {
-        for (auto splitter = this->splitters_.begin(); splitter != this->splitters_.end(); ++splitter)
+        if (band == this->bands_.end() || band->top >= bottom)
         {
-            // does the rectangle intersect with one of existing rectangles?
-            if (splitter->IntersectsWith(rectangle) == true)
-            {
-                // check if it is completely contained in the current existing rectangle
-                if (RectangleCoverageCalculator::IsCompletelyContained(*splitter, rectangle) == true)
-                {
-                    // ok, in this case we have nothing to do!
-                    return;
-                }
-
-                // check if the existing rectangle is completely contained in the new one
-                if (RectangleCoverageCalculator::IsCompletelyContained(rectangle, *splitter) == true)
-                {
-                    // in this case we remove the (smaller) rect splitters[i] (which is fully
-                    // contained in rectangle) from our list and add rectangle
-                    this->splitters_.erase(splitter);
-                    this->AddRectangle(rectangle);
-                    return;
-                }
-
-                // ok, the rectangle overlap only partially... then let's cut the new rectangle into pieces
-                // (which do not intersect with the currently investigated rectangle) and try
-                // to add those pieces
-                std::array<libCZI::IntRect, 4> splitUpRects;
-                const int number_of_split_up_rects = SplitUpIntoNonOverlapping(*splitter, rectangle, splitUpRects);
-                for (int n = 0; n < number_of_split_up_rects; ++n)
-                {
-                    this->AddRectangle(splitUpRects[n]);
-                }
-
-                return;
-            }
+            // there is no band in the remaining part of the rectangle
+            newly_covered_area += static_cast<int64_t>(right - left) * (bottom - y);
+            RectangleCoverageCalculator::AppendBand(bands, Band{ y, bottom, { Interval{ left, right } } });
+            y = bottom;
+            continue;
         }
 
-        // if we end up here this means that the new rectangle does not
-        // overlap with an existing one -> we can happily add it now!
-        this->splitters_.push_back(rectangle);
-    }
-}
+        if (band->top > y)
+        {
+            // there is a gap before the next band
+            newly_covered_area += static_cast<int64_t>(right - left) * (band->top - y);
+            RectangleCoverageCalculator::AppendBand(bands, Band{ y, band->top, { Interval{ left, right } } });
+            y = band->top;
+            continue;
+        }
 
-/*static*/int RectangleCoverageCalculator::SplitUpIntoNonOverlapping(const libCZI::IntRect& rectangle_a, const libCZI::IntRect& rectangle_b, std::array<libCZI::IntRect, 4>& result)
-{
-    // precondition: rectangle_b is not completely contained in rectangle_a (and rectangle_a not completely contained in rectangle_b)!
-    int result_index = 0;
-    if (rectangle_b.x >= rectangle_a.x && rectangle_b.x + rectangle_b.w <= rectangle_a.x + rectangle_a.w)
-    {
-        if (rectangle_a.y > rectangle_b.y)
+        // the band intersects with the rectangle - the part of the band above the rectangle remains as is (this can only be the case for the first band)
+        if (band->top < y)
         {
-            result[result_index++] = libCZI::IntRect{ rectangle_b.x, rectangle_b.y, rectangle_b.w, rectangle_a.y - rectangle_b.y };
+            RectangleCoverageCalculator::AppendBand(bands, Band{ band->top, y, band->intervals });
         }
 
-        if (rectangle_b.y + rectangle_b.h > rectangle_a.y + rectangle_a.h)
+        const int bottom_of_part = (min)(band->bottom, bottom);
+        Band part{ y, bottom_of_part, band->intervals };
+        newly_covered_area += RectangleCoverageCalculator::AddInterval(part.intervals, left, right) * (bottom_of_part - y);
+        RectangleCoverageCalculator::AppendBand(bands, std::move(part));
+
+        // ...and the part of the band below the rectangle remains as is (this can only be the case for the last band)
+        if (band->bottom > bottom)
         {
-            result[result_index++] = libCZI::IntRect{ rectangle_b.x, rectangle_a.y + rectangle_a.h, rectangle_b.w, rectangle_b.y + rectangle_b.h - rectangle_a.y - rectangle_a.h };
+            RectangleCoverageCalculator::AppendBand(bands, Band{ bottom, band->bottom, std::move(band->intervals) });
         }
+
+        y = bottom_of_part;
+        ++band;
     }
-    else if (rectangle_b.x < rectangle_a.x && rectangle_b.x + rectangle_b.w <= rectangle_a.x + rectangle_a.w)
+
+    // the band following the rectangle may have to be coalesced with the last new band
+    if (band != this->bands_.end())
     {
-        result[result_index++] = libCZI::IntRect{ rectangle_b.x, rectangle_b.y, rectangle_a.x - rectangle_b.x, rectangle_b.h };
-        if (rectangle_b.y < rectangle_a.y)
-        {
-            result[result_index++] = libCZI::IntRect{ rectangle_a.x, rectangle_b.y, rectangle_b.x + rectangle_b.w - rectangle_a.x, rectangle_a.y - rectangle_b.y };
-        }
+        RectangleCoverageCalculator::AppendBand(bands, std::move(*band));
+        ++band;
+    }
 
-        if (rectangle_b.y + rectangle_b.h > rectangle_a.y + rectangle_a.h)
-        {
-            result[result_index++] = libCZI::IntRect{ rectangle_a.x, rectangle_a.y + rectangle_a.h, rectangle_b.x + rectangle_b.w - rectangle_a.x, rectangle_b.y + rectangle_b.h - rectangle_a.y - rectangle_a.h };
-        }
+    // and now, replace the range [index_replace_begin, index_replace_end) with the new bands
+    const size_t index_replace_end = band - this->bands_.begin();
+    const size_t count_replaced = index_replace_end - index_replace_begin;
+    const size_t count_to_move = (min)(count_replaced, bands.size());
+    std::move(bands.begin(), bands.begin() + count_to_move, this->bands_.begin() + index_replace_begin);
+    if (bands.size() <= count_replaced)
+    {
+        this->bands_.erase(this->bands_.begin() + index_replace_begin + count_to_move, this->bands_.begin() + index_replace_end);
     }
-    else if (rectangle_b.x >= rectangle_a.x && rectangle_b.x + rectangle_b.w > rectangle_a.x + rectangle_a.w)
+    else
     {
-        result[result_index++] = libCZI::IntRect{ rectangle_a.x + rectangle_a.w, rectangle_b.y, rectangle_b.x + rectangle_b.w - rectangle_a.x - rectangle_a.w, rectangle_b.h };
+        this->bands_.insert(
+            this->bands_.begin() + index_replace_end,
+            make_move_iterator(bands.begin() + count_to_move),
+            make_move_iterator(bands.end()));
+    }
 
-        if (rectangle_b.y < rectangle_a.y)
-        {
-            result[result_index++] = libCZI::IntRect{ rectangle_b.x, rectangle_b.y, rectangle_a.x + rectangle_a.w - rectangle_b.x, rectangle_a.y - rectangle_b.y };
-        }
+    return newly_covered_area;
+}
 
-        if (rectangle_b.y + rectangle_b.h > rectangle_a.y + rectangle_a.h)
-        {
-            result[result_index++] = libCZI::IntRect{ rectangle_b.x, rectangle_a.y + rectangle_a.h, rectangle_a.x + rectangle_a.w - rectangle_b.x, rectangle_b.y + rectangle_b.h - rectangle_a.y - rectangle_a.h };
-        }
-    }
-    else if (rectangle_b.x <= rectangle_a.x && rectangle_b.x + rectangle_b.w >= rectangle_a.x + rectangle_a.w)
+/*static*/std::int64_t RectangleCoverageCalculator::AddInterval(std::vector<Interval>& intervals, int left, int right)
+{
+    // find the first interval which overlaps or touches the new interval, and then all the intervals which are to be merged with it
+    auto first = lower_bound(intervals.begin(), intervals.end(), left, [](const Interval& interval, int x)->bool { return interval.right < x; });
+    auto last = first;
+    int64_t already_covered = 0;
+    int merged_left = left;
+    int merged_right = right;
+    for (; last != intervals.end() && last->left <= right; ++last)
     {
-        result[result_index++] = libCZI::IntRect{ rectangle_b.x, rectangle_b.y, rectangle_a.x - rectangle_b.x, rectangle_b.h };
-        result[result_index++] = libCZI::IntRect{ rectangle_a.x + rectangle_a.w, rectangle_b.y, rectangle_b.x + rectangle_b.w - rectangle_a.x - rectangle_a.w, rectangle_b.h };
+        already_covered += (max)(0, (min)(right, last->right) - (max)(left, last->left));
+        merged_left = (min)(merged_left, last->left);
+        merged_right = (max)(merged_right, last->right);
+    }
 
-        if (rectangle_a.y > rectangle_b.y)
-        {
-            result[result_index++] = libCZI::IntRect{ rectangle_a.x, rectangle_b.y, rectangle_a.w, rectangle_a.y - rectangle_b.y };
-        }
-        else if (rectangle_a.y + rectangle_a.h > rectangle_b.y && rectangle_a.y + rectangle_a.h < rectangle_b.y + rectangle_b.h)
-        {
-            result[result_index++] = libCZI::IntRect{ rectangle_a.x, rectangle_a.y + rectangle_a.h, rectangle_a.w, rectangle_b.y + rectangle_b.h - rectangle_a.y - rectangle_a.h };
-        }
+    if (first == last)
+    {
+        intervals.insert(first, Interval{ left, right });
+    }
+    else
+    {
+        first->left = merged_left;
+        first->right = merged_right;
+        intervals.erase(first + 1, last);
     }
 
-    return result_index;
+    return right - left - already_covered;
 }
 
+/*static*/void RectangleCoverageCalculator::AppendBand(std::vector<Band>& bands, Band&& band)
+{
+    if (!bands.empty() && bands.back().bottom == band.top && bands.back().intervals == band.intervals)
+    {
+        bands.back().bottom = band.bottom;
+    }
+    else
+    {
+        bands.emplace_back(std::move(band));
+    }
+}
 
-/*static*/bool RectangleCoverageCalculator::IsCompletelyContained(const libCZI::IntRect& outer, const libCZI::IntRect& inner)
+std::vector<RectangleCoverageCalculator::Band>::const_iterator RectangleCoverageCalculator::GetFirstBandEndingBelow(int y) const
 {
-    return inner.x >= outer.x && inner.x + inner.w <= outer.x + outer.w &&
-        inner.y >= outer.y && inner.y + inner.h <= outer.y + outer.h;
+    return upper_bound(this->bands_.cbegin(), this->bands_.cend(), y, [](int y_coordinate, const Band& band)->bool { return y_coordinate < band.bottom; });
 }
 
 std::int64_t RectangleCoverageCalculator::CalcAreaOfIntersectionWithRectangle(const libCZI::IntRect& query_rectangle) const
 {
-    if (!query_rectangle.IsValid())
+    if (!query_rectangle.IsNonEmpty())
     {
         return 0;
     }
 
+    const int query_bottom = query_rectangle.y + query_rectangle.h;
+    const int query_right = query_rectangle.x + query_rectangle.w;
     int64_t area = 0;
-    for (const auto& r : this->splitters_)
+    for (auto band = this->GetFirstBandEndingBelow(query_rectangle.y); band != this->bands_.cend() && band->top < query_bottom; ++band)
     {
-        auto intersection = r.Intersect(query_rectangle);
-        if (intersection.IsValid())
+        int64_t covered_length = 0;
+        auto interval = lower_bound(band->intervals.cbegin(), band->intervals.cend(), query_rectangle.x, [](const Interval& i, int x)->bool { return i.right <= x; });
+        for (; interval != band->intervals.cend() && interval->left < query_right; ++interval)
         {
-            area += intersection.w * static_cast<int64_t>(intersection.h);
+            covered_length += (min)(interval->right, query_right) - (max)(interval->left, query_rectangle.x);
         }
+
+        area += covered_length * ((min)(band->bottom, query_bottom) - (max)(band->top, query_rectangle.y));
     }
 
     return area;
@@ -735,10 +795,34 @@ std::int64_t RectangleCoverageCalculator::CalcAreaOfIntersectionWithRectangle(co
 
 bool RectangleCoverageCalculator::IsCompletelyCovered(const libCZI::IntRect& query_rectangle) const
 {
-    if (!query_rectangle.IsValid())
+    if (!query_rectangle.IsNonEmpty())
     {
         return true;
     }
 
-    return this->CalcAreaOfIntersectionWithRectangle(query_rectangle) == static_cast<int64_t>(query_rectangle.w) * query_rectangle.h;
+    // the bands must cover the query rectangle without gaps, and in every band, the query rectangle must be contained in one interval
+    const int query_bottom = query_rectangle.y + query_rectangle.h;
+    const int query_right = query_rectangle.x + query_rectangle.w;
+    int y = query_rectangle.y;
+    for (auto band = this->GetFirstBandEndingBelow(query_rectangle.y); band != this->bands_.cend(); ++band)
+    {
+        if (band->top > y)
+        {
+            return false;
+        }
+
+        const auto interval = lower_bound(band->intervals.cbegin(), band->intervals.cend(), query_rectangle.x, [](const Interval& i, int x)->bool { return i.right <= x; });
+        if (interval == band->intervals.cend() || interval->left > query_rectangle.x || interval->right < query_right)
+        {
+            return false;
+        }
+
+        y = band->bottom;
+        if (y >= query_bottom)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
@@ -155,6 +155,16 @@ namespace libCZI
             static std::string Rgb8ColorToString(const libCZI::Rgb8Color& color);
 
             static std::map<std::wstring, std::wstring> TokenizeAzureUriString(const std::wstring& input);
+
+            /// Parse the options string and search for an item of the form "<key>=<unsigned integer>". The syntax for the
+            /// options string is a semicolon-separated list of items.
+            ///
+            /// \param          input   The options string to parse. If nullptr, the function returns false.
+            /// \param          key     The key to search for.
+            /// \param [out]    value   If successful, the value is put here.
+            ///
+            /// \returns    True if the key was found and the value could be parsed; false otherwise.
+            static bool TryGetUnsignedIntegerOption(const char* input, const char* key, std::uint32_t& value);
         };
 
         class LoHiBytePackUnpack
@@ -232,25 +242,42 @@ namespace libCZI
         /// - Then, for a given rectangle, call CalcAreaOfIntersectionWithRectangle in order to get the area of the intersection  
         ///    of this rectangle with the union of the rectangles added before.
         /// The rectangles being added do not have to follow any order, or are required to be non-overlapping.
+        /// The covered region is kept as a list of horizontal bands (non-overlapping, sorted from top to bottom), where each
+        /// band holds a sorted list of the (non-overlapping and non-touching) x-intervals covered within this band. Adjacent
+        /// bands with the same x-intervals are merged, so for the typical case of a mosaic of (overlapping) tiles, the number
+        /// of bands is in the order of the number of rows of tiles, and the number of intervals in a band is small.
         class RectangleCoverageCalculator
         {
         private:
-            /// This vector contains the rectangles added to the state of the instance. The rectangles
-            /// in this vector are guaranteed to be non-overlapping. That is why the name 'splitters' is used -
-            /// if a rectangles is added which is overlapping with the existing ones, the rectangle is split into smaller 
-            /// rectangles (which we call the 'splitters') which are non-overlapping with the existing ones.
-            std::vector<libCZI::IntRect> splitters_;
+            /// An x-interval [left, right) which is covered within a band.
+            struct Interval
+            {
+                int left;
+                int right;
+
+                bool operator==(const Interval& other) const { return this->left == other.left && this->right == other.right; }
+            };
+
+            /// A horizontal band [top, bottom) with the x-intervals covered within it.
+            struct Band
+            {
+                int top;
+                int bottom;
+                std::vector<Interval> intervals;
+            };
+
+            std::vector<Band> bands_;
         public:
-            /// Adds a rectangle to the state. The runtime of this method increases with the number of
-            /// splitters in the state of the instance and the number of rectangles this rectangle
-            /// needs to be split into. For a modest number of rectangles, the runtime is for
-            /// sure negligible.
-            /// A pathologic case to be aware of is when there are many existing and then a large rectangle
-            /// is added (which is overlapping with many of the existing ones). In this case, it would be
-            /// greatly beneficial to add the large rectangle first, and then the smaller ones.
+            /// Adds a rectangle to the state. The bands intersecting with the rectangle are located with a binary
+            /// search, and only those (and their immediate neighbors) are rebuilt - so the work is proportional
+            /// to the number of intersected bands times the number of intervals in them. In addition, the bands
+            /// below the rectangle are moved within the vector if the number of bands changes, which is linear
+            /// in the number of bands (but only moves the bands, their intervals are not copied).
             ///
             /// \param  rectangle   The rectangle to be added.
-            void AddRectangle(const libCZI::IntRect& rectangle);
+            ///
+            /// \returns    The area of the rectangle which was not covered before (i.e. by how much the covered area increased).
+            std::int64_t AddRectangle(const libCZI::IntRect& rectangle);
 
             /// Adds the rectangles given by the iterator to the state of the instance.
             ///
@@ -284,24 +311,22 @@ namespace libCZI
             /// \returns    True if completely covered; false otherwise.
             bool IsCompletelyCovered(const libCZI::IntRect& query_rectangle) const;
         private:
-            /// Test whether the rectangle 'inner' is completely contained in the rectangle 'outer'.
-            ///
-            /// \param  outer   The outer rectangle.
-            /// \param  inner   The inner rectangle.
-            ///
-            /// \returns    True if completely contained, false if not.
-            static bool IsCompletelyContained(const libCZI::IntRect& outer, const libCZI::IntRect& inner);
+            /// Gets an iterator to the first band whose bottom is below the specified y-coordinate.
+            std::vector<Band>::const_iterator GetFirstBandEndingBelow(int y) const;
 
-            /// The area of rectangle_b which does not overlap with rectangle_a is determined and
-            /// we return this part as a list of 4 rectangles at most. The return value is the number
-            /// of rectangles in the result array.
+            /// Adds the interval [left, right) to the specified (sorted) list of intervals, merging it with the intervals it
+            /// overlaps or touches.
             ///
-            /// \param          rectangle_a The rectangle a.
-            /// \param          rectangle_b The rectangle b.
-            /// \param [out]    result      The resulting splitters are put into this array. There will be 4 rectangles at most.
+            /// \param [in,out] intervals   The intervals.
+            /// \param          left        The left (inclusive) of the interval to be added.
+            /// \param          right       The right (exclusive) of the interval to be added.
             ///
-            /// \returns    The number of valid rectangles in the 'result' array.
-            static int SplitUpIntoNonOverlapping(const libCZI::IntRect& rectangle_a, const libCZI::IntRect& rectangle_b, std::array<libCZI::IntRect, 4>& result);
+            /// \returns    The length of the part of the interval which was not covered before.
+            static std::int64_t AddInterval(std::vector<Interval>& intervals, int left, int right);
+
+            /// Appends the band to the specified list of bands - if it adjoins the last band and has the same intervals,
+            /// the last band is extended instead.
+            static void AppendBand(std::vector<Band>& bands, Band&& band);
         };
 
     }   // namespace detail
@@ -6,6 +6,8 @@
 #include <cstdint>
 #include "inc_libCZI_Config.h"
 #include "utilities.h"
+#include "utilities_simd.h"
+#include "BitmapOperations.h"
 
 using namespace std;
 using namespace libCZI::detail;
@@ -84,7 +86,39 @@ static int check_4th_gen_intel_core_features()
     return 1;
 }
 
-static bool CheckWhetherCpuSupportsAVX2()
+static int check_avx512_f_bw_vbmi_features()
+{
+    uint32_t abcd[4];
+    constexpr uint32_t osxsave_mask = (1 << 27);
+    constexpr uint32_t avx512_f_bw_mask = (1 << 16) | (1 << 30);
+    constexpr uint32_t avx512_vbmi_mask = (1 << 1);
+
+    /*  CPUID.(EAX=01H, ECX=0H):ECX.OSXSAVE[bit 27]==1 */
+    run_cpuid(1, 0, abcd);
+    if ((abcd[2] & osxsave_mask) != osxsave_mask)
+        return 0;
+
+    /* checking if xmm, ymm, opmask and zmm state are enabled in XCR0 */
+    uint32_t xcr0;
+#if defined(_MSC_VER)
+    xcr0 = static_cast<uint32_t>(_xgetbv(0));
+#else
+    __asm__("xgetbv" : "=a" (xcr0) : "c" (0) : "%edx");
+#endif
+    if ((xcr0 & 0xe6) != 0xe6)
+        return 0;
+
+    /*  CPUID.(EAX=07H, ECX=0H):EBX.AVX512F[bit 16]==1  &&
+        CPUID.(EAX=07H, ECX=0H):EBX.AVX512BW[bit 30]==1 &&
+        CPUID.(EAX=07H, ECX=0H):ECX.AVX512VBMI[bit 1]==1 */
+    run_cpuid(7, 0, abcd);
+    if ((abcd[1] & avx512_f_bw_mask) != avx512_f_bw_mask || (abcd[2] & avx512_vbmi_mask) != avx512_vbmi_mask)
+        return 0;
+
+    return 1;
+}
+
+/*static*/bool CpuFeatures::HasAvx2()
 {
     static int avx2Supported = -1;
 
@@ -103,6 +137,25 @@ static bool CheckWhetherCpuSupportsAVX2()
     }
 }
 
+/*static*/bool CpuFeatures::HasAvx512Vbmi()
+{
+    static int avx512VbmiSupported = -1;
+
+    if (avx512VbmiSupported == 0)
+    {
+        return false;
+    }
+    else if (avx512VbmiSupported == 1)
+    {
+        return true;
+    }
+    else
+    {
+        avx512VbmiSupported = (CpuFeatures::HasAvx2() && check_avx512_f_bw_vbmi_features() > 0) ? 1 : 0;
+        return (avx512VbmiSupported == 1);
+    }
+}
+
 class LoHiBytePackUnpackAvx : public LoHiBytePackUnpack
 {
 public:
@@ -209,7 +262,14 @@ LoHiBytePackUnpackAvx::pfnLoHiBytePackStrided_t LoHiBytePackUnpackAvx::pfnLoHiBy
 
 /*static*/void LoHiBytePackUnpackAvx::LoHiByteUnpackStrided_Choose(const void* ptrSrc, std::uint32_t wordCount, std::uint32_t stride, std::uint32_t lineCount, void* ptrDst)
 {
-    if (CheckWhetherCpuSupportsAVX2())
+#if LIBCZI_HAS_AVX512VBMIINTRINSICS
+    if (CpuFeatures::HasAvx512Vbmi())
+    {
+        LoHiBytePackUnpackAvx::pfnLoHiByteUnpackStrided = SimdKernelsAvx512Vbmi::LoHiByteUnpackStrided;
+    }
+    else
+#endif
+    if (CpuFeatures::HasAvx2())
     {
         LoHiBytePackUnpackAvx::pfnLoHiByteUnpackStrided = LoHiBytePackUnpackAvx::LoHiByteUnpackStrided_AVX;
     }
@@ -223,7 +283,14 @@ LoHiBytePackUnpackAvx::pfnLoHiBytePackStrided_t LoHiBytePackUnpackAvx::pfnLoHiBy
 
 /*static*/void LoHiBytePackUnpackAvx::LoHiBytePackStrided_Choose(const void* ptrSrc, size_t sizeSrc, std::uint32_t width, std::uint32_t height, std::uint32_t stride, void* dest)
 {
-    if (CheckWhetherCpuSupportsAVX2())
+#if LIBCZI_HAS_AVX512VBMIINTRINSICS
+    if (CpuFeatures::HasAvx512Vbmi())
+    {
+        LoHiBytePackUnpackAvx::pfnLoHiBytePackStrided = SimdKernelsAvx512Vbmi::LoHiBytePackStrided;
+    }
+    else
+#endif
+    if (CpuFeatures::HasAvx2())
     {
         LoHiBytePackUnpackAvx::pfnLoHiBytePackStrided = LoHiBytePackUnpackAvx::LoHiBytePackStrided_AVX;
     }
@@ -235,6 +302,88 @@ LoHiBytePackUnpackAvx::pfnLoHiBytePackStrided_t LoHiBytePackUnpackAvx::pfnLoHiBy
     (*LoHiBytePackUnpackAvx::pfnLoHiBytePackStrided)(ptrSrc, sizeSrc, width, height, stride, dest);
 }
 
+//----------------------------------------------------------------------------
+
+class BitmapOperationsAvx : public CBitmapOperations
+{
+public:
+    typedef void(*pfnRGB48ToBGR48_t)(int, int, std::uint16_t*, int);
+
+    static pfnRGB48ToBGR48_t pfnRGB48ToBGR48;
+
+    static void RGB48ToBGR48_Choose(int w, int h, std::uint16_t* ptr, int stride);
+
+    static void RGB48ToBGR48_AVX(int w, int h, std::uint16_t* ptr, int stride);
+};
+
+BitmapOperationsAvx::pfnRGB48ToBGR48_t BitmapOperationsAvx::pfnRGB48ToBGR48 = &BitmapOperationsAvx::RGB48ToBGR48_Choose;
+
+/*static*/void CBitmapOperations::RGB48ToBGR48(int w, int h, std::uint16_t* ptr, int stride)
+{
+    (*BitmapOperationsAvx::pfnRGB48ToBGR48)(w, h, ptr, stride);
+}
+
+/*static*/void BitmapOperationsAvx::RGB48ToBGR48_AVX(int w, int h, std::uint16_t* ptr, int stride)
+{
+    // swap the first and the third word of the two 6-byte-pixels, leave the last 4 bytes as they are
+    static const __m128i shuffleConst128 = _mm_setr_epi8(
+        4, 5, 2, 3, 0, 1,
+        10, 11, 8, 9, 6, 7,
+        12, 13, 14, 15);
+    const __m256i shuffleConst = _mm256_broadcastsi128_si256(shuffleConst128);
+
+    for (int y = 0; y < h; ++y)
+    {
+        uint8_t* pLine = reinterpret_cast<uint8_t*>(ptr) + y * static_cast<ptrdiff_t>(stride);
+        int x = 0;
+
+        // We process 4 pixels (24 bytes) per loop, where the lower lane holds pixels 0 and 1, and the upper lane
+        //  pixels 2 and 3. Each lane is 16 bytes, so we access 4 bytes beyond the 4 pixels - therefore we need
+        //  at least 5 pixels here. The lower lane is stored first, so the (unmodified) 4 bytes at its end are
+        //  then overwritten with the result from the upper lane.
+        for (; x + 5 <= w; x += 4)
+        {
+            const __m256i d = _mm256_loadu2_m128i(reinterpret_cast<const __m128i*>(pLine + 12), reinterpret_cast<const __m128i*>(pLine));
+            const __m256i shuffled = _mm256_shuffle_epi8(d, shuffleConst);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pLine), _mm256_castsi256_si128(shuffled));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pLine + 12), _mm256_extracti128_si256(shuffled, 1));
+            pLine += 24;
+        }
+
+        uint16_t* pLineWords = reinterpret_cast<uint16_t*>(pLine);
+        for (; x < w; ++x)
+        {
+            const uint16_t v = pLineWords[0];
+            pLineWords[0] = pLineWords[2];
+            pLineWords[2] = v;
+            pLineWords += 3;
+        }
+    }
+
+    _mm256_zeroall();
+}
+
+/*static*/void BitmapOperationsAvx::RGB48ToBGR48_Choose(int w, int h, std::uint16_t* ptr, int stride)
+{
+#if LIBCZI_HAS_AVX512VBMIINTRINSICS
+    if (CpuFeatures::HasAvx512Vbmi())
+    {
+        BitmapOperationsAvx::pfnRGB48ToBGR48 = SimdKernelsAvx512Vbmi::RGB48ToBGR48;
+    }
+    else
+#endif
+    if (CpuFeatures::HasAvx2())
+    {
+        BitmapOperationsAvx::pfnRGB48ToBGR48 = BitmapOperationsAvx::RGB48ToBGR48_AVX;
+    }
+    else
+    {
+        BitmapOperationsAvx::pfnRGB48ToBGR48 = BitmapOperationsAvx::RGB48ToBGR48_C;
+    }
+
+    (*BitmapOperationsAvx::pfnRGB48ToBGR48)(w, h, ptr, stride);
+}
+
 #elif LIBCZI_HAS_NEOININTRINSICS
 
 #include <arm_neon.h>
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "inc_libCZI_Config.h"
+
+namespace libCZI
+{
+    namespace detail
+    {
+#if LIBCZI_HAS_AVXINTRINSICS
+        /// Runtime detection of the instruction set extensions supported by the CPU (and enabled by the operating system).
+        /// The SIMD-kernels are selected based on this information - the general pattern is that a function pointer initially
+        /// points to a "choose"-function, which determines the best implementation on first call and then updates the function pointer.
+        class CpuFeatures
+        {
+        public:
+            /// Determine whether AVX2 (and the related extensions FMA, BMI1, BMI2, MOVBE and LZCNT) are supported.
+            ///
+            /// \returns True if AVX2 is supported, false otherwise.
+            static bool HasAvx2();
+
+            /// Determine whether AVX-512 with the extensions F, BW and VBMI are supported.
+            ///
+            /// \returns True if AVX-512 (F, BW and VBMI) is supported, false otherwise.
+            static bool HasAvx512Vbmi();
+        };
+#endif
+
+#if LIBCZI_HAS_AVX512VBMIINTRINSICS
+        /// Implementations of pixel-kernels with AVX-512 (F, BW and VBMI). Those functions are in a separate module (which is
+        /// compiled with the respective compiler switches), and they must only be called if CpuFeatures::HasAvx512Vbmi() returned true.
+        /// The arguments have the same semantic as the corresponding functions in LoHiBytePackUnpack and CBitmapOperations, and
+        /// they are not validated here.
+        class SimdKernelsAvx512Vbmi
+        {
+        public:
+            static void LoHiByteUnpackStrided(const void* ptrSrc, std::uint32_t wordCount, std::uint32_t stride, std::uint32_t lineCount, void* ptrDst);
+            static void LoHiBytePackStrided(const void* ptrSrc, size_t sizeSrc, std::uint32_t width, std::uint32_t height, std::uint32_t stride, void* dest);
+            static void RGB48ToBGR48(int w, int h, std::uint16_t* ptr, int stride);
+        };
+#endif
+    }
+}
@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "utilities_simd.h"
+
+#if LIBCZI_HAS_AVX512VBMIINTRINSICS
+
+// Note: On x86/x64 (and GCC/Clang) this module is compiled with the switches "-mavx512f -mavx512bw -mavx512vbmi". The functions
+//        in here must only be called after a runtime detection of the AVX-512-capabilities (c.f. CpuFeatures::HasAvx512Vbmi).
+
+#include <immintrin.h>
+
+using namespace std;
+using namespace libCZI::detail;
+
+namespace
+{
+    /// Permutation for gathering the low-bytes of 32 words into the lower half, and the high-bytes into the upper half.
+    alignas(64) const uint8_t kUnpackLoHiBytesPermutation[64] =
+    {
+        0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
+        32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62,
+        1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31,
+        33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59, 61, 63
+    };
+
+    /// Permutation for interleaving the 32 bytes in the lower half with the 32 bytes in the upper half.
+    alignas(64) const uint8_t kPackLoHiBytesPermutation[64] =
+    {
+        0, 32, 1, 33, 2, 34, 3, 35, 4, 36, 5, 37, 6, 38, 7, 39,
+        8, 40, 9, 41, 10, 42, 11, 43, 12, 44, 13, 45, 14, 46, 15, 47,
+        16, 48, 17, 49, 18, 50, 19, 51, 20, 52, 21, 53, 22, 54, 23, 55,
+        24, 56, 25, 57, 26, 58, 27, 59, 28, 60, 29, 61, 30, 62, 31, 63
+    };
+
+    /// Permutation for swapping the first and the third word in 10 consecutive 6-byte-pixels (the last 4 bytes are not modified).
+    alignas(64) const uint8_t kSwapRgb48Permutation[64] =
+    {
+        4, 5, 2, 3, 0, 1, 10, 11, 8, 9, 6, 7, 16, 17, 14, 15,
+        12, 13, 22, 23, 20, 21, 18, 19, 28, 29, 26, 27, 24, 25, 34, 35,
+        32, 33, 30, 31, 40, 41, 38, 39, 36, 37, 46, 47, 44, 45, 42, 43,
+        52, 53, 50, 51, 48, 49, 58, 59, 56, 57, 54, 55, 60, 61, 62, 63
+    };
+}
+
+/*static*/void SimdKernelsAvx512Vbmi::LoHiByteUnpackStrided(const void* ptrSrc, std::uint32_t wordCount, std::uint32_t stride, std::uint32_t lineCount, void* ptrDst)
+{
+    const __m512i permutation = _mm512_load_si512(kUnpackLoHiBytesPermutation);
+    uint8_t* pDst = static_cast<uint8_t*>(ptrDst);
+    const size_t halfLength = static_cast<size_t>(wordCount) * lineCount;
+    const uint32_t widthOver32 = wordCount / 32;
+    const uint32_t widthModulo32 = wordCount % 32;
+
+    for (uint32_t y = 0; y < lineCount; ++y)
+    {
+        const uint16_t* pSrc = reinterpret_cast<const uint16_t*>(static_cast<const uint8_t*>(ptrSrc) + y * static_cast<size_t>(stride));
+
+        for (uint32_t i = 0; i < widthOver32; ++i)
+        {
+            const __m512i shuffled = _mm512_permutexvar_epi8(permutation, _mm512_loadu_si512(pSrc));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst), _mm512_castsi512_si256(shuffled));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + halfLength), _mm512_extracti64x4_epi64(shuffled, 1));
+
+            pSrc += 32;  // we do 32 words = 64 bytes per loop
+            pDst += 32;
+        }
+
+        for (uint32_t i = 0; i < widthModulo32; ++i)
+        {
+            const uint16_t v = *pSrc++;
+            *pDst = static_cast<uint8_t>(v);
+            *(pDst + halfLength) = static_cast<uint8_t>(v >> 8);
+            pDst++;
+        }
+    }
+
+    _mm256_zeroupper();
+}
+
+/*static*/void SimdKernelsAvx512Vbmi::LoHiBytePackStrided(const void* ptrSrc, size_t sizeSrc, std::uint32_t width, std::uint32_t height, std::uint32_t stride, void* dest)
+{
+    const __m512i permutation = _mm512_load_si512(kPackLoHiBytesPermutation);
+    const uint8_t* pSrc = static_cast<const uint8_t*>(ptrSrc);
+    const size_t halfLength = sizeSrc / 2;
+    const uint32_t widthOver32 = width / 32;
+    const uint32_t widthRemainder = width % 32;
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        uint8_t* pDst = static_cast<uint8_t*>(dest) + static_cast<size_t>(y) * stride;
+
+        for (uint32_t x = 0; x < widthOver32; ++x)
+        {
+            const __m256i lowBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc));
+            const __m256i highBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + halfLength));
+            const __m512i packed = _mm512_permutexvar_epi8(permutation, _mm512_inserti64x4(_mm512_castsi256_si512(lowBytes), highBytes, 1));
+            _mm512_storeu_si512(pDst, packed);
+            pSrc += 32;
+            pDst += 64;
+        }
+
+        uint16_t* pDstWord = reinterpret_cast<uint16_t*>(pDst);
+        for (uint32_t x = 0; x < widthRemainder; ++x)
+        {
+            const uint16_t v = *pSrc | (static_cast<uint16_t>(*(pSrc + halfLength)) << 8);
+            *pDstWord++ = v;
+            ++pSrc;
+        }
+    }
+
+    _mm256_zeroupper();
+}
+
+/*static*/void SimdKernelsAvx512Vbmi::RGB48ToBGR48(int w, int h, std::uint16_t* ptr, int stride)
+{
+    const __m512i permutation = _mm512_load_si512(kSwapRgb48Permutation);
+    constexpr __mmask64 maskTenPixels = (static_cast<__mmask64>(1) << 60) - 1;
+    for (int y = 0; y < h; ++y)
+    {
+        uint8_t* pLine = reinterpret_cast<uint8_t*>(ptr) + y * static_cast<ptrdiff_t>(stride);
+        int x = 0;
+        for (; x + 10 <= w; x += 10)
+        {
+            const __m512i swapped = _mm512_permutexvar_epi8(permutation, _mm512_maskz_loadu_epi8(maskTenPixels, pLine));
+            _mm512_mask_storeu_epi8(pLine, maskTenPixels, swapped);
+            pLine += 60;
+        }
+
+        if (x < w)
+        {
+            // the remaining (less than 10) pixels are processed with a masked load and store - masked-out bytes are
+            //  neither read nor written
+            const __mmask64 mask = (static_cast<__mmask64>(1) << ((w - x) * 6)) - 1;
+            const __m512i swapped = _mm512_permutexvar_epi8(permutation, _mm512_maskz_loadu_epi8(mask, pLine));
+            _mm512_mask_storeu_epi8(pLine, mask, swapped);
+        }
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
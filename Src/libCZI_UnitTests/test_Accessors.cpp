@@ -743,3 +743,501 @@ TEST(Accessor, CreateDocumentAndCheckSingleChannelScalingAccessorWithSubBlockCac
         EXPECT_EQ(pixel_x1_y1, 4);
     }
 }
+
+TEST(Accessor, CreateDocumentAndCheckSingleChannelScalingAccessorWithDoNotAdmitToSubBlockCache)
+{
+    auto czi_document_as_blob = CreateCziWithFourSubblockInMosaicArragengement();
+
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+
+    const auto accessor = reader->CreateSingleChannelScalingTileAccessor();
+    const auto subblock_cache = CreateSubBlockCache();
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    ISingleChannelScalingTileAccessor::Options options;
+    options.Clear();
+    options.backGroundColor = RgbFloatColor{ 0,0,0 };
+    options.subBlockCache = subblock_cache;
+    options.onlyUseSubBlockCacheForCompressedData = false;
+    options.doNotAdmitToSubBlockCache = true;
+
+    const auto composite_bitmap = accessor->Get(PixelType::Gray8, IntRect{ 1,1,2,2 }, &plane_coordinate, 1, &options);
+    ASSERT_EQ(composite_bitmap->GetWidth(), 2);
+    ASSERT_EQ(composite_bitmap->GetHeight(), 2);
+    {
+        const ScopedBitmapLockerSP lock_info_bitmap{ composite_bitmap };
+        EXPECT_EQ(*(static_cast<const uint8_t*>(lock_info_bitmap.ptrDataRoi) + 0), 1);
+        EXPECT_EQ(*(static_cast<const uint8_t*>(lock_info_bitmap.ptrDataRoi) + static_cast<size_t>(1) * lock_info_bitmap.stride + 1), 4);
+    }
+
+    // nothing must have been added to the cache
+    EXPECT_EQ(subblock_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 0);
+}
+
+TEST(Accessor, CreateDocumentAndCheckSingleChannelScalingAccessorWithRenderedTileCache)
+{
+    auto czi_document_as_blob = CreateCziWithFourSubblockInMosaicArragengement();
+
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+
+    const auto rendered_tile_cache = CreateRenderedTileCache(ISubBlockCacheControl::PruneOptions{});
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    ISingleChannelScalingTileAccessor::Options options;
+    options.Clear();
+    options.backGroundColor = RgbFloatColor{ 0,0,0 };
+    options.renderedTileCache = rendered_tile_cache;
+
+    const auto check_composite = [](const shared_ptr<IBitmapData>& composite_bitmap)->void
+    {
+        ASSERT_EQ(composite_bitmap->GetWidth(), 2);
+        ASSERT_EQ(composite_bitmap->GetHeight(), 2);
+        const ScopedBitmapLockerSP lock_info_bitmap{ composite_bitmap };
+        EXPECT_EQ(*(static_cast<const uint8_t*>(lock_info_bitmap.ptrDataRoi) + 0), 1);
+        EXPECT_EQ(*(static_cast<const uint8_t*>(lock_info_bitmap.ptrDataRoi) + static_cast<size_t>(1) * lock_info_bitmap.stride + 1), 4);
+    };
+
+    const auto composite_bitmap = reader->CreateSingleChannelScalingTileAccessor()->Get(PixelType::Gray8, IntRect{ 1,1,2,2 }, &plane_coordinate, 1, &options);
+    check_composite(composite_bitmap);
+    EXPECT_EQ(rendered_tile_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 1);
+
+    // modifying the result must not affect the cached one
+    {
+        const ScopedBitmapLockerSP lock_info_bitmap{ composite_bitmap };
+        *static_cast<uint8_t*>(lock_info_bitmap.ptrDataRoi) = 42;
+    }
+
+    // the same request (with a new accessor object) is served from the cache
+    check_composite(reader->CreateSingleChannelScalingTileAccessor()->Get(PixelType::Gray8, IntRect{ 1,1,2,2 }, &plane_coordinate, 1, &options));
+    EXPECT_EQ(rendered_tile_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 1);
+
+    // a different background color gives a different key
+    options.backGroundColor = RgbFloatColor{ 1,1,1 };
+    check_composite(reader->CreateSingleChannelScalingTileAccessor()->Get(PixelType::Gray8, IntRect{ 1,1,2,2 }, &plane_coordinate, 1, &options));
+    EXPECT_EQ(rendered_tile_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 2);
+
+    // without a background color, the result is not cached
+    options.backGroundColor = RgbFloatColor{ numeric_limits<float>::quiet_NaN(), 0, 0 };
+    reader->CreateSingleChannelScalingTileAccessor()->Get(PixelType::Gray8, IntRect{ 1,1,2,2 }, &plane_coordinate, 1, &options);
+    EXPECT_EQ(rendered_tile_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 2);
+
+    // after re-opening the reader, the entries of the previous instance are not used anymore
+    reader->Close();
+    reader->Open(memory_stream);
+    options.backGroundColor = RgbFloatColor{ 0,0,0 };
+    check_composite(reader->CreateSingleChannelScalingTileAccessor()->Get(PixelType::Gray8, IntRect{ 1,1,2,2 }, &plane_coordinate, 1, &options));
+    EXPECT_EQ(rendered_tile_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 3);
+
+    rendered_tile_cache->Prune(ISubBlockCacheControl::PruneOptions{ (numeric_limits<uint64_t>::max)(), 1 });
+    EXPECT_EQ(rendered_tile_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 1);
+}
+
+/// Creates a synthetic CZI document with 8x8 overlapping subblocks (of size 16x16, placed on a grid with spacing 12)
+/// with random content. The M-index of the subblocks is counting up from 0.
+///
+/// \returns A blob containing the synthetic CZI document.
+static tuple<shared_ptr<void>, size_t> CreateCziWithOverlappingSubblocksInMosaicArrangement()
+{
+    return CreateCziDocument(
+        make_shared<CCziWriterInfo>(
+            GUID{ 0x1234567,0x89ab,0xcdef,{ 1,2,3,4,5,6,7,8 } },
+            CDimBounds{ { DimensionIndex::C, 0, 1 } },	// set a bounds C
+            0, 63),	// set a bounds M : 0<=m<=63
+        [](ICziWriter* writer)->void
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                AddSubBlockWithBitmap(
+                    writer,
+                    CDimCoordinate{ { DimensionIndex::C, 0 } },
+                    i,
+                    IntRect{ (i % 8) * 12, (i / 8) * 12, 16, 16 },
+                    CreateRandomBitmap(PixelType::Gray8, 16, 16));
+            }
+        });
+}
+
+TEST(Accessor, SingleChannelTileAccessorWithDecodeThreadsGivesSameResultAsSequential)
+{
+    auto czi_document_as_blob = CreateCziWithOverlappingSubblocksInMosaicArrangement();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const auto accessor = reader->CreateSingleChannelTileAccessor();
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    ISingleChannelTileAccessor::Options options;
+    options.Clear();
+    options.backGroundColor = RgbFloatColor{ 0,0,0 };
+
+    for (const bool use_visibility_check_optimization : { false, true })
+    {
+        options.useVisibilityCheckOptimization = use_visibility_check_optimization;
+        options.decodeThreadCount = 0;
+        const auto composite_sequential = accessor->Get(PixelType::Gray8, IntRect{ 5,7,90,80 }, &plane_coordinate, &options);
+        options.decodeThreadCount = 4;
+        const auto composite_parallel = accessor->Get(PixelType::Gray8, IntRect{ 5,7,90,80 }, &plane_coordinate, &options);
+        EXPECT_TRUE(AreBitmapDataEqual(composite_sequential, composite_parallel));
+    }
+}
+
+TEST(Accessor, SingleChannelPyramidLayerTileAccessorWithDecodeThreadsGivesSameResultAsSequential)
+{
+    auto czi_document_as_blob = CreateCziWithOverlappingSubblocksInMosaicArrangement();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const auto accessor = reader->CreateSingleChannelPyramidLayerTileAccessor();
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    ISingleChannelPyramidLayerTileAccessor::Options options;
+    options.Clear();
+    options.backGroundColor = RgbFloatColor{ 0,0,0 };
+
+    options.decodeThreadCount = 0;
+    const auto composite_sequential = accessor->Get(PixelType::Gray8, IntRect{ 5,7,90,80 }, &plane_coordinate, ISingleChannelPyramidLayerTileAccessor::PyramidLayerInfo{ 2, 0 }, &options);
+    options.decodeThreadCount = 4;
+    const auto composite_parallel = accessor->Get(PixelType::Gray8, IntRect{ 5,7,90,80 }, &plane_coordinate, ISingleChannelPyramidLayerTileAccessor::PyramidLayerInfo{ 2, 0 }, &options);
+    EXPECT_TRUE(AreBitmapDataEqual(composite_sequential, composite_parallel));
+}
+
+TEST(Accessor, SingleChannelScalingTileAccessorWithDecodeThreadsAndSubBlockCacheGivesSameResultAsSequential)
+{
+    auto czi_document_as_blob = CreateCziWithOverlappingSubblocksInMosaicArrangement();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const auto accessor = reader->CreateSingleChannelScalingTileAccessor();
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    ISingleChannelScalingTileAccessor::Options options;
+    options.Clear();
+    options.backGroundColor = RgbFloatColor{ 0,0,0 };
+
+    for (const float zoom : { 1.f, 0.37f })
+    {
+        options.decodeThreadCount = 0;
+        options.subBlockCache.reset();
+        const auto composite_sequential = accessor->Get(PixelType::Gray8, IntRect{ 5,7,90,80 }, &plane_coordinate, zoom, &options);
+
+        options.decodeThreadCount = 3;
+        options.subBlockCache = CreateSubBlockCache();
+        options.onlyUseSubBlockCacheForCompressedData = false;
+        const auto composite_parallel = accessor->Get(PixelType::Gray8, IntRect{ 5,7,90,80 }, &plane_coordinate, zoom, &options);
+        EXPECT_TRUE(AreBitmapDataEqual(composite_sequential, composite_parallel));
+
+        // and a second time, now with all subblocks coming from the cache
+        const auto composite_parallel_from_cache = accessor->Get(PixelType::Gray8, IntRect{ 5,7,90,80 }, &plane_coordinate, zoom, &options);
+        EXPECT_TRUE(AreBitmapDataEqual(composite_sequential, composite_parallel_from_cache));
+    }
+}
+
+TEST(Accessor, SingleChannelTileAccessorGetMultiplePlanesGivesSameResultAsGetForEachPlane)
+{
+    auto czi_document_as_blob = CreateCziWithThreeZPlanesOfOverlappingSubblocks();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const auto accessor = reader->CreateSingleChannelTileAccessor();
+    const vector<CDimCoordinate> plane_coordinates
+    {
+        CDimCoordinate{ {DimensionIndex::C, 0}, {DimensionIndex::Z, 2} },
+        CDimCoordinate{ {DimensionIndex::C, 0}, {DimensionIndex::Z, 0} },
+        CDimCoordinate{ {DimensionIndex::C, 0}, {DimensionIndex::Z, 1} },
+    };
+
+    ISingleChannelTileAccessor::Options options;
+    options.Clear();
+    options.backGroundColor = RgbFloatColor{ 0.5f,0.5f,0.5f };
+
+    for (const bool use_visibility_check_optimization : { false, true })
+    {
+        for (const uint32_t decode_thread_count : { 0u, 3u })
+        {
+            options.useVisibilityCheckOptimization = use_visibility_check_optimization;
+            options.decodeThreadCount = decode_thread_count;
+            const auto composites = accessor->GetMultiplePlanes(PixelType::Gray8, IntRect{ 3,5,40,38 }, plane_coordinates, &options);
+            ASSERT_EQ(composites.size(), plane_coordinates.size());
+            for (size_t i = 0; i < plane_coordinates.size(); ++i)
+            {
+                const auto composite = accessor->Get(PixelType::Gray8, IntRect{ 3,5,40,38 }, &plane_coordinates[i], &options);
+                EXPECT_TRUE(AreBitmapDataEqual(composite, composites[i]));
+            }
+        }
+    }
+}
+
+TEST(Accessor, SingleChannelProjectionAccessorGivesSameResultAsProjectingTheComposites)
+{
+    auto czi_document_as_blob = CreateCziWithThreeZPlanesOfOverlappingSubblocks();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const auto tile_accessor = reader->CreateSingleChannelTileAccessor();
+    const auto projection_accessor = reader->CreateSingleChannelProjectionAccessor();
+    const IntRect roi{ 3,5,40,38 };
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+
+    ISingleChannelTileAccessor::Options tile_accessor_options;
+    tile_accessor_options.Clear();
+    tile_accessor_options.backGroundColor = RgbFloatColor{ 0.5f,0.5f,0.5f };
+    ISingleChannelProjectionAccessor::Options projection_accessor_options;
+    projection_accessor_options.Clear();
+    projection_accessor_options.backGroundColor = RgbFloatColor{ 0.5f,0.5f,0.5f };
+
+    for (const auto pixel_type : { PixelType::Gray8, PixelType::Gray32Float })
+    {
+        vector<shared_ptr<IBitmapData>> planes;
+        for (int z = 0; z < 3; ++z)
+        {
+            const CDimCoordinate plane{ {DimensionIndex::C, 0}, {DimensionIndex::Z, z} };
+            planes.push_back(tile_accessor->Get(pixel_type, roi, &plane, &tile_accessor_options));
+        }
+
+        for (const auto operation : { ProjectionOperation::Maximum, ProjectionOperation::Minimum, ProjectionOperation::Mean, ProjectionOperation::Sum })
+        {
+            const auto projection = projection_accessor->Get(pixel_type, roi, &plane_coordinate, ISingleChannelProjectionAccessor::Range{ DimensionIndex::Z, 0, 3 }, operation, &projection_accessor_options);
+            ASSERT_EQ(projection->GetPixelType(), pixel_type);
+            ASSERT_EQ(projection->GetWidth(), static_cast<uint32_t>(roi.w));
+            ASSERT_EQ(projection->GetHeight(), static_cast<uint32_t>(roi.h));
+
+            ScopedBitmapLockerSP lock_projection{ projection };
+            ScopedBitmapLockerSP lock_plane0{ planes[0] };
+            ScopedBitmapLockerSP lock_plane1{ planes[1] };
+            ScopedBitmapLockerSP lock_plane2{ planes[2] };
+            for (int y = 0; y < roi.h; ++y)
+            {
+                for (int x = 0; x < roi.w; ++x)
+                {
+                    if (pixel_type == PixelType::Gray8)
+                    {
+                        const uint8_t a = static_cast<const uint8_t*>(lock_plane0.ptrDataRoi)[y * lock_plane0.stride + x];
+                        const uint8_t b = static_cast<const uint8_t*>(lock_plane1.ptrDataRoi)[y * lock_plane1.stride + x];
+                        const uint8_t c = static_cast<const uint8_t*>(lock_plane2.ptrDataRoi)[y * lock_plane2.stride + x];
+                        int expected;
+                        switch (operation)
+                        {
+                        case ProjectionOperation::Maximum: expected = (max)({ a, b, c }); break;
+                        case ProjectionOperation::Minimum: expected = (min)({ a, b, c }); break;
+                        case ProjectionOperation::Mean: expected = (a + b + c + 1) / 3; break;
+                        default: expected = (min)(a + b + c, 255); break;
+                        }
+
+                        ASSERT_EQ(static_cast<const uint8_t*>(lock_projection.ptrDataRoi)[y * lock_projection.stride + x], expected);
+                    }
+                    else
+                    {
+                        const float a = *reinterpret_cast<const float*>(static_cast<const uint8_t*>(lock_plane0.ptrDataRoi) + y * lock_plane0.stride + x * 4);
+                        const float b = *reinterpret_cast<const float*>(static_cast<const uint8_t*>(lock_plane1.ptrDataRoi) + y * lock_plane1.stride + x * 4);
+                        const float c = *reinterpret_cast<const float*>(static_cast<const uint8_t*>(lock_plane2.ptrDataRoi) + y * lock_plane2.stride + x * 4);
+                        float expected;
+                        switch (operation)
+                        {
+                        case ProjectionOperation::Maximum: expected = (max)({ a, b, c }); break;
+                        case ProjectionOperation::Minimum: expected = (min)({ a, b, c }); break;
+                        case ProjectionOperation::Mean: expected = (a + b + c) / 3.f; break;
+                        default: expected = a + b + c; break;
+                        }
+
+                        ASSERT_FLOAT_EQ(*reinterpret_cast<const float*>(static_cast<const uint8_t*>(lock_projection.ptrDataRoi) + y * lock_projection.stride + x * 4), expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(Accessor, RenderIntoExternalMemoryAndCompareWithNewlyAllocatedBitmap)
+{
+    auto czi_document_as_blob = CreateCziWithOverlappingSubblocksInMosaicArrangement();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    const IntRect roi{ 5,7,90,80 };
+
+    const auto check_external_memory_is_equal_to_bitmap = [](const vector<uint8_t>& external_memory, uint32_t stride, const shared_ptr<IBitmapData>& bitmap)->void
+    {
+        ScopedBitmapLockerSP lock_bitmap{ bitmap };
+        for (uint32_t y = 0; y < bitmap->GetHeight(); ++y)
+        {
+            EXPECT_EQ(memcmp(external_memory.data() + y * stride, static_cast<const uint8_t*>(lock_bitmap.ptrDataRoi) + y * lock_bitmap.stride, bitmap->GetWidth()), 0);
+
+            // the padding at the end of the line must not have been touched
+            for (uint32_t x = bitmap->GetWidth(); x < stride; ++x)
+            {
+                EXPECT_EQ(external_memory[y * stride + x], 0xab);
+            }
+        }
+    };
+
+    {
+        const auto accessor = reader->CreateSingleChannelTileAccessor();
+        ISingleChannelTileAccessor::Options options;
+        options.Clear();
+        options.backGroundColor = RgbFloatColor{ 0,0,0 };
+        const auto composite = accessor->Get(PixelType::Gray8, roi, &plane_coordinate, &options);
+
+        const uint32_t stride = roi.w + 7;
+        vector<uint8_t> external_memory(static_cast<size_t>(stride) * roi.h, 0xab);
+        accessor->Get(
+            BitmapMemoryDescriptor{ PixelType::Gray8, static_cast<uint32_t>(roi.w), static_cast<uint32_t>(roi.h), external_memory.data(), stride },
+            IntPointAndFrameOfReference{ CZIFrameOfReference::RawSubBlockCoordinateSystem, { roi.x, roi.y } },
+            &plane_coordinate,
+            &options);
+        check_external_memory_is_equal_to_bitmap(external_memory, stride, composite);
+    }
+
+    {
+        const auto accessor = reader->CreateSingleChannelScalingTileAccessor();
+        ISingleChannelScalingTileAccessor::Options options;
+        options.Clear();
+        options.backGroundColor = RgbFloatColor{ 0,0,0 };
+        const auto composite = accessor->Get(PixelType::Gray8, roi, &plane_coordinate, 0.37f, &options);
+
+        const IntSize size = accessor->CalcSize(roi, 0.37f);
+        const uint32_t stride = size.w + 3;
+        vector<uint8_t> external_memory(static_cast<size_t>(stride) * size.h, 0xab);
+        accessor->Get(
+            BitmapMemoryDescriptor{ PixelType::Gray8, size.w, size.h, external_memory.data(), stride },
+            IntRectAndFrameOfReference{ CZIFrameOfReference::RawSubBlockCoordinateSystem, roi },
+            &plane_coordinate,
+            0.37f,
+            &options);
+        check_external_memory_is_equal_to_bitmap(external_memory, stride, composite);
+    }
+}
+
+TEST(Accessor, RenderIntoExternalMemoryWithInvalidDescriptorAndExpectException)
+{
+    auto czi_document_as_blob = CreateCziWithOverlappingSubblocksInMosaicArrangement();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const auto accessor = reader->CreateSingleChannelTileAccessor();
+    const CDimCoordinate plane_coordinate{ { DimensionIndex::C, 0 } };
+    const IntPointAndFrameOfReference position{ CZIFrameOfReference::RawSubBlockCoordinateSystem, { 0, 0 } };
+
+    vector<uint8_t> external_memory(4 * 4 * 2);
+
+    // the stride is smaller than the width times the size of a pixel
+    EXPECT_THROW(
+        accessor->Get(BitmapMemoryDescriptor{ PixelType::Gray16, 4, 4, external_memory.data(), 7 }, position, &plane_coordinate, nullptr),
+        invalid_argument);
+
+    // the pointer is null
+    EXPECT_THROW(
+        accessor->Get(BitmapMemoryDescriptor{ PixelType::Gray8, 4, 4, nullptr, 4 }, position, &plane_coordinate, nullptr),
+        invalid_argument);
+
+    // an invalid pixel type
+    EXPECT_THROW(
+        accessor->Get(BitmapMemoryDescriptor{ PixelType::Invalid, 4, 4, external_memory.data(), 8 }, position, &plane_coordinate, nullptr),
+        invalid_argument);
+
+    // a valid descriptor (with a stride exactly the width times the size of a pixel) must be accepted
+    EXPECT_NO_THROW(
+        accessor->Get(BitmapMemoryDescriptor{ PixelType::Gray16, 4, 4, external_memory.data(), 8 }, position, &plane_coordinate, nullptr));
+}
+
+TEST(Accessor, PlaneTileIteratorGivesSameResultAsSingleChannelTileAccessor)
+{
+    auto czi_document_as_blob = CreateCziWithOverlappingSubblocksInMosaicArrangement();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const auto accessor = reader->CreateSingleChannelTileAccessor();
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    const IntRect roi{ 5,7,90,80 };
+
+    ISingleChannelTileAccessor::Options accessor_options;
+    accessor_options.Clear();
+    accessor_options.backGroundColor = RgbFloatColor{ 0.5f,0.5f,0.5f };
+
+    for (const uint32_t decode_thread_count : { 0u, 3u })
+    {
+        PlaneTileIteratorOptions iterator_options;
+        iterator_options.backGroundColor = RgbFloatColor{ 0.5f,0.5f,0.5f };
+        iterator_options.decodeThreadCount = decode_thread_count;
+        const auto iterator = CreatePlaneTileIterator(reader, PixelType::Invalid, roi, &plane_coordinate, IntSize{ 25, 19 }, iterator_options);
+
+        int tile_count = 0;
+        IntRect tile_rect;
+        shared_ptr<IBitmapData> tile;
+        while (iterator->GetNext(&tile_rect, &tile))
+        {
+            // the tiles are expected row by row, and the ones in the last column and last row are clipped
+            const int column = tile_count % 4;
+            const int row = tile_count / 4;
+            EXPECT_EQ(tile_rect.x, roi.x + column * 25);
+            EXPECT_EQ(tile_rect.y, roi.y + row * 19);
+            EXPECT_EQ(tile_rect.w, column < 3 ? 25 : 15);
+            EXPECT_EQ(tile_rect.h, row < 4 ? 19 : 4);
+            ASSERT_EQ(tile->GetPixelType(), PixelType::Gray8);
+
+            const auto expected_tile = accessor->Get(PixelType::Gray8, tile_rect, &plane_coordinate, &accessor_options);
+            EXPECT_TRUE(AreBitmapDataEqual(expected_tile, tile));
+            ++tile_count;
+        }
+
+        EXPECT_EQ(tile_count, 20);
+        EXPECT_FALSE(iterator->GetNext(nullptr, nullptr));
+    }
+}
+
+static tuple<shared_ptr<void>, size_t> CreateCziWithPyramidLayerCoveringOnlyTheLeftHalf()
+{
+    return CreateCziDocument(
+        make_shared<CCziWriterInfo>(GUID{ 0x1234567,0x89ab,0xcdef,{ 1,2,3,4,5,6,7,8 } }),
+        [](ICziWriter* writer)->void
+        {
+            const CDimCoordinate coordinate{ { DimensionIndex::C, 0 } };
+
+            // four subblocks of 64x64 on layer-0 (with the values 10, 20, 30 and 40), and a pyramid-subblock with zoom 1/2
+            //  which covers only the left half of the document (with the value 99)
+            AddSubBlockWithBitmap(writer, coordinate, 0, IntRect{ 0, 0, 64, 64 }, CreateGray8BitmapAndFill(64, 64, 10));
+            AddSubBlockWithBitmap(writer, coordinate, 1, IntRect{ 64, 0, 64, 64 }, CreateGray8BitmapAndFill(64, 64, 20));
+            AddSubBlockWithBitmap(writer, coordinate, 2, IntRect{ 0, 64, 64, 64 }, CreateGray8BitmapAndFill(64, 64, 30));
+            AddSubBlockWithBitmap(writer, coordinate, 3, IntRect{ 64, 64, 64, 64 }, CreateGray8BitmapAndFill(64, 64, 40));
+            AddSubBlockWithBitmap(writer, coordinate, -1, IntRect{ 0, 0, 64, 128 }, CreateGray8BitmapAndFill(32, 64, 99));
+        });
+}
+
+TEST(Accessor, SingleChannelScalingTileAccessorFillsHolesOfPyramidLayerFromFinerLayer)
+{
+    auto czi_document_as_blob = CreateCziWithPyramidLayerCoveringOnlyTheLeftHalf();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+
+    const auto accessor = reader->CreateSingleChannelScalingTileAccessor();
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    for (const bool use_visibility_check_optimization : { false, true })
+    {
+        ISingleChannelScalingTileAccessor::Options options;
+        options.Clear();
+        options.backGroundColor = RgbFloatColor{ 0,0,0 };
+        options.useVisibilityCheckOptimization = use_visibility_check_optimization;
+
+        // at zoom 1/2, the left half is to be taken from the pyramid-subblock, and the right half (which is not covered by
+        //  the pyramid-layer) from the layer-0 subblocks (we do not check the pixels right at the borders of the subblocks, where the
+        //  nearest-neighbor scaling may pick either one)
+        const auto composite_bitmap = accessor->Get(PixelType::Gray8, IntRect{ 0, 0, 128, 128 }, &plane_coordinate, 0.5f, &options);
+        ASSERT_EQ(composite_bitmap->GetWidth(), 64);
+        ASSERT_EQ(composite_bitmap->GetHeight(), 64);
+        const ScopedBitmapLockerSP lock_info_bitmap{ composite_bitmap };
+        for (uint32_t y = 0; y < composite_bitmap->GetHeight(); ++y)
+        {
+            for (uint32_t x = 0; x < composite_bitmap->GetWidth(); ++x)
+            {
+                if (x == 31 || x == 32 || y == 31 || y == 32)
+                {
+                    continue;
+                }
+
+                const uint8_t expected_value = x < 32 ? 99 : (y < 32 ? 20 : 40);
+                const uint8_t value = *(static_cast<const uint8_t*>(lock_info_bitmap.ptrDataRoi) + static_cast<size_t>(y) * lock_info_bitmap.stride + x);
+                ASSERT_EQ(value, expected_value) << "at x=" << x << " y=" << y;
+            }
+        }
+    }
+}
@@ -0,0 +1,333 @@
+// SPDX-FileCopyrightText: 2026 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "include_gtest.h"
+#include "inc_libCZI.h"
+#include "MemInputOutputStream.h"
+#include "utils.h"
+#include <cstdlib>
+
+using namespace libCZI;
+using namespace std;
+
+// JPG-encoded grayscale image (44x30 pixels), the pixel value at (x,y) is 4*x+2*y
+static const uint8_t kJpgGray8_44x30[] =
+{
+    0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+    0xff, 0xdb, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x04, 0x03, 0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03, 0x04, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06,
+    0x07, 0x09, 0x08, 0x06, 0x07, 0x09, 0x07, 0x06, 0x06, 0x08, 0x0b, 0x08, 0x09, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x06, 0x08,
+    0x0b, 0x0c, 0x0b, 0x0a, 0x0c, 0x09, 0x0a, 0x0a, 0x0a, 0xff, 0xc0, 0x00, 0x0b, 0x08, 0x00, 0x1e, 0x00, 0x2c, 0x01, 0x01,
+    0x11, 0x00, 0xff, 0xc4, 0x00, 0x1f, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x10,
+    0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7d, 0x01, 0x02, 0x03, 0x00,
+    0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08,
+    0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a,
+    0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75,
+    0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98,
+    0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba,
+    0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xda,
+    0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3f, 0x00, 0xfc, 0x53, 0xf8, 0x6d, 0xe1, 0xaf, 0xf5, 0x7f, 0xbb, 0xf4, 0xed, 0x5f,
+    0x40, 0x7c, 0x36, 0xf0, 0xd7, 0xfa, 0xbf, 0xdd, 0xfa, 0x76, 0xaf, 0xa0, 0x3e, 0x1b, 0x78, 0x6b, 0xfd, 0x5f, 0xee, 0xfd,
+    0x3b, 0x57, 0xd0, 0x1f, 0x0d, 0xbc, 0x35, 0xfe, 0xaf, 0xf7, 0x7e, 0x9d, 0xab, 0xe8, 0x0f, 0x86, 0xde, 0x1a, 0xff, 0x00,
+    0x57, 0xfb, 0xbf, 0x4e, 0xd5, 0xed, 0x9a, 0x17, 0x86, 0xbf, 0xe2, 0x5a, 0x9f, 0xbb, 0xfd, 0x2b, 0xf9, 0xd3, 0xf8, 0x6d,
+    0xe1, 0xaf, 0xf5, 0x7f, 0xbb, 0xf4, 0xed, 0x5f, 0x40, 0x7c, 0x36, 0xf0, 0xd7, 0xfa, 0xbf, 0xdd, 0xfa, 0x76, 0xaf, 0xa0,
+    0x3e, 0x1b, 0x78, 0x6b, 0xfd, 0x5f, 0xee, 0xfd, 0x3b, 0x57, 0xd0, 0x1f, 0x0d, 0xbc, 0x35, 0xfe, 0xaf, 0xf7, 0x7e, 0x9d,
+    0xab, 0xe8, 0x0f, 0x86, 0xde, 0x1a, 0xff, 0x00, 0x57, 0xfb, 0xbf, 0x4e, 0xd5, 0xed, 0x9a, 0x17, 0x86, 0xbf, 0xe2, 0x5a,
+    0x9f, 0xbb, 0xfd, 0x2b, 0xf9, 0xd3, 0xf8, 0x6d, 0xe1, 0xaf, 0xf5, 0x7f, 0xbb, 0xf4, 0xed, 0x5f, 0x40, 0x7c, 0x36, 0xf0,
+    0xd7, 0xfa, 0xbf, 0xdd, 0xfa, 0x76, 0xaf, 0xa0, 0x3e, 0x1b, 0x78, 0x6b, 0xfd, 0x5f, 0xee, 0xfd, 0x3b, 0x57, 0xd0, 0x1f,
+    0x0d, 0xbc, 0x35, 0xfe, 0xaf, 0xf7, 0x7e, 0x9d, 0xab, 0xe8, 0x0f, 0x86, 0xde, 0x1a, 0xff, 0x00, 0x57, 0xfb, 0xbf, 0x4e,
+    0xd5, 0xed, 0x9a, 0x17, 0x86, 0xbf, 0xe2, 0x5a, 0x9f, 0xbb, 0xfd, 0x2b, 0xf9, 0xd0, 0xf8, 0x6d, 0xa1, 0x43, 0xfb, 0xbe,
+    0x9d, 0xab, 0xe8, 0x0f, 0x86, 0xda, 0x14, 0x3f, 0xbb, 0xe9, 0xda, 0xbe, 0x80, 0xf8, 0x6d, 0xa1, 0x43, 0xfb, 0xbe, 0x9d,
+    0xab, 0xe8, 0x0f, 0x86, 0xda, 0x14, 0x3f, 0xbb, 0xe9, 0xda, 0xbe, 0x80, 0xf8, 0x6d, 0xa1, 0x43, 0xfb, 0xbe, 0x9d, 0xab,
+    0xdb, 0x34, 0x2d, 0x0a, 0x1f, 0xec, 0xd4, 0xe9, 0x5f, 0xff, 0xd9,
+};
+
+// JPG-encoded color image (64x48 pixels, no chroma-subsampling), the pixel value at (x,y) is R=3*x, G=4*y, B=128+x-y
+static const uint8_t kJpgBgr24_64x48[] =
+{
+    0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+    0xff, 0xdb, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x04, 0x03, 0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03, 0x04, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06,
+    0x07, 0x09, 0x08, 0x06, 0x07, 0x09, 0x07, 0x06, 0x06, 0x08, 0x0b, 0x08, 0x09, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x06, 0x08,
+    0x0b, 0x0c, 0x0b, 0x0a, 0x0c, 0x09, 0x0a, 0x0a, 0x0a, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x05, 0x03, 0x03, 0x05, 0x0a, 0x07, 0x06, 0x07, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0xff, 0xc0,
+    0x00, 0x11, 0x08, 0x00, 0x30, 0x00, 0x40, 0x03, 0x01, 0x11, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff, 0xc4, 0x00,
+    0x1f, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03,
+    0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7d, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21,
+    0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15,
+    0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29,
+    0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56,
+    0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+    0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4,
+    0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6,
+    0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7,
+    0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xc4, 0x00, 0x1f, 0x01, 0x00, 0x03,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+    0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x11, 0x00, 0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07,
+    0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51,
+    0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15,
+    0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x35,
+    0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+    0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84,
+    0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6,
+    0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8,
+    0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea,
+    0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11,
+    0x00, 0x3f, 0x00, 0xfc, 0x67, 0xd3, 0x7c, 0x2f, 0xd3, 0xe4, 0xfd, 0x2b, 0xfb, 0x9b, 0xfb, 0x47, 0xcc, 0xf9, 0x3c, 0x16,
+    0x3f, 0x6d, 0x4e, 0x83, 0x4d, 0xf0, 0xbf, 0x4f, 0x93, 0xf4, 0xa3, 0xfb, 0x43, 0xcc, 0xfa, 0xdc, 0x16, 0x3f, 0x6d, 0x4e,
+    0x83, 0x4c, 0xf0, 0xb8, 0xe3, 0x29, 0xfa, 0x51, 0xfd, 0xa1, 0xe6, 0x7d, 0x76, 0x0b, 0x1f, 0xb6, 0xa7, 0x43, 0xa6, 0xf8,
+    0x5b, 0xa7, 0xee, 0xcf, 0xe5, 0x47, 0xf6, 0x87, 0x99, 0xf5, 0xb8, 0x2c, 0x7e, 0xda, 0x9d, 0x06, 0x9b, 0xe1, 0x6e, 0x9f,
+    0xba, 0x3f, 0x95, 0x1f, 0xda, 0x2f, 0xb9, 0xf5, 0xd8, 0x2c, 0x76, 0xda, 0x9d, 0x0e, 0x99, 0xe1, 0x6e, 0x9f, 0xb9, 0xfd,
+    0x28, 0xfe, 0xd1, 0x7d, 0xcf, 0xad, 0xc1, 0x63, 0xf6, 0xd4, 0xe8, 0x34, 0xdf, 0x0a, 0xf4, 0xfd, 0xcd, 0x1f, 0xda, 0x2f,
+    0xb9, 0xf5, 0xb8, 0x2c, 0x7e, 0xda, 0x9d, 0x06, 0x99, 0xe1, 0x6e, 0x9f, 0xb9, 0xa5, 0xfd, 0xa2, 0xfb, 0x9f, 0x5d, 0x82,
+    0xc7, 0xed, 0xa9, 0xf3, 0x26, 0x99, 0xe1, 0x62, 0x31, 0x88, 0xc7, 0xe5, 0x5f, 0x0d, 0xfd, 0xa2, 0x7f, 0x91, 0xd8, 0x2c,
+    0x7e, 0xda, 0x9d, 0x0e, 0x99, 0xe1, 0x7e, 0x9f, 0x27, 0xe9, 0x47, 0xf6, 0x89, 0xf5, 0xb8, 0x2c, 0x7e, 0xda, 0x9d, 0x06,
+    0x9b, 0xe1, 0x7e, 0x9f, 0x27, 0xe9, 0x4b, 0xfb, 0x45, 0x1f, 0x5d, 0x82, 0xc7, 0xed, 0xa9, 0xd0, 0x69, 0xbe, 0x17, 0xe9,
+    0xf2, 0x7e, 0x94, 0x7f, 0x68, 0xae, 0xe7, 0xd6, 0xe0, 0xb1, 0xfb, 0x6a, 0x74, 0x3a, 0x67, 0x85, 0xc1, 0xc6, 0x23, 0x3f,
+    0x95, 0x1f, 0xda, 0x2b, 0xb9, 0xf5, 0xd8, 0x2c, 0x76, 0xda, 0x9d, 0x06, 0x9b, 0xe1, 0x6e, 0x9f, 0xba, 0x3f, 0x95, 0x1f,
+    0xda, 0x2b, 0xb9, 0xf5, 0xb8, 0x2c, 0x7e, 0xda, 0x9d, 0x06, 0x99, 0xe1, 0x6e, 0x9f, 0xba, 0x3f, 0x95, 0x1f, 0xda, 0x2b,
+    0xb9, 0xf5, 0xb8, 0x2c, 0x7e, 0xda, 0x9d, 0x0e, 0x99, 0xe1, 0x6e, 0x9f, 0xb9, 0xa3, 0xfb, 0x45, 0x77, 0x3e, 0xbb, 0x05,
+    0x8f, 0xdb, 0x53, 0xe6, 0x4d, 0x37, 0xc2, 0xdd, 0x3f, 0x74, 0x3f, 0x2a, 0xf8, 0x6f, 0xed, 0x17, 0xdc, 0xff, 0x00, 0x23,
+    0xb0, 0x58, 0xfd, 0xb5, 0x3a, 0x0d, 0x37, 0xc2, 0xdd, 0x3f, 0x76, 0x3f, 0x2a, 0x3f, 0xb4, 0x5f, 0x73, 0xeb, 0x70, 0x58,
+    0xfd, 0xb5, 0x3a, 0x1d, 0x33, 0xc2, 0xe7, 0x8c, 0xa7, 0xe9, 0x47, 0xf6, 0x8b, 0xee, 0x7d, 0x76, 0x0b, 0x1f, 0xb6, 0xa7,
+    0x41, 0xa6, 0xf8, 0x5f, 0xa7, 0xc9, 0xfa, 0x52, 0xfe, 0xd1, 0x7d, 0xcf, 0xad, 0xc1, 0x63, 0xb6, 0xd4, 0xe8, 0x34, 0xdf,
+    0x0b, 0xf4, 0xf9, 0x3f, 0x4a, 0x3f, 0xb4, 0x5f, 0x73, 0xeb, 0xb0, 0x58, 0xfd, 0xb5, 0x3a, 0x0d, 0x33, 0xc2, 0xe3, 0x8c,
+    0xa7, 0xe9, 0x47, 0xf6, 0x8b, 0xee, 0x7d, 0x6e, 0x0b, 0x1f, 0xb6, 0xa7, 0x43, 0xa6, 0xf8, 0x5b, 0xa7, 0xee, 0x8f, 0xe5,
+    0x47, 0xf6, 0x81, 0xf5, 0xb8, 0x2c, 0x7e, 0xda, 0x9d, 0x06, 0x9b, 0xe1, 0x6e, 0x9f, 0xba, 0x3f, 0x95, 0x2f, 0xed, 0x13,
+    0xeb, 0xb0, 0x58, 0xfd, 0xb5, 0x3e, 0x64, 0xd3, 0x3c, 0x2d, 0xd3, 0xf7, 0x35, 0xf0, 0xdf, 0xda, 0x2b, 0xb9, 0xfe, 0x47,
+    0x60, 0xb1, 0xfb, 0x6a, 0x74, 0x3a, 0x67, 0x85, 0xba, 0x7e, 0xe8, 0x7e, 0x54, 0x7f, 0x68, 0xae, 0xe7, 0xd6, 0xe0, 0xb1,
+    0xfb, 0x6a, 0x74, 0x1a, 0x6f, 0x85, 0xba, 0x7e, 0xe8, 0x7e, 0x54, 0x7f, 0x68, 0xae, 0xe7, 0xd7, 0x60, 0xb1, 0xfb, 0x6a,
+    0x74, 0x1a, 0x67, 0x85, 0xc8, 0xc6, 0x23, 0x1f, 0x95, 0x1f, 0xda, 0x2b, 0xb9, 0xf5, 0xb8, 0x2c, 0x76, 0xda, 0x9d, 0x0e,
+    0x9b, 0xe1, 0x7e, 0x9f, 0x27, 0xe9, 0x4b, 0xfb, 0x47, 0xcc, 0xfa, 0xdc, 0x16, 0x3f, 0x6d, 0x4e, 0x83, 0x4d, 0xf0, 0xbf,
+    0x4f, 0x93, 0xf4, 0xa3, 0xfb, 0x43, 0xcc, 0xfa, 0xec, 0x16, 0x3f, 0x6d, 0x4e, 0x83, 0x4c, 0xf0, 0xbf, 0x4f, 0x93, 0xf4,
+    0xa3, 0xfb, 0x43, 0xcc, 0xfa, 0xdc, 0x16, 0x3f, 0x6d, 0x4e, 0x87, 0x4c, 0xf0, 0xb0, 0x38, 0xc4, 0x67, 0xf2, 0xa3, 0xfb,
+    0x43, 0xcc, 0xfa, 0xec, 0x16, 0x3f, 0x6d, 0x4f, 0x99, 0x34, 0xcf, 0x0b, 0x74, 0xfd, 0xcd, 0x7c, 0x37, 0xf6, 0x8b, 0xee,
+    0x7f, 0x91, 0xd8, 0x2c, 0x7f, 0x99, 0xd0, 0x69, 0xbe, 0x15, 0xe9, 0xfb, 0x9a, 0x3f, 0xb4, 0x5f, 0x73, 0xeb, 0x70, 0x58,
+    0xfd, 0xb5, 0x3a, 0x0d, 0x33, 0xc2, 0xdd, 0x3f, 0x72, 0x3f, 0x2a, 0x5f, 0xda, 0x07, 0xd7, 0x60, 0xb1, 0xfb, 0x6a, 0x74,
+    0x3a, 0x6f, 0x85, 0xba, 0x7e, 0xe8, 0x7e, 0x54, 0x7f, 0x68, 0x9f, 0x5b, 0x82, 0xc7, 0xed, 0xa9, 0xd0, 0x69, 0xbe, 0x16,
+    0xe9, 0xfb, 0xb1, 0xf9, 0x51, 0xfd, 0xa2, 0x7d, 0x6e, 0x0b, 0x1d, 0xb6, 0xa7, 0x43, 0xa6, 0x78, 0x5c, 0xf1, 0x94, 0xfd,
+    0x28, 0xfe, 0xd1, 0x3e, 0xbb, 0x05, 0x8f, 0xdb, 0x53, 0xa0, 0xd3, 0x7c, 0x2f, 0xd3, 0xe4, 0xfd, 0x29, 0x7f, 0x68, 0xa3,
+    0xeb, 0x70, 0x58, 0xfd, 0xb5, 0x3a, 0x0d, 0x37, 0xc2, 0xfd, 0x3e, 0x4f, 0xd2, 0x8f, 0xed, 0x15, 0xdc, 0xfa, 0xec, 0x16,
+    0x3f, 0x6d, 0x4f, 0x99, 0x34, 0xdf, 0x0b, 0x74, 0xfd, 0xd1, 0xfc, 0xab, 0xe1, 0xbf, 0xb4, 0x7c, 0xcf, 0xf2, 0x3b, 0x05,
+    0x8f, 0xdb, 0x53, 0xa1, 0xd3, 0x3c, 0x2d, 0xd3, 0xf7, 0x3f, 0xa5, 0x1f, 0xda, 0x1e, 0x67, 0xd6, 0xe0, 0xb1, 0xfe, 0x67,
+    0x41, 0xa6, 0xf8, 0x57, 0xa7, 0xee, 0x68, 0xfe, 0xd0, 0xf3, 0x3e, 0xbb, 0x05, 0x8f, 0xdb, 0x53, 0xa0, 0xd3, 0x3c, 0x2d,
+    0x8c, 0x7e, 0xe6, 0x8f, 0xed, 0x0f, 0x33, 0xeb, 0x70, 0x58, 0xfd, 0xb5, 0x3a, 0x1d, 0x33, 0xc2, 0xdd, 0x3f, 0x74, 0x3f,
+    0x2a, 0x5f, 0xda, 0x2f, 0xb9, 0xf5, 0xd8, 0x2c, 0x76, 0xda, 0x9d, 0x06, 0x9b, 0xe1, 0x6e, 0x9f, 0xba, 0x1f, 0x95, 0x1f,
+    0xda, 0x2f, 0xb9, 0xf5, 0xb8, 0x2c, 0x7f, 0x99, 0xd0, 0x69, 0x9e, 0x17, 0x3c, 0x7e, 0xec, 0x7e, 0x54, 0x7f, 0x68, 0xbe,
+    0xe7, 0xd6, 0xe0, 0xb1, 0xfb, 0x6a, 0x74, 0x3a, 0x6f, 0x85, 0xfa, 0x7c, 0x9f, 0xa5, 0x1f, 0xda, 0x2f, 0xb9, 0xf5, 0xd8,
+    0x2c, 0x7e, 0xda, 0x9f, 0xff, 0xd9,
+};
+
+static shared_ptr<IDecoder> GetJpgDecoderOrNull()
+{
+    return GetDefaultSiteObject(SiteObjectType::Default)->GetDecoder(ImageDecoderType::JPG_LibJpeg, nullptr);
+}
+
+static uint8_t GetGray8Pixel(IBitmapData* bitmap, uint32_t x, uint32_t y)
+{
+    ScopedBitmapLockerP lock{ bitmap };
+    return *(static_cast<const uint8_t*>(lock.ptrDataRoi) + static_cast<size_t>(y) * lock.stride + x);
+}
+
+static Rgb8Color GetBgr24Pixel(IBitmapData* bitmap, uint32_t x, uint32_t y)
+{
+    ScopedBitmapLockerP lock{ bitmap };
+    const uint8_t* p = static_cast<const uint8_t*>(lock.ptrDataRoi) + static_cast<size_t>(y) * lock.stride + 3 * static_cast<size_t>(x);
+    return Rgb8Color{ p[2], p[1], p[0] };
+}
+
+TEST(JpgDecode, DecodeGray8AndCheckContent)
+{
+    const auto decoder = GetJpgDecoderOrNull();
+    if (!decoder)
+    {
+        GTEST_SKIP() << "The JPG-decoder is not available, therefore skipping this test.";
+    }
+
+    const auto bitmap = decoder->Decode(kJpgGray8_44x30, sizeof(kJpgGray8_44x30), PixelType::Gray8, 44, 30);
+    ASSERT_EQ(bitmap->GetPixelType(), PixelType::Gray8);
+    ASSERT_EQ(bitmap->GetWidth(), 44u);
+    ASSERT_EQ(bitmap->GetHeight(), 30u);
+    for (uint32_t y = 0; y < 30; ++y)
+    {
+        for (uint32_t x = 0; x < 44; ++x)
+        {
+            EXPECT_NEAR(GetGray8Pixel(bitmap.get(), x, y), 4 * x + 2 * y, 4) << "at (" << x << "," << y << ")";
+        }
+    }
+}
+
+TEST(JpgDecode, DecodeBgr24AndCheckContent)
+{
+    const auto decoder = GetJpgDecoderOrNull();
+    if (!decoder)
+    {
+        GTEST_SKIP() << "The JPG-decoder is not available, therefore skipping this test.";
+    }
+
+    const auto bitmap = decoder->Decode(kJpgBgr24_64x48, sizeof(kJpgBgr24_64x48), nullptr, nullptr, nullptr, nullptr);
+    ASSERT_EQ(bitmap->GetPixelType(), PixelType::Bgr24);
+    ASSERT_EQ(bitmap->GetWidth(), 64u);
+    ASSERT_EQ(bitmap->GetHeight(), 48u);
+    for (uint32_t y = 0; y < 48; ++y)
+    {
+        for (uint32_t x = 0; x < 64; ++x)
+        {
+            const auto pixel = GetBgr24Pixel(bitmap.get(), x, y);
+            EXPECT_NEAR(pixel.r, 3 * static_cast<int>(x), 6) << "at (" << x << "," << y << ")";
+            EXPECT_NEAR(pixel.g, 4 * static_cast<int>(y), 6) << "at (" << x << "," << y << ")";
+            EXPECT_NEAR(pixel.b, 128 + static_cast<int>(x) - static_cast<int>(y), 6) << "at (" << x << "," << y << ")";
+        }
+    }
+}
+
+TEST(JpgDecode, DecodeWithDownscaleAndCheckSizeAndContent)
+{
+    const auto decoder = GetJpgDecoderOrNull();
+    if (!decoder)
+    {
+        GTEST_SKIP() << "The JPG-decoder is not available, therefore skipping this test.";
+    }
+
+    for (const uint32_t denominator : { 2u, 4u, 8u })
+    {
+        const string arguments = "scale_denominator=" + to_string(denominator);
+        const uint32_t expected_width = (44 + denominator - 1) / denominator;
+        const uint32_t expected_height = (30 + denominator - 1) / denominator;
+        const auto bitmap = decoder->Decode(kJpgGray8_44x30, sizeof(kJpgGray8_44x30), PixelType::Gray8, expected_width, expected_height, arguments.c_str());
+        ASSERT_EQ(bitmap->GetWidth(), expected_width);
+        ASSERT_EQ(bitmap->GetHeight(), expected_height);
+
+        // check the pixels which are computed from a complete block of source pixels, the value is expected
+        //  to be (approximately) the average of the source pixels
+        for (uint32_t y = 0; y < 30 / denominator; ++y)
+        {
+            for (uint32_t x = 0; x < 44 / denominator; ++x)
+            {
+                const double center_x = x * denominator + (denominator - 1) / 2.0;
+                const double center_y = y * denominator + (denominator - 1) / 2.0;
+                EXPECT_NEAR(GetGray8Pixel(bitmap.get(), x, y), 4 * center_x + 2 * center_y, 6) << "at (" << x << "," << y << ") with denominator " << denominator;
+            }
+        }
+    }
+}
+
+TEST(JpgDecode, CreateBitmapFromSubBlockDataWithDownscaleAndPixelTypeConversion)
+{
+    if (!GetJpgDecoderOrNull())
+    {
+        GTEST_SKIP() << "The JPG-decoder is not available, therefore skipping this test.";
+    }
+
+    CreateBitmapOptions options;
+    options.jpg_downscale_denominator = 4;
+    const auto bitmap = CreateBitmapFromSubBlockData(CompressionMode::Jpg, kJpgBgr24_64x48, sizeof(kJpgBgr24_64x48), PixelType::Gray8, 64, 48, &options);
+    EXPECT_EQ(bitmap->GetPixelType(), PixelType::Gray8);
+    EXPECT_EQ(bitmap->GetWidth(), 16u);
+    EXPECT_EQ(bitmap->GetHeight(), 12u);
+
+    options.jpg_downscale_denominator = 3;
+    EXPECT_THROW(CreateBitmapFromSubBlockData(CompressionMode::Jpg, kJpgBgr24_64x48, sizeof(kJpgBgr24_64x48), PixelType::Gray8, 64, 48, &options), invalid_argument);
+}
+
+TEST(JpgDecode, TryDecodeInvalidData)
+{
+    const auto decoder = GetJpgDecoderOrNull();
+    if (!decoder)
+    {
+        GTEST_SKIP() << "The JPG-decoder is not available, therefore skipping this test.";
+    }
+
+    static const uint8_t invalid_data[] = { 0xff, 0xd8, 0xff, 0xe0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100 };
+    EXPECT_THROW(decoder->Decode(invalid_data, sizeof(invalid_data), PixelType::Gray8, 10, 10), exception);
+
+    // truncated data must also be reported as an error
+    EXPECT_THROW(decoder->Decode(kJpgGray8_44x30, 200, PixelType::Gray8, 44, 30), exception);
+}
+
+static tuple<shared_ptr<void>, size_t> CreateCziWithJpgCompressedSubBlocks()
+{
+    return CreateCziDocument(
+        make_shared<CCziWriterInfo>(
+            GUID{ 0x1234567,0x89ab,0xcdef,{ 1,2,3,4,5,6,7,8 } },
+            CDimBounds{ { DimensionIndex::C, 0, 1 } },
+            0, 3),
+        [](ICziWriter* writer)->void
+        {
+            // put four subblocks side by side (in a 2x2 arrangement)
+            for (int i = 0; i < 4; ++i)
+            {
+                AddSubBlockInfoMemPtr addSbBlkInfo;
+                addSbBlkInfo.Clear();
+                addSbBlkInfo.coordinate.Set(DimensionIndex::C, 0);
+                addSbBlkInfo.mIndexValid = true;
+                addSbBlkInfo.mIndex = i;
+                addSbBlkInfo.x = (i % 2) * 64;
+                addSbBlkInfo.y = (i / 2) * 48;
+                addSbBlkInfo.logicalWidth = 64;
+                addSbBlkInfo.logicalHeight = 48;
+                addSbBlkInfo.physicalWidth = 64;
+                addSbBlkInfo.physicalHeight = 48;
+                addSbBlkInfo.PixelType = PixelType::Bgr24;
+                addSbBlkInfo.SetCompressionMode(CompressionMode::Jpg);
+                addSbBlkInfo.ptrData = kJpgBgr24_64x48;
+                addSbBlkInfo.dataSize = sizeof(kJpgBgr24_64x48);
+                writer->SyncAddSubBlock(addSbBlkInfo);
+            }
+        });
+}
+
+TEST(JpgDecode, ScalingAccessorWithReducedResolutionDecode)
+{
+    if (!GetJpgDecoderOrNull())
+    {
+        GTEST_SKIP() << "The JPG-decoder is not available, therefore skipping this test.";
+    }
+
+    auto czi_document_as_blob = CreateCziWithJpgCompressedSubBlocks();
+    const auto memory_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+    const auto accessor = reader->CreateSingleChannelScalingTileAccessor();
+    const CDimCoordinate plane_coordinate{ {DimensionIndex::C, 0} };
+    ISingleChannelScalingTileAccessor::Options options;
+    options.Clear();
+    options.backGroundColor = RgbFloatColor{ 0, 0, 0 };
+    const auto cache = CreateSubBlockCache();
+    options.subBlockCache = cache;
+
+    const auto composite_full_resolution_decode = accessor->Get(PixelType::Bgr24, IntRect{ 0, 0, 128, 96 }, &plane_coordinate, 0.25f, &options);
+    ISubBlockCacheControl::PruneOptions prune_options;
+    prune_options.maxSubBlockCount = 0;
+    cache->Prune(prune_options);
+    options.useReducedResolutionDecode = true;
+    const auto composite_reduced_resolution_decode = accessor->Get(PixelType::Bgr24, IntRect{ 0, 0, 128, 96 }, &plane_coordinate, 0.25f, &options);
+
+    // the reduced-resolution bitmaps are not to be added to the cache
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 0u);
+
+    ASSERT_EQ(composite_full_resolution_decode->GetWidth(), composite_reduced_resolution_decode->GetWidth());
+    ASSERT_EQ(composite_full_resolution_decode->GetHeight(), composite_reduced_resolution_decode->GetHeight());
+
+    // with nearest-neighbor scaling we pick one pixel out of a 4x4-block, whereas with the reduced-resolution decoding
+    //  we get the average of this block - for the gradients in our test image, this means a difference of less than
+    //  two times the slope
+    for (uint32_t y = 0; y < composite_full_resolution_decode->GetHeight(); ++y)
+    {
+        for (uint32_t x = 0; x < composite_full_resolution_decode->GetWidth(); ++x)
+        {
+            const auto pixel_full_resolution = GetBgr24Pixel(composite_full_resolution_decode.get(), x, y);
+            const auto pixel_reduced_resolution = GetBgr24Pixel(composite_reduced_resolution_decode.get(), x, y);
+            EXPECT_NEAR(pixel_full_resolution.r, pixel_reduced_resolution.r, 16) << "at (" << x << "," << y << ")";
+            EXPECT_NEAR(pixel_full_resolution.g, pixel_reduced_resolution.g, 16) << "at (" << x << "," << y << ")";
+            EXPECT_NEAR(pixel_full_resolution.b, pixel_reduced_resolution.b, 16) << "at (" << x << "," << y << ")";
+        }
+    }
+}
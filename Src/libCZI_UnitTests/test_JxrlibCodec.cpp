@@ -497,3 +497,65 @@ TEST(JxrlibCodec, CallDecoderExpectingADifferentBitmapTypeAndExpectException)
             exception);
     }
 }
+
+namespace
+{
+    void CompressAndDecompressWithAndWithoutMultipleThreadsAndCompare(PixelType pixel_type, uint32_t width, uint32_t height, uint32_t quality, uint32_t max_decode_threads = 4)
+    {
+        const auto bitmap = CreateTestBitmap(pixel_type, width, height);
+        shared_ptr<libCZI::IMemoryBlock> encoded_data;
+        {
+            const ScopedBitmapLockerSP lck{ bitmap };
+            libCZI::CompressParametersOnMap params;
+            params.map[static_cast<int>(libCZI::CompressionParameterKey::JXRLIB_QUALITY)] = libCZI::CompressParameter(quality);
+            encoded_data = JxrLibCompress::Compress(
+                bitmap->GetPixelType(),
+                bitmap->GetWidth(),
+                bitmap->GetHeight(),
+                lck.stride,
+                lck.ptrDataRoi,
+                &params);
+        }
+
+        const auto codec = CJxrLibDecoder::Create();
+        const auto bitmap_decoded_single_threaded = codec->Decode(
+            encoded_data->GetPtr(),
+            encoded_data->GetSizeOfData(),
+            pixel_type,
+            width,
+            height);
+        const auto bitmap_decoded_multi_threaded = codec->Decode(
+            encoded_data->GetPtr(),
+            encoded_data->GetSizeOfData(),
+            pixel_type,
+            width,
+            height,
+            ("max_decode_threads=" + to_string(max_decode_threads)).c_str());
+        EXPECT_TRUE(AreBitmapDataEqual(bitmap_decoded_single_threaded, bitmap_decoded_multi_threaded)) << "Multi-threaded decoding gave a different result.";
+    }
+}
+
+TEST(JxrlibCodec, DecodeWithMultipleThreadsAndCompareWithSingleThreaded_Gray8)
+{
+    CompressAndDecompressWithAndWithoutMultipleThreadsAndCompare(PixelType::Gray8, 1027, 1100, 1000u);
+    CompressAndDecompressWithAndWithoutMultipleThreadsAndCompare(PixelType::Gray8, 1027, 1100, 800u);
+}
+
+TEST(JxrlibCodec, DecodeWithMultipleThreadsAndCompareWithSingleThreaded_Bgr24)
+{
+    CompressAndDecompressWithAndWithoutMultipleThreadsAndCompare(PixelType::Bgr24, 999, 1040, 1000u);
+    CompressAndDecompressWithAndWithoutMultipleThreadsAndCompare(PixelType::Bgr24, 999, 1040, 850u);
+}
+
+TEST(JxrlibCodec, DecodeWithMultipleThreadsAndCompareWithSingleThreaded_Gray16)
+{
+    CompressAndDecompressWithAndWithoutMultipleThreadsAndCompare(PixelType::Gray16, 800, 1300, 1000u);
+    CompressAndDecompressWithAndWithoutMultipleThreadsAndCompare(PixelType::Gray16, 800, 1300, 900u);
+}
+
+TEST(JxrlibCodec, DecodeWithMultipleThreadsWhereAlignedBandHeightReducesTheNumberOfBands)
+{
+    // with 20 threads, the band height for 5121 rows is 257, which is rounded up to 272 - so only 19 bands are needed, and
+    //  a 20th band would start beyond the image
+    CompressAndDecompressWithAndWithoutMultipleThreadsAndCompare(PixelType::Gray8, 64, 5121, 1000u, 20);
+}
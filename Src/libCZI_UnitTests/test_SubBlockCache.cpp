@@ -4,7 +4,11 @@
 
 #include "include_gtest.h"
 #include "inc_libCZI.h"
+#include "MemInputOutputStream.h"
 #include "utils.h"
+#include "../libCZI/subblock_prefetcher.h"
+#include <atomic>
+#include <thread>
 
 using namespace libCZI;
 using namespace std;
@@ -156,3 +160,638 @@ TEST(SubBlockCache, PruneCacheCase3)
     cache_item_from_cache = cache->Get(2);
     EXPECT_TRUE(cache_item_from_cache.IsValid());
 }
+
+TEST(SubBlockCache, CapacityIsEnforcedWhenAddingCase1)
+{
+    // We create a cache with a capacity of 2 elements, and add 3 elements. The first added element (which
+    //  is the least recently used one) should have been evicted automatically.
+    SubBlockCacheOptions options;
+    options.capacity.maxSubBlockCount = 2;
+    const auto cache = CreateSubBlockCache(options);
+    cache->Add(0, { CreateTestBitmap(PixelType::Gray8, 2, 2) });
+    cache->Add(1, { CreateTestBitmap(PixelType::Gray8, 2, 2) });
+    cache->Add(2, { CreateTestBitmap(PixelType::Gray8, 2, 2) });
+
+    const auto statistics = cache->GetStatistics(ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount);
+    EXPECT_EQ(statistics.elementsCount, 2);
+    EXPECT_EQ(statistics.memoryUsage, 2 * 2 * 2);
+    EXPECT_FALSE(cache->Get(0).IsValid());
+    EXPECT_TRUE(cache->Get(1).IsValid());
+    EXPECT_TRUE(cache->Get(2).IsValid());
+}
+
+TEST(SubBlockCache, CapacityIsEnforcedWhenAddingCase2)
+{
+    // We create a cache with a capacity of 3 bytes, and add 3 elements (each one byte in size), then access element 0 (so
+    //  that element 1 is now the least recently used one), and then add another element. Element 1 should have been evicted.
+    SubBlockCacheOptions options;
+    options.capacity.maxMemoryUsage = 3;
+    const auto cache = CreateSubBlockCache(options);
+    cache->Add(0, { CreateTestBitmap(PixelType::Gray8, 1, 1) });
+    cache->Add(1, { CreateTestBitmap(PixelType::Gray8, 1, 1) });
+    cache->Add(2, { CreateTestBitmap(PixelType::Gray8, 1, 1) });
+    EXPECT_TRUE(cache->Get(0).IsValid());
+    cache->Add(3, { CreateTestBitmap(PixelType::Gray8, 1, 1) });
+
+    const auto statistics = cache->GetStatistics(ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount);
+    EXPECT_EQ(statistics.elementsCount, 3);
+    EXPECT_EQ(statistics.memoryUsage, 3);
+    EXPECT_TRUE(cache->Get(0).IsValid());
+    EXPECT_FALSE(cache->Get(1).IsValid());
+    EXPECT_TRUE(cache->Get(2).IsValid());
+    EXPECT_TRUE(cache->Get(3).IsValid());
+}
+
+TEST(SubBlockCache, PruneLargeCacheAndCheckLruOrder)
+{
+    // add a large number of elements, then access every other element (in reverse order), and prune the cache
+    //  to half of its size - exactly the elements which were accessed should remain
+    constexpr int kNumberOfElements = 1000;
+    const auto cache = CreateSubBlockCache();
+    const auto bitmap = CreateTestBitmap(PixelType::Gray8, 1, 1);
+    for (int i = 0; i < kNumberOfElements; ++i)
+    {
+        cache->Add(i, { bitmap });
+    }
+
+    for (int i = kNumberOfElements - 2; i >= 0; i -= 2)
+    {
+        EXPECT_TRUE(cache->Get(i).IsValid());
+    }
+
+    cache->Prune({ numeric_limits<uint64_t>::max(), kNumberOfElements / 2 });
+
+    const auto statistics = cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount);
+    EXPECT_EQ(statistics.elementsCount, kNumberOfElements / 2);
+    for (int i = 0; i < kNumberOfElements; ++i)
+    {
+        EXPECT_EQ(cache->Get(i).IsValid(), i % 2 == 0) << "element " << i;
+    }
+}
+
+TEST(SubBlockCache, ShardedCacheSimpleUseCase)
+{
+    SubBlockCacheOptions options;
+    options.numberOfShards = 8;
+    const auto cache = CreateSubBlockCache(options);
+    for (int i = 0; i < 100; ++i)
+    {
+        cache->Add(i, { CreateTestBitmap(PixelType::Gray8, 2, 3) });
+    }
+
+    const auto statistics = cache->GetStatistics(ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount);
+    EXPECT_EQ(statistics.validityMask, ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount);
+    EXPECT_EQ(statistics.elementsCount, 100);
+    EXPECT_EQ(statistics.memoryUsage, 100 * 2 * 3);
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 100);
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kMemoryUsage).memoryUsage, 100 * 2 * 3);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(cache->Get(i).IsValid());
+    }
+
+    EXPECT_FALSE(cache->Get(100).IsValid());
+
+    cache->Prune({ numeric_limits<uint64_t>::max(), 0 });
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 0);
+}
+
+TEST(SubBlockCache, CountersAndResetCase1)
+{
+    // with a capacity of 2 elements, we add 3 elements (so one is evicted), and then do two lookups (one hit and one miss)
+    SubBlockCacheOptions options;
+    options.capacity.maxSubBlockCount = 2;
+    const auto cache = CreateSubBlockCache(options);
+    cache->Add(0, { CreateTestBitmap(PixelType::Gray8, 2, 2) });
+    cache->Add(1, { CreateTestBitmap(PixelType::Gray8, 2, 2) });
+    cache->Add(2, { CreateTestBitmap(PixelType::Gray8, 2, 2) });
+    cache->Add(2, { CreateTestBitmap(PixelType::Gray8, 2, 2) });
+    EXPECT_TRUE(cache->Get(2).IsValid());
+    EXPECT_FALSE(cache->Get(0).IsValid());
+
+    auto statistics = cache->GetStatisticsAndResetCounters(ISubBlockCacheStatistics::kCounters);
+    EXPECT_EQ(statistics.validityMask, static_cast<uint8_t>(ISubBlockCacheStatistics::kCounters));
+    EXPECT_EQ(statistics.hits, 1);
+    EXPECT_EQ(statistics.misses, 1);
+    EXPECT_EQ(statistics.insertions, 3);
+    EXPECT_EQ(statistics.evictions, 1);
+    EXPECT_EQ(statistics.bytesEvicted, 4);
+
+    // the counters have been reset, the memory usage is not affected by this
+    statistics = cache->GetStatistics(ISubBlockCacheStatistics::kCounters | ISubBlockCacheStatistics::kMemoryUsage);
+    EXPECT_EQ(statistics.validityMask, ISubBlockCacheStatistics::kCounters | ISubBlockCacheStatistics::kMemoryUsage);
+    EXPECT_EQ(statistics.hits, 0);
+    EXPECT_EQ(statistics.misses, 0);
+    EXPECT_EQ(statistics.insertions, 0);
+    EXPECT_EQ(statistics.evictions, 0);
+    EXPECT_EQ(statistics.bytesEvicted, 0);
+    EXPECT_EQ(statistics.memoryUsage, 8);
+}
+
+TEST(SubBlockCache, CountersAndLoadLatencyHistogramWithShardedCache)
+{
+    SubBlockCacheOptions options;
+    options.numberOfShards = 4;
+    const auto cache = CreateSubBlockCache(options);
+    for (int i = 0; i < 10; ++i)
+    {
+        cache->GetOrLoad(
+            i,
+            [](bool&)->ISubBlockCacheOperation::CacheItem
+            {
+                return { CreateTestBitmap(PixelType::Gray8, 1, 1) };
+            });
+    }
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(cache->Get(i).IsValid());
+    }
+
+    const auto statistics = cache->GetStatistics(ISubBlockCacheStatistics::kCounters | ISubBlockCacheStatistics::kLoadLatencyHistogram);
+    EXPECT_EQ(statistics.validityMask, ISubBlockCacheStatistics::kCounters | ISubBlockCacheStatistics::kLoadLatencyHistogram);
+    EXPECT_EQ(statistics.hits, 10);
+    EXPECT_EQ(statistics.misses, 10);
+    EXPECT_EQ(statistics.insertions, 10);
+    EXPECT_EQ(statistics.evictions, 0);
+    uint64_t number_of_loads = 0;
+    for (int i = 0; i < ISubBlockCacheStatistics::kLoadLatencyHistogramBucketCount; ++i)
+    {
+        number_of_loads += statistics.loadLatencyHistogram[i];
+    }
+
+    EXPECT_EQ(number_of_loads, 10);
+}
+
+TEST(SubBlockCache, ShardedCacheWithCapacityAndConcurrentAccess)
+{
+    // we add elements concurrently from multiple threads to a sharded cache with a capacity, and check that
+    //  the capacity is not exceeded
+    SubBlockCacheOptions options;
+    options.numberOfShards = 4;
+    options.capacity.maxSubBlockCount = 64;
+    const auto cache = CreateSubBlockCache(options);
+    const auto bitmap = CreateTestBitmap(PixelType::Gray8, 1, 1);
+
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&cache, &bitmap, t]()
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                const int subblock_index = t * 1000 + i;
+                cache->Add(subblock_index, { bitmap });
+                cache->Get(subblock_index);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const auto statistics = cache->GetStatistics(ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount);
+    EXPECT_LE(statistics.elementsCount, 64);
+    EXPECT_GT(statistics.elementsCount, 0);
+    EXPECT_EQ(statistics.memoryUsage, statistics.elementsCount);
+}
+
+TEST(SubBlockCache, GetOrLoadWithConcurrentMissesCallsLoadFunctionOnce)
+{
+    const auto cache = CreateSubBlockCache();
+    const auto bitmap = CreateTestBitmap(PixelType::Gray8, 4, 4);
+    atomic<int> load_function_call_count{ 0 };
+    atomic<int> threads_started{ 0 };
+    constexpr int kNumberOfThreads = 8;
+
+    vector<thread> threads;
+    vector<shared_ptr<IBitmapData>> results(kNumberOfThreads);
+    for (int t = 0; t < kNumberOfThreads; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            ++threads_started;
+            results[t] = cache->GetOrLoad(
+                42,
+                [&](bool& add_to_cache)->ISubBlockCacheOperation::CacheItem
+                {
+                    ++load_function_call_count;
+
+                    // keep the load "in flight" until all threads have started, so that they all miss
+                    while (threads_started.load() < kNumberOfThreads)
+                    {
+                        this_thread::yield();
+                    }
+
+                    this_thread::sleep_for(chrono::milliseconds(20));
+                    return { bitmap };
+                }).bitmap;
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(load_function_call_count.load(), 1);
+    for (const auto& result : results)
+    {
+        EXPECT_EQ(result, bitmap);
+    }
+
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 1);
+}
+
+TEST(SubBlockCache, GetOrLoadWithItemNotToBeAddedAndWithException)
+{
+    SubBlockCacheOptions options;
+    options.numberOfShards = 2;
+    const auto cache = CreateSubBlockCache(options);
+    const auto bitmap = CreateTestBitmap(PixelType::Gray8, 4, 4);
+
+    // an item which is not to be added is returned to the caller, but not put into the cache
+    auto item = cache->GetOrLoad(
+        1,
+        [&](bool& add_to_cache)->ISubBlockCacheOperation::CacheItem
+        {
+            add_to_cache = false;
+            return { bitmap };
+        });
+    EXPECT_EQ(item.bitmap, bitmap);
+    EXPECT_FALSE(cache->Get(1).IsValid());
+
+    // an exception from the load-function is propagated, and nothing is added
+    EXPECT_THROW(
+        cache->GetOrLoad(
+            1,
+            [](bool&)->ISubBlockCacheOperation::CacheItem
+            {
+                throw runtime_error("load failed");
+            }),
+        runtime_error);
+    EXPECT_FALSE(cache->Get(1).IsValid());
+
+    // after a load which added the item, the load-function is not called again
+    cache->GetOrLoad(1, [&](bool&)->ISubBlockCacheOperation::CacheItem { return { bitmap }; });
+    item = cache->GetOrLoad(
+        1,
+        [](bool&)->ISubBlockCacheOperation::CacheItem
+        {
+            ADD_FAILURE() << "the load-function was not expected to be called";
+            return {};
+        });
+    EXPECT_EQ(item.bitmap, bitmap);
+}
+
+TEST(SubBlockCache, MultiFileCacheKeepsFilesApartAndSharesCapacity)
+{
+    SubBlockCacheOptions options;
+    options.capacity.maxSubBlockCount = 4;
+    const auto multi_file_cache = CreateMultiFileSubBlockCache(options);
+    const libCZI::GUID guid_file1{ 0x11111111, 0x1111, 0x1111, { 1, 1, 1, 1, 1, 1, 1, 1 } };
+    const libCZI::GUID guid_file2{ 0x22222222, 0x2222, 0x2222, { 2, 2, 2, 2, 2, 2, 2, 2 } };
+    const auto cache_file1 = multi_file_cache->GetCacheForFile(guid_file1);
+    const auto cache_file2 = multi_file_cache->GetCacheForFile(guid_file2);
+
+    const auto bitmap1 = CreateTestBitmap(PixelType::Gray8, 1, 1);
+    const auto bitmap2 = CreateTestBitmap(PixelType::Gray8, 1, 1);
+    cache_file1->Add(0, { bitmap1 });
+    cache_file2->Add(0, { bitmap2 });
+    EXPECT_EQ(cache_file1->Get(0).bitmap, bitmap1);
+    EXPECT_EQ(cache_file2->Get(0).bitmap, bitmap2);
+    EXPECT_EQ(multi_file_cache->GetCacheForFile(guid_file1)->Get(0).bitmap, bitmap1);
+    EXPECT_EQ(multi_file_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 2);
+
+    // the capacity applies to both files together - adding to file 2 evicts the entries of file 1
+    for (int i = 1; i <= 4; ++i)
+    {
+        cache_file2->Add(i, { bitmap2 });
+    }
+
+    EXPECT_EQ(multi_file_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 4);
+    EXPECT_FALSE(cache_file1->Get(0).IsValid());
+
+    multi_file_cache->RemoveFile(guid_file2);
+    EXPECT_EQ(multi_file_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 0);
+
+    // the cache object for a file remains usable after the file was removed
+    cache_file2->Add(7, { bitmap2 });
+    EXPECT_EQ(cache_file2->Get(7).bitmap, bitmap2);
+}
+
+TEST(SubBlockCache, MultiFileCacheDoesNotAddResultOfLoadInProgressWhenFileIsRemoved)
+{
+    const auto multi_file_cache = CreateMultiFileSubBlockCache(SubBlockCacheOptions{});
+    const libCZI::GUID guid_file{ 0x11111111, 0x1111, 0x1111, { 1, 1, 1, 1, 1, 1, 1, 1 } };
+    const auto cache_file = multi_file_cache->GetCacheForFile(guid_file);
+    const auto bitmap = CreateTestBitmap(PixelType::Gray8, 4, 4);
+
+    // the file is removed while the load-operation is in progress - the loaded item is returned to the caller, but it
+    //  must not end up in the cache
+    const auto item = cache_file->GetOrLoad(
+        3,
+        [&](bool&)->ISubBlockCacheOperation::CacheItem
+        {
+            multi_file_cache->RemoveFile(guid_file);
+            return { bitmap };
+        });
+    EXPECT_EQ(item.bitmap, bitmap);
+    EXPECT_FALSE(cache_file->Get(3).IsValid());
+    EXPECT_EQ(multi_file_cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 0);
+
+    // a load which starts after the removal is added as usual
+    cache_file->GetOrLoad(3, [&](bool&)->ISubBlockCacheOperation::CacheItem { return { bitmap }; });
+    EXPECT_EQ(cache_file->Get(3).bitmap, bitmap);
+}
+
+TEST(SubBlockCache, TinyLfuAdmissionPolicyKeepsFrequentlyUsedElementsDuringScan)
+{
+    SubBlockCacheOptions options;
+    options.capacity.maxSubBlockCount = 10;
+    options.admissionPolicy = SubBlockCacheOptions::AdmissionPolicy::TinyLfu;
+    const auto cache = CreateSubBlockCache(options);
+    const auto bitmap = CreateTestBitmap(PixelType::Gray8, 1, 1);
+
+    // the "working set" - elements 0 to 9, which are accessed a couple of times
+    for (int i = 0; i < 10; ++i)
+    {
+        cache->Add(i, { bitmap });
+    }
+
+    for (int repeat = 0; repeat < 3; ++repeat)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            EXPECT_TRUE(cache->Get(i).IsValid());
+        }
+    }
+
+    // now, a "scan" over many elements which are accessed once only - while the working set continues to be used
+    for (int i = 100; i < 1100; ++i)
+    {
+        if (!cache->Get(i).IsValid())
+        {
+            cache->Add(i, { bitmap });
+        }
+
+        if (i % 10 == 0)
+        {
+            for (int j = 0; j < 10; ++j)
+            {
+                cache->Get(j);
+            }
+        }
+    }
+
+    // with the TinyLFU admission policy, the working set is still in the cache
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(cache->Get(i).IsValid()) << "element " << i << " was expected to be in the cache";
+    }
+
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 10);
+
+    // whereas with an LRU-cache, the working set is evicted by the scan
+    options.admissionPolicy = SubBlockCacheOptions::AdmissionPolicy::AdmitAll;
+    const auto lru_cache = CreateSubBlockCache(options);
+    for (int i = 0; i < 10; ++i)
+    {
+        lru_cache->Add(i, { bitmap });
+    }
+
+    for (int i = 100; i < 1100; ++i)
+    {
+        lru_cache->Add(i, { bitmap });
+    }
+
+    EXPECT_FALSE(lru_cache->Get(0).IsValid());
+}
+
+namespace
+{
+    /// A stream which counts the read-operations (and forwards them to another stream).
+    class ReadCountingStream : public IStream
+    {
+    private:
+        shared_ptr<IStream> stream_;
+        atomic<int> read_count_{ 0 };
+    public:
+        explicit ReadCountingStream(shared_ptr<IStream> stream) : stream_(std::move(stream))
+        {
+        }
+
+        void Read(std::uint64_t offset, void* pv, std::uint64_t size, std::uint64_t* ptrBytesRead) override
+        {
+            ++this->read_count_;
+            this->stream_->Read(offset, pv, size, ptrBytesRead);
+        }
+
+        int GetReadCount() const
+        {
+            return this->read_count_.load();
+        }
+    };
+
+    tuple<shared_ptr<void>, size_t> CreateCziWithOneZstd1CompressedSubBlock(const shared_ptr<IBitmapData>& bitmap)
+    {
+        shared_ptr<IMemoryBlock> encoded_data;
+        {
+            const ScopedBitmapLockerSP lck{ bitmap };
+            encoded_data = ZstdCompress::CompressZStd1Alloc(bitmap->GetWidth(), bitmap->GetHeight(), lck.stride, bitmap->GetPixelType(), lck.ptrDataRoi, nullptr);
+        }
+
+        return CreateCziDocument(
+            make_shared<CCziWriterInfo>(libCZI::GUID{ 0x1234567, 0x89ab, 0xcdef, { 1, 2, 3, 4, 5, 6, 7, 8 } }),
+            [&](ICziWriter* writer)->void
+            {
+                AddSubBlockInfoMemPtr add_sub_block_info;
+                add_sub_block_info.Clear();
+                add_sub_block_info.coordinate = CDimCoordinate::Parse("C0");
+                add_sub_block_info.mIndexValid = true;
+                add_sub_block_info.mIndex = 0;
+                add_sub_block_info.x = 0;
+                add_sub_block_info.y = 0;
+                add_sub_block_info.logicalWidth = add_sub_block_info.physicalWidth = bitmap->GetWidth();
+                add_sub_block_info.logicalHeight = add_sub_block_info.physicalHeight = bitmap->GetHeight();
+                add_sub_block_info.PixelType = bitmap->GetPixelType();
+                add_sub_block_info.ptrData = encoded_data->GetPtr();
+                add_sub_block_info.dataSize = encoded_data->GetSizeOfData();
+                add_sub_block_info.SetCompressionMode(CompressionMode::Zstd1);
+                writer->SyncAddSubBlock(add_sub_block_info);
+            });
+    }
+}
+
+TEST(SubBlockCache, TinyLfuAdmissionPolicyComparesWithAllElementsToBeEvicted)
+{
+    SubBlockCacheOptions options;
+    options.capacity.maxMemoryUsage = 300;
+    options.admissionPolicy = SubBlockCacheOptions::AdmissionPolicy::TinyLfu;
+    const auto cache = CreateSubBlockCache(options);
+
+    // three elements of 100 bytes each, the LRU-order is 0 (least recently used), 1, 2 - where element 1 is used frequently
+    cache->Add(0, { CreateTestBitmap(PixelType::Gray8, 10, 10) });
+    cache->Add(1, { CreateTestBitmap(PixelType::Gray8, 10, 10) });
+    cache->Add(2, { CreateTestBitmap(PixelType::Gray8, 10, 10) });
+    for (int i = 0; i < 5; ++i)
+    {
+        cache->Get(1);
+    }
+
+    cache->Get(2);
+
+    // an element of 200 bytes would evict the elements 0 and 1 - it is used more often than element 0, but less often
+    //  than element 1, so it is not admitted
+    cache->Get(10);
+    cache->Get(10);
+    cache->Add(10, { CreateTestBitmap(PixelType::Gray8, 20, 10) });
+    EXPECT_FALSE(cache->Get(10).IsValid());
+    EXPECT_TRUE(cache->Get(0).IsValid());
+    EXPECT_TRUE(cache->Get(1).IsValid());
+    EXPECT_TRUE(cache->Get(2).IsValid());
+
+    // whereas an element of 100 bytes only evicts the least recently used element (which is now element 0 again, since its
+    //  access above was the first of the three)
+    cache->Get(11);
+    cache->Get(11);
+    cache->Get(11);
+    cache->Add(11, { CreateTestBitmap(PixelType::Gray8, 10, 10) });
+    EXPECT_TRUE(cache->Get(11).IsValid());
+    EXPECT_FALSE(cache->Get(0).IsValid());
+    EXPECT_TRUE(cache->Get(1).IsValid());
+}
+
+TEST(SubBlockCache, CompressedTierAvoidsReadingTheSubBlockAgain)
+{
+    const auto bitmap = CreateTestBitmap(PixelType::Gray8, 32, 32);
+    const auto czi_document_as_blob = CreateCziWithOneZstd1CompressedSubBlock(bitmap);
+    const auto stream = make_shared<ReadCountingStream>(make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob)));
+    const auto reader = CreateCZIReader();
+    reader->Open(stream);
+
+    SubBlockCacheOptions cache_options;
+    cache_options.compressedTierMaxMemoryUsage = 1024 * 1024;
+    const auto cache = CreateSubBlockCache(cache_options);
+
+    const auto accessor = reader->CreateSingleChannelTileAccessor();
+    ISingleChannelTileAccessor::Options options;
+    options.Clear();
+    options.subBlockCache = cache;
+    const CDimCoordinate plane_coordinate{ { DimensionIndex::C, 0 } };
+    const auto composite1 = accessor->Get(IntRect{ 0, 0, 32, 32 }, &plane_coordinate, &options);
+    EXPECT_TRUE(cache->GetCompressedSubBlock(0));
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 1);
+
+    // now, we remove the decoded bitmap from the cache - the next request must be served from the compressed tier without I/O
+    cache->Prune({ numeric_limits<uint64_t>::max(), 0 });
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 0);
+    const int read_count_before = stream->GetReadCount();
+    const auto composite2 = accessor->Get(IntRect{ 0, 0, 32, 32 }, &plane_coordinate, &options);
+    EXPECT_EQ(stream->GetReadCount(), read_count_before);
+    EXPECT_TRUE(AreBitmapDataEqual(composite1, composite2));
+    EXPECT_TRUE(AreBitmapDataEqual(composite1, bitmap));
+}
+
+TEST(SubBlockCache, ScalingAccessorWithDownscaledRenditionsInCache)
+{
+    const auto bitmap = CreateGray8BitmapAndFill(64, 64, 42);
+    const auto czi_document_as_blob = CreateCziWithOneZstd1CompressedSubBlock(bitmap);
+    const auto stream = make_shared<ReadCountingStream>(make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob)));
+    const auto reader = CreateCZIReader();
+    reader->Open(stream);
+
+    const auto cache = CreateSubBlockCache();
+    const auto accessor = reader->CreateSingleChannelScalingTileAccessor();
+    ISingleChannelScalingTileAccessor::Options options;
+    options.Clear();
+    options.backGroundColor = RgbFloatColor{ 0, 0, 0 };
+    options.subBlockCache = cache;
+    options.useDownscaledSubBlockCache = true;
+    const CDimCoordinate plane_coordinate{ { DimensionIndex::C, 0 } };
+
+    // with a zoom of 0.3, the rendition downscaled by a factor of 2 is the smallest one which is still larger than the destination
+    const auto composite1 = accessor->Get(IntRect{ 0, 0, 64, 64 }, &plane_coordinate, 0.3f, &options);
+    const auto rendition = cache->GetDownscaled(0, 1);
+    ASSERT_TRUE(rendition.IsValid());
+    EXPECT_EQ(rendition.bitmap->GetWidth(), 32);
+    EXPECT_EQ(rendition.bitmap->GetHeight(), 32);
+    EXPECT_FALSE(cache->GetDownscaled(0, 2).IsValid());
+
+    // only the rendition is in the cache (and not the full-resolution bitmap it was created from)
+    const auto statistics = cache->GetStatistics(ISubBlockCacheStatistics::kMemoryUsage | ISubBlockCacheStatistics::kElementsCount);
+    EXPECT_EQ(statistics.elementsCount, 1);
+    EXPECT_EQ(statistics.memoryUsage, 32 * 32);
+    EXPECT_FALSE(cache->Get(0).IsValid());
+
+    // the second request is served from the rendition (so no I/O is necessary), and gives the same result
+    const int read_count_before = stream->GetReadCount();
+    const auto composite2 = accessor->Get(IntRect{ 0, 0, 64, 64 }, &plane_coordinate, 0.3f, &options);
+    EXPECT_EQ(stream->GetReadCount(), read_count_before);
+    EXPECT_TRUE(AreBitmapDataEqual(composite1, composite2));
+    EXPECT_TRUE(AreBitmapDataEqual(composite1, CreateGray8BitmapAndFill(composite1->GetWidth(), composite1->GetHeight(), 42)));
+
+    EXPECT_THROW(cache->GetDownscaled(0, 0), invalid_argument);
+    EXPECT_THROW(cache->AddDownscaled(0, 16, rendition), invalid_argument);
+}
+
+TEST(SubBlockCache, PrefetcherLoadsRingAndAdjacentPlanes)
+{
+    const auto czi_document_as_blob = CreateCziWithThreeZPlanesOfOverlappingSubblocks();
+    const auto reader = CreateCZIReader();
+    reader->Open(make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob)));
+
+    const auto cache = CreateSubBlockCache();
+    SubBlockPrefetcherOptions prefetcher_options;
+    prefetcher_options.numberOfThreads = 2;
+    prefetcher_options.onlyUseSubBlockCacheForCompressedData = false;
+    const auto prefetcher = CreateSubBlockPrefetcher(reader, cache, prefetcher_options);
+
+    // the request is for a part of the subblock in the second column and second row of the plane Z=1 (which is the only subblock
+    //  intersecting with it), the ring around it then covers the first three columns and rows
+    const CDimCoordinate plane_coordinate{ { DimensionIndex::Z, 1 }, { DimensionIndex::C, 0 } };
+    prefetcher->Prefetch(IntRect{ 17, 17, 6, 6 }, &plane_coordinate, 1);
+    prefetcher->WaitUntilIdle();
+
+    // we expect the 7 subblocks around the center on Z=1 (the subblock in the upper left corner is missing on this plane), and
+    //  the subblocks in the center on Z=0 and Z=2
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 9);
+    reader->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo& info)->bool
+        {
+            int z;
+            info.coordinate.TryGetPosition(DimensionIndex::Z, &z);
+            const int column = info.logicalRect.x / 12;
+            const int row = info.logicalRect.y / 12;
+            const bool is_center = column == 1 && row == 1;
+            const bool is_in_ring = !is_center && column <= 2 && row <= 2;
+            const bool expected_in_cache = (z == 1 && is_in_ring) || (z != 1 && is_center);
+            EXPECT_EQ(cache->Get(index).IsValid(), expected_in_cache) << "subblock #" << index;
+            return true;
+        });
+}
+
+TEST(SubBlockCache, PrefetcherSkipsUncompressedSubBlocksIfOnlyCompressedDataIsCached)
+{
+    const auto czi_document_as_blob = CreateCziWithThreeZPlanesOfOverlappingSubblocks();
+    const auto reader = CreateCZIReader();
+    reader->Open(make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob)));
+
+    // all subblocks in the document are uncompressed, so with the default options (where they would not be added to the
+    //  cache) nothing is to be prefetched
+    const auto cache = CreateSubBlockCache();
+    const CDimCoordinate plane_coordinate{ { DimensionIndex::Z, 1 }, { DimensionIndex::C, 0 } };
+    SubBlockPrefetcherOptions prefetcher_options;
+    libCZI::detail::SubBlockPrefetcher prefetcher(reader, cache, prefetcher_options);
+    EXPECT_TRUE(prefetcher.DetermineSubBlocksToPrefetch(IntRect{ 17, 17, 6, 6 }, &plane_coordinate, 1).empty());
+    prefetcher.Prefetch(IntRect{ 17, 17, 6, 6 }, &plane_coordinate, 1);
+    prefetcher.WaitUntilIdle();
+    EXPECT_EQ(cache->GetStatistics(ISubBlockCacheStatistics::kElementsCount).elementsCount, 0);
+
+    prefetcher_options.onlyUseSubBlockCacheForCompressedData = false;
+    libCZI::detail::SubBlockPrefetcher prefetcher_for_all_subblocks(reader, cache, prefetcher_options);
+    EXPECT_EQ(prefetcher_for_all_subblocks.DetermineSubBlocksToPrefetch(IntRect{ 17, 17, 6, 6 }, &plane_coordinate, 1).size(), 9);
+}
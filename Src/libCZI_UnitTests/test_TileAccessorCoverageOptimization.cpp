@@ -9,6 +9,7 @@
 #include "inc_libCZI.h"
 #include "../libCZI/SingleChannelTileAccessor.h"
 #include "../libCZI/SingleChannelScalingTileAccessor.h"
+#include "../libCZI/rendered_tile_cache.h"
 #include "MemOutputStream.h"
 #include "utils.h"
 
@@ -613,3 +614,98 @@ TEST(TileAccessorCoverageOptimization, CheckForVisibility_TestCase5)
     EXPECT_EQ(indices_of_visible_tiles[0], 1);
     EXPECT_EQ(indices_of_visible_tiles[1], 5);
 }
+
+/// Creates a CZI document with two (partially overlapping) scenes, each consisting of a mosaic of 8x8 subblocks of size 32x32 on
+/// layer-0, and with three pyramid-layers (with zoom 1/2, 1/4 and 1/8). On the first two pyramid-layers, a subblock is missing
+/// (different ones in the two scenes), so that the holes have to be filled from the finer layers. The content is random.
+///
+/// \returns A blob containing the synthetic CZI document.
+static tuple<shared_ptr<void>, size_t> CreateCziWithTwoScenesWithPyramidLayersWithHoles()
+{
+    return CreateCziDocument(
+        make_shared<CCziWriterInfo>(GUID{ 0x1234567,0x89ab,0xcdef,{ 1,2,3,4,5,6,7,8 } }),
+        [](ICziWriter* writer)->void
+        {
+            const auto add_sub_block = [writer](int scene, int x, int y, int logical_size, int m_index)->void
+            {
+                AddSubBlockWithBitmap(
+                    writer,
+                    CDimCoordinate{ { DimensionIndex::C, 0 }, { DimensionIndex::S, scene } },
+                    m_index,
+                    IntRect{ x, y, logical_size, logical_size },
+                    CreateRandomBitmap(PixelType::Gray8, 32, 32));
+            };
+
+            for (int scene = 0; scene < 2; ++scene)
+            {
+                const int scene_x = scene * 200;
+                const int scene_y = scene * 40;
+                for (int i = 0; i < 64; ++i)
+                {
+                    add_sub_block(scene, scene_x + (i % 8) * 32, scene_y + (i / 8) * 32, 32, i);
+                }
+
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (i != 5 + scene)
+                    {
+                        add_sub_block(scene, scene_x + (i % 4) * 64, scene_y + (i / 4) * 64, 64, -1);
+                    }
+                }
+
+                for (int i = 0; i < 4; ++i)
+                {
+                    if (i != 3 - scene)
+                    {
+                        add_sub_block(scene, scene_x + (i % 2) * 128, scene_y + (i / 2) * 128, 128, -1);
+                    }
+                }
+
+                add_sub_block(scene, scene_x, scene_y, 256, -1);
+            }
+        });
+}
+
+TEST(TileAccessorCoverageOptimization, ScalingAccessorWithLayerIndexGivesSameResultAsWithoutLayerIndex)
+{
+    const auto czi_document_as_blob = CreateCziWithTwoScenesWithPyramidLayersWithHoles();
+    const auto reader = CreateCZIReader();
+    reader->Open(make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob)));
+
+    // the reader provides an instance-identity, so the accessor operating on it is using the layer-index - whereas the shim
+    //  does not, so the accessor operating on it is using the "complete subset of subblocks" (and its selection from it)
+    ASSERT_NE(dynamic_cast<const IRepositoryInstanceIdentity*>(reader.get()), nullptr);
+    const auto accessor_with_layer_index = reader->CreateSingleChannelScalingTileAccessor();
+    const shared_ptr<ISingleChannelScalingTileAccessor> accessor_without_layer_index = make_shared<CSingleChannelScalingTileAccessor>(make_shared<SubBlockRepositoryShim>(reader));
+
+    const auto statistics = reader->GetStatistics();
+    const CDimCoordinate plane_coordinate{ { DimensionIndex::C, 0 } };
+    const vector<IntRect> rois
+    {
+        statistics.boundingBoxLayer0Only,
+        IntRect{ statistics.boundingBoxLayer0Only.x + 100, statistics.boundingBoxLayer0Only.y + 50, 300, 180 },
+        IntRect{ statistics.boundingBoxLayer0Only.x + 190, statistics.boundingBoxLayer0Only.y + 70, 75, 61 },
+    };
+
+    for (const bool use_visibility_check_optimization : { false, true })
+    {
+        ISingleChannelScalingTileAccessor::Options options;
+        options.Clear();
+        options.backGroundColor = RgbFloatColor{ 0, 0, 0 };
+        options.useVisibilityCheckOptimization = use_visibility_check_optimization;
+        for (const auto& scene_filter : { shared_ptr<IIndexSet>(), Utils::IndexSetFromString(L"1") })
+        {
+            options.sceneFilter = scene_filter;
+            for (const auto& roi : rois)
+            {
+                for (const float zoom : { 1.f, 0.7f, 0.5f, 0.3f, 0.25f, 0.17f, 0.125f, 0.06f, 0.01f })
+                {
+                    const auto composite_with_layer_index = accessor_with_layer_index->Get(PixelType::Gray8, roi, &plane_coordinate, zoom, &options);
+                    const auto composite_without_layer_index = accessor_without_layer_index->Get(PixelType::Gray8, roi, &plane_coordinate, zoom, &options);
+                    EXPECT_TRUE(AreBitmapDataEqual(composite_with_layer_index, composite_without_layer_index))
+                        << "zoom=" << zoom << " roi=" << roi.x << "," << roi.y << "," << roi.w << "," << roi.h << " visibility-check=" << use_visibility_check_optimization << " scene-filter=" << (scene_filter ? "S1" : "none");
+                }
+            }
+        }
+    }
+}
@@ -468,3 +468,48 @@ TEST(Utilities, Tokenize)
     EXPECT_EQ(tokens[0], L"");
     EXPECT_EQ(tokens[1], L"");
 }
+
+TEST(Utilities, LoHiByteUnpackAndPackAndCompareWithReference)
+{
+    // we use widths which exercise the vectorized loops as well as the remainder-handling of the SIMD-implementations
+    for (const uint32_t width : { 1u, 15u, 16u, 31u, 32u, 33u, 64u, 95u, 100u })
+    {
+        constexpr uint32_t height = 5;
+        const uint32_t stride = width * 2 + 6;
+        vector<uint8_t> source(static_cast<size_t>(stride) * height);
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            source[i] = static_cast<uint8_t>(i * 7 + 3);
+        }
+
+        const size_t half_length = static_cast<size_t>(width) * height;
+        vector<uint8_t> unpacked(half_length * 2);
+        LoHiBytePackUnpack::LoHiByteUnpackStrided(source.data(), width, stride, height, unpacked.data());
+
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const size_t index = static_cast<size_t>(y) * width + x;
+                ASSERT_EQ(unpacked[index], source[y * static_cast<size_t>(stride) + x * 2]) << "width=" << width;
+                ASSERT_EQ(unpacked[half_length + index], source[y * static_cast<size_t>(stride) + x * 2 + 1]) << "width=" << width;
+            }
+        }
+
+        vector<uint8_t> packed(source.size(), 0xcc);
+        LoHiBytePackUnpack::LoHiBytePackStrided(unpacked.data(), unpacked.size(), width, height, stride, packed.data());
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width * 2; ++x)
+            {
+                ASSERT_EQ(packed[y * static_cast<size_t>(stride) + x], source[y * static_cast<size_t>(stride) + x]) << "width=" << width;
+            }
+
+            // the padding at the end of the line must not be touched
+            for (uint32_t x = width * 2; x < stride; ++x)
+            {
+                ASSERT_EQ(packed[y * static_cast<size_t>(stride) + x], 0xcc) << "width=" << width;
+            }
+        }
+    }
+}
@@ -9,6 +9,7 @@
 
 using namespace libCZI;
 using namespace libCZI::detail;
+using namespace std;
 
 static std::shared_ptr<IBitmapData> CreateTestImage()
 {
@@ -358,3 +359,129 @@ TEST(BitmapOperations, CopyWithOffsetGray8ToGray16_2)
 
     ASSERT_EQ(memcmp(destination_locked.ptrDataRoi, expected_result_data, 8 * 8 * 2), 0);
 }
+
+TEST(BitmapOperations, RGB48ToBGR48AndCompareWithReference)
+{
+    // we use widths which exercise the vectorized loops as well as the remainder-handling of the SIMD-implementations
+    for (int width = 1; width <= 25; ++width)
+    {
+        constexpr int height = 3;
+        const int stride = width * 6 + 10;
+        vector<uint16_t> data(static_cast<size_t>(stride / 2) * height);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<uint16_t>(i * 131 + 17);
+        }
+
+        const vector<uint16_t> original = data;
+        CBitmapOperations::RGB48ToBGR48(width, height, data.data(), stride);
+
+        for (int y = 0; y < height; ++y)
+        {
+            const uint16_t* line = data.data() + static_cast<size_t>(y) * (stride / 2);
+            const uint16_t* original_line = original.data() + static_cast<size_t>(y) * (stride / 2);
+            for (int x = 0; x < width; ++x)
+            {
+                ASSERT_EQ(line[x * 3 + 0], original_line[x * 3 + 2]) << "width=" << width;
+                ASSERT_EQ(line[x * 3 + 1], original_line[x * 3 + 1]) << "width=" << width;
+                ASSERT_EQ(line[x * 3 + 2], original_line[x * 3 + 0]) << "width=" << width;
+            }
+
+            // the padding at the end of the line must not be touched
+            for (int x = width * 3; x < stride / 2; ++x)
+            {
+                ASSERT_EQ(line[x], original_line[x]) << "width=" << width;
+            }
+        }
+    }
+}
+
+TEST(BitmapOperations, AreaAverageResizeGray8AndCheckResult)
+{
+    static const uint8_t source_data[4 * 4] =
+    {
+        0, 4, 8, 12,
+        16, 20, 24, 28,
+        32, 36, 40, 44,
+        48, 52, 56, 60
+    };
+
+    auto source = CBitmapData<CHeapAllocator>::Create(PixelType::Gray8, 4, 4, 4);
+    {
+        ScopedBitmapLockerSP source_locked{ source };
+        memcpy(source_locked.ptrDataRoi, source_data, 4 * 4);
+    }
+
+    auto destination = CBitmapData<CHeapAllocator>::Create(PixelType::Gray8, 2, 2, 2);
+    CBitmapOperations::AreaAverageResize(source.get(), destination.get(), DblRect{ 0, 0, 4, 4 }, DblRect{ 0, 0, 2, 2 });
+
+    static const uint8_t expected_result_data[2 * 2] = { 10, 18, 42, 50 };
+    ScopedBitmapLockerSP destination_locked{ destination };
+    ASSERT_EQ(memcmp(destination_locked.ptrDataRoi, expected_result_data, 2 * 2), 0);
+}
+
+TEST(BitmapOperations, BilinearResizeGray8AndCheckResult)
+{
+    auto source = CBitmapData<CHeapAllocator>::Create(PixelType::Gray8, 2, 1, 2);
+    {
+        ScopedBitmapLockerSP source_locked{ source };
+        static_cast<uint8_t*>(source_locked.ptrDataRoi)[0] = 0;
+        static_cast<uint8_t*>(source_locked.ptrDataRoi)[1] = 100;
+    }
+
+    auto destination = CBitmapData<CHeapAllocator>::Create(PixelType::Gray8, 4, 1, 4);
+    CBitmapOperations::BilinearResize(source.get(), destination.get(), DblRect{ 0, 0, 2, 1 }, DblRect{ 0, 0, 4, 1 });
+
+    static const uint8_t expected_result_data[4] = { 0, 25, 75, 100 };
+    ScopedBitmapLockerSP destination_locked{ destination };
+    ASSERT_EQ(memcmp(destination_locked.ptrDataRoi, expected_result_data, 4), 0);
+}
+
+TEST(BitmapOperations, AreaAverageResizeOfAdjacentRoisGivesSameResultAsWhole)
+{
+    // when a bitmap is drawn in two parts (as it is the case with adjacent tiles), we expect exactly the same result as
+    //  when drawing it in one go - i.e. no gaps and no overlap at the seam, even if the seam is at a fractional position
+    for (const auto pixel_type : { PixelType::Gray8, PixelType::Gray16, PixelType::Bgr24, PixelType::Bgr48 })
+    {
+        auto source = CreateTestBitmap(pixel_type, 10, 10);
+        auto destination_whole = CBitmapData<CHeapAllocator>::Create(pixel_type, 4, 4);
+        auto destination_in_parts = CBitmapData<CHeapAllocator>::Create(pixel_type, 4, 4);
+        CBitmapOperations::Fill(destination_whole.get(), RgbFloatColor{ 0, 0, 0 });
+        CBitmapOperations::Fill(destination_in_parts.get(), RgbFloatColor{ 0, 0, 0 });
+
+        CBitmapOperations::AreaAverageResize(source.get(), destination_whole.get(), DblRect{ 0, 0, 10, 10 }, DblRect{ 0, 0, 4, 4 });
+        CBitmapOperations::AreaAverageResize(source.get(), destination_in_parts.get(), DblRect{ 0, 0, 3.125, 10 }, DblRect{ 0, 0, 1.25, 4 });
+        CBitmapOperations::AreaAverageResize(source.get(), destination_in_parts.get(), DblRect{ 3.125, 0, 6.875, 10 }, DblRect{ 1.25, 0, 2.75, 4 });
+
+        EXPECT_TRUE(AreBitmapDataEqual(destination_whole, destination_in_parts)) << "Bitmaps are expected to be equal.";
+    }
+}
+
+TEST(BitmapOperations, NNResizeSamePixelTypeGivesSameResultAsConvertingPath)
+{
+    // the same-pixel-type case uses a specialized gather-path (and copies lines where possible) - check that it gives exactly the
+    //  same pixels as the generic path with a pixel converter (Gray8 to Gray16 is a plain widening conversion)
+    auto source = CreateTestBitmap(PixelType::Gray8, 37, 29);
+    const DblRect source_roi{ 3, 2, 30, 25 };
+    for (const auto& destination_roi : { DblRect{ 1, 1, 15, 12.5 }, DblRect{ 0.5, 2, 30, 25 }, DblRect{ -2, -1, 75, 62.5 } })
+    {
+        auto destination_gray8 = CBitmapData<CHeapAllocator>::Create(PixelType::Gray8, 64, 48);
+        auto destination_gray16 = CBitmapData<CHeapAllocator>::Create(PixelType::Gray16, 64, 48);
+        CBitmapOperations::Fill(destination_gray8.get(), RgbFloatColor{ 0, 0, 0 });
+        CBitmapOperations::Fill(destination_gray16.get(), RgbFloatColor{ 0, 0, 0 });
+        CBitmapOperations::NNResize(source.get(), destination_gray8.get(), source_roi, destination_roi);
+        CBitmapOperations::NNResize(source.get(), destination_gray16.get(), source_roi, destination_roi);
+
+        ScopedBitmapLockerSP lock_gray8{ destination_gray8 };
+        ScopedBitmapLockerSP lock_gray16{ destination_gray16 };
+        for (uint32_t y = 0; y < 48; ++y)
+        {
+            const uint8_t* line_gray8 = static_cast<const uint8_t*>(lock_gray8.ptrDataRoi) + static_cast<size_t>(y) * lock_gray8.stride;
+            const uint16_t* line_gray16 = reinterpret_cast<const uint16_t*>(static_cast<const uint8_t*>(lock_gray16.ptrDataRoi) + static_cast<size_t>(y) * lock_gray16.stride);
+            for (uint32_t x = 0; x < 64; ++x)
+            {
+                ASSERT_EQ(line_gray8[x], line_gray16[x]) << "x=" << x << " y=" << y;
+            }
+        }
+    }
+}
@@ -6,9 +6,12 @@
 #include "inc_libCZI.h"
 #include "../libCZI/bitmapData.h"
 #include "../libCZI/utilities.h"
+#include "../libCZI/BitmapOperationsBitonal.h"
 #include "MemOutputStream.h"
 #include "utils.h"
 
+#include <random>
+
 using namespace libCZI;
 using namespace libCZI::detail;
 using namespace std;
@@ -1092,3 +1095,103 @@ TEST(MaskAwareComposition, SingleChannelTileAccessorMaskTooSmallComposeWithoutMa
         }
     }
 }
+
+TEST(MaskAwareComposition, ComposeInBandsGivesSameResultAsSequentialComposition)
+{
+    // compose a set of overlapping tiles (half of them with a random mask) once sequentially and once with multiple bands
+    //  (with a number of bands which does not divide the height) - the results must be identical
+    constexpr int kTileCount = 40;
+    mt19937 random_engine(1234);
+    vector<shared_ptr<IBitmapData>> tiles;
+    vector<shared_ptr<IBitonalBitmapData>> masks;
+    vector<IntPoint> positions;
+    for (int i = 0; i < kTileCount; ++i)
+    {
+        const uint32_t width = 10 + random_engine() % 60;
+        const uint32_t height = 10 + random_engine() % 60;
+        auto tile = CStdBitmapData::Create(PixelType::Gray16, width, height);
+        {
+            ScopedBitmapLockerSP tile_locker{ tile };
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                uint16_t* line = reinterpret_cast<uint16_t*>(static_cast<uint8_t*>(tile_locker.ptrDataRoi) + static_cast<size_t>(y) * tile_locker.stride);
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    line[x] = static_cast<uint16_t>(random_engine());
+                }
+            }
+        }
+
+        shared_ptr<IBitonalBitmapData> mask;
+        if (i % 2 == 1)
+        {
+            mask = CStdBitonalBitmapData::Create(width, height);
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    BitonalBitmapOperations::SetPixelValue(mask, x, y, (random_engine() & 1) != 0);
+                }
+            }
+        }
+
+        tiles.push_back(tile);
+        masks.push_back(mask);
+        positions.push_back(IntPoint{ static_cast<int>(random_engine() % 120) - 20, static_cast<int>(random_engine() % 120) - 20 });
+    }
+
+    const auto get_tiles_and_mask = [&](int index, shared_ptr<IBitmapData>& spBm, shared_ptr<IBitonalBitmapData>& spMask, int& xPosTile, int& yPosTile)->bool
+    {
+        if (index >= kTileCount)
+        {
+            return false;
+        }
+
+        spBm = tiles[index];
+        spMask = masks[index];
+        xPosTile = positions[index].x;
+        yPosTile = positions[index].y;
+        return true;
+    };
+
+    auto destination_sequential = CStdBitmapData::Create(PixelType::Gray16, 100, 97);
+    auto destination_in_bands = CStdBitmapData::Create(PixelType::Gray16, 100, 97);
+    CBitmapOperations::Fill(destination_sequential.get(), RgbFloatColor{ 0, 0, 0 });
+    CBitmapOperations::Fill(destination_in_bands.get(), RgbFloatColor{ 0, 0, 0 });
+
+    Compositors::ComposeSingleTileOptions options;
+    options.Clear();
+    Compositors::ComposeSingleChannelTilesMaskAware(get_tiles_and_mask, destination_sequential.get(), 5, 3, &options);
+    options.composeThreadCount = 7;
+    Compositors::ComposeSingleChannelTilesMaskAware(get_tiles_and_mask, destination_in_bands.get(), 5, 3, &options);
+
+    EXPECT_TRUE(AreBitmapDataEqual(destination_sequential, destination_in_bands)) << "Bitmaps are expected to be equal.";
+}
+
+TEST(MaskAwareComposition, NNResizeMaskAwareWithMaskNarrowerThanSource)
+{
+    // the mask (3 pixels wide, i.e. one byte per line) is narrower than the source bitmap (32 pixels wide) - the pixels
+    //  right of the mask are to be considered "masked out", and the mask must not be read beyond the end of its lines
+    const auto source = CreateGray8BitmapAndFill(32, 4, 200);
+    const auto mask = CStdBitonalBitmapData::Create(3, 4);
+    for (uint32_t y = 0; y < 4; ++y)
+    {
+        for (uint32_t x = 0; x < 3; ++x)
+        {
+            BitonalBitmapOperations::SetPixelValue(mask, x, y, true);
+        }
+    }
+
+    const auto destination = CreateGray8BitmapAndFill(32, 4, 0);
+    BitmapOperationsBitonal::NNResizeMaskAware(source.get(), mask.get(), destination.get(), DblRect{ 0, 0, 32, 4 }, DblRect{ 0, 0, 32, 4 });
+
+    const ScopedBitmapLockerSP destination_locker{ destination };
+    for (uint32_t y = 0; y < 4; ++y)
+    {
+        const uint8_t* line = static_cast<const uint8_t*>(destination_locker.ptrDataRoi) + static_cast<size_t>(y) * destination_locker.stride;
+        for (uint32_t x = 0; x < 32; ++x)
+        {
+            EXPECT_EQ(line[x], x < 3 ? 200 : 0) << "at x=" << x << " y=" << y;
+        }
+    }
+}
@@ -482,3 +482,84 @@ TEST(Pixels, SetPixelValueAndGetPixelValue)
         }
     }
 }
+
+TEST(Pixels, BitonalBitmapOperationsCopyAtWithRandomMaskAndCompareWithReference)
+{
+    // the mask-aware copy processes eight (or 32) pixels at once where the mask allows for it - we use a mask with runs of
+    //  set and cleared bits as well as random bits, and various offsets (which give different alignments of the mask bits)
+    mt19937 random_engine(42);
+    for (const auto pixel_type : { PixelType::Gray8, PixelType::Gray16, PixelType::Bgr24, PixelType::Bgr48, PixelType::Gray32Float })
+    {
+        const uint8_t bytes_per_pel = Utils::GetBytesPerPixel(pixel_type);
+        constexpr int kSourceWidth = 83;
+        constexpr int kSourceHeight = 7;
+        constexpr int kDestinationWidth = 90;
+        constexpr int kDestinationHeight = 9;
+
+        auto src_bitmap = CStdBitmapData::Create(pixel_type, kSourceWidth, kSourceHeight);
+        auto mask_bitmap = CStdBitonalBitmapData::Create(kSourceWidth, kSourceHeight);
+        {
+            ScopedBitmapLockerSP source_locker{ src_bitmap };
+            for (int y = 0; y < kSourceHeight; ++y)
+            {
+                uint8_t* row_ptr = static_cast<uint8_t*>(source_locker.ptrDataRoi) + static_cast<size_t>(y) * source_locker.stride;
+                for (int i = 0; i < kSourceWidth * bytes_per_pel; ++i)
+                {
+                    row_ptr[i] = static_cast<uint8_t>(random_engine() | 1);
+                }
+            }
+        }
+
+        for (int y = 0; y < kSourceHeight; ++y)
+        {
+            for (int x = 0; x < kSourceWidth; ++x)
+            {
+                bool value;
+                switch (y % 3)
+                {
+                case 0:     value = (x / 40) % 2 == 0; break;    // long runs of set and cleared bits
+                case 1:     value = (random_engine() & 1) != 0; break;
+                default:    value = x % 9 != 4; break;
+                }
+
+                BitonalBitmapOperations::SetPixelValue(mask_bitmap, x, y, value);
+            }
+        }
+
+        for (const auto& offset : { IntPoint{ 0, 0 }, IntPoint{ 3, 1 }, IntPoint{ -5, -2 }, IntPoint{ -13, 1 }, IntPoint{ 9, -1 } })
+        {
+            auto dst_bitmap = CStdBitmapData::Create(pixel_type, kDestinationWidth, kDestinationHeight);
+            {
+                ScopedBitmapLockerSP destination_locker{ dst_bitmap };
+                for (int y = 0; y < kDestinationHeight; ++y)
+                {
+                    memset(static_cast<uint8_t*>(destination_locker.ptrDataRoi) + static_cast<size_t>(y) * destination_locker.stride, 0, kDestinationWidth * static_cast<size_t>(bytes_per_pel));
+                }
+            }
+
+            BitonalBitmapOperations::CopyAt(src_bitmap.get(), mask_bitmap.get(), offset, dst_bitmap.get());
+
+            ScopedBitmapLockerSP source_locker{ src_bitmap };
+            ScopedBitmapLockerSP destination_locker{ dst_bitmap };
+            for (int y = 0; y < kDestinationHeight; ++y)
+            {
+                for (int x = 0; x < kDestinationWidth; ++x)
+                {
+                    const int x_source = x - offset.x;
+                    const int y_source = y - offset.y;
+                    const bool expect_copied =
+                        x_source >= 0 && x_source < kSourceWidth && y_source >= 0 && y_source < kSourceHeight &&
+                        BitonalBitmapOperations::GetPixelValue(mask_bitmap, x_source, y_source);
+                    const uint8_t* destination_pixel = static_cast<const uint8_t*>(destination_locker.ptrDataRoi) + static_cast<size_t>(y) * destination_locker.stride + static_cast<size_t>(x) * bytes_per_pel;
+                    for (uint8_t i = 0; i < bytes_per_pel; ++i)
+                    {
+                        const uint8_t expected_value = expect_copied ?
+                            (static_cast<const uint8_t*>(source_locker.ptrDataRoi) + static_cast<size_t>(y_source) * source_locker.stride + static_cast<size_t>(x_source) * bytes_per_pel)[i] :
+                            0;
+                        ASSERT_EQ(destination_pixel[i], expected_value) << "pixeltype=" << Utils::PixelTypeToInformalString(pixel_type) << " x=" << x << " y=" << y;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -8,6 +8,8 @@
 #include "MemOutputStream.h"
 #include "utils.h"
 #include <array>
+#include <cstdio>
+#include <random>
 #include <thread>
 
 using namespace libCZI;
@@ -1608,3 +1610,242 @@ TEST(CziReader, CreateBitmapFromSubBlockDataZstd0TooSmallEnableResolutionAndChec
         }
     }
 }
+
+TEST(CziReader, ReadSubBlockFromMemoryStreamAndCheckThatDataIsNotCopied)
+{
+    // arrange
+    auto czi_document_as_blob = CreateTestCzi();
+    const auto memory_stream = CreateStreamFromMemory(get<0>(czi_document_as_blob), get<1>(czi_document_as_blob));
+    const auto reader = CreateCZIReader();
+    reader->Open(memory_stream);
+
+    // act
+    auto sub_block = reader->ReadSubBlock(0);
+    size_t size_of_data;
+    auto data = sub_block->GetRawData(ISubBlock::MemBlkType::Data, &size_of_data);
+
+    // assert
+    // since the in-memory stream gives direct access to its memory, we expect that the data of the sub-block
+    //  is referencing the memory of the stream (instead of being a copy)
+    const uint8_t* blob_begin = static_cast<const uint8_t*>(get<0>(czi_document_as_blob).get());
+    const uint8_t* blob_end = blob_begin + get<1>(czi_document_as_blob);
+    const uint8_t* data_pointer = static_cast<const uint8_t*>(data.get());
+    ASSERT_EQ(size_of_data, 100 * 100);
+    EXPECT_TRUE(data_pointer >= blob_begin && data_pointer + size_of_data <= blob_end);
+
+    // the data must remain valid after the reader and the stream (and the original blob) are gone
+    reader->Close();
+    get<0>(czi_document_as_blob).reset();
+    sub_block.reset();
+    for (size_t i = 0; i < size_of_data; ++i)
+    {
+        ASSERT_EQ(data_pointer[i], 1);
+    }
+}
+
+TEST(CziReader, ReadSubBlockFromMemoryStreamAndFromStreamWithoutDirectAccessAndCompare)
+{
+    // arrange
+    const auto czi_document_as_blob = CreateTestCzi();
+    const auto direct_access_stream = CreateStreamFromMemory(get<0>(czi_document_as_blob), get<1>(czi_document_as_blob));
+    const auto copying_stream = make_shared<CMemInputOutputStream>(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto reader_direct_access = CreateCZIReader();
+    reader_direct_access->Open(direct_access_stream);
+    const auto reader_copying = CreateCZIReader();
+    reader_copying->Open(copying_stream);
+
+    // act & assert
+    reader_copying->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo&) -> bool
+        {
+            const auto sub_block_copied = reader_copying->ReadSubBlock(index);
+            const auto sub_block_direct_access = reader_direct_access->ReadSubBlock(index);
+            for (const auto type : { ISubBlock::MemBlkType::Metadata, ISubBlock::MemBlkType::Data, ISubBlock::MemBlkType::Attachment })
+            {
+                size_t size_copied, size_direct_access;
+                const auto data_copied = sub_block_copied->GetRawData(type, &size_copied);
+                const auto data_direct_access = sub_block_direct_access->GetRawData(type, &size_direct_access);
+                EXPECT_EQ(size_copied, size_direct_access);
+                if (size_copied > 0 && size_copied == size_direct_access)
+                {
+                    EXPECT_NE(data_copied.get(), data_direct_access.get());
+                    EXPECT_EQ(memcmp(data_copied.get(), data_direct_access.get(), size_copied), 0);
+                }
+            }
+
+            return true;
+        });
+}
+
+namespace
+{
+    /// A file in the temporary directory (of the test framework) with the specified content, which is deleted when
+    /// this object is destroyed.
+    class TemporaryFile
+    {
+    private:
+        std::string filename_;
+    public:
+        TemporaryFile(const void* data, size_t size)
+        {
+            std::random_device random_device;
+            this->filename_ = testing::TempDir() + "libCZI_UnitTests_" + to_string(random_device()) + ".czi";
+            FILE* fp = fopen(this->filename_.c_str(), "wb");
+            if (fp == nullptr)
+            {
+                throw runtime_error("Could not create the temporary file \"" + this->filename_ + "\".");
+            }
+
+            const size_t bytes_written = size > 0 ? fwrite(data, 1, size, fp) : 0;
+            fclose(fp);
+            if (bytes_written != size)
+            {
+                std::remove(this->filename_.c_str());
+                throw runtime_error("Could not write the temporary file \"" + this->filename_ + "\".");
+            }
+        }
+
+        TemporaryFile(const TemporaryFile&) = delete;
+        TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+        ~TemporaryFile()
+        {
+            std::remove(this->filename_.c_str());
+        }
+
+        const std::string& GetFilename() const { return this->filename_; }
+    };
+
+    bool IsStreamClassAvailable(const string& class_name)
+    {
+        for (int i = 0; i < StreamsFactory::GetStreamClassesCount(); ++i)
+        {
+            StreamsFactory::StreamClassInfo info;
+            if (StreamsFactory::GetStreamInfoForClass(i, info) && info.class_name == class_name)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    shared_ptr<IStream> CreateStreamWithStreamsFactory(const char* class_name, const string& filename)
+    {
+        StreamsFactory::CreateStreamInfo create_info;
+        create_info.class_name = class_name;
+        return StreamsFactory::CreateStream(create_info, filename);
+    }
+}
+
+TEST(CziReader, ReadSubBlockFromMmapStreamAndCompareWithRegularFileStream)
+{
+    if (!IsStreamClassAvailable("mmap_file_inputstream"))
+    {
+        GTEST_SKIP() << "The stream class \"mmap_file_inputstream\" is not available, therefore skipping this test.";
+    }
+
+    // arrange
+    const auto czi_document_as_blob = CreateTestCzi();
+    const TemporaryFile temporary_file(get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob));
+    const auto mmap_stream = CreateStreamWithStreamsFactory("mmap_file_inputstream", temporary_file.GetFilename());
+    const auto file_stream = CreateStreamWithStreamsFactory("c_runtime_file_inputstream", temporary_file.GetFilename());
+    const auto direct_memory_access_stream = dynamic_cast<IDirectMemoryAccessStream*>(mmap_stream.get());
+    ASSERT_NE(direct_memory_access_stream, nullptr);
+    const auto mapping = direct_memory_access_stream->TryGetMemory(0, get<1>(czi_document_as_blob));
+    ASSERT_TRUE(mapping);
+    const uint8_t* mapping_begin = static_cast<const uint8_t*>(mapping.get());
+    const uint8_t* mapping_end = mapping_begin + get<1>(czi_document_as_blob);
+    ASSERT_EQ(memcmp(mapping_begin, get<0>(czi_document_as_blob).get(), get<1>(czi_document_as_blob)), 0);
+
+    const auto reader_mmap = CreateCZIReader();
+    reader_mmap->Open(mmap_stream);
+    const auto reader_file = CreateCZIReader();
+    reader_file->Open(file_stream);
+
+    // act & assert
+    int sub_block_count = 0;
+    reader_file->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo&) -> bool
+        {
+            const auto sub_block_file = reader_file->ReadSubBlock(index);
+            const auto sub_block_mmap = reader_mmap->ReadSubBlock(index);
+            for (const auto type : { ISubBlock::MemBlkType::Metadata, ISubBlock::MemBlkType::Data, ISubBlock::MemBlkType::Attachment })
+            {
+                size_t size_file, size_mmap;
+                const auto data_file = sub_block_file->GetRawData(type, &size_file);
+                const auto data_mmap = sub_block_mmap->GetRawData(type, &size_mmap);
+                EXPECT_EQ(size_file, size_mmap);
+                if (size_file > 0 && size_file == size_mmap)
+                {
+                    // the data read from the mmap-stream is expected to reference the mapping (instead of being a copy)
+                    const uint8_t* data_pointer = static_cast<const uint8_t*>(data_mmap.get());
+                    EXPECT_TRUE(data_pointer >= mapping_begin && data_pointer + size_mmap <= mapping_end);
+                    EXPECT_EQ(memcmp(data_file.get(), data_mmap.get(), size_file), 0);
+                }
+            }
+
+            ++sub_block_count;
+            return true;
+        });
+
+    EXPECT_EQ(sub_block_count, 5);
+}
+
+TEST(CziReader, MmapStreamTryGetMemoryAndReadWithRangesBeyondTheEndOfTheFile)
+{
+    if (!IsStreamClassAvailable("mmap_file_inputstream"))
+    {
+        GTEST_SKIP() << "The stream class \"mmap_file_inputstream\" is not available, therefore skipping this test.";
+    }
+
+    static constexpr uint8_t kContent[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    const TemporaryFile temporary_file(kContent, sizeof(kContent));
+    const auto stream = CreateStreamWithStreamsFactory("mmap_file_inputstream", temporary_file.GetFilename());
+    const auto direct_memory_access_stream = dynamic_cast<IDirectMemoryAccessStream*>(stream.get());
+    ASSERT_NE(direct_memory_access_stream, nullptr);
+
+    const auto last_byte = direct_memory_access_stream->TryGetMemory(sizeof(kContent) - 1, 1);
+    ASSERT_TRUE(last_byte);
+    EXPECT_EQ(*static_cast<const uint8_t*>(last_byte.get()), 10);
+    EXPECT_FALSE(direct_memory_access_stream->TryGetMemory(sizeof(kContent) - 1, 2));
+    EXPECT_FALSE(direct_memory_access_stream->TryGetMemory(0, sizeof(kContent) + 1));
+    EXPECT_FALSE(direct_memory_access_stream->TryGetMemory(sizeof(kContent) + 1, 0));
+    EXPECT_FALSE(direct_memory_access_stream->TryGetMemory(1, numeric_limits<uint64_t>::max()));
+    EXPECT_FALSE(direct_memory_access_stream->TryGetMemory(numeric_limits<uint64_t>::max(), 1));
+
+    // a read beyond the end of the file is truncated
+    uint8_t buffer[16];
+    uint64_t bytes_read = 0;
+    stream->Read(6, buffer, sizeof(buffer), &bytes_read);
+    ASSERT_EQ(bytes_read, 4);
+    EXPECT_EQ(memcmp(buffer, kContent + 6, 4), 0);
+    stream->Read(sizeof(kContent) + 5, buffer, sizeof(buffer), &bytes_read);
+    EXPECT_EQ(bytes_read, 0);
+}
+
+TEST(CziReader, MmapStreamWithZeroLengthFile)
+{
+    if (!IsStreamClassAvailable("mmap_file_inputstream"))
+    {
+        GTEST_SKIP() << "The stream class \"mmap_file_inputstream\" is not available, therefore skipping this test.";
+    }
+
+    const TemporaryFile temporary_file(nullptr, 0);
+    const auto stream = CreateStreamWithStreamsFactory("mmap_file_inputstream", temporary_file.GetFilename());
+    const auto direct_memory_access_stream = dynamic_cast<IDirectMemoryAccessStream*>(stream.get());
+    ASSERT_NE(direct_memory_access_stream, nullptr);
+
+    // there is no mapping for an empty file, so no memory can be accessed directly
+    EXPECT_FALSE(direct_memory_access_stream->TryGetMemory(0, 0));
+    EXPECT_FALSE(direct_memory_access_stream->TryGetMemory(0, 1));
+
+    uint8_t buffer[4];
+    uint64_t bytes_read = 1;
+    stream->Read(0, buffer, sizeof(buffer), &bytes_read);
+    EXPECT_EQ(bytes_read, 0);
+
+    // and opening it as CZI fails (in a controlled way)
+    const auto reader = CreateCZIReader();
+    EXPECT_ANY_THROW(reader->Open(stream));
+}
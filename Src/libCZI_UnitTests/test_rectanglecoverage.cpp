@@ -121,3 +121,67 @@ INSTANTIATE_TEST_SUITE_P(
     // Partially Overlapping Rectangles
     make_tuple(vector<IntRect>{ IntRect{ 10, 10, 40, 40 }, IntRect{ 30, 30, 30, 30 }, IntRect{ 65, 65, 25, 25 } }, 2725)
 ));
+
+TEST(CoverageCalculator, RandomRectanglesCheckNewlyCoveredAreaAndCompleteCoverageWithReferenceImplementation)
+{
+    std::random_device dev;
+    std::mt19937 rng(dev());
+    std::uniform_int_distribution<int> distribution(0, 99); // distribution in range [0, 99]
+
+    static constexpr IntRect kQueryRect{ 0, 0, 200, 200 };
+
+    for (int repeat = 0; repeat < 10; repeat++)
+    {
+        vector<IntRect> rectangles;
+        RectangleCoverageCalculator calculator;
+        int64_t covered_area = 0;
+        const int number_of_rectangles = 1 + distribution(rng);
+        for (int i = 0; i < number_of_rectangles; ++i)
+        {
+            // the value returned by AddRectangle must be the increase of the covered area
+            rectangles.emplace_back(IntRect{ distribution(rng), distribution(rng), 1 + distribution(rng), 1 + distribution(rng) });
+            covered_area += calculator.AddRectangle(rectangles.back());
+            EXPECT_EQ(covered_area, CalcAreaOfIntersectionWithRectangleReference(rectangles, kQueryRect));
+        }
+
+        for (int i = 0; i < 100; ++i)
+        {
+            // the reference implementation requires the query rectangle to be at the origin, so we translate the rectangles accordingly
+            const IntRect query_rect{ distribution(rng), distribution(rng), 1 + distribution(rng), 1 + distribution(rng) };
+            vector<IntRect> translated_rectangles;
+            for (const auto& rectangle : rectangles)
+            {
+                translated_rectangles.emplace_back(IntRect{ rectangle.x - query_rect.x, rectangle.y - query_rect.y, rectangle.w, rectangle.h });
+            }
+
+            const bool is_completely_covered = CalcAreaOfIntersectionWithRectangleReference(translated_rectangles, IntRect{ 0, 0, query_rect.w, query_rect.h }) == static_cast<int64_t>(query_rect.w) * query_rect.h;
+            EXPECT_EQ(calculator.IsCompletelyCovered(query_rect), is_completely_covered);
+        }
+    }
+}
+
+TEST(CoverageCalculator, MosaicOfManyOverlappingRectangles)
+{
+    // we add a mosaic of 100x100 rectangles of size 110x110 with a spacing of 100 (i.e. with an overlap of 10 pixels), with
+    //  the rectangle at (50,50) left out
+    RectangleCoverageCalculator calculator;
+    for (int y = 0; y < 100; ++y)
+    {
+        for (int x = 0; x < 100; ++x)
+        {
+            if (x != 50 || y != 50)
+            {
+                calculator.AddRectangle(IntRect{ x * 100, y * 100, 110, 110 });
+            }
+        }
+    }
+
+    // the hole left is of size 90x90
+    EXPECT_EQ(calculator.CalcAreaOfIntersectionWithRectangle(IntRect{ 0, 0, 10010, 10010 }), 10010LL * 10010 - 90 * 90);
+    EXPECT_FALSE(calculator.IsCompletelyCovered(IntRect{ 0, 0, 10010, 10010 }));
+    EXPECT_FALSE(calculator.IsCompletelyCovered(IntRect{ 5050, 5050, 1, 1 }));
+    EXPECT_TRUE(calculator.IsCompletelyCovered(IntRect{ 0, 0, 5010, 10010 }));
+    EXPECT_TRUE(calculator.IsCompletelyCovered(IntRect{ 5100, 0, 4910, 10010 }));
+    EXPECT_EQ(calculator.AddRectangle(IntRect{ 5000, 5000, 110, 110 }), 90 * 90);
+    EXPECT_TRUE(calculator.IsCompletelyCovered(IntRect{ 0, 0, 10010, 10010 }));
+}
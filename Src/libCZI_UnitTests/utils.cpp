@@ -4,6 +4,7 @@
 
 #include "utils.h"
 #include "../libCZI/bitmapData.h"
+#include "MemOutputStream.h"
 
 #include <random>
 
@@ -588,4 +589,75 @@ void WriteOutTestCzi(const char* testcaseName, const char* testname, const std::
     }
 }
 
+std::tuple<std::shared_ptr<void>, size_t> CreateCziDocument(const std::shared_ptr<libCZI::ICziWriterInfo>& writer_info, const std::function<void(libCZI::ICziWriter*)>& add_sub_blocks)
+{
+    auto writer = CreateCZIWriter();
+    auto outStream = make_shared<CMemOutputStream>(0);
+    writer->Create(outStream, writer_info);
+
+    add_sub_blocks(writer.get());
+
+    PrepareMetadataInfo prepare_metadata_info;
+    auto metaDataBuilder = writer->GetPreparedMetadata(prepare_metadata_info);
+    WriteMetadataInfo write_metadata_info;
+    write_metadata_info.Clear();
+    const auto& strMetadata = metaDataBuilder->GetXml();
+    write_metadata_info.szMetadata = strMetadata.c_str();
+    write_metadata_info.szMetadataSize = strMetadata.size() + 1;
+    write_metadata_info.ptrAttachment = nullptr;
+    write_metadata_info.attachmentSize = 0;
+    writer->SyncWriteMetadata(write_metadata_info);
+    writer->Close();
+    writer.reset();
+
+    size_t czi_document_size = 0;
+    shared_ptr<void> czi_document_data = outStream->GetCopy(&czi_document_size);
+    return make_tuple(czi_document_data, czi_document_size);
+}
+
+void AddSubBlockWithBitmap(libCZI::ICziWriter* writer, const libCZI::CDimCoordinate& coordinate, int m_index, const libCZI::IntRect& logical_rect, const std::shared_ptr<libCZI::IBitmapData>& bitmap)
+{
+    AddSubBlockInfoStridedBitmap addSbBlkInfo;
+    addSbBlkInfo.Clear();
+    addSbBlkInfo.coordinate = coordinate;
+    addSbBlkInfo.mIndexValid = m_index >= 0;
+    addSbBlkInfo.mIndex = (max)(m_index, 0);
+    addSbBlkInfo.x = logical_rect.x;
+    addSbBlkInfo.y = logical_rect.y;
+    addSbBlkInfo.logicalWidth = logical_rect.w;
+    addSbBlkInfo.logicalHeight = logical_rect.h;
+    addSbBlkInfo.physicalWidth = bitmap->GetWidth();
+    addSbBlkInfo.physicalHeight = bitmap->GetHeight();
+    addSbBlkInfo.PixelType = bitmap->GetPixelType();
+    const ScopedBitmapLockerSP lock_info_bitmap{ bitmap };
+    addSbBlkInfo.ptrBitmap = lock_info_bitmap.ptrDataRoi;
+    addSbBlkInfo.strideBitmap = lock_info_bitmap.stride;
+    writer->SyncAddSubBlock(addSbBlkInfo);
+}
 
+std::tuple<std::shared_ptr<void>, size_t> CreateCziWithThreeZPlanesOfOverlappingSubblocks()
+{
+    return CreateCziDocument(
+        make_shared<CCziWriterInfo>(
+            GUID{ 0x1234567,0x89ab,0xcdef,{ 1,2,3,4,5,6,7,8 } },
+            CDimBounds{ { DimensionIndex::C, 0, 1 }, { DimensionIndex::Z, 0, 3 } },
+            0, 15),  // set a bounds M : 0<=m<=15
+        [](ICziWriter* writer)->void
+        {
+            for (int z = 0; z < 3; ++z)
+            {
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (z != 1 || i != 0)
+                    {
+                        AddSubBlockWithBitmap(
+                            writer,
+                            CDimCoordinate{ { DimensionIndex::C, 0 }, { DimensionIndex::Z, z } },
+                            i,
+                            IntRect{ (i % 4) * 12, (i / 4) * 12, 16, 16 },
+                            CreateRandomBitmap(PixelType::Gray8, 16, 16));
+                    }
+                }
+            }
+        });
+}
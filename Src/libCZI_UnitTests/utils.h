@@ -6,6 +6,7 @@
 
 #include "inc_libCZI.h"
 #include "MemInputOutputStream.h"
+#include <functional>
 #include <tuple>
 #include <memory>
 
@@ -73,6 +74,32 @@ bool CompareGrayFloat32Bitmaps(const std::shared_ptr<libCZI::IBitmapData>& bmp1,
 /// \returns    The maximum difference and the mean difference of the pixel values of the two bitmaps.
 std::tuple<float,float> CalculateMaxDifferenceMeanDifference(const std::shared_ptr<libCZI::IBitmapData>& bmp1, const std::shared_ptr<libCZI::IBitmapData>& bmp2);
 
+/// Creates a synthetic CZI document in memory. A writer is created with the specified writer-info, then the specified function
+/// is called in order to add the sub-blocks, and finally the (prepared) metadata is written and the writer is closed.
+///
+/// \param  writer_info     The writer-info (giving the GUID, the dimension bounds and the M-index range).
+/// \param  add_sub_blocks  A function which is called (with the writer) in order to add the sub-blocks.
+///
+/// \returns A blob containing the synthetic CZI document.
+std::tuple<std::shared_ptr<void>, size_t> CreateCziDocument(const std::shared_ptr<libCZI::ICziWriterInfo>& writer_info, const std::function<void(libCZI::ICziWriter*)>& add_sub_blocks);
+
+/// Adds an uncompressed sub-block with the specified bitmap (i.e. the physical size and the pixel type are the ones of the
+/// bitmap) to the specified writer.
+///
+/// \param  writer          The writer.
+/// \param  coordinate      The coordinate of the sub-block.
+/// \param  m_index         The M-index of the sub-block - if negative, the sub-block has no M-index.
+/// \param  logical_rect    The logical position and size of the sub-block.
+/// \param  bitmap          The bitmap.
+void AddSubBlockWithBitmap(libCZI::ICziWriter* writer, const libCZI::CDimCoordinate& coordinate, int m_index, const libCZI::IntRect& logical_rect, const std::shared_ptr<libCZI::IBitmapData>& bitmap);
+
+/// Creates a synthetic CZI document with three Z-planes, each consisting of 4x4 overlapping subblocks (of size 16x16, placed
+/// on a grid with spacing 12) with random content. On the Z-plane with index 1, the subblock in the upper left corner is missing.
+/// The M-index of a subblock is its index in the grid (i.e. column + 4 * row).
+///
+/// \returns A blob containing the synthetic CZI document.
+std::tuple<std::shared_ptr<void>, size_t> CreateCziWithThreeZPlanesOfOverlappingSubblocks();
+
 void WriteOutTestCzi(const char* testcaseName, const char* testname, const void* ptr, size_t size);
 
 void WriteOutTestCzi(const char* testcaseName, const char* testname, const std::shared_ptr<CMemInputOutputStream>& str);